@@ -0,0 +1,376 @@
+#include "Benchmark.h"
+#include "Messages.h"
+#include <algorithm>
+#include <chrono>
+
+static const char* const TYPE_NAMES[] = {"tap", "recharge", "numbers", "lock"};
+static_assert(sizeof(TYPE_NAMES) / sizeof(TYPE_NAMES[0]) == TX_TYPE_COUNT, "TYPE_NAMES must cover every TxType");
+
+static const char* MASTER_UID = "d3:73:fd:e3";
+static const uint32_t MAX_RECHARGE = 200;   ///< Largest amount a recharge transaction asks for
+static const uint8_t NUMBER_DIGITS = 8;
+
+Benchmark::Benchmark(Simulator* sim, const BenchOptions& options)
+    : sim(sim), options(options), randomState(options.seed != 0 ? options.seed : 1), master(nullptr),
+      pool(), stats(), virtualUs(0), hostSeconds(0) {
+    if (this->options.cards == 0) this->options.cards = 1;
+    if (this->options.cards > MAX_CARDS) this->options.cards = MAX_CARDS;
+}
+
+const char* Benchmark::typeName(TxType type) {
+    return type < TX_TYPE_COUNT ? TYPE_NAMES[type] : "";
+}
+
+/**
+ * @brief Reads weights like "tap=40,recharge=30"; types not listed get 0.
+ *
+ * @return false on an unknown type or when every weight is 0.
+ */
+bool Benchmark::parseMix(const char* text, uint32_t* mix) {
+    uint32_t parsed[TX_TYPE_COUNT] = {};
+    uint32_t total = 0;
+    const char* cursor = text;
+    while (*cursor != '\0') {
+        const char* equals = strchr(cursor, '=');
+        if (equals == nullptr) return false;
+        size_t nameLength = equals - cursor;
+        uint8_t type = 0;
+        while (type < TX_TYPE_COUNT &&
+               (strlen(TYPE_NAMES[type]) != nameLength || strncmp(TYPE_NAMES[type], cursor, nameLength) != 0)) {
+            type++;
+        }
+        if (type == TX_TYPE_COUNT) return false;
+        char* end = nullptr;
+        parsed[type] = (uint32_t)strtoul(equals + 1, &end, 10);
+        total += parsed[type];
+        cursor = *end == ',' ? end + 1 : end;
+        if (*end != ',' && *end != '\0') return false;
+    }
+    if (total == 0) return false;
+    memcpy(mix, parsed, sizeof(parsed));
+    return true;
+}
+
+static double perTx(uint64_t total, uint32_t count) {
+    return count > 0 ? (double)total / count : 0;
+}
+
+/**
+ * @brief Deterministic xorshift for the workload, apart from the one of
+ * esp_random() so the firmware sees the same values as in any other run.
+ */
+uint32_t Benchmark::nextRandom() {
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 17;
+    randomState ^= randomState << 5;
+    return randomState;
+}
+
+TxType Benchmark::pickType() {
+    uint32_t total = 0;
+    for (uint8_t type = 0; type < TX_TYPE_COUNT; type++) {
+        total += options.mix[type];
+    }
+    uint32_t draw = nextRandom() % total;
+    for (uint8_t type = 0; type < TX_TYPE_COUNT; type++) {
+        if (draw < options.mix[type]) return (TxType)type;
+        draw -= options.mix[type];
+    }
+    return TX_TAP;
+}
+
+/**
+ * @brief Provisions the master card and the user cards, with numbers in
+ * every slot, then unlocks the device.
+ */
+bool Benchmark::begin() {
+    master = sim->addCard("master", MASTER_UID);
+    if (master == nullptr) return false;
+
+    for (uint8_t i = 0; i < options.cards; i++) {
+        char name[16];
+        char uid[16];
+        snprintf(name, sizeof(name), "user%u", (unsigned)i);
+        snprintf(uid, sizeof(uid), "04:%02x:%02x:%02x", (unsigned)(0x10 + i), (unsigned)(nextRandom() & 0xFF),
+                 (unsigned)(nextRandom() & 0xFF));
+        VirtualCard* card = sim->addCard(name, uid);
+        if (card == nullptr) return false;
+        snprintf((char*)card->blocks[BALANCE_SECBLOC], 16, "%u", 500u);
+        pool[i] = card;
+    }
+    return unlock();
+}
+
+bool Benchmark::unlock() {
+    ScreenManager* ui = sim->getScreens();
+    sim->tap(master);
+    bool unlocked = sim->waitFor([ui]() { return !ui->isLocked(); }, STEP_TIMEOUT_MS);
+    sim->tap(nullptr);
+    sim->wait(UI_CARD_PRESENCE_MS);
+    return unlocked;
+}
+
+/**
+ * @brief Puts a card on the reader and waits for the action menu.
+ */
+bool Benchmark::startSession(VirtualCard* card) {
+    ScreenManager* ui = sim->getScreens();
+    sim->tap(card);
+    return sim->waitFor([ui]() { return ui->getTopScreen() == &ui->selectActionScreen; }, STEP_TIMEOUT_MS);
+}
+
+/**
+ * @brief Takes the card away and waits for the home screen.
+ */
+bool Benchmark::endSession() {
+    ScreenManager* ui = sim->getScreens();
+    sim->tap(nullptr);
+    return sim->waitFor([ui]() { return ui->getTopScreen() == &ui->homeScreen; }, STEP_TIMEOUT_MS);
+}
+
+bool Benchmark::pressUntil(char key, UiScreen* screen) {
+    ScreenManager* ui = sim->getScreens();
+    sim->setKey(key, true);
+    bool shown = sim->waitFor([ui, screen]() { return ui->getTopScreen() == screen; }, STEP_TIMEOUT_MS);
+    sim->setKey(key, false);
+    sim->wait(Simulator::KEY_HOLD_MS);
+    return shown;
+}
+
+bool Benchmark::runTap(VirtualCard* card, uint32_t& latencyUs) {
+    int64_t start = HostHal::now();
+    bool ok = startSession(card);
+    latencyUs = (uint32_t)(HostHal::now() - start);
+    return endSession() && ok;
+}
+
+/**
+ * @brief Recharges 100 or 200 units; the result message is dismissed with
+ * a key, like a busy operator does.
+ */
+bool Benchmark::runRecharge(VirtualCard* card, uint32_t& latencyUs) {
+    ScreenManager* ui = sim->getScreens();
+    char amountKey = (nextRandom() & 1) ? '1' : '2';
+    if (!startSession(card) || !pressUntil('1', &ui->rechargeScreen) || !pressUntil(amountKey, &ui->confirmScreen)) {
+        return false;
+    }
+
+    int64_t start = HostHal::now();
+    sim->setKey('#', true);
+    bool shown = sim->waitFor([ui]() { return ui->getTopScreen() == &ui->messageScreen; }, STEP_TIMEOUT_MS);
+    latencyUs = (uint32_t)(HostHal::now() - start);
+    bool ok = shown && sim->rowContains(1, msg(MSG_RECHARGE_SUCCEEDED));
+    sim->setKey('#', false);
+    sim->wait(Simulator::KEY_HOLD_MS);
+
+    return pressUntil('*', &ui->homeScreen) && endSession() && ok;
+}
+
+/**
+ * @brief Types a new number into one of the four slots and saves it.
+ */
+bool Benchmark::runNumbers(VirtualCard* card, uint32_t& latencyUs) {
+    ScreenManager* ui = sim->getScreens();
+    char slotKey = (char)('1' + nextRandom() % 4);
+    if (!startSession(card) || !pressUntil('2', &ui->userModeScreen) || !pressUntil(slotKey, &ui->promptScreen)) {
+        return false;
+    }
+    for (uint8_t i = 0; i < NUMBER_DIGITS; i++) {
+        sim->pressKey((char)('0' + nextRandom() % 10));
+    }
+
+    int64_t start = HostHal::now();
+    sim->setKey('#', true);
+    bool shown = sim->waitFor([ui]() { return ui->getTopScreen() == &ui->messageScreen; }, STEP_TIMEOUT_MS);
+    latencyUs = (uint32_t)(HostHal::now() - start);
+    bool ok = shown && sim->rowContains(3, msg(MSG_SAVED));
+    sim->setKey('#', false);
+    sim->wait(Simulator::KEY_HOLD_MS);
+
+    return pressUntil('*', &ui->userModeScreen) && endSession() && ok;
+}
+
+/**
+ * @brief Locks the device, as the inactivity timeout does, and unlocks it
+ * with the master card.
+ */
+bool Benchmark::runLock(uint32_t& latencyUs) {
+    ScreenManager* ui = sim->getScreens();
+    ui->lock(false);
+    sim->wait(UI_POLL_INTERVAL_MS);
+
+    int64_t start = HostHal::now();
+    sim->tap(master);
+    bool ok = sim->waitFor([ui]() { return ui->getTopScreen() == &ui->homeScreen; }, STEP_TIMEOUT_MS);
+    latencyUs = (uint32_t)(HostHal::now() - start);
+    sim->tap(nullptr);
+    sim->wait(UI_CARD_PRESENCE_MS);
+    return ok;
+}
+
+/**
+ * @brief Brings the device back to the home screen after a failed
+ * transaction, outside the measured window.
+ */
+void Benchmark::recover() {
+    for (char key : {'#', '*'}) {
+        sim->setKey(key, false);
+    }
+    sim->tap(nullptr);
+    sim->wait(UI_CARD_PRESENCE_MS);
+    if (sim->getScreens()->isLocked()) {
+        unlock();
+    } else {
+        sim->getScreens()->resetTo(&sim->getScreens()->homeScreen);
+        sim->wait(UI_POLL_INTERVAL_MS);
+    }
+}
+
+/**
+ * @brief Replays the workload, snapshotting the counters around each
+ * transaction.
+ */
+void Benchmark::run() {
+    ScreenManager* ui = sim->getScreens();
+    ConfigManager* config = sim->getConfig();
+    auto hostStart = std::chrono::steady_clock::now();
+
+    for (uint32_t n = 0; n < options.transactions; n++) {
+        TxType type = pickType();
+        VirtualCard* card = pool[nextRandom() % options.cards];
+
+        // Preconditions the firmware would refuse, kept out of the figures
+        if (ui->isLocked()) unlock();
+        if (type == TX_RECHARGE && config->GetBalance() < MAX_RECHARGE) config->SetBalance(DEFAULT_BALANCE);
+
+        HostHal::Counters before = HostHal::getCounters();
+        int64_t start = HostHal::now();
+        uint32_t latencyUs = 0;
+        bool ok;
+        switch (type) {
+            case TX_TAP: ok = runTap(card, latencyUs); break;
+            case TX_RECHARGE: ok = runRecharge(card, latencyUs); break;
+            case TX_NUMBERS: ok = runNumbers(card, latencyUs); break;
+            default: ok = runLock(latencyUs); break;
+        }
+        const HostHal::Counters& after = HostHal::getCounters();
+        virtualUs += HostHal::now() - start;
+
+        TxStats& entry = stats[type];
+        entry.count++;
+        entry.heapAllocations += after.heapAllocations - before.heapAllocations;
+        entry.heapBytes += after.heapBytes - before.heapBytes;
+        entry.flashBytes += after.flashBytesWritten - before.flashBytesWritten;
+        entry.flashErases += after.flashErases - before.flashErases;
+        entry.nvsWrites += after.nvsWrites - before.nvsWrites;
+        entry.rfidCommands += after.rfidCommands - before.rfidCommands;
+        if (ok) {
+            HostHal::Untracked untracked;
+            entry.latencyUs.push_back(latencyUs);
+        } else {
+            entry.failures++;
+            recover();
+        }
+    }
+
+    hostSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - hostStart).count();
+}
+
+/**
+ * @brief Nearest-rank percentile of sorted latencies, 0 when there are none.
+ */
+static uint32_t percentile(const std::vector<uint32_t>& sorted, uint32_t p) {
+    if (sorted.empty()) return 0;
+    size_t rank = (sorted.size() * p + 99) / 100;
+    return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+uint32_t Benchmark::getFailures() const {
+    uint32_t failures = 0;
+    for (const TxStats& entry : stats) failures += entry.failures;
+    return failures;
+}
+
+double Benchmark::getMaxAllocationsPerTx() const {
+    double worst = 0;
+    for (const TxStats& entry : stats) {
+        worst = std::max(worst, perTx(entry.heapAllocations, entry.count));
+    }
+    return worst;
+}
+
+void Benchmark::printSummary(FILE* out) const {
+    uint32_t total = 0;
+    for (const TxStats& entry : stats) total += entry.count;
+    double seconds = virtualUs / 1e6;
+    fprintf(out, "%u transactions in %.1f s virtual (%.2f tx/s), %.2f s on the host\n", (unsigned)total, seconds,
+            seconds > 0 ? total / seconds : 0, hostSeconds);
+    fprintf(out, "%-9s %6s %5s %9s %9s %9s %9s %9s\n", "type", "count", "fail", "p50 ms", "p99 ms", "allocs/tx",
+            "flashB/tx", "rfid/tx");
+    for (uint8_t type = 0; type < TX_TYPE_COUNT; type++) {
+        const TxStats& entry = stats[type];
+        if (entry.count == 0) continue;
+        std::vector<uint32_t> sorted(entry.latencyUs);
+        std::sort(sorted.begin(), sorted.end());
+        fprintf(out, "%-9s %6u %5u %9.1f %9.1f %9.1f %9.1f %9.1f\n", TYPE_NAMES[type], (unsigned)entry.count,
+                (unsigned)entry.failures, percentile(sorted, 50) / 1000.0, percentile(sorted, 99) / 1000.0,
+                perTx(entry.heapAllocations, entry.count), perTx(entry.flashBytes, entry.count),
+                perTx(entry.rfidCommands, entry.count));
+    }
+}
+
+/**
+ * @brief Writes the options and the figures of every type as JSON.
+ *
+ * @return false when the file cannot be written.
+ */
+bool Benchmark::writeJson(const char* path) const {
+    FILE* out = fopen(path, "w");
+    if (out == nullptr) return false;
+
+    uint32_t total = 0;
+    for (const TxStats& entry : stats) total += entry.count;
+    double seconds = virtualUs / 1e6;
+
+    fprintf(out, "{\n");
+    fprintf(out, "  \"label\": \"%s\",\n", options.label != nullptr ? options.label : "");
+    fprintf(out, "  \"seed\": %u,\n", (unsigned)options.seed);
+    fprintf(out, "  \"cards\": %u,\n", (unsigned)options.cards);
+    fprintf(out, "  \"mix\": {");
+    for (uint8_t type = 0; type < TX_TYPE_COUNT; type++) {
+        fprintf(out, "%s\"%s\": %u", type > 0 ? ", " : "", TYPE_NAMES[type], (unsigned)options.mix[type]);
+    }
+    fprintf(out, "},\n");
+    fprintf(out, "  \"transactions\": %u,\n", (unsigned)total);
+    fprintf(out, "  \"failures\": %u,\n", (unsigned)getFailures());
+    fprintf(out, "  \"virtualSeconds\": %.3f,\n", seconds);
+    fprintf(out, "  \"throughputPerSecond\": %.3f,\n", seconds > 0 ? total / seconds : 0);
+    fprintf(out, "  \"hostSeconds\": %.3f,\n", hostSeconds);
+    fprintf(out, "  \"types\": {\n");
+    bool first = true;
+    for (uint8_t type = 0; type < TX_TYPE_COUNT; type++) {
+        const TxStats& entry = stats[type];
+        if (entry.count == 0) continue;
+        std::vector<uint32_t> sorted(entry.latencyUs);
+        std::sort(sorted.begin(), sorted.end());
+        uint64_t sum = 0;
+        for (uint32_t value : sorted) sum += value;
+
+        fprintf(out, "%s    \"%s\": {\n", first ? "" : ",\n", TYPE_NAMES[type]);
+        fprintf(out, "      \"count\": %u,\n", (unsigned)entry.count);
+        fprintf(out, "      \"failures\": %u,\n", (unsigned)entry.failures);
+        fprintf(out, "      \"latencyUs\": {\"p50\": %u, \"p99\": %u, \"mean\": %.0f, \"max\": %u},\n",
+                (unsigned)percentile(sorted, 50), (unsigned)percentile(sorted, 99),
+                perTx(sum, (uint32_t)sorted.size()), sorted.empty() ? 0u : (unsigned)sorted.back());
+        fprintf(out, "      \"heapAllocationsPerTx\": %.2f,\n", perTx(entry.heapAllocations, entry.count));
+        fprintf(out, "      \"heapBytesPerTx\": %.1f,\n", perTx(entry.heapBytes, entry.count));
+        fprintf(out, "      \"flashBytesPerTx\": %.1f,\n", perTx(entry.flashBytes, entry.count));
+        fprintf(out, "      \"flashErasesPerTx\": %.3f,\n", perTx(entry.flashErases, entry.count));
+        fprintf(out, "      \"nvsWritesPerTx\": %.2f,\n", perTx(entry.nvsWrites, entry.count));
+        fprintf(out, "      \"rfidCommandsPerTx\": %.1f\n", perTx(entry.rfidCommands, entry.count));
+        fprintf(out, "    }");
+        first = false;
+    }
+    fprintf(out, "\n  }\n}\n");
+    return fclose(out) == 0;
+}
@@ -0,0 +1,93 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+/**
+ * @file Benchmark.h
+ * @brief Replays a workload of card transactions on the simulator and
+ * reports their modeled cost.
+ *
+ * Each transaction is what an operator does at the counter, from the card
+ * tap to the home screen again. Latency is the virtual time from the input
+ * that starts the measured step to the screen showing its result; heap and
+ * flash figures are the HostHal counters over the whole transaction.
+ *
+ * Transaction types:
+ * - tap: a user card is read, latency up to the action menu
+ * - recharge: 100 or 200 units, latency from '#' on the confirmation to the result
+ * - numbers: one phone number edited, latency from '#' on the prompt to the result
+ * - lock: the device locks and the master card unlocks it, latency from the tap to home
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+#include "Simulator.h"
+
+enum TxType : uint8_t {
+    TX_TAP,
+    TX_RECHARGE,
+    TX_NUMBERS,
+    TX_LOCK,
+    TX_TYPE_COUNT
+};
+
+struct BenchOptions {
+    uint32_t transactions;          ///< Transactions to replay
+    uint32_t seed;                  ///< Seed of the workload, same seed same run
+    uint32_t mix[TX_TYPE_COUNT];    ///< Relative weight of each type
+    uint8_t cards;                  ///< User cards in the pool
+    const char* label;              ///< Firmware version written with the results
+};
+
+class Benchmark {
+public:
+    static const uint8_t MAX_CARDS = Simulator::MAX_CARDS - 1;  ///< One slot is the master card
+    static const uint32_t STEP_TIMEOUT_MS = 5000;               ///< Longest wait for one screen
+
+    Benchmark(Simulator* sim, const BenchOptions& options);
+
+    static const char* typeName(TxType type);
+    static bool parseMix(const char* text, uint32_t* mix);      ///< "tap=40,recharge=30,..."
+
+    bool begin();                   ///< Provision the cards and unlock the device
+    void run();
+    void printSummary(FILE* out) const;
+    bool writeJson(const char* path) const;
+    uint32_t getFailures() const;
+    double getMaxAllocationsPerTx() const;  ///< Heap allocations per transaction of the worst type
+
+private:
+    struct TxStats {
+        uint32_t count;
+        uint32_t failures;
+        std::vector<uint32_t> latencyUs;
+        uint64_t heapAllocations;
+        uint64_t heapBytes;
+        uint64_t flashBytes;
+        uint64_t flashErases;
+        uint64_t nvsWrites;
+        uint64_t rfidCommands;
+    };
+
+    uint32_t nextRandom();
+    TxType pickType();
+    bool unlock();
+    bool startSession(VirtualCard* card);
+    bool endSession();
+    bool pressUntil(char key, UiScreen* screen);
+    bool runTap(VirtualCard* card, uint32_t& latencyUs);
+    bool runRecharge(VirtualCard* card, uint32_t& latencyUs);
+    bool runNumbers(VirtualCard* card, uint32_t& latencyUs);
+    bool runLock(uint32_t& latencyUs);
+    void recover();
+
+    Simulator* sim;
+    BenchOptions options;
+    uint32_t randomState;
+    VirtualCard* master;
+    VirtualCard* pool[MAX_CARDS];
+    TxStats stats[TX_TYPE_COUNT];
+    int64_t virtualUs;              ///< Virtual time spent in transactions
+    double hostSeconds;             ///< Wall time of the run on the host
+};
+
+#endif // BENCHMARK_H
@@ -0,0 +1,83 @@
+/**
+ * @file main.cpp
+ * @brief Benchmark entry point: boots the firmware in the simulator and
+ * replays a workload of card transactions.
+ *
+ * Usage: program [-n <count>] [--mix tap=40,recharge=30,numbers=20,lock=10]
+ *                [--seed <n>] [--cards <n>] [--label <version>] [-o <results.json>]
+ *                [--max-allocs <n>] [-v]
+ * - `--max-allocs` fails the run when a transaction type averages more heap
+ *   allocations, `--max-allocs 0` guards the allocation-free card paths
+ * - `-v` keeps the firmware's Serial output
+ *
+ * The summary goes to stdout, the full figures to the JSON file. The exit
+ * code is 1 when a transaction failed or the allocation limit was passed.
+ */
+
+#include <Arduino.h>
+#include "HostHal.h"
+#include "Simulator.h"
+#include "Benchmark.h"
+
+#ifndef PIO_UNIT_TESTING  // The Unity tests bring their own main()
+
+static Simulator simulator;
+
+int main(int argc, char** argv) {
+    BenchOptions options = {1000, 1, {40, 30, 20, 10}, 8, "dev"};
+    const char* outputPath = "bench-results.json";
+    bool verbose = false;
+    double maxAllocs = -1;
+
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "-n") == 0 && hasValue) {
+            options.transactions = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--mix") == 0 && hasValue) {
+            if (!Benchmark::parseMix(argv[++i], options.mix)) {
+                fprintf(stderr, "bad mix %s, expected e.g. tap=40,recharge=30,numbers=20,lock=10\n", argv[i]);
+                return 2;
+            }
+        } else if (strcmp(argv[i], "--seed") == 0 && hasValue) {
+            options.seed = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--cards") == 0 && hasValue) {
+            options.cards = (uint8_t)strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--label") == 0 && hasValue) {
+            options.label = argv[++i];
+        } else if (strcmp(argv[i], "-o") == 0 && hasValue) {
+            outputPath = argv[++i];
+        } else if (strcmp(argv[i], "--max-allocs") == 0 && hasValue) {
+            maxAllocs = strtod(argv[++i], nullptr);
+        } else if (strcmp(argv[i], "-v") == 0) {
+            verbose = true;
+        } else {
+            fprintf(stderr, "unknown option %s\n", argv[i]);
+            return 2;
+        }
+    }
+
+    if (!verbose) HostHal::setSerialOutput(nullptr);
+    setenv("TZ", "UTC", 1);
+    simulator.begin();
+
+    Benchmark bench(&simulator, options);
+    if (!bench.begin()) {
+        fprintf(stderr, "could not unlock the device with the master card\n");
+        return 1;
+    }
+    HostHal::resetCounters();
+    bench.run();
+    bench.printSummary(stdout);
+    if (!bench.writeJson(outputPath)) {
+        fprintf(stderr, "cannot write %s\n", outputPath);
+        return 2;
+    }
+
+    if (maxAllocs >= 0 && bench.getMaxAllocationsPerTx() > maxAllocs) {
+        fprintf(stderr, "%.2f heap allocations per transaction, limit %.2f\n", bench.getMaxAllocationsPerTx(), maxAllocs);
+        return 1;
+    }
+    return bench.getFailures() == 0 ? 0 : 1;
+}
+
+#endif // PIO_UNIT_TESTING
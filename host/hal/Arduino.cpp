@@ -0,0 +1,265 @@
+#include "Arduino.h"
+#include "HostHal.h"
+#include "esp_task_wdt.h"
+
+static const uint8_t PIN_COUNT = 40;        ///< GPIO0-39 like the ESP32
+static const uint8_t SWITCH_COUNT = 16;     ///< Switches closed at once
+static const uint8_t LEDC_CHANNELS = 16;
+
+struct PinState {
+    uint8_t mode;
+    uint8_t level;                          ///< Output latch
+    void (*handler)(void*);
+    void* arg;
+    int interruptMode;
+};
+
+struct Switch {
+    uint8_t pinA;
+    uint8_t pinB;
+    bool closed;
+};
+
+static PinState pins[PIN_COUNT];
+static Switch switches[SWITCH_COUNT];
+static double toneFrequency[LEDC_CHANNELS];
+static uint32_t toneCount = 0;
+static FILE* serialOutput = stderr;
+static String serialInput;
+static uint32_t randomState = 0x2545F491;
+
+HardwareSerial Serial;
+EspClass ESP;
+
+// --------------------------------------------------
+// Virtual clock
+// --------------------------------------------------
+
+uint32_t millis() {
+    return (uint32_t)(HostHal::now() / 1000);
+}
+
+uint32_t micros() {
+    return (uint32_t)HostHal::now();
+}
+
+void delay(uint32_t ms) {
+    HostHal::advance((int64_t)ms * 1000);
+}
+
+void delayMicroseconds(uint32_t us) {
+    HostHal::advance(us);
+}
+
+void yield() {}
+
+// --------------------------------------------------
+// GPIO: pins joined by the closed switches
+// --------------------------------------------------
+
+/**
+ * @brief Level an input reads: driven by an output it is switched to,
+ * otherwise set by its pull resistor.
+ */
+static int readLevel(uint8_t pin) {
+    if (pin >= PIN_COUNT) return LOW;
+    if (pins[pin].mode == OUTPUT) return pins[pin].level;
+    for (uint8_t i = 0; i < SWITCH_COUNT; i++) {
+        const Switch& sw = switches[i];
+        if (!sw.closed || (sw.pinA != pin && sw.pinB != pin)) continue;
+        uint8_t other = sw.pinA == pin ? sw.pinB : sw.pinA;
+        if (other < PIN_COUNT && pins[other].mode == OUTPUT) {
+            return pins[other].level;
+        }
+    }
+    return (pins[pin].mode & PULLDOWN) ? LOW : HIGH;
+}
+
+/**
+ * @brief Runs the interrupt handlers of the inputs whose level changed.
+ */
+static void notifyEdges(const int* before) {
+    for (uint8_t pin = 0; pin < PIN_COUNT; pin++) {
+        PinState& state = pins[pin];
+        if (state.handler == nullptr) continue;
+        int level = readLevel(pin);
+        if (level == before[pin]) continue;
+        bool rising = level == HIGH;
+        if (state.interruptMode == CHANGE || (state.interruptMode == RISING && rising) ||
+            (state.interruptMode == FALLING && !rising)) {
+            state.handler(state.arg);
+        }
+    }
+}
+
+static void sampleLevels(int* levels) {
+    for (uint8_t pin = 0; pin < PIN_COUNT; pin++) {
+        levels[pin] = readLevel(pin);
+    }
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+    if (pin < PIN_COUNT) pins[pin].mode = mode;
+}
+
+void digitalWrite(uint8_t pin, uint8_t value) {
+    if (pin < PIN_COUNT) pins[pin].level = value ? HIGH : LOW;
+}
+
+int digitalRead(uint8_t pin) {
+    return readLevel(pin);
+}
+
+void attachInterruptArg(uint8_t pin, void (*handler)(void*), void* arg, int mode) {
+    if (pin >= PIN_COUNT) return;
+    pins[pin].handler = handler;
+    pins[pin].arg = arg;
+    pins[pin].interruptMode = mode;
+}
+
+void detachInterrupt(uint8_t pin) {
+    if (pin < PIN_COUNT) pins[pin].handler = nullptr;
+}
+
+// --------------------------------------------------
+// LEDC
+// --------------------------------------------------
+
+double ledcSetup(uint8_t channel, double frequency, uint8_t resolutionBits) {
+    (void)channel;
+    (void)resolutionBits;
+    return frequency;
+}
+
+void ledcAttachPin(uint8_t pin, uint8_t channel) {
+    (void)pin;
+    (void)channel;
+}
+
+void ledcDetachPin(uint8_t pin) {
+    (void)pin;
+}
+
+double ledcWriteTone(uint8_t channel, double frequency) {
+    if (channel >= LEDC_CHANNELS) return 0;
+    if (frequency > 0 && toneFrequency[channel] == 0) toneCount++;
+    toneFrequency[channel] = frequency;
+    return frequency;
+}
+
+void ledcWrite(uint8_t channel, uint32_t duty) {
+    if (channel < LEDC_CHANNELS && duty == 0) toneFrequency[channel] = 0;
+}
+
+// --------------------------------------------------
+// System
+// --------------------------------------------------
+
+esp_err_t esp_read_mac(uint8_t* mac, esp_mac_type_t type) {
+    static const uint8_t base[6] = {0x24, 0x0A, 0xC4, 0x00, 0x00, 0x01};
+    memcpy(mac, base, sizeof(base));
+    mac[5] += (uint8_t)type;
+    return ESP_OK;
+}
+
+/**
+ * @brief Deterministic xorshift, so runs repeat exactly.
+ */
+uint32_t esp_random() {
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 17;
+    randomState ^= randomState << 5;
+    return randomState;
+}
+
+void esp_deep_sleep_start() {
+    if (serialOutput) fflush(serialOutput);
+    fprintf(stderr, "host: deep sleep requested, the device would restart here\n");
+    exit(3);
+}
+
+// --------------------------------------------------
+// Serial
+// --------------------------------------------------
+
+int HardwareSerial::available() {
+    return serialInput.length();
+}
+
+int HardwareSerial::read() {
+    if (serialInput.length() == 0) return -1;
+    int c = (uint8_t)serialInput[0];
+    serialInput.remove(0, 1);
+    return c;
+}
+
+int HardwareSerial::peek() {
+    return serialInput.length() > 0 ? (uint8_t)serialInput[0] : -1;
+}
+
+void HardwareSerial::flush() {
+    if (serialOutput) fflush(serialOutput);
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+    if (serialOutput) fputc(c, serialOutput);
+    return 1;
+}
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size) {
+    if (serialOutput) fwrite(buffer, 1, size, serialOutput);
+    return size;
+}
+
+// --------------------------------------------------
+// Simulator controls
+// --------------------------------------------------
+
+namespace HostHal {
+
+void setSwitch(uint8_t pinA, uint8_t pinB, bool closed) {
+    int before[PIN_COUNT];
+    sampleLevels(before);
+
+    Switch* slot = nullptr;
+    for (uint8_t i = 0; i < SWITCH_COUNT; i++) {
+        Switch& sw = switches[i];
+        if (sw.closed && ((sw.pinA == pinA && sw.pinB == pinB) || (sw.pinA == pinB && sw.pinB == pinA))) {
+            slot = &sw;
+            break;
+        }
+        if (!sw.closed && slot == nullptr) slot = &sw;
+    }
+    if (slot == nullptr) return;
+    slot->pinA = pinA;
+    slot->pinB = pinB;
+    slot->closed = closed;
+
+    notifyEdges(before);
+}
+
+uint8_t getOutput(uint8_t pin) {
+    return pin < PIN_COUNT ? pins[pin].level : LOW;
+}
+
+double getToneFrequency() {
+    for (uint8_t channel = 0; channel < LEDC_CHANNELS; channel++) {
+        if (toneFrequency[channel] > 0) return toneFrequency[channel];
+    }
+    return 0;
+}
+
+uint32_t getToneCount() {
+    return toneCount;
+}
+
+void setSerialOutput(FILE* out) {
+    serialOutput = out;
+}
+
+void feedSerial(const char* text) {
+    Untracked untracked;
+    serialInput += text;
+}
+
+}  // namespace HostHal
@@ -0,0 +1,121 @@
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+/**
+ * @file Arduino.h
+ * @brief Host version of the Arduino core API used by the firmware.
+ *
+ * Time comes from the virtual clock and GPIO, LEDC and Serial from the
+ * models of HostHal.h. Types keep their ESP32 widths where the firmware
+ * depends on them: millis() and micros() are 32-bit and wrap like on the
+ * device. Like the ESP32 core it pulls in the FreeRTOS task API and <time.h>.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <algorithm>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "WString.h"
+#include "Print.h"
+
+typedef uint8_t byte;
+typedef bool boolean;
+typedef uint16_t word;
+
+using std::max;
+using std::min;
+
+#define LOW 0x0
+#define HIGH 0x1
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define PULLUP 0x04
+#define INPUT_PULLUP 0x05
+#define PULLDOWN 0x08
+#define INPUT_PULLDOWN 0x09
+#define RISING 0x01
+#define FALLING 0x02
+#define CHANGE 0x03
+
+#define IRAM_ATTR
+#define PROGMEM
+#define PSTR(s) (s)
+#define F(s) (s)
+#define memcpy_P memcpy
+#define strcpy_P strcpy
+#define strlen_P strlen
+#define pgm_read_byte(addr) (*(const uint8_t*)(addr))
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+// Virtual clock
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void yield();
+
+// GPIO
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+inline int digitalPinToInterrupt(uint8_t pin) { return pin; }
+void attachInterruptArg(uint8_t pin, void (*handler)(void*), void* arg, int mode);
+void detachInterrupt(uint8_t pin);
+
+// LEDC (buzzer)
+double ledcSetup(uint8_t channel, double frequency, uint8_t resolutionBits);
+void ledcAttachPin(uint8_t pin, uint8_t channel);
+void ledcDetachPin(uint8_t pin);
+double ledcWriteTone(uint8_t channel, double frequency);
+void ledcWrite(uint8_t channel, uint32_t duty);
+
+// System
+typedef enum {
+    ESP_MAC_WIFI_STA,
+    ESP_MAC_WIFI_SOFTAP,
+    ESP_MAC_BT,
+    ESP_MAC_ETH
+} esp_mac_type_t;
+esp_err_t esp_read_mac(uint8_t* mac, esp_mac_type_t type);
+uint32_t esp_random();
+
+/**
+ * @brief Heap figures of the ESP32 core, fixed typical values on the host.
+ */
+class EspClass {
+public:
+    uint32_t getFreeHeap() { return 180000; }
+    uint32_t getMinFreeHeap() { return 150000; }
+    uint32_t getMaxAllocHeap() { return 110000; }
+};
+
+extern EspClass ESP;
+
+/**
+ * @brief Serial port: output goes to the stream set with
+ * HostHal::setSerialOutput(), input comes from HostHal::feedSerial().
+ */
+class HardwareSerial : public Print {
+public:
+    void begin(unsigned long baud) { (void)baud; }
+    void end() {}
+    int available();
+    int read();
+    int peek();
+    void flush();
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+    using Print::write;
+};
+
+extern HardwareSerial Serial;
+
+#endif // HOST_ARDUINO_H
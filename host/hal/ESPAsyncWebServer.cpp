@@ -0,0 +1,104 @@
+#include "ESPAsyncWebServer.h"
+
+// --------------------------------------------------
+// AsyncWebServerResponse
+// --------------------------------------------------
+
+AsyncWebServerResponse::AsyncWebServerResponse(int code, const char* contentType, const uint8_t* content,
+                                               size_t length)
+    : status(code), type(contentType != nullptr ? contentType : ""), headerCount(0) {
+    if (content != nullptr) {
+        this->content.concat(reinterpret_cast<const char*>(content), length);
+    }
+}
+
+void AsyncWebServerResponse::addHeader(const String& name, const String& value) {
+    if (headerCount >= MAX_HEADERS) return;
+    headerNames[headerCount] = name;
+    headerValues[headerCount] = value;
+    headerCount++;
+}
+
+const char* AsyncWebServerResponse::header(const char* name) const {
+    for (uint8_t i = 0; i < headerCount; i++) {
+        if (headerNames[i].equalsIgnoreCase(name)) return headerValues[i].c_str();
+    }
+    return nullptr;
+}
+
+// --------------------------------------------------
+// AsyncWebServerRequest
+// --------------------------------------------------
+
+AsyncWebServerRequest::AsyncWebServerRequest(WebRequestMethodComposite method, const char* url)
+    : requestMethod(method), requestUrl(url), paramCount(0), response(nullptr) {}
+
+AsyncWebServerRequest::~AsyncWebServerRequest() {
+    if (disconnectHandler) {
+        disconnectHandler();
+    }
+    delete response;
+}
+
+void AsyncWebServerRequest::addParam(const char* name, const char* value) {
+    if (paramCount >= MAX_PARAMS) return;
+    params[paramCount++] = AsyncWebParameter(name, value);
+}
+
+bool AsyncWebServerRequest::hasParam(const char* name) const {
+    for (uint8_t i = 0; i < paramCount; i++) {
+        if (params[i].name() == name) return true;
+    }
+    return false;
+}
+
+AsyncWebParameter* AsyncWebServerRequest::getParam(const char* name) {
+    for (uint8_t i = 0; i < paramCount; i++) {
+        if (params[i].name() == name) return &params[i];
+    }
+    return nullptr;
+}
+
+AsyncWebServerResponse* AsyncWebServerRequest::beginResponse(int code, const char* contentType,
+                                                             const String& content) {
+    return new AsyncWebServerResponse(code, contentType, reinterpret_cast<const uint8_t*>(content.c_str()),
+                                      content.length());
+}
+
+AsyncWebServerResponse* AsyncWebServerRequest::beginResponse_P(int code, const char* contentType,
+                                                               const uint8_t* content, size_t length) {
+    return new AsyncWebServerResponse(code, contentType, content, length);
+}
+
+void AsyncWebServerRequest::send(AsyncWebServerResponse* response) {
+    delete this->response;
+    this->response = response;
+}
+
+void AsyncWebServerRequest::send(int code, const char* contentType, const String& content) {
+    send(beginResponse(code, contentType, content));
+}
+
+// --------------------------------------------------
+// AsyncWebServer
+// --------------------------------------------------
+
+void AsyncWebServer::on(const char* uri, WebRequestMethodComposite method, ArRequestHandlerFunction handler) {
+    if (routeCount >= MAX_ROUTES) return;
+    routes[routeCount].uri = uri;
+    routes[routeCount].method = method;
+    routes[routeCount].handler = handler;
+    routeCount++;
+}
+
+bool AsyncWebServer::handle(AsyncWebServerRequest* request) {
+    for (uint8_t i = 0; i < routeCount; i++) {
+        const Route& route = routes[i];
+        if ((route.method & request->method()) && route.uri == request->url()) {
+            route.handler(request);
+            return true;
+        }
+    }
+    request->send(404, "text/plain", "Not found");
+    return false;
+}
@@ -0,0 +1,130 @@
+#ifndef HOST_ESPASYNCWEBSERVER_H
+#define HOST_ESPASYNCWEBSERVER_H
+/**
+ * @file ESPAsyncWebServer.h
+ * @brief Host version of the ESPAsyncWebServer API used by the REST routes.
+ *
+ * There is no socket: a test builds an AsyncWebServerRequest for a method
+ * and URL, hands it to AsyncWebServer::handle() and reads the response
+ * back. Deleting the request closes the connection and runs the
+ * onDisconnect() handler, like the client going away on the device.
+ */
+
+#include <functional>
+#include <Arduino.h>
+
+enum WebRequestMethod {
+    HTTP_GET = 0x01,
+    HTTP_POST = 0x02,
+    HTTP_DELETE = 0x04,
+    HTTP_PUT = 0x08,
+    HTTP_ANY = 0x7F
+};
+
+typedef uint8_t WebRequestMethodComposite;
+
+class AsyncWebServerRequest;
+
+typedef std::function<void(AsyncWebServerRequest* request)> ArRequestHandlerFunction;
+typedef std::function<void()> ArDisconnectHandler;
+
+class AsyncWebParameter {
+public:
+    AsyncWebParameter() {}
+    AsyncWebParameter(const char* name, const char* value) : paramName(name), paramValue(value) {}
+    const String& name() const { return paramName; }
+    const String& value() const { return paramValue; }
+
+private:
+    String paramName;
+    String paramValue;
+};
+
+/**
+ * @brief Response kept in memory: status, content type, body and headers.
+ */
+class AsyncWebServerResponse {
+public:
+    static const uint8_t MAX_HEADERS = 8;
+
+    AsyncWebServerResponse(int code, const char* contentType, const uint8_t* content, size_t length);
+
+    void addHeader(const String& name, const String& value);
+
+    int code() const { return status; }
+    const String& contentType() const { return type; }
+    const String& body() const { return content; }
+    const char* header(const char* name) const;   ///< nullptr when not set
+
+private:
+    int status;
+    String type;
+    String content;
+    String headerNames[MAX_HEADERS];
+    String headerValues[MAX_HEADERS];
+    uint8_t headerCount;
+};
+
+class AsyncWebServerRequest {
+public:
+    static const uint8_t MAX_PARAMS = 8;
+
+    AsyncWebServerRequest(WebRequestMethodComposite method, const char* url);
+    ~AsyncWebServerRequest();   ///< Closes the connection: runs the onDisconnect() handler
+
+    WebRequestMethodComposite method() const { return requestMethod; }
+    const String& url() const { return requestUrl; }
+
+    void addParam(const char* name, const char* value);   ///< Host only: a query parameter
+    bool hasParam(const char* name) const;
+    AsyncWebParameter* getParam(const char* name);
+
+    AsyncWebServerResponse* beginResponse(int code, const char* contentType, const String& content = String());
+    AsyncWebServerResponse* beginResponse_P(int code, const char* contentType, const uint8_t* content,
+                                            size_t length);
+    void send(AsyncWebServerResponse* response);
+    void send(int code, const char* contentType = "text/plain", const String& content = String());
+    void onDisconnect(ArDisconnectHandler handler) { disconnectHandler = handler; }
+
+    const AsyncWebServerResponse* getResponse() const { return response; }   ///< Host only, nullptr before send()
+
+private:
+    WebRequestMethodComposite requestMethod;
+    String requestUrl;
+    AsyncWebParameter params[MAX_PARAMS];
+    uint8_t paramCount;
+    AsyncWebServerResponse* response;
+    ArDisconnectHandler disconnectHandler;
+};
+
+class AsyncWebServer {
+public:
+    static const uint8_t MAX_ROUTES = 16;
+
+    explicit AsyncWebServer(uint16_t port) : port(port), routeCount(0) {}
+    void begin() {}
+    void end() {}
+
+    void on(const char* uri, WebRequestMethodComposite method, ArRequestHandlerFunction handler);
+
+    /**
+     * @brief Host only: runs the handler registered for the request's
+     * method and URL.
+     *
+     * @return false when no route matches; the request is answered with 404.
+     */
+    bool handle(AsyncWebServerRequest* request);
+
+private:
+    struct Route {
+        String uri;
+        WebRequestMethodComposite method;
+        ArRequestHandlerFunction handler;
+    };
+
+    uint16_t port;
+    Route routes[MAX_ROUTES];
+    uint8_t routeCount;
+};
+
+#endif // HOST_ESPASYNCWEBSERVER_H
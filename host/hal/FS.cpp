@@ -0,0 +1,237 @@
+#include "FS.h"
+#include "SPIFFS.h"
+#include "HostHal.h"
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <string>
+
+static const size_t SPIFFS_TOTAL_BYTES = 0x160000;   ///< Size of the spiffs partition of the default table
+
+static std::string root;
+
+fs::SPIFFSFS SPIFFS;
+
+/**
+ * @brief Directory holding the files; a fresh temporary one unless the
+ * simulator chose one, so every run starts from an empty file system.
+ */
+static const std::string& rootDir() {
+    if (root.empty()) {
+        char pattern[] = "/tmp/spiffs-XXXXXX";
+        const char* dir = mkdtemp(pattern);
+        root = dir != nullptr ? dir : ".";
+    }
+    return root;
+}
+
+/**
+ * @brief Host path of a SPIFFS path. SPIFFS is flat, a '/' in the name is
+ * part of the name, so it is flattened to keep one directory.
+ */
+static std::string hostPath(const char* path) {
+    std::string name = path != nullptr ? path : "";
+    if (!name.empty() && name[0] == '/') name.erase(0, 1);
+    for (char& c : name) {
+        if (c == '/') c = '%';
+    }
+    return rootDir() + "/" + name;
+}
+
+namespace fs {
+
+/**
+ * @brief Host file behind a File. stdio allocates the FILE buffer on the
+ * first read, write or seek; that heap use is the model's, so every stdio
+ * call runs Untracked.
+ */
+struct FileImpl {
+    FILE* file;
+    std::string path;
+    const char* name;
+
+    ~FileImpl() {
+        if (file != nullptr) fclose(file);
+    }
+};
+
+size_t File::write(uint8_t c) {
+    return write(&c, 1);
+}
+
+size_t File::write(const uint8_t* buffer, size_t size) {
+    if (!*this) return 0;
+    HostHal::Untracked untracked;
+    size_t written = fwrite(buffer, 1, size, impl->file);
+    HostHal::countFlashWrite(written);
+    HostHal::charge((uint32_t)written * HostHal::getCostModel().flashWriteUsPerByte);
+    return written;
+}
+
+int File::available() {
+    if (!*this) return 0;
+    return (int)(size() - position());
+}
+
+int File::read() {
+    if (!*this) return -1;
+    HostHal::Untracked untracked;
+    int c = fgetc(impl->file);
+    return c == EOF ? -1 : c;
+}
+
+int File::peek() {
+    if (!*this) return -1;
+    HostHal::Untracked untracked;
+    int c = fgetc(impl->file);
+    if (c == EOF) return -1;
+    ungetc(c, impl->file);
+    return c;
+}
+
+size_t File::read(uint8_t* buffer, size_t size) {
+    if (!*this) return 0;
+    HostHal::Untracked untracked;
+    return fread(buffer, 1, size, impl->file);
+}
+
+String File::readString() {
+    String text;
+    int c;
+    while ((c = read()) >= 0) {
+        text += (char)c;
+    }
+    return text;
+}
+
+void File::flush() {
+    HostHal::Untracked untracked;
+    if (*this) fflush(impl->file);
+}
+
+bool File::seek(uint32_t pos, SeekMode mode) {
+    if (!*this) return false;
+    HostHal::Untracked untracked;
+    int whence = mode == SeekCur ? SEEK_CUR : (mode == SeekEnd ? SEEK_END : SEEK_SET);
+    return fseek(impl->file, (long)pos, whence) == 0;
+}
+
+size_t File::position() const {
+    if (!*this) return 0;
+    long pos = ftell(impl->file);
+    return pos < 0 ? 0 : (size_t)pos;
+}
+
+size_t File::size() const {
+    if (!*this) return 0;
+    HostHal::Untracked untracked;
+    fflush(impl->file);
+    struct stat info;
+    return fstat(fileno(impl->file), &info) == 0 ? (size_t)info.st_size : 0;
+}
+
+void File::close() {
+    if (!impl) return;
+    HostHal::Untracked untracked;
+    HostHal::charge(HostHal::getCostModel().fileOpenUs);
+    impl.reset();
+}
+
+const char* File::path() const {
+    return impl ? impl->path.c_str() : nullptr;
+}
+
+const char* File::name() const {
+    return impl ? impl->name : nullptr;
+}
+
+File::operator bool() const {
+    return impl && impl->file != nullptr;
+}
+
+File FS::open(const char* path, const char* mode, bool create) {
+    (void)create;
+    if (path == nullptr || mode == nullptr) return File();
+    HostHal::Untracked untracked;
+    HostHal::charge(HostHal::getCostModel().fileOpenUs);
+    std::string hostMode = mode;
+    if (hostMode.find('b') == std::string::npos) hostMode += 'b';
+    FILE* file = fopen(hostPath(path).c_str(), hostMode.c_str());
+    if (file == nullptr) return File();
+
+    std::shared_ptr<FileImpl> impl = std::make_shared<FileImpl>();
+    impl->file = file;
+    impl->path = path;
+    size_t slash = impl->path.rfind('/');
+    impl->name = impl->path.c_str() + (slash == std::string::npos ? 0 : slash + 1);
+    return File(impl);
+}
+
+bool FS::exists(const char* path) {
+    HostHal::Untracked untracked;
+    struct stat info;
+    return path != nullptr && stat(hostPath(path).c_str(), &info) == 0;
+}
+
+bool FS::remove(const char* path) {
+    HostHal::Untracked untracked;
+    return path != nullptr && unlink(hostPath(path).c_str()) == 0;
+}
+
+bool FS::rename(const char* pathFrom, const char* pathTo) {
+    if (pathFrom == nullptr || pathTo == nullptr) return false;
+    HostHal::Untracked untracked;
+    return ::rename(hostPath(pathFrom).c_str(), hostPath(pathTo).c_str()) == 0;
+}
+
+bool SPIFFSFS::begin(bool formatOnFail, const char* basePath, uint8_t maxOpenFiles, const char* partitionLabel) {
+    (void)formatOnFail;
+    (void)basePath;
+    (void)maxOpenFiles;
+    (void)partitionLabel;
+    HostHal::Untracked untracked;
+    struct stat info;
+    return stat(rootDir().c_str(), &info) == 0 && S_ISDIR(info.st_mode);
+}
+
+bool SPIFFSFS::format() {
+    HostHal::Untracked untracked;
+    DIR* dir = opendir(rootDir().c_str());
+    if (dir == nullptr) return false;
+    while (struct dirent* entry = readdir(dir)) {
+        if (entry->d_name[0] == '.') continue;
+        unlink((rootDir() + "/" + entry->d_name).c_str());
+    }
+    closedir(dir);
+    return true;
+}
+
+size_t SPIFFSFS::totalBytes() {
+    return SPIFFS_TOTAL_BYTES;
+}
+
+size_t SPIFFSFS::usedBytes() {
+    HostHal::Untracked untracked;
+    size_t used = 0;
+    DIR* dir = opendir(rootDir().c_str());
+    if (dir == nullptr) return 0;
+    while (struct dirent* entry = readdir(dir)) {
+        struct stat info;
+        if (entry->d_name[0] != '.' && stat((rootDir() + "/" + entry->d_name).c_str(), &info) == 0) {
+            used += (size_t)info.st_size;
+        }
+    }
+    closedir(dir);
+    return used;
+}
+
+}  // namespace fs
+
+namespace HostHal {
+
+void setFilesystemRoot(const char* dir) {
+    Untracked untracked;
+    root = dir != nullptr ? dir : "";
+}
+
+}  // namespace HostHal
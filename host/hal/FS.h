@@ -0,0 +1,83 @@
+#ifndef HOST_FS_H
+#define HOST_FS_H
+/**
+ * @file FS.h
+ * @brief Host version of the Arduino file system API.
+ *
+ * Files are plain files of a host directory (HostHal::setFilesystemRoot());
+ * a File is a shared handle like on the ESP32, copies refer to the same
+ * open file.
+ */
+
+#include <Arduino.h>
+#include <memory>
+
+#define FILE_READ "r"
+#define FILE_WRITE "w"
+#define FILE_APPEND "a"
+
+namespace fs {
+
+enum SeekMode {
+    SeekSet = 0,
+    SeekCur = 1,
+    SeekEnd = 2
+};
+
+struct FileImpl;
+
+class File : public Print {
+public:
+    File() {}
+    explicit File(std::shared_ptr<FileImpl> impl) : impl(impl) {}
+
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+    using Print::write;
+    int available();
+    int read();
+    int peek();
+    size_t read(uint8_t* buffer, size_t size);
+    size_t readBytes(char* buffer, size_t length) { return read((uint8_t*)buffer, length); }
+    String readString();
+    void flush();
+    bool seek(uint32_t pos, SeekMode mode = SeekSet);
+    size_t position() const;
+    size_t size() const;
+    void close();
+    const char* path() const;
+    const char* name() const;
+    bool isDirectory() const { return false; }
+    File openNextFile(const char* mode = FILE_READ) { (void)mode; return File(); }
+    operator bool() const;
+
+private:
+    std::shared_ptr<FileImpl> impl;
+};
+
+class FS {
+public:
+    explicit FS(const char* mountPoint = "") { (void)mountPoint; }
+
+    File open(const char* path, const char* mode = FILE_READ, bool create = false);
+    File open(const String& path, const char* mode = FILE_READ, bool create = false) {
+        return open(path.c_str(), mode, create);
+    }
+    bool exists(const char* path);
+    bool exists(const String& path) { return exists(path.c_str()); }
+    bool remove(const char* path);
+    bool remove(const String& path) { return remove(path.c_str()); }
+    bool rename(const char* pathFrom, const char* pathTo);
+    bool rename(const String& pathFrom, const String& pathTo) { return rename(pathFrom.c_str(), pathTo.c_str()); }
+};
+
+}  // namespace fs
+
+using fs::File;
+using fs::FS;
+using fs::SeekCur;
+using fs::SeekEnd;
+using fs::SeekMode;
+using fs::SeekSet;
+
+#endif // HOST_FS_H
@@ -0,0 +1,282 @@
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/event_groups.h"
+#include "HostHal.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Queue, or semaphore when itemSize is 0 (count of free tokens in
+ * `count`, like FreeRTOS does).
+ */
+struct QueueDefinition {
+    uint8_t* items;
+    UBaseType_t length;
+    UBaseType_t itemSize;
+    UBaseType_t head;          ///< Index of the oldest item
+    UBaseType_t count;
+    bool recursive;
+    UBaseType_t depth;         ///< Nested takes of a recursive mutex
+};
+
+struct EventGroupDef_t {
+    EventBits_t bits;
+};
+
+/**
+ * @brief Advances the clock until `ready` holds or the wait is over.
+ *
+ * On the single simulator thread only an esp_timer callback can change a
+ * queue while the caller waits, so the clock jumps from one timer deadline
+ * to the next. portMAX_DELAY does not wait at all: nothing else would
+ * ever run.
+ */
+template <typename Ready>
+static bool waitUntil(TickType_t ticks, Ready ready) {
+    if (ready()) return true;
+    if (ticks == 0 || ticks == portMAX_DELAY) return false;
+
+    int64_t endUs = HostHal::now() + (int64_t)ticks * portTICK_PERIOD_MS * 1000;
+    while (HostHal::now() < endUs) {
+        int64_t next = HostHal::nextDeadline();
+        HostHal::advanceTo(next < endUs ? next : endUs);
+        if (ready()) return true;
+    }
+    return false;
+}
+
+static QueueHandle_t createQueue(UBaseType_t length, UBaseType_t itemSize) {
+    // Both blocks are counted by the heap hooks, like the kernel's queue allocation
+    QueueHandle_t queue = (QueueHandle_t)calloc(1, sizeof(QueueDefinition));
+    if (queue == nullptr) return nullptr;
+    if (itemSize > 0) {
+        queue->items = (uint8_t*)malloc((size_t)length * itemSize);
+        if (queue->items == nullptr) {
+            free(queue);
+            return nullptr;
+        }
+    }
+    queue->length = length;
+    queue->itemSize = itemSize;
+    return queue;
+}
+
+// --------------------------------------------------
+// Tasks
+// --------------------------------------------------
+
+BaseType_t xTaskCreate(TaskFunction_t entry, const char* name, uint32_t stackDepth, void* param,
+                       UBaseType_t priority, TaskHandle_t* created) {
+    return xTaskCreatePinnedToCore(entry, name, stackDepth, param, priority, created, tskNO_AFFINITY);
+}
+
+/**
+ * @brief Never creates the task: the host has one thread, the caller falls
+ * back to doing the work inline.
+ */
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t entry, const char* name, uint32_t stackDepth, void* param,
+                                   UBaseType_t priority, TaskHandle_t* created, BaseType_t core) {
+    (void)entry;
+    (void)name;
+    (void)stackDepth;
+    (void)param;
+    (void)priority;
+    (void)core;
+    if (created != nullptr) *created = nullptr;
+    return errCOULD_NOT_ALLOCATE_REQUIRED_MEMORY;
+}
+
+void vTaskDelete(TaskHandle_t task) {
+    (void)task;
+}
+
+void vTaskDelay(TickType_t ticks) {
+    HostHal::advance((int64_t)ticks * portTICK_PERIOD_MS * 1000);
+}
+
+TickType_t xTaskGetTickCount() {
+    return (TickType_t)(HostHal::now() / 1000 / portTICK_PERIOD_MS);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle() {
+    return nullptr;
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task) {
+    (void)task;
+    return 0;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+    (void)task;
+    return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* higherPriorityTaskWoken) {
+    (void)task;
+    if (higherPriorityTaskWoken != nullptr) *higherPriorityTaskWoken = pdFALSE;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearCountOnExit, TickType_t ticksToWait) {
+    (void)clearCountOnExit;
+    waitUntil(ticksToWait, []() { return false; });
+    return 0;
+}
+
+// --------------------------------------------------
+// Queues
+// --------------------------------------------------
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize) {
+    if (length == 0 || itemSize == 0) return nullptr;
+    return createQueue(length, itemSize);
+}
+
+void vQueueDelete(QueueHandle_t queue) {
+    if (queue == nullptr) return;
+    free(queue->items);
+    free(queue);
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void* item, TickType_t ticksToWait) {
+    return xQueueSendToBack(queue, item, ticksToWait);
+}
+
+BaseType_t xQueueSendToBack(QueueHandle_t queue, const void* item, TickType_t ticksToWait) {
+    if (!waitUntil(ticksToWait, [queue]() { return queue->count < queue->length; })) {
+        return errQUEUE_FULL;
+    }
+    UBaseType_t tail = (queue->head + queue->count) % queue->length;
+    memcpy(queue->items + (size_t)tail * queue->itemSize, item, queue->itemSize);
+    queue->count++;
+    return pdPASS;
+}
+
+BaseType_t xQueueSendFromISR(QueueHandle_t queue, const void* item, BaseType_t* higherPriorityTaskWoken) {
+    if (higherPriorityTaskWoken != nullptr) *higherPriorityTaskWoken = pdFALSE;
+    return xQueueSendToBack(queue, item, 0);
+}
+
+/**
+ * @brief Replaces the item of a one-item mailbox, or queues it if empty.
+ */
+BaseType_t xQueueOverwrite(QueueHandle_t queue, const void* item) {
+    if (queue->count > 0) {
+        memcpy(queue->items + (size_t)queue->head * queue->itemSize, item, queue->itemSize);
+        return pdPASS;
+    }
+    return xQueueSendToBack(queue, item, 0);
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void* item, TickType_t ticksToWait) {
+    if (!waitUntil(ticksToWait, [queue]() { return queue->count > 0; })) {
+        return pdFALSE;
+    }
+    memcpy(item, queue->items + (size_t)queue->head * queue->itemSize, queue->itemSize);
+    queue->head = (queue->head + 1) % queue->length;
+    queue->count--;
+    return pdTRUE;
+}
+
+BaseType_t xQueueReset(QueueHandle_t queue) {
+    queue->head = 0;
+    queue->count = 0;
+    return pdPASS;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue) {
+    return queue->count;
+}
+
+// --------------------------------------------------
+// Semaphores
+// --------------------------------------------------
+
+SemaphoreHandle_t xSemaphoreCreateMutex() {
+    return xSemaphoreCreateCounting(1, 1);
+}
+
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex() {
+    SemaphoreHandle_t mutex = xSemaphoreCreateCounting(1, 1);
+    if (mutex != nullptr) mutex->recursive = true;
+    return mutex;
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary() {
+    return xSemaphoreCreateCounting(1, 0);
+}
+
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t maxCount, UBaseType_t initialCount) {
+    SemaphoreHandle_t semaphore = createQueue(maxCount, 0);
+    if (semaphore != nullptr) semaphore->count = initialCount;
+    return semaphore;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticksToWait) {
+    if (!waitUntil(ticksToWait, [semaphore]() { return semaphore->count > 0; })) {
+        return pdFALSE;
+    }
+    semaphore->count--;
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore) {
+    if (semaphore->count >= semaphore->length) return pdFALSE;
+    semaphore->count++;
+    return pdTRUE;
+}
+
+/**
+ * @brief Recursive take: there is only one task, so it always owns the mutex.
+ */
+BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t mutex, TickType_t ticksToWait) {
+    (void)ticksToWait;
+    if (mutex->depth++ == 0) mutex->count = 0;
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t mutex) {
+    if (mutex->depth == 0) return pdFALSE;
+    if (--mutex->depth == 0) mutex->count = 1;
+    return pdTRUE;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t semaphore) {
+    vQueueDelete(semaphore);
+}
+
+// --------------------------------------------------
+// Event groups
+// --------------------------------------------------
+
+EventGroupHandle_t xEventGroupCreate() {
+    return (EventGroupHandle_t)calloc(1, sizeof(EventGroupDef_t));
+}
+
+EventBits_t xEventGroupSetBits(EventGroupHandle_t group, EventBits_t bits) {
+    group->bits |= bits;
+    return group->bits;
+}
+
+EventBits_t xEventGroupClearBits(EventGroupHandle_t group, EventBits_t bits) {
+    EventBits_t before = group->bits;
+    group->bits &= ~bits;
+    return before;
+}
+
+EventBits_t xEventGroupGetBits(EventGroupHandle_t group) {
+    return group->bits;
+}
+
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t group, EventBits_t bits, BaseType_t clearOnExit,
+                                BaseType_t waitForAll, TickType_t ticksToWait) {
+    auto ready = [group, bits, waitForAll]() {
+        return waitForAll ? (group->bits & bits) == bits : (group->bits & bits) != 0;
+    };
+    bool met = waitUntil(ticksToWait, ready);
+    EventBits_t value = group->bits;
+    if (met && clearOnExit) group->bits &= ~bits;
+    return value;
+}
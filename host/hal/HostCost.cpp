@@ -0,0 +1,154 @@
+#include <new>
+#include <stdlib.h>
+#include "HostHal.h"
+
+static HostHal::CostModel costModel = {
+    1000,       // rfidFrameUs
+    25000,      // rfidTimeoutUs
+    2000,       // rfidAuthUs
+    1500,       // rfidReadUs
+    6000,       // rfidWriteUs
+    50000,      // rfidInitUs
+    3,          // flashWriteUsPerByte
+    45000,      // flashEraseUs
+    1000,       // nvsWriteUs
+    2000        // fileOpenUs
+};
+
+static HostHal::Counters counters;
+static uint32_t untrackedDepth = 0;
+
+// --------------------------------------------------
+// Heap: malloc(), calloc(), realloc() and operator new of the whole program
+// go through here. glibc lets a program replace the C allocator and still
+// reach its own through the __libc_* entry points; on another C library
+// only operator new is counted.
+// --------------------------------------------------
+
+#if defined(__GLIBC__)
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* block, size_t size);
+
+void* malloc(size_t size) {
+    void* block = __libc_malloc(size);
+    if (block != nullptr) HostHal::countAllocation(size);
+    return block;
+}
+
+void* calloc(size_t count, size_t size) {
+    void* block = __libc_calloc(count, size);
+    if (block != nullptr) HostHal::countAllocation(count * size);
+    return block;
+}
+
+void* realloc(void* block, size_t size) {
+    void* grown = __libc_realloc(block, size);
+    if (grown != nullptr && size > 0) HostHal::countAllocation(size);
+    return grown;
+}
+}
+
+static void* allocate(size_t size) {
+    return malloc(size > 0 ? size : 1);
+}
+#else
+static void* allocate(size_t size) {
+    void* block = malloc(size > 0 ? size : 1);
+    if (block != nullptr) HostHal::countAllocation(size);
+    return block;
+}
+#endif
+
+void* operator new(size_t size) {
+    void* block = allocate(size);
+    if (block == nullptr) throw std::bad_alloc();
+    return block;
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t& tag) noexcept {
+    return operator new(size, tag);
+}
+
+void operator delete(void* block) noexcept {
+    free(block);
+}
+
+void operator delete[](void* block) noexcept {
+    free(block);
+}
+
+void operator delete(void* block, size_t) noexcept {
+    free(block);
+}
+
+void operator delete[](void* block, size_t) noexcept {
+    free(block);
+}
+
+namespace HostHal {
+
+Untracked::Untracked() {
+    untrackedDepth++;
+}
+
+Untracked::~Untracked() {
+    untrackedDepth--;
+}
+
+const CostModel& getCostModel() {
+    return costModel;
+}
+
+void setCostModel(const CostModel& model) {
+    costModel = model;
+}
+
+void charge(uint32_t us) {
+    advance(us);
+}
+
+const Counters& getCounters() {
+    return counters;
+}
+
+void resetCounters() {
+    counters = Counters();
+}
+
+void countAllocation(size_t bytes) {
+    if (untrackedDepth > 0) return;
+    counters.heapAllocations++;
+    counters.heapBytes += bytes;
+}
+
+void countFlashWrite(size_t bytes) {
+    counters.flashBytesWritten += bytes;
+}
+
+void countFlashErase(uint32_t sectors) {
+    counters.flashErases += sectors;
+}
+
+void countNvsWrite() {
+    counters.nvsWrites++;
+}
+
+void countRfidCommand() {
+    counters.rfidCommands++;
+}
+
+void countLcdBytes(uint32_t bytes) {
+    counters.lcdBusBytes += bytes;
+}
+
+}  // namespace HostHal
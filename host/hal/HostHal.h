@@ -0,0 +1,122 @@
+#ifndef HOST_HAL_H
+#define HOST_HAL_H
+/**
+ * @file HostHal.h
+ * @brief Controls of the host HAL, used by the simulator to drive the firmware.
+ *
+ * The firmware modules compile unchanged against the headers of host/hal.
+ * They run on one thread with a virtual clock:
+ * - millis(), micros() and esp_timer_get_time() read the clock; it only
+ *   moves when the firmware waits (delay(), vTaskDelay(), a queue receive
+ *   with a timeout) or when the simulator advances it;
+ * - esp_timer callbacks run when the clock passes their deadline;
+ * - GPIO inputs follow switches the simulator closes between two pins,
+ *   which is how the keypad matrix is pressed;
+ * - SPIFFS is a directory of the host, Preferences and the raw partitions
+ *   live in RAM, the card reader holds the virtual cards of MFRC522.h.
+ *
+ * A run is fully deterministic: the same script gives the same output.
+ *
+ * The modeled hardware takes time: card reader commands, flash writes and
+ * erases and LCD bus bytes advance the clock by the CostModel figures, so
+ * virtual time approximates the latency seen on the device. Counters of
+ * heap allocations and flash traffic let benchmarks report cost per
+ * transaction.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+
+namespace HostHal {
+
+/**
+ * @brief Time charged to the virtual clock by the modeled hardware, in µs.
+ *
+ * Defaults follow the MFRC522 library (25 ms receive timeout, 50 ms soft
+ * reset wait), MIFARE Classic timings at 106 kbit/s and a typical SPI NOR
+ * flash (about 3 µs per programmed byte, 45 ms per 4 KB sector erase).
+ */
+struct CostModel {
+    uint32_t rfidFrameUs;           ///< REQA, select or halt answered by the card
+    uint32_t rfidTimeoutUs;         ///< Command left unanswered (no card, halted card)
+    uint32_t rfidAuthUs;            ///< Three-pass authentication
+    uint32_t rfidReadUs;            ///< 16-byte block read
+    uint32_t rfidWriteUs;           ///< Two-phase block write, card EEPROM programming included
+    uint32_t rfidInitUs;            ///< PCD_Init() soft reset
+    uint32_t flashWriteUsPerByte;   ///< Programming time per byte
+    uint32_t flashEraseUs;          ///< One 4 KB sector
+    uint32_t nvsWriteUs;            ///< Lookup and entry bookkeeping of an NVS set, on top of the bytes
+    uint32_t fileOpenUs;            ///< SPIFFS open or close, page index scan
+};
+
+/**
+ * @brief Work done by the firmware since boot, see resetCounters().
+ *
+ * Heap figures count operator new, Arduino String buffers and, with glibc,
+ * every malloc(), calloc() and realloc() of the program, libraries like
+ * ArduinoJson included; allocations the host models make for their own
+ * bookkeeping are left out. Flash bytes are payload bytes programmed into
+ * NVS, raw partitions and SPIFFS files.
+ */
+struct Counters {
+    uint64_t heapAllocations;       ///< new, new[], malloc, calloc, realloc and String (re)allocations
+    uint64_t heapBytes;             ///< Bytes requested by them
+    uint64_t flashBytesWritten;
+    uint32_t flashErases;           ///< 4 KB sectors erased
+    uint32_t nvsWrites;             ///< NVS sets that changed the stored value
+    uint32_t rfidCommands;          ///< Commands exchanged with the card reader
+    uint32_t lcdBusBytes;           ///< Bytes sent to the display
+};
+
+/**
+ * @brief Keeps heap allocations of its scope out of the counters; used by
+ * the host models around their own containers.
+ */
+class Untracked {
+public:
+    Untracked();
+    ~Untracked();
+};
+
+// Virtual clock
+int64_t now();                          ///< Microseconds since boot
+void advance(int64_t us);               ///< Move the clock forward, running the due timer callbacks
+void advanceTo(int64_t us);             ///< Same, up to an absolute time
+int64_t nextDeadline();                 ///< Deadline of the next armed timer, INT64_MAX if none
+
+// GPIO
+void setSwitch(uint8_t pinA, uint8_t pinB, bool closed);  ///< Connect two pins, like a key of the matrix
+uint8_t getOutput(uint8_t pin);         ///< Level last written to an output pin
+double getToneFrequency();              ///< Frequency of the LEDC buzzer channel, 0 when silent
+uint32_t getToneCount();                ///< Tones started since boot
+
+// Wi-Fi
+void setWiFi(bool connected, int8_t rssi = -60);  ///< Station state seen by WiFi.status()
+void setAccessPoint(bool active);       ///< Setup access point state seen by WiFiManager::isApActive()
+bool isAccessPointActive();
+void setEpoch(uint32_t epoch);          ///< UTC time returned by NTP at the current virtual time
+
+// Serial console
+void setSerialOutput(FILE* out);        ///< Where the firmware's Serial output goes, nullptr to drop it
+void feedSerial(const char* text);      ///< Characters for Serial.read()
+
+// Storage
+void setFilesystemRoot(const char* dir); ///< Host directory holding the SPIFFS files
+void failPartitionWrites(uint32_t count); ///< The next count raw partition writes fail, like a worn sector
+
+// Cost model and counters
+const CostModel& getCostModel();
+void setCostModel(const CostModel& model);
+void charge(uint32_t us);               ///< Time spent by the modeled hardware
+const Counters& getCounters();
+void resetCounters();
+void countAllocation(size_t bytes);     ///< Record a heap allocation of the firmware
+void countFlashWrite(size_t bytes);
+void countFlashErase(uint32_t sectors);
+void countNvsWrite();
+void countRfidCommand();
+void countLcdBytes(uint32_t bytes);
+
+}  // namespace HostHal
+
+#endif // HOST_HAL_H
@@ -0,0 +1,280 @@
+#include "MFRC522.h"
+#include "HostHal.h"
+
+SPIClass SPI;
+
+/// Access bits of a card as shipped (transport configuration)
+static const byte TRANSPORT_ACCESS[4] = {0xFF, 0x07, 0x80, 0x69};
+
+/**
+ * @brief One command exchanged with the card: counted, and its time charged.
+ */
+static void exchange(uint32_t us) {
+    HostHal::countRfidCommand();
+    HostHal::charge(us);
+}
+
+static int hexDigit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// --------------------------------------------------
+// VirtualCard
+// --------------------------------------------------
+
+/**
+ * @brief A blank 1K card: zeroed data, transport keys FF..FF in every trailer.
+ */
+VirtualCard::VirtualCard() : uidSize(4), sak(0x08) {
+    static const byte defaultUid[4] = {0x01, 0x02, 0x03, 0x04};
+    static const byte transportKey[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+    memset(uid, 0, sizeof(uid));
+    memcpy(uid, defaultUid, sizeof(defaultUid));
+    memset(blocks, 0, sizeof(blocks));
+    for (uint16_t sector = 0; sector < 40; sector++) {
+        setKeys((byte)sector, transportKey, transportKey);
+    }
+}
+
+bool VirtualCard::parseUid(const char* text) {
+    byte parsed[10];
+    byte size = 0;
+    while (*text != '\0') {
+        if (*text == ':') {
+            text++;
+            continue;
+        }
+        int high = hexDigit(text[0]);
+        int low = high >= 0 ? hexDigit(text[1]) : -1;
+        if (low < 0 || size == sizeof(parsed)) return false;
+        parsed[size++] = (byte)(high << 4 | low);
+        text += 2;
+    }
+    if (size != 4 && size != 7 && size != 10) return false;
+    memcpy(uid, parsed, size);
+    uidSize = size;
+    return true;
+}
+
+/**
+ * @brief Writes the sector trailer: key A, transport access bits, key B.
+ */
+void VirtualCard::setKeys(byte sector, const byte* keyA, const byte* keyB) {
+    uint16_t trailer = sector < 32 ? sector * 4 + 3 : 128 + (sector - 32) * 16 + 15;
+    if (trailer >= BLOCKS) return;
+    memcpy(blocks[trailer], keyA, 6);
+    memcpy(blocks[trailer] + 6, TRANSPORT_ACCESS, 4);
+    memcpy(blocks[trailer] + 10, keyB, 6);
+}
+
+uint16_t VirtualCard::blockCount() const {
+    switch (sak) {
+        case 0x09: return 20;     // Mini: 5 sectors
+        case 0x18: return 256;    // 4K
+        case 0x00: return 16;     // Ultralight: 64 bytes
+        default:   return 64;     // 1K
+    }
+}
+
+// --------------------------------------------------
+// Reader
+// --------------------------------------------------
+
+MFRC522::MFRC522(byte chipSelectPin, byte resetPowerDownPin)
+    : card(nullptr), state(CARD_IDLE), authSector(-1) {
+    (void)chipSelectPin;
+    (void)resetPowerDownPin;
+    memset(&uid, 0, sizeof(uid));
+}
+
+uint8_t MFRC522::sectorOf(byte blockAddr) {
+    return blockAddr < 128 ? blockAddr / 4 : 32 + (blockAddr - 128) / 16;
+}
+
+byte MFRC522::trailerOf(byte blockAddr) {
+    return blockAddr < 128 ? (blockAddr | 0x03) : (blockAddr | 0x0F);
+}
+
+void MFRC522::PCD_Init() {
+    HostHal::charge(HostHal::getCostModel().rfidInitUs);
+    state = CARD_IDLE;
+    authSector = -1;
+}
+
+bool MFRC522::PICC_IsNewCardPresent() {
+    const HostHal::CostModel& cost = HostHal::getCostModel();
+    if (card == nullptr || state == CARD_HALT) {
+        exchange(cost.rfidTimeoutUs);
+        return false;
+    }
+    if (state == CARD_ACTIVE) {
+        // Not a command of the ACTIVE state: the card resets to IDLE silently
+        state = CARD_IDLE;
+        authSector = -1;
+        exchange(cost.rfidTimeoutUs);
+        return false;
+    }
+    state = CARD_READY;
+    exchange(cost.rfidFrameUs);
+    return true;
+}
+
+/**
+ * @brief Anticollision and select, one cascade level per 4 UID bytes.
+ */
+bool MFRC522::PICC_ReadCardSerial() {
+    const HostHal::CostModel& cost = HostHal::getCostModel();
+    if (card == nullptr || state != CARD_READY) {
+        exchange(cost.rfidTimeoutUs);
+        return false;
+    }
+    uint8_t levels = card->uidSize == 4 ? 1 : (card->uidSize == 7 ? 2 : 3);
+    for (uint8_t level = 0; level < levels; level++) {
+        exchange(2 * cost.rfidFrameUs);
+    }
+    uid.size = card->uidSize;
+    memcpy(uid.uidByte, card->uid, sizeof(uid.uidByte));
+    uid.sak = card->sak;
+    state = CARD_ACTIVE;
+    authSector = -1;
+    return true;
+}
+
+MFRC522::StatusCode MFRC522::PICC_HaltA() {
+    // The library waits for the answer that a halting card never sends
+    exchange(HostHal::getCostModel().rfidTimeoutUs);
+    if (card != nullptr && state == CARD_ACTIVE) state = CARD_HALT;
+    authSector = -1;
+    // A halted card does not acknowledge: the library reports a timeout as success
+    return STATUS_OK;
+}
+
+MFRC522::StatusCode MFRC522::PCD_Authenticate(byte command, byte blockAddr, MIFARE_Key* key, Uid* target) {
+    const HostHal::CostModel& cost = HostHal::getCostModel();
+    if (card == nullptr || state != CARD_ACTIVE || target == nullptr || key == nullptr ||
+        target->size != card->uidSize || memcmp(target->uidByte, card->uid, card->uidSize) != 0 ||
+        blockAddr >= card->blockCount()) {
+        exchange(cost.rfidTimeoutUs);
+        return STATUS_TIMEOUT;
+    }
+
+    const byte* trailer = card->blocks[trailerOf(blockAddr)];
+    const byte* expected = command == PICC_CMD_MF_AUTH_KEY_B ? trailer + 10 : trailer;
+    if (memcmp(expected, key->keyByte, 6) != 0) {
+        state = CARD_IDLE;
+        authSector = -1;
+        exchange(cost.rfidTimeoutUs);
+        return STATUS_TIMEOUT;
+    }
+    exchange(cost.rfidAuthUs);
+    authSector = sectorOf(blockAddr);
+    return STATUS_OK;
+}
+
+void MFRC522::PCD_StopCrypto1() {
+    authSector = -1;
+}
+
+/**
+ * @brief Reads 16 bytes plus the 2 CRC bytes, like the library.
+ *
+ * Key A of a trailer reads as zeros; the access bits are not enforced.
+ */
+MFRC522::StatusCode MFRC522::MIFARE_Read(byte blockAddr, byte* buffer, byte* bufferSize) {
+    if (buffer == nullptr || bufferSize == nullptr || *bufferSize < 18) return STATUS_NO_ROOM;
+    const HostHal::CostModel& cost = HostHal::getCostModel();
+    if (card == nullptr || state != CARD_ACTIVE) {
+        exchange(cost.rfidTimeoutUs);
+        return STATUS_TIMEOUT;
+    }
+    exchange(cost.rfidReadUs);
+
+    if (card->sak == 0x00) {
+        // Ultralight: four 4-byte pages from blockAddr, no authentication
+        if ((uint16_t)blockAddr * 4 + 16 > (uint16_t)card->blockCount() * 16) return STATUS_MIFARE_NACK;
+        memcpy(buffer, &card->blocks[0][0] + blockAddr * 4, 16);
+    } else {
+        if (blockAddr >= card->blockCount() || authSector != sectorOf(blockAddr)) return STATUS_MIFARE_NACK;
+        memcpy(buffer, card->blocks[blockAddr], 16);
+        if (trailerOf(blockAddr) == blockAddr) memset(buffer, 0, 6);
+    }
+    buffer[16] = 0;
+    buffer[17] = 0;
+    *bufferSize = 18;
+    return STATUS_OK;
+}
+
+MFRC522::StatusCode MFRC522::MIFARE_Write(byte blockAddr, byte* buffer, byte bufferSize) {
+    if (buffer == nullptr || bufferSize < 16) return STATUS_INVALID;
+    const HostHal::CostModel& cost = HostHal::getCostModel();
+    if (card == nullptr || state != CARD_ACTIVE) {
+        exchange(cost.rfidTimeoutUs);
+        return STATUS_TIMEOUT;
+    }
+    exchange(cost.rfidWriteUs);
+    if (card->sak == 0x00 || blockAddr >= card->blockCount() || authSector != sectorOf(blockAddr)) {
+        return STATUS_MIFARE_NACK;
+    }
+    // Block 0 holds the manufacturer data and is read-only on genuine cards
+    if (blockAddr == 0) return STATUS_MIFARE_NACK;
+    memcpy(card->blocks[blockAddr], buffer, 16);
+    return STATUS_OK;
+}
+
+MFRC522::StatusCode MFRC522::MIFARE_Ultralight_Write(byte page, byte* buffer, byte bufferSize) {
+    if (buffer == nullptr || bufferSize < 4) return STATUS_INVALID;
+    const HostHal::CostModel& cost = HostHal::getCostModel();
+    if (card == nullptr || state != CARD_ACTIVE) {
+        exchange(cost.rfidTimeoutUs);
+        return STATUS_TIMEOUT;
+    }
+    exchange(cost.rfidWriteUs);
+    if (card->sak != 0x00 || page < 4 || (uint16_t)page * 4 + 4 > (uint16_t)card->blockCount() * 16) {
+        return STATUS_MIFARE_NACK;
+    }
+    memcpy(&card->blocks[0][0] + page * 4, buffer, 4);
+    return STATUS_OK;
+}
+
+MFRC522::PICC_Type MFRC522::PICC_GetType(byte sak) {
+    switch (sak & 0x7F) {
+        case 0x04: return PICC_TYPE_NOT_COMPLETE;
+        case 0x09: return PICC_TYPE_MIFARE_MINI;
+        case 0x08: return PICC_TYPE_MIFARE_1K;
+        case 0x18: return PICC_TYPE_MIFARE_4K;
+        case 0x00: return PICC_TYPE_MIFARE_UL;
+        case 0x10:
+        case 0x11: return PICC_TYPE_MIFARE_PLUS;
+        case 0x01: return PICC_TYPE_TNP3XXX;
+        case 0x20: return PICC_TYPE_ISO_14443_4;
+        case 0x40: return PICC_TYPE_ISO_18092;
+        default:   return PICC_TYPE_UNKNOWN;
+    }
+}
+
+const char* MFRC522::GetStatusCodeName(StatusCode code) {
+    switch (code) {
+        case STATUS_OK:             return "Success.";
+        case STATUS_ERROR:          return "Error in communication.";
+        case STATUS_COLLISION:      return "Collision detected.";
+        case STATUS_TIMEOUT:        return "Timeout in communication.";
+        case STATUS_NO_ROOM:        return "A buffer is not big enough.";
+        case STATUS_INTERNAL_ERROR: return "Internal error in the code. Should not happen.";
+        case STATUS_INVALID:        return "Invalid argument.";
+        case STATUS_CRC_WRONG:      return "The CRC_A does not match.";
+        case STATUS_MIFARE_NACK:    return "A MIFARE PICC responded with NAK.";
+        default:                    return "Unknown error";
+    }
+}
+
+/**
+ * @brief A card entering the field starts IDLE, like a freshly powered card.
+ */
+void MFRC522::placeCard(VirtualCard* newCard) {
+    card = newCard;
+    state = CARD_IDLE;
+    authSector = -1;
+}
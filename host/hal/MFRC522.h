@@ -0,0 +1,122 @@
+#ifndef HOST_MFRC522_H
+#define HOST_MFRC522_H
+/**
+ * @file MFRC522.h
+ * @brief Host version of the MFRC522 reader, with virtual cards in its field.
+ *
+ * Same API subset as the miguelbalboa library. The card follows the
+ * ISO 14443-3 states the firmware depends on:
+ * - PICC_IsNewCardPresent() sends REQA: only an IDLE card answers; an ACTIVE
+ *   card drops back to IDLE without answering, a HALTed card stays silent;
+ * - PICC_ReadCardSerial() selects the card (ACTIVE);
+ * - PCD_Init() cycles the antenna, which powers every card back to IDLE;
+ * - PCD_Authenticate() checks the key against the sector trailer; a failed
+ *   authentication drops the card to IDLE.
+ */
+
+#include <Arduino.h>
+#include <SPI.h>
+
+/**
+ * @brief A MIFARE Classic card: UID, SAK and the block image.
+ */
+struct VirtualCard {
+    static const uint16_t BLOCKS = 256;   ///< Enough for a 4K card
+
+    byte uid[10];
+    byte uidSize;
+    byte sak;                  ///< 0x08 1K, 0x18 4K, 0x09 Mini, 0x00 Ultralight
+    byte blocks[BLOCKS][16];
+
+    VirtualCard();
+    bool parseUid(const char* text);      ///< "d3:73:fd:e3" or "d373fde3"
+    void setKeys(byte sector, const byte* keyA, const byte* keyB);
+    uint16_t blockCount() const;
+};
+
+class MFRC522 {
+public:
+    enum StatusCode : byte {
+        STATUS_OK,
+        STATUS_ERROR,
+        STATUS_COLLISION,
+        STATUS_TIMEOUT,
+        STATUS_NO_ROOM,
+        STATUS_INTERNAL_ERROR,
+        STATUS_INVALID,
+        STATUS_CRC_WRONG,
+        STATUS_MIFARE_NACK = 0xff
+    };
+
+    enum PICC_Type : byte {
+        PICC_TYPE_UNKNOWN,
+        PICC_TYPE_ISO_14443_4,
+        PICC_TYPE_ISO_18092,
+        PICC_TYPE_MIFARE_MINI,
+        PICC_TYPE_MIFARE_1K,
+        PICC_TYPE_MIFARE_4K,
+        PICC_TYPE_MIFARE_UL,
+        PICC_TYPE_MIFARE_PLUS,
+        PICC_TYPE_MIFARE_DESFIRE,
+        PICC_TYPE_TNP3XXX,
+        PICC_TYPE_NOT_COMPLETE = 0xff
+    };
+
+    enum PICC_Command : byte {
+        PICC_CMD_REQA = 0x26,
+        PICC_CMD_WUPA = 0x52,
+        PICC_CMD_MF_AUTH_KEY_A = 0x60,
+        PICC_CMD_MF_AUTH_KEY_B = 0x61,
+        PICC_CMD_MF_READ = 0x30,
+        PICC_CMD_MF_WRITE = 0xA0,
+        PICC_CMD_UL_WRITE = 0xA2
+    };
+
+    typedef struct {
+        byte size;
+        byte uidByte[10];
+        byte sak;
+    } Uid;
+
+    typedef struct {
+        byte keyByte[6];
+    } MIFARE_Key;
+
+    Uid uid;
+
+    MFRC522(byte chipSelectPin, byte resetPowerDownPin);
+
+    void PCD_Init();
+    bool PICC_IsNewCardPresent();
+    bool PICC_ReadCardSerial();
+    StatusCode PICC_HaltA();
+    StatusCode PCD_Authenticate(byte command, byte blockAddr, MIFARE_Key* key, Uid* uid);
+    void PCD_StopCrypto1();
+    StatusCode MIFARE_Read(byte blockAddr, byte* buffer, byte* bufferSize);
+    StatusCode MIFARE_Write(byte blockAddr, byte* buffer, byte bufferSize);
+    StatusCode MIFARE_Ultralight_Write(byte page, byte* buffer, byte bufferSize);
+
+    static PICC_Type PICC_GetType(byte sak);
+    static const char* GetStatusCodeName(StatusCode code);
+
+    // Simulator controls
+    void placeCard(VirtualCard* card);   ///< Card entering the field, nullptr removes it
+    VirtualCard* getCard() const { return card; }
+
+private:
+    enum CardState : byte {
+        CARD_IDLE,
+        CARD_READY,            ///< Answered REQA, waiting for the select
+        CARD_ACTIVE,
+        CARD_HALT
+    };
+
+    static uint8_t sectorOf(byte blockAddr);
+    static byte trailerOf(byte blockAddr);
+
+    VirtualCard* card;
+    CardState state;
+    int16_t authSector;        ///< Sector of the last authentication, -1 if none
+};
+
+#endif // HOST_MFRC522_H
@@ -0,0 +1,30 @@
+#ifndef HOST_NTPCLIENT_H
+#define HOST_NTPCLIENT_H
+/**
+ * @file NTPClient.h
+ * @brief Host version of the NTP client: the time set with
+ * HostHal::setEpoch(), running on the virtual clock.
+ */
+
+#include <Arduino.h>
+#include "WiFiUdp.h"
+
+class NTPClient {
+public:
+    NTPClient(WiFiUDP& udp, const char* poolServerName, long timeOffset = 0, unsigned long updateInterval = 60000);
+
+    void begin() {}
+    bool update();
+    bool forceUpdate() { return update(); }
+    bool isTimeSet() const;
+    void setTimeOffset(int timeOffset) { this->timeOffset = timeOffset; }
+    unsigned long getEpochTime() const;
+    int getHours() const { return (int)(getEpochTime() % 86400L / 3600); }
+    int getMinutes() const { return (int)(getEpochTime() % 3600 / 60); }
+    int getSeconds() const { return (int)(getEpochTime() % 60); }
+
+private:
+    long timeOffset;
+};
+
+#endif // HOST_NTPCLIENT_H
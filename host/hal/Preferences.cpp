@@ -0,0 +1,194 @@
+#include "Preferences.h"
+#include "HostHal.h"
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * @brief A stored value: NVS keeps the type with the key, a get of another
+ * type misses.
+ */
+struct Entry {
+    uint8_t type = 0xFF;      ///< No type until the first put
+    std::vector<uint8_t> bytes;
+};
+
+struct Namespace {
+    std::map<std::string, Entry> entries;
+};
+
+enum EntryType : uint8_t {
+    TYPE_U8,
+    TYPE_I32,
+    TYPE_U32,
+    TYPE_U64,
+    TYPE_BLOB,
+    TYPE_STR
+};
+
+static const size_t KEY_MAX = 15;   ///< NVS key length limit
+static const size_t NVS_ENTRY = 32; ///< NVS entry size: one for the key, more for string and blob data
+
+static std::map<std::string, Namespace>& namespaces() {
+    static std::map<std::string, Namespace> all;
+    return all;
+}
+
+Preferences::Preferences() : space(nullptr), readOnly(false) {}
+
+Preferences::~Preferences() {
+    end();
+}
+
+bool Preferences::begin(const char* name, bool readOnlyMode, const char* partitionLabel) {
+    (void)partitionLabel;
+    HostHal::Untracked untracked;
+    if (name == nullptr || strlen(name) > KEY_MAX) return false;
+    space = &namespaces()[name];
+    readOnly = readOnlyMode;
+    return true;
+}
+
+void Preferences::end() {
+    space = nullptr;
+}
+
+bool Preferences::clear() {
+    if (space == nullptr || readOnly) return false;
+    HostHal::Untracked untracked;
+    space->entries.clear();
+    return true;
+}
+
+bool Preferences::remove(const char* key) {
+    if (space == nullptr || readOnly || key == nullptr) return false;
+    HostHal::Untracked untracked;
+    return space->entries.erase(key) > 0;
+}
+
+bool Preferences::isKey(const char* key) {
+    HostHal::Untracked untracked;
+    return space != nullptr && key != nullptr && space->entries.count(key) > 0;
+}
+
+/**
+ * @brief Stores a value. Like NVS, a set that does not change the stored
+ * value writes nothing; otherwise the key entry and the data entries of a
+ * string or blob are programmed.
+ */
+size_t Preferences::put(const char* key, uint8_t type, const void* value, size_t length) {
+    if (space == nullptr || readOnly || key == nullptr || strlen(key) > KEY_MAX) return 0;
+    HostHal::Untracked untracked;
+    Entry& entry = space->entries[key];
+    if (entry.type == type && entry.bytes.size() == length && memcmp(entry.bytes.data(), value, length) == 0) {
+        return length;
+    }
+    entry.type = type;
+    entry.bytes.assign((const uint8_t*)value, (const uint8_t*)value + length);
+
+    size_t programmed = NVS_ENTRY;
+    if (type == TYPE_STR || type == TYPE_BLOB) programmed += (length + NVS_ENTRY - 1) / NVS_ENTRY * NVS_ENTRY;
+    const HostHal::CostModel& cost = HostHal::getCostModel();
+    HostHal::countNvsWrite();
+    HostHal::countFlashWrite(programmed);
+    HostHal::charge(cost.nvsWriteUs + (uint32_t)programmed * cost.flashWriteUsPerByte);
+    return length;
+}
+
+bool Preferences::get(const char* key, uint8_t type, void* value, size_t length) {
+    if (space == nullptr || key == nullptr) return false;
+    HostHal::Untracked untracked;
+    auto found = space->entries.find(key);
+    if (found == space->entries.end() || found->second.type != type || found->second.bytes.size() != length) {
+        return false;
+    }
+    memcpy(value, found->second.bytes.data(), length);
+    return true;
+}
+
+size_t Preferences::putBool(const char* key, bool value) {
+    uint8_t byte = value ? 1 : 0;
+    return put(key, TYPE_U8, &byte, sizeof(byte));
+}
+
+size_t Preferences::putInt(const char* key, int32_t value) {
+    return put(key, TYPE_I32, &value, sizeof(value));
+}
+
+size_t Preferences::putUInt(const char* key, uint32_t value) {
+    return put(key, TYPE_U32, &value, sizeof(value));
+}
+
+size_t Preferences::putULong64(const char* key, uint64_t value) {
+    return put(key, TYPE_U64, &value, sizeof(value));
+}
+
+size_t Preferences::putFloat(const char* key, float value) {
+    return put(key, TYPE_BLOB, &value, sizeof(value));
+}
+
+size_t Preferences::putString(const char* key, const char* value) {
+    if (value == nullptr) return 0;
+    // The terminator is stored too, the returned length leaves it out
+    return put(key, TYPE_STR, value, strlen(value) + 1) > 0 ? strlen(value) : 0;
+}
+
+size_t Preferences::putString(const char* key, const String& value) {
+    return putString(key, value.c_str());
+}
+
+bool Preferences::getBool(const char* key, bool defaultValue) {
+    uint8_t byte;
+    return get(key, TYPE_U8, &byte, sizeof(byte)) ? byte != 0 : defaultValue;
+}
+
+int32_t Preferences::getInt(const char* key, int32_t defaultValue) {
+    int32_t value;
+    return get(key, TYPE_I32, &value, sizeof(value)) ? value : defaultValue;
+}
+
+uint32_t Preferences::getUInt(const char* key, uint32_t defaultValue) {
+    uint32_t value;
+    return get(key, TYPE_U32, &value, sizeof(value)) ? value : defaultValue;
+}
+
+uint64_t Preferences::getULong64(const char* key, uint64_t defaultValue) {
+    uint64_t value;
+    return get(key, TYPE_U64, &value, sizeof(value)) ? value : defaultValue;
+}
+
+float Preferences::getFloat(const char* key, float defaultValue) {
+    float value;
+    return get(key, TYPE_BLOB, &value, sizeof(value)) ? value : defaultValue;
+}
+
+/**
+ * @brief Copies a string value, terminator included.
+ *
+ * @return Bytes copied with the terminator, 0 if missing or if it does not fit.
+ */
+size_t Preferences::getString(const char* key, char* value, size_t maxLen) {
+    if (space == nullptr || key == nullptr) return 0;
+    HostHal::Untracked untracked;
+    auto found = space->entries.find(key);
+    if (found == space->entries.end() || found->second.type != TYPE_STR) return 0;
+    size_t length = found->second.bytes.size();
+    if (value == nullptr) return length;
+    if (length > maxLen) return 0;
+    memcpy(value, found->second.bytes.data(), length);
+    return length;
+}
+
+String Preferences::getString(const char* key, const String& defaultValue) {
+    if (space == nullptr || key == nullptr) return defaultValue;
+    const char* text = nullptr;
+    {
+        HostHal::Untracked untracked;
+        auto found = space->entries.find(key);
+        if (found != space->entries.end() && found->second.type == TYPE_STR) {
+            text = (const char*)found->second.bytes.data();
+        }
+    }
+    // The returned String is the firmware's allocation
+    return text != nullptr ? String(text) : defaultValue;
+}
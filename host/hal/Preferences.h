@@ -0,0 +1,48 @@
+#ifndef HOST_PREFERENCES_H
+#define HOST_PREFERENCES_H
+/**
+ * @file Preferences.h
+ * @brief Host version of the NVS key-value store.
+ *
+ * Every namespace lives in RAM for the whole run, shared by the Preferences
+ * objects that open it, and starts empty like a freshly erased device.
+ */
+
+#include <Arduino.h>
+
+class Preferences {
+public:
+    Preferences();
+    ~Preferences();
+
+    bool begin(const char* name, bool readOnly = false, const char* partitionLabel = nullptr);
+    void end();
+    bool clear();
+    bool remove(const char* key);
+    bool isKey(const char* key);
+
+    size_t putBool(const char* key, bool value);
+    size_t putInt(const char* key, int32_t value);
+    size_t putUInt(const char* key, uint32_t value);
+    size_t putULong64(const char* key, uint64_t value);
+    size_t putFloat(const char* key, float value);
+    size_t putString(const char* key, const char* value);
+    size_t putString(const char* key, const String& value);
+
+    bool getBool(const char* key, bool defaultValue = false);
+    int32_t getInt(const char* key, int32_t defaultValue = 0);
+    uint32_t getUInt(const char* key, uint32_t defaultValue = 0);
+    uint64_t getULong64(const char* key, uint64_t defaultValue = 0);
+    float getFloat(const char* key, float defaultValue = NAN);
+    size_t getString(const char* key, char* value, size_t maxLen);
+    String getString(const char* key, const String& defaultValue = String());
+
+private:
+    size_t put(const char* key, uint8_t type, const void* value, size_t length);
+    bool get(const char* key, uint8_t type, void* value, size_t length);
+
+    struct Namespace* space;   ///< nullptr until begin()
+    bool readOnly;
+};
+
+#endif // HOST_PREFERENCES_H
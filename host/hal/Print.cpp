@@ -0,0 +1,73 @@
+#include "Print.h"
+#include "HostHal.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+size_t Print::write(const uint8_t* buffer, size_t size) {
+    size_t n = 0;
+    while (size--) {
+        if (write(*buffer++) == 0) break;
+        n++;
+    }
+    return n;
+}
+
+/**
+ * @brief Formats into a stack buffer, or a heap one for long output, like
+ * the ESP32 core.
+ */
+size_t Print::printf(const char* format, ...) {
+    char local[64];
+    char* text = local;
+    va_list args;
+    va_start(args, format);
+    va_list copy;
+    va_copy(copy, args);
+    int length = vsnprintf(local, sizeof(local), format, copy);
+    va_end(copy);
+    if (length < 0) {
+        va_end(args);
+        return 0;
+    }
+    if ((size_t)length >= sizeof(local)) {
+        text = (char*)malloc(length + 1);   // Counted like the core's printf() heap buffer
+        if (text == nullptr) {
+            va_end(args);
+            return 0;
+        }
+        vsnprintf(text, length + 1, format, args);
+    }
+    va_end(args);
+    size_t n = write((const uint8_t*)text, length);
+    if (text != local) free(text);
+    return n;
+}
+
+size_t Print::print(long long value, int base) {
+    if (base == DEC && value < 0) {
+        size_t n = print('-');
+        return n + print(0ULL - (unsigned long long)value, base);
+    }
+    return print((unsigned long long)value, base);
+}
+
+size_t Print::print(unsigned long long value, int base) {
+    if (base == 0) return write((uint8_t)value);
+    if (base < 2) base = DEC;
+    char text[65];
+    char* out = text + sizeof(text) - 1;
+    *out = '\0';
+    do {
+        unsigned digit = (unsigned)(value % base);
+        *--out = (char)(digit < 10 ? '0' + digit : 'A' + digit - 10);
+        value /= base;
+    } while (value > 0);
+    return write(out);
+}
+
+size_t Print::print(double value, int digits) {
+    char text[64];
+    snprintf(text, sizeof(text), "%.*f", digits, value);
+    return write(text);
+}
@@ -0,0 +1,61 @@
+#ifndef HOST_PRINT_H
+#define HOST_PRINT_H
+/**
+ * @file Print.h
+ * @brief Host version of the Arduino Print base class.
+ *
+ * Classes only implement write(uint8_t), and optionally the buffer version;
+ * every print()/println()/printf() formats like the Arduino core.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "WString.h"
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+class Print {
+public:
+    virtual ~Print() {}
+
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size);
+    size_t write(const char* str) { return str ? write((const uint8_t*)str, strlen(str)) : 0; }
+    size_t write(const char* buffer, size_t size) { return write((const uint8_t*)buffer, size); }
+
+    size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+    size_t print(const String& s) { return write(s.c_str(), s.length()); }
+    size_t print(const char* str) { return write(str); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(unsigned char value, int base = DEC) { return print((unsigned long long)value, base); }
+    size_t print(int value, int base = DEC) { return print((long long)value, base); }
+    size_t print(unsigned int value, int base = DEC) { return print((unsigned long long)value, base); }
+    size_t print(long value, int base = DEC) { return print((long long)value, base); }
+    size_t print(unsigned long value, int base = DEC) { return print((unsigned long long)value, base); }
+    size_t print(long long value, int base = DEC);
+    size_t print(unsigned long long value, int base = DEC);
+    size_t print(double value, int digits = 2);
+
+    size_t println() { return write("\r\n"); }
+    template <typename T>
+    size_t println(const T& value) {
+        size_t n = print(value);
+        return n + println();
+    }
+    template <typename T>
+    size_t println(const T& value, int format) {
+        size_t n = print(value, format);
+        return n + println();
+    }
+    size_t println(const char* str) {
+        size_t n = print(str);
+        return n + println();
+    }
+};
+
+#endif // HOST_PRINT_H
@@ -0,0 +1,24 @@
+#ifndef HOST_SPI_H
+#define HOST_SPI_H
+/**
+ * @file SPI.h
+ * @brief Host version of the SPI bus; the card reader model of MFRC522.h
+ * does not go through it.
+ */
+
+#include <Arduino.h>
+
+class SPIClass {
+public:
+    void begin(int8_t sck = -1, int8_t miso = -1, int8_t mosi = -1, int8_t ss = -1) {
+        (void)sck;
+        (void)miso;
+        (void)mosi;
+        (void)ss;
+    }
+    void end() {}
+};
+
+extern SPIClass SPI;
+
+#endif // HOST_SPI_H
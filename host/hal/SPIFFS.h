@@ -0,0 +1,26 @@
+#ifndef HOST_SPIFFS_H
+#define HOST_SPIFFS_H
+/**
+ * @file SPIFFS.h
+ * @brief Host version of the SPIFFS mount, backed by a host directory.
+ */
+
+#include "FS.h"
+
+namespace fs {
+
+class SPIFFSFS : public FS {
+public:
+    bool begin(bool formatOnFail = false, const char* basePath = "/spiffs", uint8_t maxOpenFiles = 10,
+               const char* partitionLabel = nullptr);
+    void end() {}
+    bool format();
+    size_t totalBytes();
+    size_t usedBytes();
+};
+
+}  // namespace fs
+
+extern fs::SPIFFSFS SPIFFS;
+
+#endif // HOST_SPIFFS_H
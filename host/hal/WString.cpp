@@ -0,0 +1,345 @@
+#include "WString.h"
+#include "HostHal.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Formats an integer in base 2-36, lowercase digits like utoa().
+ */
+static void formatUnsigned(char* out, unsigned long long value, unsigned char base) {
+    char digits[66];
+    size_t count = 0;
+    if (base < 2 || base > 36) base = 10;
+    do {
+        unsigned digit = (unsigned)(value % base);
+        digits[count++] = (char)(digit < 10 ? '0' + digit : 'a' + digit - 10);
+        value /= base;
+    } while (value > 0);
+    while (count > 0) {
+        *out++ = digits[--count];
+    }
+    *out = '\0';
+}
+
+static void formatSigned(char* out, long long value, unsigned char base) {
+    // Like itoa(), only base 10 prints a sign
+    if (value < 0 && base == 10) {
+        *out++ = '-';
+        formatUnsigned(out, 0ULL - (unsigned long long)value, base);
+    } else {
+        formatUnsigned(out, (unsigned long long)value, base);
+    }
+}
+
+String::String(const char* cstr) {
+    invalidate();
+    if (cstr) copy(cstr, strlen(cstr));
+}
+
+String::String(const String& str) {
+    invalidate();
+    *this = str;
+}
+
+String::String(String&& str) {
+    invalidate();
+    move(str);
+}
+
+String::String(char c) {
+    invalidate();
+    char text[2] = {c, '\0'};
+    copy(text, c == '\0' ? 0 : 1);
+}
+
+String::String(unsigned char value, unsigned char base) : String((unsigned long long)value, base) {}
+String::String(int value, unsigned char base) : String((long long)value, base) {}
+String::String(unsigned int value, unsigned char base) : String((unsigned long long)value, base) {}
+String::String(long value, unsigned char base) : String((long long)value, base) {}
+String::String(unsigned long value, unsigned char base) : String((unsigned long long)value, base) {}
+
+String::String(long long value, unsigned char base) {
+    invalidate();
+    char text[66];
+    formatSigned(text, value, base);
+    copy(text, strlen(text));
+}
+
+String::String(unsigned long long value, unsigned char base) {
+    invalidate();
+    char text[66];
+    formatUnsigned(text, value, base);
+    copy(text, strlen(text));
+}
+
+String::String(float value, unsigned char decimals) : String((double)value, decimals) {}
+
+String::String(double value, unsigned char decimals) {
+    invalidate();
+    char text[64];
+    snprintf(text, sizeof(text), "%.*f", decimals, value);
+    copy(text, strlen(text));
+}
+
+String::~String() {
+    free(buffer);
+}
+
+void String::invalidate() {
+    buffer = nullptr;
+    capacity = 0;
+    len = 0;
+}
+
+/**
+ * @brief Grows the buffer to hold maxStrLen characters; never shrinks it.
+ */
+bool String::reserve(unsigned int size) {
+    if (buffer && capacity >= size) return true;
+    if (changeBuffer(size)) {
+        if (len == 0) buffer[0] = '\0';
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Always on the heap here; counted as an allocation only when the
+ * device's String would leave its inline buffer for it.
+ */
+bool String::changeBuffer(unsigned int maxStrLen) {
+    char* grown;
+    {
+        HostHal::Untracked untracked;
+        grown = (char*)realloc(buffer, maxStrLen + 1);
+    }
+    if (grown == nullptr) return false;
+    if (maxStrLen > SSO_CAPACITY) HostHal::countAllocation(maxStrLen + 1);
+    buffer = grown;
+    capacity = maxStrLen;
+    return true;
+}
+
+String& String::copy(const char* cstr, unsigned int length) {
+    if (!reserve(length)) {
+        free(buffer);
+        invalidate();
+        return *this;
+    }
+    len = length;
+    memmove(buffer, cstr, length);
+    buffer[length] = '\0';
+    return *this;
+}
+
+void String::move(String& rhs) {
+    free(buffer);
+    buffer = rhs.buffer;
+    capacity = rhs.capacity;
+    len = rhs.len;
+    rhs.invalidate();
+}
+
+String& String::operator=(const String& rhs) {
+    if (this == &rhs) return *this;
+    if (rhs.buffer) {
+        copy(rhs.buffer, rhs.len);
+    } else {
+        free(buffer);
+        invalidate();
+    }
+    return *this;
+}
+
+String& String::operator=(String&& rhs) {
+    if (this != &rhs) move(rhs);
+    return *this;
+}
+
+String& String::operator=(const char* cstr) {
+    if (cstr) {
+        copy(cstr, strlen(cstr));
+    } else {
+        free(buffer);
+        invalidate();
+    }
+    return *this;
+}
+
+bool String::concat(const char* cstr, unsigned int length) {
+    unsigned int newLength = len + length;
+    if (cstr == nullptr) return false;
+    if (length == 0) return true;
+    if (!reserve(newLength)) return false;
+    memmove(buffer + len, cstr, length);
+    len = newLength;
+    buffer[len] = '\0';
+    return true;
+}
+
+bool String::concat(const String& str) {
+    // Appending a string to itself must not read the buffer after realloc()
+    if (&str == this) {
+        unsigned int length = len;
+        if (!reserve(len * 2)) return false;
+        memcpy(buffer + len, buffer, length);
+        len += length;
+        buffer[len] = '\0';
+        return true;
+    }
+    return concat(str.c_str(), str.len);
+}
+
+bool String::concat(const char* cstr) {
+    return cstr ? concat(cstr, strlen(cstr)) : false;
+}
+
+bool String::concat(char c) {
+    return concat(&c, 1);
+}
+
+bool String::concat(unsigned char value) { return concat(String(value)); }
+bool String::concat(int value) { return concat(String(value)); }
+bool String::concat(unsigned int value) { return concat(String(value)); }
+bool String::concat(long value) { return concat(String(value)); }
+bool String::concat(unsigned long value) { return concat(String(value)); }
+bool String::concat(long long value) { return concat(String(value)); }
+bool String::concat(unsigned long long value) { return concat(String(value)); }
+bool String::concat(double value) { return concat(String(value)); }
+
+int String::compareTo(const String& s) const {
+    return strcmp(c_str(), s.c_str());
+}
+
+bool String::equals(const String& s) const {
+    return len == s.len && compareTo(s) == 0;
+}
+
+bool String::equals(const char* cstr) const {
+    return strcmp(c_str(), cstr ? cstr : "") == 0;
+}
+
+bool String::equalsIgnoreCase(const String& s) const {
+    if (len != s.len) return false;
+    const char* a = c_str();
+    const char* b = s.c_str();
+    for (unsigned int i = 0; i < len; i++) {
+        if (tolower((unsigned char)a[i]) != tolower((unsigned char)b[i])) return false;
+    }
+    return true;
+}
+
+bool String::startsWith(const String& prefix) const {
+    return prefix.len <= len && strncmp(c_str(), prefix.c_str(), prefix.len) == 0;
+}
+
+bool String::endsWith(const String& suffix) const {
+    return suffix.len <= len && strcmp(c_str() + len - suffix.len, suffix.c_str()) == 0;
+}
+
+char String::charAt(unsigned int index) const {
+    return (*this)[index];
+}
+
+char String::operator[](unsigned int index) const {
+    return index < len ? buffer[index] : '\0';
+}
+
+char& String::operator[](unsigned int index) {
+    static char dummy;
+    if (index >= len) {
+        dummy = '\0';
+        return dummy;
+    }
+    return buffer[index];
+}
+
+int String::indexOf(char c, unsigned int fromIndex) const {
+    if (fromIndex >= len) return -1;
+    const char* found = strchr(buffer + fromIndex, c);
+    return found ? (int)(found - buffer) : -1;
+}
+
+int String::indexOf(const String& str, unsigned int fromIndex) const {
+    if (fromIndex >= len) return -1;
+    const char* found = strstr(buffer + fromIndex, str.c_str());
+    return found ? (int)(found - buffer) : -1;
+}
+
+String String::substring(unsigned int left, unsigned int right) const {
+    if (left > right) {
+        unsigned int swap = left;
+        left = right;
+        right = swap;
+    }
+    String out;
+    if (left >= len) return out;
+    if (right > len) right = len;
+    out.copy(buffer + left, right - left);
+    return out;
+}
+
+void String::remove(unsigned int index) {
+    remove(index, (unsigned int)-1);
+}
+
+void String::remove(unsigned int index, unsigned int count) {
+    if (index >= len || count == 0) return;
+    if (count > len - index) count = len - index;
+    memmove(buffer + index, buffer + index + count, len - index - count);
+    len -= count;
+    buffer[len] = '\0';
+}
+
+void String::toUpperCase() {
+    for (unsigned int i = 0; i < len; i++) buffer[i] = (char)toupper((unsigned char)buffer[i]);
+}
+
+void String::toLowerCase() {
+    for (unsigned int i = 0; i < len; i++) buffer[i] = (char)tolower((unsigned char)buffer[i]);
+}
+
+void String::trim() {
+    if (buffer == nullptr || len == 0) return;
+    char* begin = buffer;
+    while (isspace((unsigned char)*begin)) begin++;
+    char* end = buffer + len - 1;
+    while (end >= begin && isspace((unsigned char)*end)) end--;
+    len = end + 1 - begin;
+    if (begin > buffer) memmove(buffer, begin, len);
+    buffer[len] = '\0';
+}
+
+long String::toInt() const {
+    return buffer ? atol(buffer) : 0;
+}
+
+float String::toFloat() const {
+    return buffer ? (float)atof(buffer) : 0;
+}
+
+String operator+(const String& lhs, const String& rhs) {
+    String out(lhs);
+    out.concat(rhs);
+    return out;
+}
+
+String operator+(const String& lhs, const char* rhs) {
+    String out(lhs);
+    out.concat(rhs);
+    return out;
+}
+
+String operator+(const char* lhs, const String& rhs) {
+    String out(lhs);
+    out.concat(rhs);
+    return out;
+}
+
+String operator+(const String& lhs, char rhs) {
+    String out(lhs);
+    out.concat(rhs);
+    return out;
+}
@@ -0,0 +1,112 @@
+#ifndef HOST_WSTRING_H
+#define HOST_WSTRING_H
+/**
+ * @file WString.h
+ * @brief Host version of the Arduino String.
+ *
+ * Same interface as the core's WString. The text always lives in a
+ * malloc()ed buffer grown with realloc(); heap allocations are counted like
+ * the ESP32 core makes them, which keeps up to SSO_CAPACITY characters in
+ * the String itself. Only the members the firmware uses are provided.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+class String {
+    // Safe bool: `if (str)` and `return str;` from a bool function compile like on the device
+    typedef void (String::*StringIfHelperType)() const;
+    void StringIfHelper() const {}
+
+public:
+    String(const char* cstr = "");
+    String(const String& str);
+    String(String&& str);
+    explicit String(char c);
+    explicit String(unsigned char value, unsigned char base = 10);
+    explicit String(int value, unsigned char base = 10);
+    explicit String(unsigned int value, unsigned char base = 10);
+    explicit String(long value, unsigned char base = 10);
+    explicit String(unsigned long value, unsigned char base = 10);
+    explicit String(long long value, unsigned char base = 10);
+    explicit String(unsigned long long value, unsigned char base = 10);
+    explicit String(float value, unsigned char decimals = 2);
+    explicit String(double value, unsigned char decimals = 2);
+    ~String();
+
+    String& operator=(const String& rhs);
+    String& operator=(String&& rhs);
+    String& operator=(const char* cstr);
+
+    bool reserve(unsigned int size);
+    unsigned int length() const { return len; }
+    bool isEmpty() const { return len == 0; }
+    const char* c_str() const { return buffer ? buffer : ""; }
+    operator StringIfHelperType() const { return buffer ? &String::StringIfHelper : 0; }
+
+    bool concat(const String& str);
+    bool concat(const char* cstr);
+    bool concat(const char* cstr, unsigned int length);
+    bool concat(char c);
+    bool concat(unsigned char value);
+    bool concat(int value);
+    bool concat(unsigned int value);
+    bool concat(long value);
+    bool concat(unsigned long value);
+    bool concat(long long value);
+    bool concat(unsigned long long value);
+    bool concat(double value);
+
+    template <typename T>
+    String& operator+=(const T& rhs) {
+        concat(rhs);
+        return *this;
+    }
+
+    int compareTo(const String& s) const;
+    bool equals(const String& s) const;
+    bool equals(const char* cstr) const;
+    bool equalsIgnoreCase(const String& s) const;
+    bool startsWith(const String& prefix) const;
+    bool endsWith(const String& suffix) const;
+    bool operator==(const String& rhs) const { return equals(rhs); }
+    bool operator==(const char* cstr) const { return equals(cstr); }
+    bool operator!=(const String& rhs) const { return !equals(rhs); }
+    bool operator!=(const char* cstr) const { return !equals(cstr); }
+    bool operator<(const String& rhs) const { return compareTo(rhs) < 0; }
+
+    char charAt(unsigned int index) const;
+    char operator[](unsigned int index) const;
+    char& operator[](unsigned int index);
+    int indexOf(char c, unsigned int fromIndex = 0) const;
+    int indexOf(const String& str, unsigned int fromIndex = 0) const;
+    String substring(unsigned int beginIndex) const { return substring(beginIndex, len); }
+    String substring(unsigned int beginIndex, unsigned int endIndex) const;
+
+    void remove(unsigned int index);
+    void remove(unsigned int index, unsigned int count);
+    void toUpperCase();
+    void toLowerCase();
+    void trim();
+    long toInt() const;
+    float toFloat() const;
+
+    static const unsigned int SSO_CAPACITY = 14;   ///< Inline characters of the ESP32 core's String
+
+private:
+    void invalidate();
+    bool changeBuffer(unsigned int maxStrLen);
+    String& copy(const char* cstr, unsigned int length);
+    void move(String& rhs);
+
+    char* buffer;           ///< nullptr only after a failed allocation
+    unsigned int capacity;  ///< Characters the buffer holds, terminator excluded
+    unsigned int len;
+};
+
+String operator+(const String& lhs, const String& rhs);
+String operator+(const String& lhs, const char* rhs);
+String operator+(const char* lhs, const String& rhs);
+String operator+(const String& lhs, char rhs);
+
+#endif // HOST_WSTRING_H
@@ -0,0 +1,60 @@
+#include "WiFi.h"
+#include "NTPClient.h"
+#include "HostHal.h"
+
+static bool connected = true;
+static int8_t rssi = -60;
+static bool accessPoint = false;
+static uint32_t epochBase = 1735689600;     ///< 2025-01-01 00:00:00 UTC
+static int64_t epochSetUs = 0;
+
+WiFiClass WiFi;
+
+wl_status_t WiFiClass::status() {
+    return connected ? WL_CONNECTED : WL_DISCONNECTED;
+}
+
+int8_t WiFiClass::RSSI() {
+    return connected ? rssi : 0;
+}
+
+NTPClient::NTPClient(WiFiUDP& udp, const char* poolServerName, long timeOffset, unsigned long updateInterval)
+    : timeOffset(timeOffset) {
+    (void)udp;
+    (void)poolServerName;
+    (void)updateInterval;
+}
+
+bool NTPClient::update() {
+    return connected;
+}
+
+bool NTPClient::isTimeSet() const {
+    return true;
+}
+
+unsigned long NTPClient::getEpochTime() const {
+    return epochBase + (unsigned long)((HostHal::now() - epochSetUs) / 1000000) + timeOffset;
+}
+
+namespace HostHal {
+
+void setWiFi(bool isConnected, int8_t signal) {
+    connected = isConnected;
+    rssi = signal;
+}
+
+void setAccessPoint(bool active) {
+    accessPoint = active;
+}
+
+bool isAccessPointActive() {
+    return accessPoint;
+}
+
+void setEpoch(uint32_t epoch) {
+    epochBase = epoch;
+    epochSetUs = now();
+}
+
+}  // namespace HostHal
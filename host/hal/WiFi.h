@@ -0,0 +1,32 @@
+#ifndef HOST_WIFI_H
+#define HOST_WIFI_H
+/**
+ * @file WiFi.h
+ * @brief Host version of the ESP32 Wi-Fi station state, set by the simulator
+ * with HostHal::setWiFi().
+ */
+
+#include <Arduino.h>
+
+typedef enum {
+    WL_IDLE_STATUS = 0,
+    WL_NO_SSID_AVAIL = 1,
+    WL_SCAN_COMPLETED = 2,
+    WL_CONNECTED = 3,
+    WL_CONNECT_FAILED = 4,
+    WL_CONNECTION_LOST = 5,
+    WL_DISCONNECTED = 6
+} wl_status_t;
+
+typedef int WiFiEvent_t;
+
+class WiFiClass {
+public:
+    wl_status_t status();
+    int8_t RSSI();
+    bool isConnected() { return status() == WL_CONNECTED; }
+};
+
+extern WiFiClass WiFi;
+
+#endif // HOST_WIFI_H
@@ -0,0 +1,10 @@
+#ifndef HOST_WIFIUDP_H
+#define HOST_WIFIUDP_H
+/**
+ * @file WiFiUdp.h
+ * @brief Host placeholder of the UDP socket the NTP client is built on.
+ */
+
+class WiFiUDP {};
+
+#endif // HOST_WIFIUDP_H
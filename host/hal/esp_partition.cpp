@@ -0,0 +1,85 @@
+#include "esp_partition.h"
+#include "HostHal.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief A raw data partition of partitions.csv and its RAM image,
+ * allocated erased on first use.
+ */
+struct HostPartition {
+    esp_partition_t info;
+    uint8_t* image;
+};
+
+static HostPartition partitions[] = {
+    {{ESP_PARTITION_TYPE_DATA, (esp_partition_subtype_t)0x40, 0x2F0000, 0x8B000, "counter", false}, nullptr},
+};
+
+static uint32_t failingWrites = 0;   ///< Writes left to fail, see HostHal::failPartitionWrites()
+
+void HostHal::failPartitionWrites(uint32_t count) {
+    failingWrites = count;
+}
+
+static HostPartition* lookup(const esp_partition_t* partition) {
+    for (size_t i = 0; i < sizeof(partitions) / sizeof(partitions[0]); i++) {
+        if (&partitions[i].info == partition) return &partitions[i];
+    }
+    return nullptr;
+}
+
+const esp_partition_t* esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype,
+                                                const char* label) {
+    for (size_t i = 0; i < sizeof(partitions) / sizeof(partitions[0]); i++) {
+        HostPartition& partition = partitions[i];
+        if (partition.info.type != type) continue;
+        if (subtype != ESP_PARTITION_SUBTYPE_ANY && partition.info.subtype != subtype) continue;
+        if (label != nullptr && strcmp(partition.info.label, label) != 0) continue;
+        if (partition.image == nullptr) {
+            HostHal::Untracked untracked;
+            partition.image = (uint8_t*)malloc(partition.info.size);
+            if (partition.image == nullptr) return nullptr;
+            memset(partition.image, 0xFF, partition.info.size);
+        }
+        return &partition.info;
+    }
+    return nullptr;
+}
+
+esp_err_t esp_partition_read(const esp_partition_t* partition, size_t srcOffset, void* dst, size_t size) {
+    HostPartition* host = lookup(partition);
+    if (host == nullptr || dst == nullptr) return ESP_ERR_INVALID_ARG;
+    if (srcOffset > partition->size || size > partition->size - srcOffset) return ESP_ERR_INVALID_SIZE;
+    memcpy(dst, host->image + srcOffset, size);
+    return ESP_OK;
+}
+
+esp_err_t esp_partition_write(const esp_partition_t* partition, size_t dstOffset, const void* src, size_t size) {
+    HostPartition* host = lookup(partition);
+    if (host == nullptr || src == nullptr) return ESP_ERR_INVALID_ARG;
+    if (dstOffset > partition->size || size > partition->size - dstOffset) return ESP_ERR_INVALID_SIZE;
+    if (failingWrites > 0) {
+        failingWrites--;
+        return ESP_FAIL;   // Nothing programmed
+    }
+    const uint8_t* bytes = (const uint8_t*)src;
+    for (size_t i = 0; i < size; i++) {
+        host->image[dstOffset + i] &= bytes[i];  // Programming only clears bits
+    }
+    HostHal::countFlashWrite(size);
+    HostHal::charge((uint32_t)size * HostHal::getCostModel().flashWriteUsPerByte);
+    return ESP_OK;
+}
+
+esp_err_t esp_partition_erase_range(const esp_partition_t* partition, size_t offset, size_t size) {
+    HostPartition* host = lookup(partition);
+    if (host == nullptr) return ESP_ERR_INVALID_ARG;
+    if (offset % SPI_FLASH_SEC_SIZE != 0 || size % SPI_FLASH_SEC_SIZE != 0) return ESP_ERR_INVALID_SIZE;
+    if (offset > partition->size || size > partition->size - offset) return ESP_ERR_INVALID_SIZE;
+    memset(host->image + offset, 0xFF, size);
+    uint32_t sectors = (uint32_t)(size / SPI_FLASH_SEC_SIZE);
+    HostHal::countFlashErase(sectors);
+    HostHal::charge(sectors * HostHal::getCostModel().flashEraseUs);
+    return ESP_OK;
+}
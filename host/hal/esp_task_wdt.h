@@ -0,0 +1,15 @@
+#ifndef HOST_ESP_TASK_WDT_H
+#define HOST_ESP_TASK_WDT_H
+/**
+ * @file esp_task_wdt.h
+ * @brief Host version of the task watchdog and sleep calls: nothing to feed.
+ */
+
+#include <stdint.h>
+#include "esp_err.h"
+
+inline esp_err_t esp_task_wdt_reset() { return ESP_OK; }
+inline esp_err_t esp_sleep_enable_timer_wakeup(uint64_t) { return ESP_OK; }
+void esp_deep_sleep_start();   ///< Ends the simulation, the device would reboot
+
+#endif // HOST_ESP_TASK_WDT_H
@@ -0,0 +1,136 @@
+#include "esp_timer.h"
+#include "HostHal.h"
+#include <stdlib.h>
+
+/**
+ * @brief An esp_timer; armed timers form a list scanned for the earliest
+ * deadline, there are only a handful of them.
+ */
+struct esp_timer {
+    esp_timer_cb_t callback;
+    void* arg;
+    const char* name;
+    int64_t deadlineUs;
+    uint64_t periodUs;         ///< 0 for one-shot
+    bool armed;
+    esp_timer* next;           ///< Every created timer
+};
+
+static int64_t clockUs = 0;
+static esp_timer* timers = nullptr;
+static bool dispatching = false;
+
+static esp_timer* earliest() {
+    esp_timer* first = nullptr;
+    for (esp_timer* timer = timers; timer != nullptr; timer = timer->next) {
+        if (timer->armed && (first == nullptr || timer->deadlineUs < first->deadlineUs)) {
+            first = timer;
+        }
+    }
+    return first;
+}
+
+namespace HostHal {
+
+int64_t now() {
+    return clockUs;
+}
+
+void advance(int64_t us) {
+    advanceTo(clockUs + (us > 0 ? us : 0));
+}
+
+/**
+ * @brief Moves the clock to the target, stopping at every timer deadline on
+ * the way to run its callback.
+ *
+ * A callback that waits (delay() in a timer callback) only moves the clock;
+ * timers do not preempt each other, like on the single esp_timer task.
+ */
+void advanceTo(int64_t us) {
+    if (dispatching) {
+        if (us > clockUs) clockUs = us;
+        return;
+    }
+    while (true) {
+        esp_timer* timer = earliest();
+        if (timer == nullptr || timer->deadlineUs > us) break;
+        if (timer->deadlineUs > clockUs) clockUs = timer->deadlineUs;
+        if (timer->periodUs > 0) {
+            timer->deadlineUs += timer->periodUs;
+        } else {
+            timer->armed = false;
+        }
+        dispatching = true;
+        timer->callback(timer->arg);
+        dispatching = false;
+    }
+    if (us > clockUs) clockUs = us;
+}
+
+int64_t nextDeadline() {
+    esp_timer* timer = earliest();
+    return timer != nullptr ? timer->deadlineUs : INT64_MAX;
+}
+
+}  // namespace HostHal
+
+int64_t esp_timer_get_time() {
+    return clockUs;
+}
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t* args, esp_timer_handle_t* handle) {
+    if (args == nullptr || args->callback == nullptr || handle == nullptr) return ESP_ERR_INVALID_ARG;
+    esp_timer* timer = (esp_timer*)calloc(1, sizeof(esp_timer));
+    if (timer == nullptr) return ESP_ERR_NO_MEM;
+    HostHal::countAllocation(sizeof(esp_timer));
+    timer->callback = args->callback;
+    timer->arg = args->arg;
+    timer->name = args->name;
+    timer->next = timers;
+    timers = timer;
+    *handle = timer;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeoutUs) {
+    if (timer == nullptr) return ESP_ERR_INVALID_ARG;
+    if (timer->armed) return ESP_ERR_INVALID_STATE;
+    timer->deadlineUs = clockUs + (int64_t)timeoutUs;
+    timer->periodUs = 0;
+    timer->armed = true;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t periodUs) {
+    if (timer == nullptr || periodUs == 0) return ESP_ERR_INVALID_ARG;
+    if (timer->armed) return ESP_ERR_INVALID_STATE;
+    timer->deadlineUs = clockUs + (int64_t)periodUs;
+    timer->periodUs = periodUs;
+    timer->armed = true;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer) {
+    if (timer == nullptr) return ESP_ERR_INVALID_ARG;
+    if (!timer->armed) return ESP_ERR_INVALID_STATE;
+    timer->armed = false;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t timer) {
+    if (timer == nullptr) return ESP_ERR_INVALID_ARG;
+    if (timer->armed) return ESP_ERR_INVALID_STATE;
+    for (esp_timer** link = &timers; *link != nullptr; link = &(*link)->next) {
+        if (*link == timer) {
+            *link = timer->next;
+            break;
+        }
+    }
+    free(timer);
+    return ESP_OK;
+}
+
+bool esp_timer_is_active(esp_timer_handle_t timer) {
+    return timer != nullptr && timer->armed;
+}
@@ -0,0 +1,51 @@
+#ifndef HOST_FREERTOS_H
+#define HOST_FREERTOS_H
+/**
+ * @file FreeRTOS.h
+ * @brief Host version of the FreeRTOS types and critical sections.
+ *
+ * The host runs the firmware on a single thread (see HostHal.h): task
+ * creation fails, so every module takes its inline path, critical sections
+ * have nothing to exclude and blocking calls advance the virtual clock.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdFALSE 0
+#define pdTRUE 1
+#define pdPASS pdTRUE
+#define pdFAIL pdFALSE
+#define errQUEUE_FULL 0
+#define errCOULD_NOT_ALLOCATE_REQUIRED_MEMORY (-1)
+
+#define configTICK_RATE_HZ 1000
+#define configGENERATE_RUN_TIME_STATS 0
+#define portTICK_PERIOD_MS (1000 / configTICK_RATE_HZ)
+#define portMAX_DELAY ((TickType_t)0xffffffffUL)
+#define pdMS_TO_TICKS(ms) ((TickType_t)(((TickType_t)(ms) * (TickType_t)configTICK_RATE_HZ) / (TickType_t)1000U))
+#define tskNO_AFFINITY 0x7FFFFFFF
+
+typedef struct tskTaskControlBlock* TaskHandle_t;
+typedef struct QueueDefinition* QueueHandle_t;
+typedef QueueHandle_t SemaphoreHandle_t;
+typedef void (*TaskFunction_t)(void*);
+
+typedef struct {
+    uint32_t owner;
+    uint32_t count;
+} portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED {0, 0}
+#define portMUX_INITIALIZE(mux) ((mux)->owner = 0, (mux)->count = 0)
+#define portENTER_CRITICAL(mux) ((void)(mux))
+#define portEXIT_CRITICAL(mux) ((void)(mux))
+#define portENTER_CRITICAL_ISR(mux) ((void)(mux))
+#define portEXIT_CRITICAL_ISR(mux) ((void)(mux))
+#define portYIELD_FROM_ISR() ((void)0)
+
+#endif // HOST_FREERTOS_H
@@ -0,0 +1,73 @@
+#include <Arduino.h>
+#include "Config.h"
+#include "HostHal.h"
+#include "HostLcdSink.h"
+
+HostLcdSink::HostLcdSink() : col(0), row(0), busBytes(0) {
+    memset(cells, ' ', sizeof(cells));
+}
+
+void HostLcdSink::begin() {
+    memset(cells, ' ', sizeof(cells));
+    col = 0;
+    row = 0;
+    busBytes = 0;
+}
+
+void HostLcdSink::send(uint32_t bytes) {
+    busBytes += bytes;
+    HostHal::countLcdBytes(bytes);
+    HostHal::charge((uint32_t)((uint64_t)bytes * BITS_PER_BYTE * 1000000 / LCD_I2C_CLOCK_HZ));
+}
+
+void HostLcdSink::moveTo(uint8_t newCol, uint8_t newRow) {
+    col = newCol;
+    row = newRow;
+    send(BYTES_PER_WRITE);
+}
+
+/**
+ * @brief Writes at the cursor; past the end of a row the HD44780 keeps
+ * writing into display RAM that is not visible, so the rest is dropped.
+ */
+void HostLcdSink::writeChars(const uint8_t* data, uint8_t len) {
+    for (uint8_t i = 0; i < len; i++) {
+        if (row < LCD_ROWS && col < LCD_COLUMNS) {
+            cells[row][col] = data[i];
+        }
+        col++;
+    }
+    send((uint32_t)len * BYTES_PER_WRITE);
+}
+
+void HostLcdSink::loadGlyph(uint8_t slot, const uint8_t* rows) {
+    (void)slot;
+    (void)rows;
+    send((1 + LcdFrameBuffer::GLYPH_ROWS) * BYTES_PER_WRITE);
+}
+
+uint32_t HostLcdSink::getBusBytes() const {
+    return busBytes;
+}
+
+const char* HostLcdSink::getRow(uint8_t index, char* out, size_t size) const {
+    if (size == 0) return out;
+    size_t length = 0;
+    if (index < LCD_ROWS) {
+        for (; length < LCD_COLUMNS && length + 1 < size; length++) {
+            uint8_t c = cells[index][length];
+            out[length] = c < LcdFrameBuffer::GLYPH_SLOTS ? '#' : (c < 0x20 || c > 0x7E ? '?' : (char)c);
+        }
+    }
+    out[length] = '\0';
+    return out;
+}
+
+void HostLcdSink::print(FILE* out) const {
+    char text[LCD_COLUMNS + 1];
+    fprintf(out, "+%.*s+\n", LCD_COLUMNS, "--------------------------------");
+    for (uint8_t i = 0; i < LCD_ROWS; i++) {
+        fprintf(out, "|%s|\n", getRow(i, text, sizeof(text)));
+    }
+    fprintf(out, "+%.*s+\n", LCD_COLUMNS, "--------------------------------");
+}
@@ -0,0 +1,40 @@
+#ifndef HOSTLCDSINK_H
+#define HOSTLCDSINK_H
+/**
+ * @file HostLcdSink.h
+ * @brief LcdSink keeping the character grid of the display in RAM, so the
+ * simulator can print it and compare rows.
+ *
+ * Bus bytes are counted like I2cLcdSink sends them (4 expander bytes per
+ * character or command), so the LCD statistics match the device, and take
+ * their transfer time at LCD_I2C_CLOCK_HZ on the virtual clock.
+ */
+
+#include "LcdFrameBuffer.h"
+
+class HostLcdSink : public LcdSink {
+public:
+    HostLcdSink();
+
+    void begin() override;
+    void moveTo(uint8_t col, uint8_t row) override;
+    void writeChars(const uint8_t* data, uint8_t len) override;
+    void loadGlyph(uint8_t slot, const uint8_t* rows) override;
+    uint32_t getBusBytes() const override;
+
+    const char* getRow(uint8_t row, char* out, size_t size) const;  ///< Row text, custom glyphs shown as '#'
+    void print(FILE* out) const;                                     ///< Draw the display in a frame
+
+private:
+    static const uint8_t BYTES_PER_WRITE = 4;
+    static const uint32_t BITS_PER_BYTE = 9;   ///< 8 data bits and the acknowledge
+
+    void send(uint32_t bytes);
+
+    uint8_t cells[LCD_ROWS][LCD_COLUMNS];
+    uint8_t col;
+    uint8_t row;
+    uint32_t busBytes;
+};
+
+#endif // HOSTLCDSINK_H
@@ -0,0 +1,80 @@
+/**
+ * @file HostNetwork.cpp
+ * @brief Host stand-ins for the network side of the firmware.
+ *
+ * WiFiManager and AssetCatalog are not built for the host (no lwIP, no web
+ * server). The UI only reads the connection state, the signal strength,
+ * the access point state and Message, so those follow the state set with
+ * HostHal::setWiFi() and HostHal::setAccessPoint(); everything else does nothing.
+ */
+
+#include "WiFiManager.h"
+#include "HostHal.h"
+
+AssetCatalog::AssetCatalog(fs::FS* fs) : fs(fs), count(0), stats() {}
+
+WiFiManager::WiFiManager(ConfigManager* configManager)
+    : configManager(configManager), server(80), assets(&SPIFFS), isAPMode(false), apSSID(DEFAULT_AP_SSID),
+      apPassword(DEFAULT_AP_PASSWORD), state(WIFI_STATE_IDLE), connected(false), apFallback(false), failures(0),
+      attempts(0), retryAtUs(0), timer(nullptr), task(nullptr), events(nullptr), serverStarted(false), signalPercent(0xFF),
+      signalRssi(0), signalReadMs(0) {
+    portMUX_INITIALIZE(&lock);
+    Message[0] = '\0';
+}
+
+void WiFiManager::begin() {
+    attempts++;
+}
+
+void WiFiManager::setAPCredentials(const char* ssid, const char* password) {
+    apSSID = ssid;
+    apPassword = password;
+}
+
+/**
+ * @brief Same RSSI to percentage mapping as the device, read on every call.
+ */
+uint8_t WiFiManager::getSignalStrengthPercent() {
+    if (!isStillConnected()) {
+        return 0;
+    }
+    int rssi = WiFi.RSSI();
+    if (rssi <= -100) return 0;
+    if (rssi >= -50) return 100;
+    return 2 * (rssi + 100);
+}
+
+int8_t WiFiManager::getRssi() {
+    return isStillConnected() ? WiFi.RSSI() : 0;
+}
+
+bool WiFiManager::isStillConnected() {
+    connected = WiFi.status() == WL_CONNECTED;
+    state = connected ? WIFI_STATE_CONNECTED : WIFI_STATE_BACKOFF;
+    return connected;
+}
+
+WiFiState WiFiManager::getState() const {
+    return state;
+}
+
+bool WiFiManager::isApActive() const {
+    return HostHal::isAccessPointActive();
+}
+
+uint32_t WiFiManager::getAttemptCount() const {
+    return attempts;
+}
+
+bool WiFiManager::waitForConnection(uint32_t timeoutMs) {
+    (void)timeoutMs;
+    return isStillConnected();
+}
+
+AsyncWebServer& WiFiManager::getServer() {
+    return server;
+}
+
+AssetCatalog& WiFiManager::getAssets() {
+    return assets;
+}
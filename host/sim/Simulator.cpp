@@ -0,0 +1,281 @@
+#include "Simulator.h"
+#include "BootSequencer.h"
+#include "HostHal.h"
+#include "Metrics.h"
+
+static const char KEYMAP[ROW_NUM][COLUMN_NUM] = {
+    {'1', '2', '3'},
+    {'4', '5', '6'},
+    {'7', '8', '9'},
+    {'*', '0', '#'}
+};
+static const uint8_t ROW_PINS[ROW_NUM] = {KEYPAD_ROW_1_PIN, KEYPAD_ROW_2_PIN, KEYPAD_ROW_3_PIN, KEYPAD_ROW_4_PIN};
+static const uint8_t COL_PINS[COLUMN_NUM] = {KEYPAD_COL_1_PIN, KEYPAD_COL_2_PIN, KEYPAD_COL_3_PIN};
+
+/// Sectors whose trailers hold AUTH_KEY_A / AUTH_KEY_B on a provisioned card
+static const byte KEYED_SECTORS[] = {BALANCE_AUTH / 4, NUM012_AUTH / 4, NUM034_AUTH / 4};
+
+Simulator* Simulator::instance = nullptr;
+
+Simulator::Simulator()
+    : rfid(RFID_SDA_PIN, RFID_RST_PIN), lcdFrame(&lcdSink), configManager(nullptr), wifiManager(nullptr),
+      timeManager(nullptr), log(nullptr), buzz(nullptr), rfidManager(nullptr), screenManager(nullptr),
+      keypad(nullptr), cardCount(0) {
+    memset(names, 0, sizeof(names));
+}
+
+Simulator::~Simulator() {
+    if (instance == this) instance = nullptr;
+}
+
+/**
+ * @brief Builds the managers and runs the boot stages of setup().
+ *
+ * Tasks cannot be created on the host, so the stages run one after the
+ * other and every task body falls back to running from the UI loop.
+ */
+void Simulator::begin() {
+    instance = this;
+    prefs.begin(CONFIG_PARTITION, false);
+    Metrics.subscribe();
+
+    configManager = new ConfigManager(&prefs);
+    wifiManager = new WiFiManager(configManager);
+    timeManager = new TimeManager();
+    log = new LogManager();
+    buzz = new BuzzerManager(BUZZ_PIN);
+    rfidManager = new MRC522Manager(configManager, &rfid);
+    screenManager = new ScreenManager(configManager, wifiManager, log, rfidManager, &lcdFrame, buzz);
+    keypad = new KeypadScanner(screenManager->getEventQueue());
+
+    BootSequencer boot;
+    boot.addStage("config", []() { instance->configManager->begin(); });
+    boot.addStage("lcd", []() {
+        instance->screenManager->begin();
+        instance->lcdFrame.startTask();
+    }, BOOT_PARALLEL);
+    boot.addStage("rfid", []() {
+        instance->rfid.PCD_Init();
+        instance->rfidManager->begin();
+        instance->screenManager->getCardPoller().start();
+    }, BOOT_PARALLEL);
+    boot.addStage("spiffs", []() {
+        instance->log->begin();
+        instance->log->startTask();
+    }, BOOT_PARALLEL);
+    boot.addStage("buzzer", []() { instance->buzz->begin(); }, BOOT_PARALLEL);
+    boot.addStage("keypad", []() { instance->keypad->begin(); }, BOOT_PARALLEL);
+    boot.addStage("wifi", []() {
+        instance->wifiManager->begin();
+        instance->timeManager->initialize();
+        instance->timeManager->updateTime();
+    }, BOOT_BACKGROUND);
+    boot.run();
+    boot.printReport();
+
+    screenManager->lock(false);
+    wait(UI_POLL_INTERVAL_MS);
+}
+
+/**
+ * @brief Runs the UI loop, like the UI task, until ms of virtual time passed.
+ */
+void Simulator::wait(uint32_t ms) {
+    int64_t endUs = HostHal::now() + (int64_t)ms * 1000;
+    while (HostHal::now() < endUs) {
+        step(endUs);
+    }
+}
+
+void Simulator::step(int64_t endUs) {
+    int64_t before = HostHal::now();
+    uint32_t leftMs = endUs > before ? (uint32_t)((endUs - before + 999) / 1000) : 1;
+    screenManager->poll(leftMs < UI_POLL_INTERVAL_MS ? leftMs : UI_POLL_INTERVAL_MS);
+    if (HostHal::now() == before) {
+        // Only events were handled: time goes on like on the device
+        HostHal::advance(1000);
+    }
+}
+
+bool Simulator::keyPins(char key, uint8_t& rowPin, uint8_t& colPin) const {
+    for (uint8_t r = 0; r < ROW_NUM; r++) {
+        for (uint8_t c = 0; c < COLUMN_NUM; c++) {
+            if (KEYMAP[r][c] == key) {
+                rowPin = ROW_PINS[r];
+                colPin = COL_PINS[c];
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Closes the row/column switch of a key for holdMs, then releases it
+ * for the same time, so the scanner sees one debounced press.
+ */
+void Simulator::pressKey(char key, uint32_t holdMs) {
+    setKey(key, true);
+    wait(holdMs);
+    setKey(key, false);
+    wait(KEY_HOLD_MS);
+}
+
+void Simulator::setKey(char key, bool pressed) {
+    uint8_t rowPin;
+    uint8_t colPin;
+    if (keyPins(key, rowPin, colPin)) HostHal::setSwitch(rowPin, colPin, pressed);
+}
+
+/**
+ * @brief Defines a provisioned 1K card: firmware keys on sectors 9-11,
+ * everything else blank with transport keys.
+ */
+VirtualCard* Simulator::addCard(const char* name, const char* uid) {
+    VirtualCard* card = findCard(name);
+    if (card == nullptr) {
+        if (cardCount == MAX_CARDS) return nullptr;
+        card = &cards[cardCount];
+        strncpy(names[cardCount], name, NAME_LENGTH);
+        cardCount++;
+    }
+    *card = VirtualCard();
+    if (!card->parseUid(uid)) return nullptr;
+
+    static const byte keyA[6] = AUTH_KEY_A;
+    static const byte keyB[6] = AUTH_KEY_B;
+    for (byte sector : KEYED_SECTORS) {
+        card->setKeys(sector, keyA, keyB);
+    }
+    return card;
+}
+
+VirtualCard* Simulator::findCard(const char* name) {
+    for (uint8_t i = 0; i < cardCount; i++) {
+        if (strcmp(names[i], name) == 0) return &cards[i];
+    }
+    return nullptr;
+}
+
+void Simulator::tap(VirtualCard* card) {
+    rfid.placeCard(card);
+}
+
+bool Simulator::rowContains(uint8_t row, const char* text) {
+    char shown[LCD_COLUMNS + 1];
+    lcdSink.getRow(row, shown, sizeof(shown));
+    return row < LCD_ROWS && strstr(shown, text) != nullptr;
+}
+
+bool Simulator::expectRow(uint8_t row, const char* text) {
+    if (rowContains(row, text)) return true;
+    char shown[LCD_COLUMNS + 1];
+    lcdSink.getRow(row, shown, sizeof(shown));
+    fprintf(stderr, "expect: row %u is \"%s\", not containing \"%s\"\n", (unsigned)row, shown, text);
+    lcdSink.print(stderr);
+    return false;
+}
+
+void Simulator::printLog() {
+    File file = SPIFFS.open(LOGFILE_PATH, FILE_READ);
+    if (!file) {
+        printf("(no log file)\n");
+        return;
+    }
+    String text = file.readString();
+    printf("%s\n", text.c_str());
+}
+
+/**
+ * @brief Executes one script line.
+ *
+ * @return false on an unknown or malformed command or a failed expectation.
+ */
+bool Simulator::execute(const char* line) {
+    char command[16] = "";
+    char arg1[64] = "";
+    char arg2[64] = "";
+    int consumed = 0;
+    if (sscanf(line, " %15s%n", command, &consumed) != 1 || command[0] == '#') return true;
+    const char* rest = line + consumed;
+    while (*rest == ' ' || *rest == '\t') rest++;
+
+    if (strcmp(command, "wait") == 0) {
+        wait((uint32_t)strtoul(rest, nullptr, 10));
+    } else if (strcmp(command, "key") == 0) {
+        for (const char* key = rest; *key != '\0' && *key != '\n'; key++) {
+            if (*key != ' ') pressKey(*key);
+        }
+    } else if (strcmp(command, "hold") == 0) {
+        unsigned long ms = 0;
+        if (sscanf(rest, "%1s %lu", arg1, &ms) != 2) return false;
+        pressKey(arg1[0], (uint32_t)ms);
+    } else if (strcmp(command, "card") == 0) {
+        if (sscanf(rest, "%63s %63s", arg1, arg2) != 2) return false;
+        VirtualCard* card = addCard(arg1, arg2);
+        if (card == nullptr) return false;
+        const char* option = strstr(rest, "balance ");
+        if (option != nullptr) {
+            snprintf((char*)card->blocks[BALANCE_SECBLOC], 16, "%lu", strtoul(option + 8, nullptr, 10));
+        }
+        option = strstr(rest, "type ");
+        if (option != nullptr) {
+            option += 5;
+            card->sak = strncmp(option, "4k", 2) == 0 ? 0x18
+                      : strncmp(option, "mini", 4) == 0 ? 0x09
+                      : strncmp(option, "ul", 2) == 0 ? 0x00 : 0x08;
+        }
+    } else if (strcmp(command, "tap") == 0) {
+        VirtualCard* card = findCard(rest);
+        if (card == nullptr) return false;
+        tap(card);
+    } else if (strcmp(command, "remove") == 0) {
+        tap(nullptr);
+    } else if (strcmp(command, "wifi") == 0) {
+        int rssi = -60;
+        sscanf(rest, "%63s %d", arg1, &rssi);
+        if (strcmp(arg1, "ap") == 0) {
+            sscanf(rest, "%*s %63s", arg2);
+            HostHal::setAccessPoint(strcmp(arg2, "off") != 0);
+        } else {
+            HostHal::setWiFi(strcmp(arg1, "off") != 0, (int8_t)rssi);
+        }
+    } else if (strcmp(command, "time") == 0) {
+        HostHal::setEpoch((uint32_t)strtoul(rest, nullptr, 10));
+    } else if (strcmp(command, "screen") == 0) {
+        lcdSink.print(stdout);
+    } else if (strcmp(command, "expect") == 0) {
+        char* text = nullptr;
+        unsigned long row = strtoul(rest, &text, 10);
+        while (*text == ' ') text++;
+        return expectRow((uint8_t)row, text);
+    } else if (strcmp(command, "block") == 0) {
+        unsigned long block = 0;
+        if (sscanf(rest, "%63s %lu", arg1, &block) != 2 || block >= VirtualCard::BLOCKS) return false;
+        VirtualCard* card = findCard(arg1);
+        if (card == nullptr) return false;
+        for (uint8_t i = 0; i < 16; i++) {
+            printf("%02x%s", card->blocks[block][i], i == 15 ? "\n" : " ");
+        }
+    } else if (strcmp(command, "log") == 0) {
+        printLog();
+    } else {
+        fprintf(stderr, "unknown command: %s\n", command);
+        return false;
+    }
+    return true;
+}
+
+bool Simulator::run(FILE* script, const char* name) {
+    char line[160];
+    uint32_t number = 0;
+    while (fgets(line, sizeof(line), script) != nullptr) {
+        number++;
+        line[strcspn(line, "\r\n")] = '\0';
+        if (!execute(line)) {
+            fprintf(stderr, "%s:%u: failed: %s\n", name, (unsigned)number, line);
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,99 @@
+#ifndef SIMULATOR_H
+#define SIMULATOR_H
+/**
+ * @file Simulator.h
+ * @brief Runs the firmware on the host and drives it from a script.
+ *
+ * The managers are built and booted like setup() does on the device, minus
+ * the network modules. The UI loop runs on the calling thread and only
+ * while the script waits, so every step is deterministic.
+ *
+ * Script commands, one per line ('#' starts a comment):
+ * - `card <name> <uid> [balance <n>] [type 1k|4k|mini|ul]` define a card;
+ *   sectors 9-11 get the firmware keys, the balance goes to block 37
+ * - `tap <name>` put a card on the reader, `remove` take it away
+ * - `key <keys>` press and release keys of the pad, e.g. `key 1#`
+ * - `hold <key> <ms>` keep a key pressed
+ * - `wait <ms>` let the firmware run
+ * - `wifi on [rssi]` / `wifi off`, `wifi ap on|off`, `time <epoch>` network state
+ *   seen by the firmware
+ * - `screen` print the display, `expect <row> <text>` fail unless the row contains text
+ * - `block <name> <n>` print a block of a card, `log` print the log file
+ */
+
+#include <Arduino.h>
+#include <MFRC522.h>
+#include <Preferences.h>
+#include "ConfigManager.h"
+#include "ScreenManager.h"
+#include "KeypadScanner.h"
+#include "HostLcdSink.h"
+#include "HostHal.h"
+
+class Simulator {
+public:
+    static const uint8_t MAX_CARDS = 16;
+    static const uint8_t NAME_LENGTH = 15;
+    static const uint32_t KEY_HOLD_MS = 60;     ///< Press and release time of `key`, above the debounce
+
+    Simulator();
+    ~Simulator();
+
+    void begin();                               ///< Boot the firmware
+    bool run(FILE* script, const char* name);   ///< Execute a script, false at the first failing line
+    bool execute(const char* line);             ///< Execute one command
+    void wait(uint32_t ms);                     ///< Run the UI loop for ms of virtual time
+    void pressKey(char key, uint32_t holdMs = KEY_HOLD_MS);
+    void setKey(char key, bool pressed);        ///< Close or open the switch of a key, without waiting
+    bool rowContains(uint8_t row, const char* text);
+
+    /**
+     * @brief Runs the UI loop until ready() holds, checked after every poll.
+     *
+     * @return false when timeoutMs of virtual time passed first.
+     */
+    template <typename Ready>
+    bool waitFor(Ready ready, uint32_t timeoutMs) {
+        int64_t endUs = HostHal::now() + (int64_t)timeoutMs * 1000;
+        while (!ready()) {
+            if (HostHal::now() >= endUs) return false;
+            step(endUs);
+        }
+        return true;
+    }
+    VirtualCard* addCard(const char* name, const char* uid);
+    VirtualCard* findCard(const char* name);
+    void tap(VirtualCard* card);                ///< nullptr removes the card
+
+    HostLcdSink& getDisplay() { return lcdSink; }
+    ScreenManager* getScreens() const { return screenManager; }
+    MRC522Manager* getReader() const { return rfidManager; }
+    ConfigManager* getConfig() const { return configManager; }
+
+private:
+    void step(int64_t endUs);                   ///< One poll of the UI loop, not past endUs
+    bool keyPins(char key, uint8_t& rowPin, uint8_t& colPin) const;
+    bool expectRow(uint8_t row, const char* text);
+    void printLog();
+
+    static Simulator* instance;   ///< For the boot stages, plain function pointers
+
+    Preferences prefs;
+    MFRC522 rfid;
+    HostLcdSink lcdSink;
+    LcdFrameBuffer lcdFrame;
+    ConfigManager* configManager;
+    WiFiManager* wifiManager;
+    TimeManager* timeManager;
+    LogManager* log;
+    BuzzerManager* buzz;
+    MRC522Manager* rfidManager;
+    ScreenManager* screenManager;
+    KeypadScanner* keypad;
+
+    VirtualCard cards[MAX_CARDS];
+    char names[MAX_CARDS][NAME_LENGTH + 1];
+    uint8_t cardCount;
+};
+
+#endif // SIMULATOR_H
@@ -0,0 +1,47 @@
+/**
+ * @file main.cpp
+ * @brief Host build entry point: boots the firmware in the simulator and
+ * runs a script from a file or stdin.
+ *
+ * Usage: program [-q] [-s <spiffs dir>] [script]
+ * - `-q` drops the firmware's Serial output
+ * - `-s` keeps the SPIFFS files in a directory instead of a fresh temporary one
+ *
+ * The exit code is 0 when every line of the script passed.
+ */
+
+#include <Arduino.h>
+#include "HostHal.h"
+#include "Simulator.h"
+
+#ifndef PIO_UNIT_TESTING  // The Unity tests bring their own main()
+
+static Simulator simulator;
+
+int main(int argc, char** argv) {
+    const char* scriptPath = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-q") == 0) {
+            HostHal::setSerialOutput(nullptr);
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            HostHal::setFilesystemRoot(argv[++i]);
+        } else {
+            scriptPath = argv[i];
+        }
+    }
+
+    FILE* script = scriptPath != nullptr ? fopen(scriptPath, "r") : stdin;
+    if (script == nullptr) {
+        fprintf(stderr, "cannot open %s\n", scriptPath);
+        return 2;
+    }
+
+    setenv("TZ", "UTC", 1);
+    simulator.begin();
+    bool passed = simulator.run(script, scriptPath != nullptr ? scriptPath : "stdin");
+    if (script != stdin) fclose(script);
+    Serial.flush();
+    return passed ? 0 : 1;
+}
+
+#endif // PIO_UNIT_TESTING
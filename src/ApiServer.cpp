@@ -0,0 +1,284 @@
+#include "ApiServer.h"
+#include <esp_timer.h>
+#include "ScreenManager.h"
+
+static const char JSON_TYPE[] = "application/json";
+
+/// Schema entries left out of /api/config: the Wi-Fi password, and the
+/// master card UID since anyone who knows it can clone the unlock card
+static const char* const HIDDEN_SETTINGS[] = {"WifiPass", "MasterCardId"};
+
+static bool isHiddenSetting(const char* name) {
+    for (size_t i = 0; i < sizeof(HIDDEN_SETTINGS) / sizeof(HIDDEN_SETTINGS[0]); i++) {
+        if (strcmp(name, HIDDEN_SETTINGS[i]) == 0) return true;
+    }
+    return false;
+}
+
+// --------------------------------------------------
+// JsonArena
+// --------------------------------------------------
+
+JsonArena::JsonArena() : used(0), last(0), peak(0) {}
+
+/**
+ * @brief Hands out the next block of the buffer.
+ *
+ * Each block is preceded by its size so reallocate() can copy it.
+ *
+ * @return nullptr when the arena is full; ArduinoJson then flags the
+ *         document as overflowed.
+ */
+void* JsonArena::allocate(size_t size) {
+    size_t header = (used + ALIGN - 1) & ~(ALIGN - 1);
+    size_t start = header + ALIGN;
+    if (start + size > sizeof(buffer)) return nullptr;
+
+    *reinterpret_cast<size_t*>(&buffer[header]) = size;
+    last = header;
+    used = start + size;
+    if (used > peak) peak = used;
+    return &buffer[start];
+}
+
+void JsonArena::deallocate(void* ptr) {
+    // Blocks are only released by reset()
+}
+
+void* JsonArena::reallocate(void* ptr, size_t newSize) {
+    if (ptr == nullptr) return allocate(newSize);
+
+    size_t start = static_cast<uint8_t*>(ptr) - buffer;
+    size_t header = start - ALIGN;
+    size_t size = *reinterpret_cast<size_t*>(&buffer[header]);
+
+    if (header == last) {
+        // Last block: grow or shrink in place
+        if (start + newSize > sizeof(buffer)) return nullptr;
+        *reinterpret_cast<size_t*>(&buffer[header]) = newSize;
+        used = start + newSize;
+        if (used > peak) peak = used;
+        return ptr;
+    }
+    if (newSize <= size) return ptr;
+
+    void* moved = allocate(newSize);
+    if (moved != nullptr) {
+        memcpy(moved, ptr, size);
+    }
+    return moved;
+}
+
+void JsonArena::reset() {
+    used = 0;
+    last = 0;
+}
+
+size_t JsonArena::getUsed() const {
+    return used;
+}
+
+size_t JsonArena::getPeak() const {
+    return peak;
+}
+
+// --------------------------------------------------
+// ApiServer
+// --------------------------------------------------
+
+/**
+ * @brief Constructor for the ApiServer class.
+ *
+ * @param configManager Source of the configuration and the device balance.
+ * @param wifiManager Source of the cached Wi-Fi state.
+ * @param screenManager Source of the lock state and the last recharge.
+ * @param logManager Source of the recent transactions.
+ */
+ApiServer::ApiServer(ConfigManager* configManager, WiFiManager* wifiManager, ScreenManager* screenManager,
+                     LogManager* logManager)
+    : configManager(configManager), wifiManager(wifiManager), screenManager(screenManager),
+      logManager(logManager) {
+    for (uint8_t i = 0; i < API_RESPONSE_SLOTS; i++) {
+        slots[i].busy = false;
+    }
+    memset(&stats, 0, sizeof(stats));
+    portMUX_INITIALIZE(&lock);
+}
+
+/**
+ * @brief Registers the API routes. Can be called before or after the server
+ *        is started.
+ *
+ * @param server The WiFiManager's web server.
+ */
+void ApiServer::begin(AsyncWebServer& server) {
+    server.on("/api/status", HTTP_GET, [this](AsyncWebServerRequest* request) { handleStatus(request); });
+    server.on("/api/balance", HTTP_GET, [this](AsyncWebServerRequest* request) { handleBalance(request); });
+    server.on("/api/transactions", HTTP_GET, [this](AsyncWebServerRequest* request) { handleTransactions(request); });
+    server.on("/api/config", HTTP_GET, [this](AsyncWebServerRequest* request) { handleConfig(request); });
+
+    if (DEBUGMODE) {
+        Serial.println("ApiServer: REST API routes registered");
+    }
+}
+
+ApiServer::Stats ApiServer::getStats() const {
+    Stats copy;
+    portENTER_CRITICAL(&lock);
+    copy = stats;
+    portEXIT_CRITICAL(&lock);
+    return copy;
+}
+
+void ApiServer::handleStatus(AsyncWebServerRequest* request) {
+    TRACE_SCOPE("api.status");
+    int64_t startUs = esp_timer_get_time();
+    arena.reset();
+    JsonDocument doc(&arena);
+
+    doc["deviceId"] = configManager->GetDeviceId();
+    doc["deviceName"] = configManager->GetDeviceName();
+    doc["uptimeMs"] = millis();
+    doc["locked"] = screenManager->isLocked();
+
+    JsonObject wifi = doc["wifi"].to<JsonObject>();
+    wifi["connected"] = wifiManager->isStillConnected();
+    wifi["signal"] = wifiManager->getSignalStrengthPercent();
+    wifi["apActive"] = wifiManager->isApActive();
+    wifi["attempts"] = wifiManager->getAttemptCount();
+
+    JsonObject heap = doc["heap"].to<JsonObject>();
+    heap["free"] = ESP.getFreeHeap();
+    heap["minFree"] = ESP.getMinFreeHeap();
+    heap["maxAlloc"] = ESP.getMaxAllocHeap();
+
+    send(request, doc, startUs);
+}
+
+void ApiServer::handleBalance(AsyncWebServerRequest* request) {
+    TRACE_SCOPE("api.balance");
+    int64_t startUs = esp_timer_get_time();
+    arena.reset();
+    JsonDocument doc(&arena);
+
+    doc["device"] = configManager->GetBalance();
+    doc["lastRecharge"] = screenManager->getLastRechargeAmount();
+
+    send(request, doc, startUs);
+}
+
+/**
+ * @brief Lists the transactions kept in RAM, oldest first.
+ *
+ * `next` is the sequence to pass as `?since=` on the next poll so only
+ * newer transactions are returned.
+ */
+void ApiServer::handleTransactions(AsyncWebServerRequest* request) {
+    TRACE_SCOPE("api.transactions");
+    int64_t startUs = esp_timer_get_time();
+    uint32_t since = 0;
+    if (request->hasParam("since")) {
+        since = (uint32_t)strtoul(request->getParam("since")->value().c_str(), nullptr, 10);
+    }
+    size_t count = logManager->getRecentRecords(records, LOG_RECENT_ENTRIES, since);
+
+    arena.reset();
+    JsonDocument doc(&arena);
+    doc["next"] = count > 0 ? records[count - 1].sequence : since;
+
+    JsonArray entries = doc["entries"].to<JsonArray>();
+    for (size_t i = 0; i < count; i++) {
+        const LogRecord& record = records[i];
+        JsonObject entry = entries.add<JsonObject>();
+        entry["seq"] = record.sequence;
+        entry["uptimeMs"] = record.uptimeMs;
+        entry["timestamp"] = record.timestamp;
+        entry["action"] = record.action;
+        entry["cardId"] = record.cardId;
+        entry["status"] = record.status;
+        if (record.amount > 0) entry["amount"] = record.amount;
+        if (record.balance > 0) entry["balance"] = record.balance;
+    }
+
+    send(request, doc, startUs);
+}
+
+/**
+ * @brief Lists the configuration schema values under their schema names.
+ */
+void ApiServer::handleConfig(AsyncWebServerRequest* request) {
+    TRACE_SCOPE("api.config");
+    int64_t startUs = esp_timer_get_time();
+    arena.reset();
+    JsonDocument doc(&arena);
+
+#define API_CONFIG_FIELD(name, key, type, def, lo, hi)                                      \
+    if (!isHiddenSetting(#name)) doc[#name] = configManager->Get##name();
+    CONFIG_SCHEMA(API_CONFIG_FIELD)
+#undef API_CONFIG_FIELD
+
+    send(request, doc, startUs);
+}
+
+/**
+ * @brief Serializes a document into a free slot and sends it.
+ *
+ * The slot is handed to the response without a copy and released when the
+ * connection closes.
+ */
+void ApiServer::send(AsyncWebServerRequest* request, const JsonDocument& doc, int64_t startUs) {
+    if (doc.overflowed() || measureJson(doc) >= API_RESPONSE_SIZE) {
+        portENTER_CRITICAL(&lock);
+        stats.overflows++;
+        portEXIT_CRITICAL(&lock);
+        request->send(500, JSON_TYPE, "{\"error\":\"response too large\"}");
+        return;
+    }
+
+    int8_t slot = acquireSlot();
+    if (slot < 0) {
+        portENTER_CRITICAL(&lock);
+        stats.busy++;
+        portEXIT_CRITICAL(&lock);
+        AsyncWebServerResponse* response = request->beginResponse(503, JSON_TYPE, "{\"error\":\"busy\"}");
+        response->addHeader("Retry-After", "1");
+        request->send(response);
+        return;
+    }
+
+    size_t length = serializeJson(doc, slots[slot].body, API_RESPONSE_SIZE);
+    AsyncWebServerResponse* response =
+        request->beginResponse_P(200, JSON_TYPE, reinterpret_cast<const uint8_t*>(slots[slot].body), length);
+    response->addHeader("Cache-Control", "no-store");
+    request->onDisconnect([this, slot]() { releaseSlot(slot); });
+    request->send(response);
+
+    uint32_t durationUs = (uint32_t)(esp_timer_get_time() - startUs);
+    portENTER_CRITICAL(&lock);
+    stats.requests++;
+    stats.lastBuildUs = durationUs;
+    if (durationUs > stats.maxBuildUs) {
+        stats.maxBuildUs = durationUs;
+    }
+    portEXIT_CRITICAL(&lock);
+}
+
+int8_t ApiServer::acquireSlot() {
+    int8_t found = -1;
+    portENTER_CRITICAL(&lock);
+    for (uint8_t i = 0; i < API_RESPONSE_SLOTS; i++) {
+        if (!slots[i].busy) {
+            slots[i].busy = true;
+            found = i;
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&lock);
+    return found;
+}
+
+void ApiServer::releaseSlot(int8_t slot) {
+    portENTER_CRITICAL(&lock);
+    slots[slot].busy = false;
+    portEXIT_CRITICAL(&lock);
+}
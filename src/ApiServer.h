@@ -0,0 +1,107 @@
+#ifndef APISERVER_H
+#define APISERVER_H
+/**
+ * @file ApiServer.h
+ * @brief JSON REST API of the device, served from RAM.
+ *
+ * Routes registered on the WiFiManager's AsyncWebServer:
+ * - `GET /api/status`       : identity, uptime, lock state, Wi-Fi and heap.
+ * - `GET /api/balance`      : device balance and last recharge amount.
+ * - `GET /api/transactions` : latest transactions, `?since=<seq>` returns only newer ones.
+ * - `GET /api/config`       : the configuration schema values, secrets left out.
+ *
+ * Every value comes from state that is already in RAM: the ConfigManager
+ * cache, the balance journal copy, the cached Wi-Fi state and the
+ * LogManager transaction ring. Handlers never touch SPIFFS, NVS or the RFID
+ * reader, so a request is answered in a few milliseconds.
+ *
+ * Documents are built with ArduinoJson in a static arena (`JsonArena`) and
+ * serialized into one of `API_RESPONSE_SLOTS` fixed buffers, which is sent
+ * as is and released when the connection closes. Serving a request does not
+ * allocate the JSON or its text on the heap; when all slots are in flight
+ * the request is answered with 503 and `Retry-After`.
+ */
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <ESPAsyncWebServer.h>
+#include <freertos/FreeRTOS.h>
+#include "Config.h"
+#include "ConfigManager.h"
+#include "WiFiManager.h"
+#include "LogManager.h"
+
+class ScreenManager;
+
+/**
+ * @class JsonArena
+ * @brief ArduinoJson allocator handing out memory from a fixed buffer.
+ *
+ * Allocation only moves a pointer; nothing is freed until `reset()`, called
+ * before each document is built. The last block can grow in place, which is
+ * how ArduinoJson grows strings and pools.
+ */
+class JsonArena : public ArduinoJson::Allocator {
+public:
+    JsonArena();
+
+    void* allocate(size_t size) override;
+    void deallocate(void* ptr) override;
+    void* reallocate(void* ptr, size_t newSize) override;
+
+    void reset();                    ///< Forget every block; no document may be alive
+    size_t getUsed() const;
+    size_t getPeak() const;          ///< Highest use since boot, to size API_JSON_ARENA_SIZE
+
+private:
+    static const size_t ALIGN = sizeof(void*);
+
+    alignas(8) uint8_t buffer[API_JSON_ARENA_SIZE];
+    size_t used;
+    size_t last;                     ///< Offset of the last block's header
+    size_t peak;
+};
+
+class ApiServer {
+public:
+    struct Stats {
+        uint32_t requests;     ///< Requests answered with 200
+        uint32_t busy;         ///< Requests refused because every slot was in flight
+        uint32_t overflows;    ///< Documents that did not fit the arena or a slot
+        uint32_t lastBuildUs;  ///< Time to build and serialize the last response
+        uint32_t maxBuildUs;
+    };
+
+    ApiServer(ConfigManager* configManager, WiFiManager* wifiManager, ScreenManager* screenManager,
+              LogManager* logManager);
+
+    void begin(AsyncWebServer& server);   ///< Register the /api routes
+    Stats getStats() const;
+
+private:
+    struct ResponseSlot {
+        char body[API_RESPONSE_SIZE];
+        volatile bool busy;
+    };
+
+    void handleStatus(AsyncWebServerRequest* request);
+    void handleBalance(AsyncWebServerRequest* request);
+    void handleTransactions(AsyncWebServerRequest* request);
+    void handleConfig(AsyncWebServerRequest* request);
+    void send(AsyncWebServerRequest* request, const JsonDocument& doc, int64_t startUs);
+    int8_t acquireSlot();
+    void releaseSlot(int8_t slot);
+
+    ConfigManager* configManager;
+    WiFiManager* wifiManager;
+    ScreenManager* screenManager;
+    LogManager* logManager;
+
+    JsonArena arena;                          ///< Handlers run one at a time on the web server task
+    ResponseSlot slots[API_RESPONSE_SLOTS];
+    LogRecord records[LOG_RECENT_ENTRIES];    ///< Snapshot of the transaction ring being serialized
+    Stats stats;
+    mutable portMUX_TYPE lock;                ///< Protects the slot flags and stats
+};
+
+#endif // APISERVER_H
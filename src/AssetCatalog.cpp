@@ -0,0 +1,147 @@
+#include "AssetCatalog.h"
+
+/**
+ * @brief Constructor for the AssetCatalog class.
+ *
+ * @param fs Filesystem holding the assets, mounted before begin().
+ */
+AssetCatalog::AssetCatalog(fs::FS* fs) : fs(fs), count(0) {
+    memset(&stats, 0, sizeof(stats));
+}
+
+/**
+ * @brief Reads the asset index written by the build step.
+ *
+ * Each line is "<path> <etag> <g|->". The build writes it sorted by path,
+ * which find() relies on.
+ *
+ * @return true if the index was loaded.
+ */
+bool AssetCatalog::begin() {
+    count = 0;
+    File index = fs->open(ASSET_INDEX_PATH, FILE_READ);
+    if (!index) {
+        if (DEBUGMODE) {
+            Serial.println("AssetCatalog: no asset index, serving files without ETag");
+        }
+        return false;
+    }
+
+    while (index.available() && count < ASSET_MAX_ENTRIES) {
+        String line = index.readStringUntil('\n');
+        char path[ASSET_PATH_MAX + 2];
+        char etag[ASSET_ETAG_LENGTH + 2];
+        char flag;
+        if (sscanf(line.c_str(), "%32s %17s %c", path, etag, &flag) != 3 || strlen(path) > ASSET_PATH_MAX ||
+            strlen(etag) != ASSET_ETAG_LENGTH) {
+            continue;
+        }
+        AssetEntry& entry = entries[count++];
+        strcpy(entry.path, path);
+        snprintf(entry.etag, sizeof(entry.etag), "\"%s\"", etag);
+        entry.gzipped = flag == 'g';
+    }
+    index.close();
+
+    if (DEBUGMODE) {
+        Serial.printf("AssetCatalog: %u assets indexed\n", (unsigned)count);
+    }
+    return true;
+}
+
+/**
+ * @brief Answers a request for an asset.
+ *
+ * @param request The incoming web request.
+ * @param path Asset path, e.g. "/welcome.html".
+ * @param cacheControl Cache-Control header value; "no-cache" makes browsers
+ *        revalidate with the ETag, which costs a 304 only.
+ */
+void AssetCatalog::send(AsyncWebServerRequest* request, const char* path, const char* cacheControl) {
+    const char* type = contentType(path);
+    const AssetEntry* asset = find(path);
+    if (asset == nullptr) {
+        if (count > 0) {
+            request->send(404, "text/plain", "Not found");
+        } else {
+            request->send(*fs, path, type);  // No index: the library looks for the file and its .gz
+        }
+        return;
+    }
+
+    if (request->hasHeader("If-None-Match") && request->header("If-None-Match") == asset->etag) {
+        AsyncWebServerResponse* response = request->beginResponse(304);
+        response->addHeader("ETag", asset->etag);
+        response->addHeader("Cache-Control", cacheControl);
+        request->send(response);
+        stats.notModified++;
+        return;
+    }
+
+    char stored[ASSET_PATH_MAX + 1];
+    snprintf(stored, sizeof(stored), asset->gzipped ? "%s.gz" : "%s", asset->path);
+    File file = fs->open(stored, FILE_READ);
+    if (!file) {
+        request->send(404, "text/plain", "Not found");
+        return;
+    }
+
+    // A .gz file served under its plain path gets Content-Encoding: gzip
+    AsyncWebServerResponse* response = request->beginResponse(file, asset->path, type);
+    response->addHeader("ETag", asset->etag);
+    response->addHeader("Cache-Control", cacheControl);
+    request->send(response);
+    stats.served++;
+}
+
+/**
+ * @brief Looks an asset up by path (binary search of the sorted index).
+ *
+ * @return The entry, nullptr if the path is not in the index.
+ */
+const AssetEntry* AssetCatalog::find(const char* path) const {
+    size_t low = 0;
+    size_t high = count;
+    while (low < high) {
+        size_t mid = (low + high) / 2;
+        int order = strcmp(entries[mid].path, path);
+        if (order == 0) return &entries[mid];
+        if (order < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return nullptr;
+}
+
+size_t AssetCatalog::getCount() const {
+    return count;
+}
+
+AssetCatalog::Stats AssetCatalog::getStats() const {
+    return stats;
+}
+
+const char* AssetCatalog::contentType(const char* path) {
+    static const struct {
+        const char* extension;
+        const char* type;
+    } TYPES[] = {
+        {".html", "text/html"},
+        {".css", "text/css"},
+        {".js", "application/javascript"},
+        {".json", "application/json"},
+        {".png", "image/png"},
+        {".svg", "image/svg+xml"},
+        {".ico", "image/x-icon"},
+    };
+
+    const char* dot = strrchr(path, '.');
+    if (dot != nullptr) {
+        for (size_t i = 0; i < sizeof(TYPES) / sizeof(TYPES[0]); i++) {
+            if (strcmp(dot, TYPES[i].extension) == 0) return TYPES[i].type;
+        }
+    }
+    return "text/plain";
+}
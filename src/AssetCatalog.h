@@ -0,0 +1,55 @@
+#ifndef ASSETCATALOG_H
+#define ASSETCATALOG_H
+/**
+ * @file AssetCatalog.h
+ * @brief Serves the web UI files prepared by test/build_assets.py.
+ *
+ * The build step minifies and gzips the text assets of data/ and lists every
+ * asset with a content hash in `/assets.idx`. The catalog reads that list
+ * once at boot; requests are then answered from RAM as far as possible:
+ * - a request carrying the current ETag in `If-None-Match` gets a 304
+ *   without touching the filesystem;
+ * - otherwise the stored file (the .gz for text assets) is opened once and
+ *   streamed with `Content-Encoding: gzip`, its strong ETag and the given
+ *   Cache-Control.
+ *
+ * Without an index (filesystem uploaded from the raw data/ folder) files are
+ * served as before, without ETag.
+ */
+
+#include <Arduino.h>
+#include <FS.h>
+#include <ESPAsyncWebServer.h>
+#include "Config.h"
+
+struct AssetEntry {
+    char path[ASSET_PATH_MAX + 1];      ///< Request path, without .gz
+    char etag[ASSET_ETAG_LENGTH + 3];   ///< Quoted hash, as sent in the header
+    bool gzipped;                       ///< Stored as path + ".gz"
+};
+
+class AssetCatalog {
+public:
+    struct Stats {
+        uint32_t served;        ///< 200 responses
+        uint32_t notModified;   ///< 304 responses
+    };
+
+    explicit AssetCatalog(fs::FS* fs);
+
+    bool begin();   ///< Load the index; false if it is missing (files are then served without ETag)
+    void send(AsyncWebServerRequest* request, const char* path, const char* cacheControl = "no-cache");
+    const AssetEntry* find(const char* path) const;
+    size_t getCount() const;
+    Stats getStats() const;
+
+private:
+    static const char* contentType(const char* path);
+
+    fs::FS* fs;
+    AssetEntry entries[ASSET_MAX_ENTRIES];   ///< Sorted by path
+    size_t count;
+    Stats stats;
+};
+
+#endif // ASSETCATALOG_H
@@ -0,0 +1,167 @@
+#include "BootSequencer.h"
+#include <esp_timer.h>
+
+/**
+ * @brief Constructor for the BootSequencer class.
+ */
+BootSequencer::BootSequencer() : stageCount(0), startTimeUs(0), bootTimeUs(0) {
+    groupDone = xSemaphoreCreateCounting(MAX_STAGES, 0);
+}
+
+/**
+ * @brief Destructor for the BootSequencer class.
+ *
+ * Background stages may still be running, so the semaphore is only deleted
+ * when no stage is left in flight.
+ */
+BootSequencer::~BootSequencer() {
+    for (uint8_t i = 0; i < stageCount; i++) {
+        if (stages[i].durationUs < 0) return;
+    }
+    vSemaphoreDelete(groupDone);
+}
+
+/**
+ * @brief Registers an initialization stage.
+ *
+ * @param name Stage name used in the report.
+ * @param fn Stage body.
+ * @param mode Scheduling mode of the stage.
+ * @return true if the stage was added, false if the table is full.
+ */
+bool BootSequencer::addStage(const char* name, BootStageFn fn, BootStageMode mode) {
+    if (stageCount >= MAX_STAGES) {
+        return false;
+    }
+    BootStage& stage = stages[stageCount++];
+    stage.name = name;
+    stage.fn = fn;
+    stage.mode = mode;
+    stage.startUs = 0;
+    stage.durationUs = -1;
+    stage.owner = this;
+    return true;
+}
+
+/**
+ * @brief Runs every registered stage.
+ *
+ * Sequential stages run inline. A run of consecutive parallel stages is
+ * launched at once and awaited as a group before the next sequential stage.
+ * Background stages are launched and left running.
+ */
+void BootSequencer::run() {
+    startTimeUs = esp_timer_get_time();
+
+    uint8_t i = 0;
+    while (i < stageCount) {
+        BootStage& stage = stages[i];
+
+        if (stage.mode == BOOT_SEQUENTIAL) {
+            runStage(stage);
+            i++;
+            continue;
+        }
+
+        if (stage.mode == BOOT_BACKGROUND) {
+            launchStage(stage);
+            i++;
+            continue;
+        }
+
+        // Launch the whole group of adjacent parallel stages, then wait for it
+        uint8_t groupSize = 0;
+        while (i < stageCount && stages[i].mode == BOOT_PARALLEL) {
+            launchStage(stages[i]);
+            groupSize++;
+            i++;
+        }
+        for (uint8_t done = 0; done < groupSize; done++) {
+            xSemaphoreTake(groupDone, portMAX_DELAY);
+        }
+    }
+
+    bootTimeUs = esp_timer_get_time() - startTimeUs;
+}
+
+/**
+ * @brief Prints the timing of every finished stage on Serial.
+ */
+void BootSequencer::printReport() {
+    if (!DEBUGMODE) return;
+
+    Serial.println("BootSequencer: stage timings (start / duration, ms)");
+    for (uint8_t i = 0; i < stageCount; i++) {
+        const BootStage& stage = stages[i];
+        if (stage.durationUs < 0) {
+            Serial.printf("  %-10s %8.1f / running%s\n", stage.name, stage.startUs / 1000.0,
+                          stage.mode == BOOT_BACKGROUND ? " (background)" : "");
+        } else {
+            Serial.printf("  %-10s %8.1f / %8.1f%s\n", stage.name, stage.startUs / 1000.0,
+                          stage.durationUs / 1000.0, stage.mode == BOOT_BACKGROUND ? " (background)" : "");
+        }
+    }
+    Serial.printf("BootSequencer: ready in %.1f ms\n", bootTimeUs / 1000.0);
+}
+
+uint8_t BootSequencer::getStageCount() const {
+    return stageCount;
+}
+
+const BootStage* BootSequencer::getStage(uint8_t index) const {
+    return index < stageCount ? &stages[index] : nullptr;
+}
+
+int64_t BootSequencer::getBootTimeUs() const {
+    return bootTimeUs;
+}
+
+/**
+ * @brief Executes one stage and records its start offset and duration.
+ *
+ * @param stage The stage to run.
+ */
+void BootSequencer::runStage(BootStage& stage) {
+    int64_t begin = esp_timer_get_time();
+    stage.startUs = begin - startTimeUs;
+    stage.fn();
+    stage.durationUs = esp_timer_get_time() - begin;
+    Trace.record(stage.name, begin, (uint32_t)stage.durationUs);
+}
+
+/**
+ * @brief Starts a stage on a dedicated FreeRTOS task.
+ *
+ * Falls back to running the stage inline if the task cannot be created.
+ *
+ * @param stage The stage to launch.
+ */
+void BootSequencer::launchStage(BootStage& stage) {
+    if (xTaskCreate(stageTask, stage.name, BOOT_STAGE_STACK_SIZE, &stage, BOOT_STAGE_PRIORITY, nullptr) != pdPASS) {
+        if (DEBUGMODE) {
+            Serial.printf("BootSequencer: no task for %s, running inline\n", stage.name);
+        }
+        runStage(stage);
+        if (stage.mode == BOOT_PARALLEL) {
+            xSemaphoreGive(groupDone);
+        }
+    }
+}
+
+/**
+ * @brief Task body for parallel and background stages.
+ *
+ * @param param Pointer to the BootStage to run.
+ */
+void BootSequencer::stageTask(void* param) {
+    BootStage* stage = static_cast<BootStage*>(param);
+    stage->owner->runStage(*stage);
+
+    if (stage->mode == BOOT_PARALLEL) {
+        xSemaphoreGive(stage->owner->groupDone);
+    } else if (DEBUGMODE) {
+        Serial.printf("BootSequencer: background stage %s done in %.1f ms\n", stage->name,
+                      stage->durationUs / 1000.0);
+    }
+    vTaskDelete(nullptr);
+}
@@ -0,0 +1,67 @@
+#ifndef BOOTSEQUENCER_H
+#define BOOTSEQUENCER_H
+/**
+ * @file BootSequencer.h
+ * @brief Runs the subsystem initialization stages and records their timings.
+ *
+ * Stages are registered in order with one of three modes:
+ * - `BOOT_SEQUENTIAL` : runs on the caller's task, after every previous stage.
+ * - `BOOT_PARALLEL`   : consecutive parallel stages run together, each on its own
+ *                       FreeRTOS task; the sequencer waits for the whole group.
+ * - `BOOT_BACKGROUND` : runs on its own task and is not waited for (e.g. WiFi connect).
+ *
+ * Each stage records its start offset and duration in microseconds from
+ * `esp_timer_get_time()`, so slow stages show up in the boot report.
+ */
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include "Config.h"
+#include "TraceBuffer.h"
+
+typedef void (*BootStageFn)();
+
+enum BootStageMode {
+    BOOT_SEQUENTIAL,   ///< Run inline, in order
+    BOOT_PARALLEL,     ///< Run concurrently with adjacent parallel stages
+    BOOT_BACKGROUND    ///< Run detached, boot does not wait for it
+};
+
+struct BootStage {
+    const char* name;          ///< Stage name shown in the report
+    BootStageFn fn;            ///< Stage body
+    BootStageMode mode;        ///< How the stage is scheduled
+    int64_t startUs;           ///< Start time relative to the sequencer start
+    int64_t durationUs;        ///< Stage duration, -1 while running
+    class BootSequencer* owner;  ///< Sequencer that launched the stage
+};
+
+class BootSequencer {
+public:
+    static const uint8_t MAX_STAGES = 12;   ///< Capacity of the stage table
+
+    BootSequencer();
+    ~BootSequencer();
+
+    bool addStage(const char* name, BootStageFn fn, BootStageMode mode = BOOT_SEQUENTIAL);
+    void run();                             ///< Execute every registered stage
+    void printReport();                     ///< Print per-stage timings on Serial
+
+    uint8_t getStageCount() const;
+    const BootStage* getStage(uint8_t index) const;
+    int64_t getBootTimeUs() const;          ///< Time from run() start to the last awaited stage
+
+private:
+    static void stageTask(void* param);     ///< FreeRTOS entry for parallel/background stages
+    void runStage(BootStage& stage);        ///< Time and execute one stage
+    void launchStage(BootStage& stage);     ///< Start a stage on its own task
+
+    BootStage stages[MAX_STAGES];
+    uint8_t stageCount;
+    int64_t startTimeUs;
+    int64_t bootTimeUs;
+    SemaphoreHandle_t groupDone;            ///< Given by each finished parallel stage
+};
+
+#endif // BOOTSEQUENCER_H
@@ -1,37 +1,249 @@
 #include "BuzzerManager.h"
 
+static const BuzzerNote successNotes[] = {
+    {1000, 50, 0},
+};
+static const BuzzerNote failureNotes[] = {
+    {500, 50, 110},
+    {500, 50, 110},
+    {500, 50, 0},
+};
+
+static const BuzzerPattern successPattern = {successNotes, 1, BUZZER_PRIORITY_NORMAL};
+static const BuzzerPattern failurePattern = {failureNotes, 3, BUZZER_PRIORITY_HIGH};
+
+/// Marker posted by stop()
+static const BuzzerPattern* const STOP_REQUEST = nullptr;
+
 /**
- * @brief Constructs a BuzzerManager object and initializes the buzzer pin.
+ * @brief Constructs a BuzzerManager object. The hardware is set up by begin().
  * @param pin The pin connected to the buzzer.
  */
-BuzzerManager::BuzzerManager(uint8_t pin) : _pin(pin) {}
+BuzzerManager::BuzzerManager(uint8_t pin)
+    : _pin(pin), timer(nullptr), pendingCount(0), current(nullptr), noteIndex(0), phase(PHASE_IDLE),
+      deadlineUs(0), playing(false) {
+    requests = xQueueCreate(BUZZER_QUEUE_LENGTH, sizeof(const BuzzerPattern*));
+    memset(&stats, 0, sizeof(stats));
+    portMUX_INITIALIZE(&lock);
+}
+
+BuzzerManager::~BuzzerManager() {
+    if (timer != nullptr) {
+        esp_timer_stop(timer);
+        esp_timer_delete(timer);
+    }
+    ledcDetachPin(_pin);
+    vQueueDelete(requests);
+}
 
 /**
- * @brief Initializes the buzzer by configuring the pin as output.
- *        Plays a short initialization tone to confirm setup.
+ * @brief Attaches the buzzer pin to its LEDC channel, silent, creates
+ *        the sequencing timer and subscribes to the transactions of the bus.
  */
 void BuzzerManager::begin() {
-    pinMode(_pin, OUTPUT); // Set the pin as output
-    tone(_pin, 0, 1);      // Short initialization tone (0 Hz, 1 ms)
-    noTone(_pin);          // Ensure the tone is stopped
+    ledcSetup(BUZZER_LEDC_CHANNEL, 1000, BUZZER_LEDC_RESOLUTION);
+    ledcAttachPin(_pin, BUZZER_LEDC_CHANNEL);
+    ledcWriteTone(BUZZER_LEDC_CHANNEL, 0);
+
+    esp_timer_create_args_t args = {};
+    args.callback = &BuzzerManager::onTimer;
+    args.arg = this;
+    args.dispatch_method = ESP_TIMER_TASK;
+    args.name = "buzzer";
+
+    if (esp_timer_create(&args, &timer) != ESP_OK) {
+        if (DEBUGMODE) {
+            Serial.println("BuzzerManager: failed to create the sequencing timer");
+        }
+        timer = nullptr;
+        return;
+    }
+    Bus.attach(SUBSCRIBER_BUZZER, onBusEvent, this);
+}
+
+/**
+ * @brief Queues a pattern and returns without waiting.
+ *
+ * The timer callback is woken at once to pick the request up, so a higher
+ * priority pattern preempts the current one without delay.
+ *
+ * @param pattern Pattern to play; must outlive its playback (use static tables).
+ * @return false if the buzzer is not initialized or the queue is full.
+ */
+bool BuzzerManager::play(const BuzzerPattern& pattern) {
+    const BuzzerPattern* request = &pattern;
+    if (timer == nullptr || pattern.count == 0) return false;
+
+    if (xQueueSend(requests, &request, 0) != pdTRUE) {
+        count(&Stats::dropped);
+        return false;
+    }
+    esp_timer_stop(timer);
+    esp_timer_start_once(timer, 0);
+    return true;
+}
+
+void BuzzerManager::stop() {
+    if (timer == nullptr) return;
+    xQueueReset(requests);
+    xQueueSend(requests, &STOP_REQUEST, 0);
+    esp_timer_stop(timer);
+    esp_timer_start_once(timer, 0);
+}
+
+bool BuzzerManager::isPlaying() const {
+    return playing;
+}
+
+BuzzerManager::Stats BuzzerManager::getStats() const {
+    BuzzerManager::Stats copy;
+    portENTER_CRITICAL(&lock);
+    copy = stats;
+    portEXIT_CRITICAL(&lock);
+    return copy;
 }
 
 /**
  * @brief Plays a short, high-pitched tone to indicate success.
  */
 void BuzzerManager::playSuccessTone() {
-    tone(_pin, 1000, 50);  // Play a 1000 Hz tone for 50 ms
-    noTone(_pin);          // Stop the tone
+    play(successPattern);
 }
 
 /**
- * @brief Plays a repeated, low-pitched tone to indicate failure.
- *        The tone plays three times with delays between each beep.
+ * @brief Plays three low-pitched beeps to indicate failure.
+ *        Takes over from any confirmation tone still playing.
  */
 void BuzzerManager::playFailureTone() {
-    for (int i = 0; i < 3; i++) {
-        tone(_pin, 500, 50); // Play a 500 Hz tone for 50 ms
-        noTone(_pin);        // Stop the tone
-        delay(110);          // Wait between tones
+    play(failurePattern);
+}
+
+void BuzzerManager::onTimer(void* arg) {
+    static_cast<BuzzerManager*>(arg)->step();
+}
+
+/**
+ * @brief Bus wake hook: runs the timer callback at once, which takes the
+ * transaction and plays its result tone.
+ */
+void BuzzerManager::onBusEvent(void* context) {
+    BuzzerManager* self = static_cast<BuzzerManager*>(context);
+    esp_timer_stop(self->timer);
+    esp_timer_start_once(self->timer, 0);
+}
+
+/**
+ * @brief Timer callback: applies new requests, then moves on to the next
+ * note, gap or pattern when the current one is over.
+ *
+ * Runs on the esp_timer task only; it is the single owner of the playback
+ * state. play() may wake it before the current note ends, in which case it
+ * just re-arms for the remaining time.
+ */
+void BuzzerManager::step() {
+    takeRequests();
+
+    int64_t now = esp_timer_get_time();
+    if (phase != PHASE_START && now < deadlineUs) {
+        arm(deadlineUs - now);
+        return;
+    }
+
+    if (phase == PHASE_NOTE && current->notes[noteIndex].gapMs > 0) {
+        phase = PHASE_GAP;
+        ledcWriteTone(BUZZER_LEDC_CHANNEL, 0);
+        deadlineUs = now + current->notes[noteIndex].gapMs * 1000LL;
+        arm(deadlineUs - now);
+        return;
+    }
+    if (phase == PHASE_NOTE || phase == PHASE_GAP) {
+        if (++noteIndex < current->count) {
+            phase = PHASE_START;
+        } else {
+            current = nullptr;
+            phase = PHASE_IDLE;
+        }
+    }
+
+    if (current == nullptr && pendingCount > 0) {
+        // Highest priority first, oldest first within a priority
+        uint8_t best = 0;
+        for (uint8_t i = 1; i < pendingCount; i++) {
+            if (pending[i]->priority > pending[best]->priority) {
+                best = i;
+            }
+        }
+        const BuzzerPattern* next = pending[best];
+        memmove(&pending[best], &pending[best + 1], (pendingCount - best - 1) * sizeof(pending[0]));
+        pendingCount--;
+        startPattern(next);
     }
+
+    if (current == nullptr) {
+        ledcWriteTone(BUZZER_LEDC_CHANNEL, 0);
+        playing = false;
+        return;
+    }
+
+    const BuzzerNote& note = current->notes[noteIndex];
+    ledcWriteTone(BUZZER_LEDC_CHANNEL, note.frequency);
+    phase = PHASE_NOTE;
+    deadlineUs = now + note.durationMs * 1000LL;
+    arm(deadlineUs - now);
+}
+
+/**
+ * @brief Moves the patterns posted by play(), and the result tones of the
+ * transactions published on the bus, into the pending list.
+ */
+void BuzzerManager::takeRequests() {
+    const BuzzerPattern* request;
+    while (xQueueReceive(requests, &request, 0) == pdTRUE) {
+        if (request == STOP_REQUEST) {
+            pendingCount = 0;
+            current = nullptr;
+            phase = PHASE_IDLE;
+            continue;
+        }
+        accept(request);
+    }
+
+    BusEvent event;
+    while (Bus.receive(SUBSCRIBER_BUZZER, event)) {
+        accept(event.success ? &successPattern : &failurePattern);
+    }
+}
+
+/**
+ * @brief Queues a pattern, preempting the current one if it has a higher
+ * priority.
+ */
+void BuzzerManager::accept(const BuzzerPattern* request) {
+    if (current != nullptr && request->priority > current->priority) {
+        count(&Stats::preempted);
+        startPattern(request);
+    } else if (pendingCount < BUZZER_QUEUE_LENGTH) {
+        pending[pendingCount++] = request;
+    } else {
+        count(&Stats::dropped);
+    }
+}
+
+void BuzzerManager::startPattern(const BuzzerPattern* pattern) {
+    current = pattern;
+    noteIndex = 0;
+    phase = PHASE_START;
+    playing = true;
+    count(&Stats::played);
+}
+
+void BuzzerManager::arm(int64_t delayUs) {
+    // Fails only if play() re-armed the timer meanwhile; that run takes over
+    esp_timer_start_once(timer, delayUs > 0 ? delayUs : 0);
+}
+
+void BuzzerManager::count(uint32_t Stats::*counter) {
+    portENTER_CRITICAL(&lock);
+    stats.*counter += 1;
+    portEXIT_CRITICAL(&lock);
 }
@@ -1,17 +1,100 @@
 #ifndef BUZZERMANAGER_H
 #define BUZZERMANAGER_H
+/**
+ * @file BuzzerManager.h
+ * @brief Non-blocking buzzer sequencer on the LEDC peripheral.
+ *
+ * Sounds are patterns of notes (frequency, duration, gap). `play()` queues a
+ * pattern and returns immediately; the LEDC channel generates the square wave
+ * in hardware and a one-shot esp_timer steps from note to note, so no task
+ * ever waits on the buzzer.
+ *
+ * Patterns carry a priority. A pattern of higher priority than the one
+ * playing cuts it off and starts at once; otherwise it waits in the queue and
+ * the highest priority waiting pattern plays next (first come, first served
+ * within a priority). When the queue is full the new pattern is dropped.
+ *
+ * The buzzer also subscribes to the transactions of the EventBus and plays
+ * the success or failure tone of each one; the timer callback takes them
+ * from the bus.
+ */
 
-#include "ConfigManager.h"
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include "Config.h"
+#include "EventBus.h"
+
+enum BuzzerPriority : uint8_t {
+    BUZZER_PRIORITY_LOW,       ///< Feedback that may be skipped (key clicks)
+    BUZZER_PRIORITY_NORMAL,    ///< Confirmations
+    BUZZER_PRIORITY_HIGH       ///< Errors and alarms
+};
+
+struct BuzzerNote {
+    uint16_t frequency;        ///< Hz, 0 for a rest
+    uint16_t durationMs;       ///< Time the note sounds
+    uint16_t gapMs;            ///< Silence after the note
+};
+
+struct BuzzerPattern {
+    const BuzzerNote* notes;
+    uint8_t count;
+    BuzzerPriority priority;
+};
 
 class BuzzerManager {
 public:
+    struct Stats {
+        uint32_t played;       ///< Patterns started
+        uint32_t preempted;    ///< Patterns cut off by a higher priority one
+        uint32_t dropped;      ///< Patterns lost because the queue was full
+    };
+
     BuzzerManager(uint8_t pin);
+    ~BuzzerManager();
     void begin();
+    bool play(const BuzzerPattern& pattern);   ///< Queue a pattern, false if it was dropped
+    void stop();                               ///< Silence the buzzer and forget the queue
+    bool isPlaying() const;
+    Stats getStats() const;
+
     void playSuccessTone();
     void playFailureTone();
 
 private:
+    enum Phase : uint8_t {
+        PHASE_IDLE,    ///< Nothing playing
+        PHASE_START,   ///< Note noteIndex is to be sounded now
+        PHASE_NOTE,    ///< Note sounding until deadlineUs
+        PHASE_GAP      ///< Silence after the note until deadlineUs
+    };
+
+    static void onTimer(void* arg);
+    static void onBusEvent(void* context);
+    void step();
+    void takeRequests();
+    void accept(const BuzzerPattern* request);
+    void startPattern(const BuzzerPattern* pattern);
+    void arm(int64_t delayUs);
+    void count(uint32_t Stats::*counter);
+
     uint8_t _pin;
+    esp_timer_handle_t timer;
+    QueueHandle_t requests;                            ///< Patterns posted by play(), read by the timer
+
+    // Owned by the timer callback
+    const BuzzerPattern* pending[BUZZER_QUEUE_LENGTH]; ///< Waiting patterns, in arrival order
+    uint8_t pendingCount;
+    const BuzzerPattern* current;                      ///< Pattern playing, nullptr when idle
+    uint8_t noteIndex;
+    Phase phase;
+    int64_t deadlineUs;                                ///< End of the note or gap in progress
+    volatile bool playing;
+
+    Stats stats;
+    mutable portMUX_TYPE lock;                         ///< Protects stats for readers on other tasks
 };
 
 #endif // BUZZERMANAGER_H
@@ -0,0 +1,137 @@
+#include "CardPoller.h"
+#include "ScreenManager.h"
+
+/**
+ * @brief Constructor for the CardPoller class.
+ *
+ * @param ui Queue the card events are posted to.
+ * @param rfid The card reader.
+ */
+CardPoller::CardPoller(ScreenManager* ui, MRC522Manager* rfid)
+    : ui(ui), rfid(rfid), task(nullptr), mode(UI_CARD_NONE), armed(false), generation(0),
+      lastPollMs(0) {
+    portMUX_INITIALIZE(&lock);
+}
+
+/**
+ * @brief Starts the RFID reader task; from then on the UI loop no longer polls.
+ *
+ * @return true if the task is running.
+ */
+bool CardPoller::start() {
+    if (task != nullptr) return true;
+    if (!Tasks.start(TASK_RFID, taskEntry, this, &task)) {
+        task = nullptr;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Sets what to poll for and re-arms the poller.
+ *
+ * Called by the UI on every navigation and after it handled a card event.
+ *
+ * @param newMode Card mode of the screen now on top.
+ */
+void CardPoller::setMode(UiCardMode newMode) {
+    portENTER_CRITICAL(&lock);
+    mode = newMode;
+    armed = true;
+    generation++;
+    portEXIT_CRITICAL(&lock);
+
+    if (task != nullptr) {
+        xTaskNotifyGive(task);
+    }
+}
+
+UiCardMode CardPoller::getArmedMode(uint32_t& current) const {
+    portENTER_CRITICAL(&lock);
+    UiCardMode armedMode = armed ? mode : UI_CARD_NONE;
+    current = generation;
+    portEXIT_CRITICAL(&lock);
+    return armedMode;
+}
+
+/**
+ * @brief Stops polling until the next setMode(), unless one came in since
+ * the poll that posted the event started. An event lost on a full queue
+ * does not disarm, polling goes on.
+ */
+void CardPoller::disarm(uint32_t pollGeneration) {
+    portENTER_CRITICAL(&lock);
+    if (generation == pollGeneration) {
+        armed = false;
+    }
+    portEXIT_CRITICAL(&lock);
+}
+
+void CardPoller::taskEntry(void* param) {
+    static_cast<CardPoller*>(param)->run();
+}
+
+/**
+ * @brief RFID task body: sleeps while disarmed, otherwise polls at the
+ * period of the current mode. setMode() wakes it early.
+ */
+void CardPoller::run() {
+    while (true) {
+        uint32_t current;
+        UiCardMode armedMode = getArmedMode(current);
+        if (armedMode == UI_CARD_NONE) {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            continue;
+        }
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(armedMode == UI_CARD_TAP ? UI_CARD_POLL_MS : UI_CARD_PRESENCE_MS));
+
+        TaskWork work(TASK_RFID);
+        poll(millis());
+    }
+}
+
+/**
+ * @brief Polls the reader once if the period of the current mode elapsed.
+ *
+ * The reader is held for the whole exchange, so a screen reading the card
+ * on the UI task waits for the poll to finish and the other way round.
+ *
+ * @param now Current millis().
+ */
+void CardPoller::poll(uint32_t now) {
+    uint32_t current;
+    UiCardMode armedMode = getArmedMode(current);
+    uint32_t period = armedMode == UI_CARD_TAP ? UI_CARD_POLL_MS : UI_CARD_PRESENCE_MS;
+    if (armedMode == UI_CARD_NONE || now - lastPollMs < period) {
+        return;
+    }
+    lastPollMs = now;
+
+    rfid->acquire();
+    if (armedMode == UI_CARD_TAP) {
+        uint8_t status = rfid->IsMasterCard();
+        // 3: no card, 4/5: unreadable or unsupported card, ignored like before
+        if (status == 0 || status == 1 || status == 6 || status == 7) {
+            BusEvent tap = {TOPIC_CARD, 0, status, true, 0, 0, now};
+            rfid->getLastUID(tap.cardId, sizeof(tap.cardId));
+            rfid->release();
+
+            Bus.publish(tap);
+            if (ui->post({UI_EVENT_CARD, status, now})) {
+                disarm(current);
+            }
+            return;
+        }
+    } else {
+        rfid->resetRFID();
+        if (!rfid->IsCardDetected()) {
+            rfid->release();
+
+            if (ui->post({UI_EVENT_CARD_REMOVED, 0, now})) {
+                disarm(current);
+            }
+            return;
+        }
+    }
+    rfid->release();
+}
@@ -0,0 +1,59 @@
+#ifndef CARDPOLLER_H
+#define CARDPOLLER_H
+/**
+ * @file CardPoller.h
+ * @brief RFID reader task: polls the card reader as the top screen asks and queues UI events.
+ *
+ * The UI task tells the poller what the screen on top expects with
+ * setMode(): new card taps (UI_CARD_TAP, every `UI_CARD_POLL_MS`), the
+ * session card staying on the reader (UI_CARD_PRESENCE, every
+ * `UI_CARD_PRESENCE_MS`) or nothing. The poller talks to the reader on its
+ * own task, so the SPI exchanges never hold up key handling or drawing, and
+ * posts UI_EVENT_CARD / UI_EVENT_CARD_REMOVED to the UI queue. Accepted taps
+ * are also published on the card topic of the EventBus.
+ *
+ * After posting an event the poller disarms until the UI has handled it and
+ * calls setMode() again, so a card is never reported twice to a screen that
+ * is still busy with the first tap.
+ *
+ * Before start(), or if the task could not be created, the UI loop calls
+ * poll() itself.
+ */
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "Config.h"
+#include "UiEvent.h"
+#include "MRC522Manager.h"
+#include "EventBus.h"
+#include "TaskTopology.h"
+
+class ScreenManager;
+
+class CardPoller {
+public:
+    CardPoller(ScreenManager* ui, MRC522Manager* rfid);
+
+    bool start();                     ///< Start the RFID reader task
+    bool isRunning() const { return task != nullptr; }
+    void setMode(UiCardMode mode);    ///< Poll for this screen's needs, re-arms the poller
+    void poll(uint32_t now);          ///< One poll if due; called by the task, or by the UI loop when there is none
+
+private:
+    static void taskEntry(void* param);
+    void run();
+    UiCardMode getArmedMode(uint32_t& generation) const;
+    void disarm(uint32_t generation);
+
+    ScreenManager* ui;
+    MRC522Manager* rfid;
+    TaskHandle_t task;
+    UiCardMode mode;
+    bool armed;
+    uint32_t generation;              ///< Bumped by setMode(), a poll started before it does not disarm
+    uint32_t lastPollMs;
+    mutable portMUX_TYPE lock;        ///< Protects mode, armed and generation, set by the UI task
+};
+
+#endif // CARDPOLLER_H
@@ -1,7 +1,7 @@
 #ifndef CONFIG_H
 #define CONFIG_H
 
-#include <ArduinoJson.h>
+#include <Arduino.h>
 #include <esp_task_wdt.h>
 
 // ==================================================
@@ -39,8 +39,10 @@
 #define DEBUGMODE 1                                        ///< Set to 1 to enable debug output, 0 to disable
 #define SERIAL_BAUD_RATE 115200                            ///< Baud rate for serial communication
 #define CONFIG_PARTITION "config"                          ///< Partition for configuration storage
+#define COUNTER_PARTITION "counter"                        ///< Raw data partition holding the balance journal
 
 #define LOCK_TIMEOUT 60000                                 ///< Lock timeout duration in milliseconds
+#define LOCK_TIMEOUT_KEY "LCKTO"                           ///< Identifier for the lock timeout in device storage
 
 // ==================================================
 // AUTHENTICATION SECTORS & BLOCKS
@@ -105,11 +107,19 @@ extern byte customKey[6];     ///< Secure key used for authentication in product
 #define LAST_KEYPRESS_DELAY 400   ///< Delay after the last keypress (in milliseconds)
 #define OUT_DELAY 1000            ///< Delay for output (in milliseconds)
 
+#define KEYPAD_SCAN_PERIOD_MS 5     ///< Matrix scan period of the keypad timer
+#define KEYPAD_DEBOUNCE_MS 20       ///< Time a key must be stable before a press/release is reported
+#define KEYPAD_LONG_PRESS_MS 800    ///< Hold time reported as a long press
+
 // ==================================================
 // LCD I2C Display Configuration
 // ==================================================
 #define SDA_PIN 21  ///< Custom SDA pin for I2C communication
 #define SCL_PIN 22  ///< Custom SCL pin for I2C communication
+#define LCD_I2C_ADDRESS 0x27  ///< PCF8574 backpack address
+#define LCD_COLUMNS 20        ///< Characters per LCD line
+#define LCD_ROWS 4            ///< Number of LCD lines
+#define LCD_I2C_CLOCK_HZ 100000  ///< I2C standard mode, the PCF8574's rated maximum
 
 // ==================================================
 // LED Pin Configuration
@@ -125,6 +135,138 @@ extern byte customKey[6];     ///< Secure key used for authentication in product
 // BUZZER Pin Configuration
 // ==================================================
 #define BUZZ_PIN 12  ///< BUZZER pin for sound notifications
+#define BUZZER_LEDC_CHANNEL 0       ///< LEDC channel generating the buzzer square wave
+#define BUZZER_LEDC_RESOLUTION 8    ///< LEDC duty resolution (bits) of the buzzer channel
+#define BUZZER_QUEUE_LENGTH 4       ///< Patterns waiting behind the one playing
+
+// ==================================================
+// Wi-Fi Connection Configuration
+// ==================================================
+#define WIFI_CONNECT_TIMEOUT_MS 10000   ///< Time an attempt may take to get an IP before it counts as failed
+#define WIFI_BACKOFF_MIN_MS 1000        ///< Delay before the first reconnection attempt
+#define WIFI_BACKOFF_MAX_MS 60000       ///< Cap of the doubling reconnection delay
+#define WIFI_AP_FALLBACK_FAILURES 3     ///< Failed attempts in a row before the setup AP is opened alongside the station
+#define WIFI_RSSI_REFRESH_MS 2000       ///< Age after which the cached signal strength is read again
+
+// ==================================================
+// REST API Configuration
+// ==================================================
+#define API_RESPONSE_SLOTS 3         ///< JSON responses being sent at once; more concurrent requests get a 503
+#define API_RESPONSE_SIZE 3072       ///< Largest JSON response body (bytes)
+#define API_JSON_ARENA_SIZE 4096     ///< Static arena the JSON documents are built in
+#define LOG_RECENT_ENTRIES 16        ///< Transactions kept in RAM for /api/transactions
+#define LOG_QUEUE_LENGTH 8           ///< Log entries waiting for the writer task before new ones are dropped
+#define LOG_ENTRY_SIZE 320           ///< Longest JSON text of one log file entry
+
+// ==================================================
+// Web Assets Configuration
+// ==================================================
+#define ASSET_INDEX_PATH "/assets.idx"    ///< Asset list written by test/build_assets.py
+#define ASSET_MAX_ENTRIES 40              ///< Assets the catalog can hold
+#define ASSET_PATH_MAX 31                 ///< Longest SPIFFS path
+#define ASSET_ETAG_LENGTH 16              ///< Hex digits of the content hash used as ETag
+
+// ==================================================
+// File Manager Configuration
+// ==================================================
+#define FILES_PAGE_DEFAULT 20        ///< Files per /list_recorded_files page when no limit is given
+#define FILES_PAGE_MAX 50            ///< Largest page a client may ask for
+#define FILES_ENTRY_SIZE 128         ///< Longest JSON text of one listed file
+#define FILES_MAX_DOWNLOADS 2        ///< Downloads running at once, each holds a SPIFFS file descriptor
+
+// ==================================================
+// Live Event Stream Configuration
+// ==================================================
+#define LIVE_QUEUE_LENGTH 16         ///< Events a client may lag behind before the oldest are dropped
+#define LIVE_EVENT_SIZE 160          ///< Longest JSON text of one event
+#define LIVE_MAX_CLIENTS 4           ///< SSE and WebSocket clients connected at once
+#define LIVE_KEEPALIVE_MS 15000      ///< Idle time after which an SSE ping event keeps the connections open
+#define LIVE_SSE_RETRY_MS 2000       ///< Reconnection delay announced to SSE clients
+#define LIVE_SSE_IN_FLIGHT 4         ///< SSE messages queued on a client before the rest wait in the ring
+
+// ==================================================
+// GPIO Manager Configuration
+// ==================================================
+#define GPIO_LED1_PIN 2              ///< "LED 1" output of gpiomanager.html (LED_GREEN_PIN/LED_RED_PIN are flash pins)
+#define GPIO_LED2_PIN 15             ///< "LED 2" output
+#define GPIO_BUTTON1_PIN 13          ///< "Button 1" input, to GND, internal pull-up
+#define GPIO_BUTTON2_PIN 17          ///< "Button 2" input, to GND, internal pull-up
+#define GPIO_DEBOUNCE_MS 30          ///< Settling time after an input edge before the pins are sampled
+#define GPIO_MAX_CLIENTS 3           ///< SSE clients of /gpio/events connected at once
+#define GPIO_KEEPALIVE_MS 15000      ///< Idle time after which an SSE ping event keeps the connections open
+#define GPIO_STATE_SIZE 96           ///< Longest JSON text of the pin state
+
+// ==================================================
+// Metrics Configuration
+// ==================================================
+#define METRICS_PREFIX "rfid_"       ///< Prefix of every exported metric name
+#define METRICS_AUTH_SECTORS 40      ///< Sectors counted for auth failures (MIFARE Classic 4K has 40)
+#define METRICS_LINE_SIZE 192        ///< Longest line of the /metrics text, rendered on the stack
+
+// ==================================================
+// Event Bus Configuration
+// ==================================================
+#define BUS_QUEUE_LENGTH 16          ///< Events a subscriber may lag behind before new ones are dropped for it (power of two)
+
+// ==================================================
+// Task Topology Configuration
+// ==================================================
+// Every application task, see TaskTopology.h. Core 0 runs the radio and the
+// network stack, so the tasks feeding the network (and the slow LCD and file
+// writes) go there; core 1 keeps the UI and the card reader responsive.
+#define UI_TASK_STACK_SIZE 8192      ///< Stack size (bytes) of the UI event loop task
+#define UI_TASK_PRIORITY 2           ///< FreeRTOS priority of the UI event loop task
+#define UI_TASK_CORE 1               ///< Core of the UI event loop task
+#define RFID_TASK_STACK_SIZE 4096    ///< Stack size (bytes) of the card reader polling task
+#define RFID_TASK_PRIORITY 3         ///< FreeRTOS priority of the card reader polling task, above the UI so taps are not missed
+#define RFID_TASK_CORE 1             ///< Core of the card reader polling task
+#define LOG_TASK_STACK_SIZE 6144     ///< Stack size (bytes) of the log file writer task
+#define LOG_TASK_PRIORITY 1          ///< FreeRTOS priority of the log file writer task
+#define LOG_TASK_CORE 0              ///< Core of the log file writer task
+#define LCD_TASK_STACK_SIZE 3072     ///< Stack size (bytes) of the LCD output task
+#define LCD_TASK_PRIORITY 1          ///< FreeRTOS priority of the LCD output task
+#define LCD_TASK_CORE 0              ///< Core running the LCD output task (the UI loop runs on core 1)
+#define LIVE_TASK_STACK_SIZE 3072    ///< Stack size (bytes) of the live stream sender task
+#define LIVE_TASK_PRIORITY 1         ///< FreeRTOS priority of the live stream sender task
+#define LIVE_TASK_CORE 0             ///< Core of the live stream sender task, next to the network stack
+#define GPIO_TASK_STACK_SIZE 2048    ///< Stack size (bytes) of the input debounce task
+#define GPIO_TASK_PRIORITY 2         ///< FreeRTOS priority of the input debounce task
+#define GPIO_TASK_CORE 0             ///< Core of the input debounce task
+#define NET_TASK_STACK_SIZE 4096     ///< Stack size (bytes) of the Wi-Fi connection task
+#define NET_TASK_PRIORITY 1          ///< FreeRTOS priority of the Wi-Fi connection task
+#define NET_TASK_CORE 0              ///< Core of the Wi-Fi connection task, next to the network stack
+#define CONSOLE_POLL_MS 50           ///< Serial console polling period of the Arduino loop
+
+// ==================================================
+// Boot Sequencer Configuration
+// ==================================================
+#define BOOT_STAGE_STACK_SIZE 6144   ///< Stack size (bytes) of parallel/background boot stage tasks
+#define BOOT_STAGE_PRIORITY 1        ///< FreeRTOS priority of boot stage tasks
+
+// ==================================================
+// UI Configuration
+// ==================================================
+#define UI_EVENT_QUEUE_LENGTH 16     ///< Pending keypad/card/network events
+#define UI_SCREEN_STACK_DEPTH 6      ///< Maximum number of stacked screens
+#define UI_POLL_INTERVAL_MS 10       ///< Longest wait for an event before timers and inputs are checked again
+#define UI_CARD_POLL_MS 50           ///< Card tap polling period on screens waiting for a card
+#define UI_CARD_PRESENCE_MS 500      ///< Card presence check period during a user card session
+#define UI_HOME_ROTATE_MS 5000       ///< Home page view rotation period
+#define UI_MESSAGE_MS 3000           ///< Time a result message stays on screen
+#define UI_PROMPT_MAX_LENGTH 10      ///< Maximum digits typed in a prompt
+#define MARQUEE_MAX_REGIONS 4        ///< Scrolling text regions active at once
+#define MARQUEE_TEXT_MAX 48          ///< Longest text of a scrolling region
+#define MARQUEE_STEP_MS 500          ///< Default time between one-character shifts
+#define MARQUEE_GAP 3                ///< Blanks between the end of a scrolling text and its restart
+#ifndef UI_LANGUAGE
+#define UI_LANGUAGE 0                ///< LCD text language, see Messages.h (0: English, 1: French); can be set with -DUI_LANGUAGE
+#endif
+
+// ==================================================
+// Trace Configuration
+// ==================================================
+#define TRACE_ENABLED 1              ///< Set to 1 to record TRACE_SCOPE timings, 0 to compile them out
+#define TRACE_BUFFER_SIZE 256        ///< Number of events kept in the trace ring buffer
 
 // ==================================================
 // End of Configuration
@@ -1,5 +1,6 @@
 
 #include "ConfigManager.h"
+#include "Metrics.h"
 
 
 /************************************************************************************************/
@@ -13,7 +14,8 @@
  * 
  * @param prefs Reference to the Preferences object.
  */
-ConfigManager::ConfigManager(Preferences* preferences) : preferences(preferences),namespaceName(CONFIG_PARTITION) {}
+ConfigManager::ConfigManager(Preferences* preferences) : preferences(preferences),namespaceName(CONFIG_PARTITION),
+    balanceFlash(COUNTER_PARTITION), balanceStore(&balanceFlash) {}
 
 /**
  * @brief Destructor for the ConfigManager class.
@@ -104,7 +106,8 @@ void ConfigManager::startPreferencesRead() {
  * and initializing various settings and configurations if necessary. 
  * It uses the Preferences library to store configuration data and
  * ensures that the system can either reset to default settings or
- * use existing configurations.
+ * use existing configurations. Defaults are written in place, so the
+ * first boot continues without a restart.
  */
 void ConfigManager::begin() {
     if (DEBUGMODE) {
@@ -112,6 +115,13 @@ void ConfigManager::begin() {
         Serial.println("#               Starting CONFIG Manager                   #");
         Serial.println("###########################################################");
     }
+
+    // Mount the balance journal, seeding it from the legacy NVS key on first use
+    if (!balanceFlash.begin() || !balanceStore.begin(preferences->getULong64(BALANCE, DEFAULT_BALANCE))) {
+        if (DEBUGMODE) {
+            Serial.println("ConfigManager: Balance journal unavailable, using NVS key.");
+        }
+    }
     
     bool resetFlag = GetBool(RESET_FLAG, true); // Default to true if not set; // Default to Reset flag true 
 
@@ -119,15 +129,12 @@ void ConfigManager::begin() {
         if (DEBUGMODE) {
             Serial.println("ConfigManager:System Initializing the device.");
         }
-        delay(100);
-        initializeDefaults();  // Reset preferences if the flag is set
-        RestartSysDelay(7000); 
+        initializeDefaults();  // Reset preferences and cache if the flag is set, then keep booting
     } else {
         if (DEBUGMODE) {
             Serial.println("ConfigManager:System Using existing configuration.");
         }
-        // end();
-        delay(300);
+        loadCache();  // Read every schema entry once
     }
 }
 
@@ -174,23 +181,70 @@ void ConfigManager::initializeDefaults() {
 /**
  * @brief Initializes all default variables.
  * 
- * This function sets the initial values for various boolean and string 
- * variables used by the ConfigManager. It includes settings for GPIO, 
- * Wi-Fi SSID, and password. Debug messages are printed if DEBUGMODE is enabled.
+ * This function writes the default value of every entry declared in
+ * ConfigSchema.h to the preferences and to the RAM cache. The reset flag
+ * default is false, so the device is not re-initialized on the next boot.
  */
 void ConfigManager::initializeVariables() {
-    // Assign default values to configuration variables
-    preferences->putBool(APWIFIMODE_FLAG, true); 
-    preferences->putString(WIFISSID, DEFAULT_WIFI_SSID);  // Default Wi-Fi SSID
-    preferences->putString(WIFIPASS, DEFAULT_WIFI_PASSWORD);  // Default Wi-Fi password
-    preferences->putBool(RESET_FLAG, false);  // Reset flag is set to false after initialization
-    preferences->putULong64(BALANCE,DEFAULT_BALANCE);// set balance of the system to 0
-    preferences->putString(DEVICE_NAME,DEFAULT_DEVICE_NAME);// Default balance name
-    preferences->putString(DEVICE_ID,DEFAULT_DEVICE_ID);
-    preferences->putString(DEV_MASTR_CARD_ID,DEFAULT_MASTR_CARD_ID);
-    preferences->putString(DEV_MANAGER_NAME,DEFAULT_DEV_MANAGER_NAME);
+#define CONFIG_DEFAULT_Bool(name, key, def)   cache.name = (def); preferences->putBool(key, cache.name);
+#define CONFIG_DEFAULT_UInt32(name, key, def) cache.name = (def); preferences->putUInt(key, cache.name);
+#define CONFIG_DEFAULT_String(name, key, def) strncpy(cache.name, def, sizeof(cache.name)); preferences->putString(key, cache.name);
+#define CONFIG_DEFAULT(name, key, type, def, lo, hi) CONFIG_DEFAULT_##type(name, key, def)
+    CONFIG_SCHEMA(CONFIG_DEFAULT)
+#undef CONFIG_DEFAULT
+    SetBalance(DEFAULT_BALANCE);// set balance of the system to its default
 }
 
+/**
+ * @brief Loads every schema entry from the preferences into the RAM cache.
+ * 
+ * Missing or out-of-bounds values are replaced by their schema default, so the
+ * typed getters never need to touch NVS.
+ */
+void ConfigManager::loadCache() {
+#define CONFIG_LOAD_Bool(name, key, def, lo, hi)                                        \
+    cache.name = preferences->getBool(key, def);
+#define CONFIG_LOAD_UInt32(name, key, def, lo, hi)                                      \
+    cache.name = preferences->getUInt(key, def);                                        \
+    if (cache.name < (lo) || cache.name > (hi)) cache.name = (def);
+#define CONFIG_LOAD_String(name, key, def, lo, hi)                                      \
+    if (!preferences->isKey(key) || preferences->getString(key, cache.name, sizeof(cache.name)) == 0 \
+        || strlen(cache.name) < (size_t)(lo)) {                                         \
+        strncpy(cache.name, def, sizeof(cache.name));                                   \
+    }
+#define CONFIG_LOAD(name, key, type, def, lo, hi) CONFIG_LOAD_##type(name, key, def, lo, hi)
+    CONFIG_SCHEMA(CONFIG_LOAD)
+#undef CONFIG_LOAD
+}
+
+// --------------------------------------------------
+// Typed setters generated from ConfigSchema.h
+// --------------------------------------------------
+#define CONFIG_SETTER_Bool(name, key, lo, hi)                                           \
+    bool ConfigManager::Set##name(bool value) {                                         \
+        cache.name = value;                                                             \
+        PutBool(key, value);                                                            \
+        return true;                                                                    \
+    }
+#define CONFIG_SETTER_UInt32(name, key, lo, hi)                                         \
+    bool ConfigManager::Set##name(uint32_t value) {                                     \
+        if (value < (lo) || value > (hi)) return false;                                 \
+        cache.name = value;                                                             \
+        PutUInt(key, value);                                                            \
+        return true;                                                                    \
+    }
+#define CONFIG_SETTER_String(name, key, lo, hi)                                         \
+    bool ConfigManager::Set##name(const char* value) {                                  \
+        size_t length = strlen(value);                                                  \
+        if (length < (size_t)(lo) || length > (size_t)(hi)) return false;               \
+        memcpy(cache.name, value, length + 1);                                          \
+        PutString(key, value);                                                          \
+        return true;                                                                    \
+    }
+#define CONFIG_SETTER(name, key, type, def, lo, hi) CONFIG_SETTER_##type(name, key, lo, hi)
+CONFIG_SCHEMA(CONFIG_SETTER)
+#undef CONFIG_SETTER
+
 /**
  * @brief Gets a boolean value from preferences.
  * 
@@ -227,18 +281,18 @@ int ConfigManager::GetInt(const char* key, int defaultValue) {
     return value;
 }
 /**
- * @brief Gets an integer value from preferences.
+ * @brief Gets an unsigned 64-bit integer value from preferences.
  * 
- * This function retrieves an integer value associated with the given key 
+ * This function retrieves an unsigned 64-bit value associated with the given key 
  * from the preferences. If the key does not exist, it returns the specified 
  * default value. The function also resets the watchdog timer to prevent 
  * unexpected resets.
  * 
  * @param key The key associated with the integer value.
  * @param defaultValue The default value to return if the key does not exist.
- * @return int The retrieved integer value or the default value.
+ * @return uint64_t The retrieved value or the default value.
  */
-uint64_t ConfigManager::GetULong64(const char* key, int defaultValue) {
+uint64_t ConfigManager::GetULong64(const char* key, uint64_t defaultValue) {
     esp_task_wdt_reset();
     uint64_t value = preferences->getULong64(key, defaultValue);
     return value;
@@ -294,6 +348,7 @@ void ConfigManager::PutBool(const char* key, bool value) {
     esp_task_wdt_reset();
     RemoveKey(key);
     preferences->putBool(key, value);  // Store the new value
+    Metrics.increment(METRIC_NVS_WRITES);
 }
 
 /**
@@ -306,26 +361,28 @@ void ConfigManager::PutBool(const char* key, bool value) {
  * @param key The key to associate with the unsigned integer value.
  * @param value The unsigned integer value to store.
  */
-void ConfigManager::PutUInt(const char* key, int value) {
+void ConfigManager::PutUInt(const char* key, uint32_t value) {
     esp_task_wdt_reset();
     RemoveKey(key);
     preferences->putUInt(key, value);  // Store the new value
+    Metrics.increment(METRIC_NVS_WRITES);
 }
 
 /**
- * @brief Puts an unsigned integer value into preferences.
+ * @brief Puts an unsigned 64-bit integer value into preferences.
  * 
- * This function stores an unsigned integer value associated with the given 
+ * This function stores an unsigned 64-bit value associated with the given 
  * key in the preferences. It also resets the watchdog timer to prevent 
  * unexpected resets.
  * 
  * @param key The key to associate with the unsigned integer value.
- * @param value The unsigned integer value to store.
+ * @param value The unsigned 64-bit value to store.
  */
-void ConfigManager::PutULong64(const char* key, int value) {
+void ConfigManager::PutULong64(const char* key, uint64_t value) {
     esp_task_wdt_reset();
     RemoveKey(key);
     preferences->putULong64(key, value);  // Store the new value
+    Metrics.increment(METRIC_NVS_WRITES);
 }
 
 /**
@@ -342,6 +399,7 @@ void ConfigManager::PutInt(const char* key, int value) {
     esp_task_wdt_reset();
     RemoveKey(key);
     preferences->putInt(key, value);  // Store the new value
+    Metrics.increment(METRIC_NVS_WRITES);
 }
 
 /**
@@ -358,6 +416,7 @@ void ConfigManager::PutFloat(const char* key, float value) {
     esp_task_wdt_reset();
     RemoveKey(key);
     preferences->putFloat(key, value);  // Store the new value
+    Metrics.increment(METRIC_NVS_WRITES);
 }
 
 /**
@@ -374,6 +433,7 @@ void ConfigManager::PutString(const char* key, const String& value) {
     esp_task_wdt_reset();
     RemoveKey(key);
     preferences->putString(key, value);  // Store the new value
+    Metrics.increment(METRIC_NVS_WRITES);
 }
 
 /**
@@ -414,32 +474,75 @@ void ConfigManager::RemoveKey(const char * key) {
 /**
  * @brief Sets the AP flag in the preferences.
  * 
- * This function removes the existing "strAP" key and sets it to 
- * true. It introduces a delay after updating the preferences.
+ * This function stores the AP flag as true through the typed
+ * schema setter.
  */
 void ConfigManager::SetAPFLag() {
-    RemoveKey(APWIFIMODE_FLAG);
-    preferences->putBool(APWIFIMODE_FLAG, true);
-    delay(100);
+    SetApMode(true);
 }
 
 /**
  * @brief Resets the AP flag in the preferences.
  * 
- * This function removes the existing "strAP" key and sets it to 
- * true. It introduces a delay after updating the preferences.
+ * This function stores the AP flag as false through the typed
+ * schema setter.
  */
 void ConfigManager::ResetAPFLag() {
-    RemoveKey(APWIFIMODE_FLAG);
-    preferences->putBool(APWIFIMODE_FLAG, false);
-    delay(100);
+    SetApMode(false);
 };
 
 /**
- * @brief Returns the AP flag in the preferences.
+ * @brief Returns the AP flag from the configuration cache.
  * 
  */
 bool ConfigManager::GetAPFLag() {
-    return preferences->getBool(APWIFIMODE_FLAG, true);
+    return GetApMode();
 }
 
+/**
+ * @brief Returns the device balance.
+ * 
+ * The value comes from the RAM copy of the balance journal. If the journal
+ * partition is missing (old partition table) it falls back to the NVS key.
+ * 
+ * @return uint64_t The current balance.
+ */
+uint64_t ConfigManager::GetBalance() {
+    if (balanceStore.isReady()) {
+        return static_cast<uint64_t>(balanceStore.getValue());
+    }
+    return GetULong64(BALANCE, 0);
+}
+
+/**
+ * @brief Applies a signed change to the device balance.
+ * 
+ * Each call appends one 16-byte record to the journal instead of rewriting
+ * the NVS entry.
+ * 
+ * @param delta The amount to add (negative to deduct).
+ * @return true if the change was persisted.
+ */
+bool ConfigManager::AdjustBalance(int64_t delta) {
+    esp_task_wdt_reset();
+    if (balanceStore.isReady()) {
+        return balanceStore.add(delta);
+    }
+    PutULong64(BALANCE, GetULong64(BALANCE, 0) + delta);
+    return true;
+}
+
+/**
+ * @brief Replaces the device balance with an absolute value.
+ * 
+ * @param value The new balance.
+ * @return true if the value was persisted.
+ */
+bool ConfigManager::SetBalance(uint64_t value) {
+    esp_task_wdt_reset();
+    if (balanceStore.isReady()) {
+        return balanceStore.reset(static_cast<int64_t>(value));
+    }
+    PutULong64(BALANCE, value);
+    return true;
+}
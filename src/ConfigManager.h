@@ -23,6 +23,8 @@
  */
 
 #include "Config.h"  // Include Config.h for default values
+#include "ConfigSchema.h"
+#include "CounterStore.h"
 #include <Preferences.h>
 #include <esp_task_wdt.h>
 #include <Arduino.h>
@@ -40,13 +42,13 @@ public:
     void PutInt(const char* key, int value);        // Save an integer value
     void PutFloat(const char* key, float value);    // Save a float value
     void PutString(const char* key, const String& value);  // Save a string value
-    void PutUInt(const char* key, int value);       // Save an unsigned integer value
-    void PutULong64(const char* key, int value);       // Save an unsigned integer value
+    void PutUInt(const char* key, uint32_t value);  // Save an unsigned integer value
+    void PutULong64(const char* key, uint64_t value);  // Save an unsigned 64-bit integer value
 
 
     bool GetBool(const char* key, bool defaultValue);    // Retrieve a boolean value
     int GetInt(const char* key, int defaultValue);       // Retrieve an integer value
-    uint64_t GetULong64(const char* key, int defaultValue);       // Retrieve an UIntinteger value
+    uint64_t GetULong64(const char* key, uint64_t defaultValue);  // Retrieve an unsigned 64-bit integer value
     float GetFloat(const char* key, float defaultValue); // Retrieve a float value
     String GetString(const char* key, const String& defaultValue);  // Retrieve a string value
 
@@ -65,14 +67,26 @@ public:
 
     void SetAPFLag();  // Set the AP flag
 
+    // Device balance, kept in the wear-leveled journal
+    uint64_t GetBalance();                // Current device balance
+    bool AdjustBalance(int64_t delta);    // Apply a signed change to the balance
+    bool SetBalance(uint64_t value);      // Replace the balance with an absolute value
+
+    // Typed accessors generated from ConfigSchema.h, e.g. GetWifiSsid() / SetWifiSsid()
+    CONFIG_SCHEMA(CONFIG_ACCESSORS)
+
 private:
     // Private utility methods for internal use only
     void initializeDefaults();   // Initialize default values
     void initializeVariables();  // Initialize internal variables
     bool getResetFlag();         // Get system reset flag
+    void loadCache();            // Load every schema entry into the RAM cache
 
     Preferences* preferences;     // Preferences object to store configuration
     const char* namespaceName;   // Namespace for the preferences storage
+    PartitionFlash balanceFlash;  // Raw partition backing the balance journal
+    CounterStore balanceStore;    // Wear-leveled balance counter
+    ConfigCache cache;            // RAM copy of the schema entries
 };
 
 #endif // CONFIG_MANAGER_H
\ No newline at end of file
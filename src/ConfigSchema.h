@@ -0,0 +1,78 @@
+#ifndef CONFIG_SCHEMA_H
+#define CONFIG_SCHEMA_H
+/**
+ * @file ConfigSchema.h
+ * @brief Compile-time schema of the persistent configuration.
+ *
+ * Every persisted setting is declared once in `CONFIG_SCHEMA` with its NVS key,
+ * type, default value and bounds. The table is expanded by `ConfigManager` to
+ * generate the packed RAM cache, the typed `Get<Name>()` / `Set<Name>()` accessors,
+ * the default initialization and the load path.
+ *
+ * Columns: X(Name, Key, Type, Default, Min, Max)
+ * - `Bool`   : Min/Max are ignored (0/1).
+ * - `UInt32` : Min/Max bound the value.
+ * - `String` : Min/Max bound the length in characters; the cache reserves Max + 1 bytes.
+ *
+ * The device balance is not part of the schema: it lives in the CounterStore journal.
+ */
+
+#include <stdint.h>
+#include "Config.h"
+
+#define CONFIG_SCHEMA(X)                                                                    \
+    X(ApMode,       APWIFIMODE_FLAG,   Bool,   true,                     0,     1)          \
+    X(ResetFlag,    RESET_FLAG,        Bool,   false,                    0,     1)          \
+    X(WifiSsid,     WIFISSID,          String, DEFAULT_WIFI_SSID,        0,     32)         \
+    X(WifiPass,     WIFIPASS,          String, DEFAULT_WIFI_PASSWORD,    0,     63)         \
+    X(DeviceName,   DEVICE_NAME,       String, DEFAULT_DEVICE_NAME,      1,     20)         \
+    X(DeviceId,     DEVICE_ID,         String, DEFAULT_DEVICE_ID,        1,     20)         \
+    X(MasterCardId, DEV_MASTR_CARD_ID, String, DEFAULT_MASTR_CARD_ID,    11,    29)         \
+    X(ManagerName,  DEV_MANAGER_NAME,  String, DEFAULT_DEV_MANAGER_NAME, 1,     11)         \
+    X(LockTimeout,  LOCK_TIMEOUT_KEY,  UInt32, LOCK_TIMEOUT,             10000, 600000)
+
+#define NVS_KEY_MAX_LENGTH 15  ///< Longest key accepted by NVS
+
+// --------------------------------------------------
+// Compile-time validation of the table
+// --------------------------------------------------
+#define CONFIG_CHECK_Bool(name, def, lo, hi)                                                \
+    static_assert((def) == true || (def) == false, #name ": invalid boolean default");
+#define CONFIG_CHECK_UInt32(name, def, lo, hi)                                              \
+    static_assert((lo) <= (hi), #name ": empty range");                                     \
+    static_assert((lo) <= (def) && (def) <= (hi), #name ": default out of bounds");
+#define CONFIG_CHECK_String(name, def, lo, hi)                                              \
+    static_assert(sizeof(def) - 1 >= (lo) && sizeof(def) - 1 <= (hi), #name ": default length out of bounds");
+#define CONFIG_CHECK(name, key, type, def, lo, hi)                                          \
+    static_assert(sizeof(key) - 1 <= NVS_KEY_MAX_LENGTH, #name ": NVS key too long");       \
+    CONFIG_CHECK_##type(name, def, lo, hi)
+
+CONFIG_SCHEMA(CONFIG_CHECK)
+
+// --------------------------------------------------
+// Packed RAM cache, one member per schema entry
+// --------------------------------------------------
+#define CONFIG_CACHE_Bool(name, hi)   bool name;
+#define CONFIG_CACHE_UInt32(name, hi) uint32_t name;
+#define CONFIG_CACHE_String(name, hi) char name[(hi) + 1];
+#define CONFIG_CACHE_MEMBER(name, key, type, def, lo, hi) CONFIG_CACHE_##type(name, hi)
+
+struct ConfigCache {
+    CONFIG_SCHEMA(CONFIG_CACHE_MEMBER)
+} __attribute__((packed));
+
+// --------------------------------------------------
+// Typed accessor declarations (expanded inside ConfigManager)
+// --------------------------------------------------
+#define CONFIG_ACCESSORS_Bool(name)                                                         \
+    bool Get##name() const { return cache.name; }                                           \
+    bool Set##name(bool value);
+#define CONFIG_ACCESSORS_UInt32(name)                                                       \
+    uint32_t Get##name() const { return cache.name; }                                       \
+    bool Set##name(uint32_t value);
+#define CONFIG_ACCESSORS_String(name)                                                       \
+    const char* Get##name() const { return cache.name; }                                    \
+    bool Set##name(const char* value);
+#define CONFIG_ACCESSORS(name, key, type, def, lo, hi) CONFIG_ACCESSORS_##type(name)
+
+#endif // CONFIG_SCHEMA_H
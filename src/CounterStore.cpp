@@ -0,0 +1,312 @@
+#include "CounterStore.h"
+#include <string.h>
+#include <esp_partition.h>
+
+/************************************************************************************************/
+/*                              Partition backed flash region                                   */
+/************************************************************************************************/
+
+/**
+ * @brief Constructor for the PartitionFlash class.
+ *
+ * @param label Label of the data partition holding the journal.
+ */
+PartitionFlash::PartitionFlash(const char* label) : label(label), partition(nullptr) {}
+
+/**
+ * @brief Looks up the data partition by its label.
+ *
+ * @return true if the partition exists in the flashed partition table.
+ */
+bool PartitionFlash::begin() {
+    partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, label);
+    return partition != nullptr;
+}
+
+size_t PartitionFlash::size() const {
+    return partition ? static_cast<const esp_partition_t*>(partition)->size : 0;
+}
+
+bool PartitionFlash::read(size_t offset, void* dst, size_t len) {
+    if (!partition) return false;
+    return esp_partition_read(static_cast<const esp_partition_t*>(partition), offset, dst, len) == ESP_OK;
+}
+
+bool PartitionFlash::write(size_t offset, const void* src, size_t len) {
+    if (!partition) return false;
+    return esp_partition_write(static_cast<const esp_partition_t*>(partition), offset, src, len) == ESP_OK;
+}
+
+bool PartitionFlash::eraseSector(size_t offset) {
+    if (!partition) return false;
+    return esp_partition_erase_range(static_cast<const esp_partition_t*>(partition), offset, CounterStore::SECTOR_SIZE) == ESP_OK;
+}
+
+/************************************************************************************************/
+/*                              Counter Store class definition                                  */
+/************************************************************************************************/
+
+/**
+ * @brief Constructor for the CounterStore class.
+ *
+ * @param flash Flash region that holds the journal. It must contain at least two sectors.
+ */
+CounterStore::CounterStore(CounterFlash* flash)
+    : flash(flash), sectorCount(0), activeSector(0), nextSlot(0), generation(0),
+      sequence(0), eraseCount(0), value(0), ready(false) {}
+
+/**
+ * @brief Mounts the journal and recovers the counter value.
+ *
+ * Scans every sector header and selects the valid one with the highest generation,
+ * then replays its delta records. If no valid header is found the region is
+ * formatted and the counter starts at `seedValue`.
+ *
+ * @param seedValue Value used when the region holds no journal yet.
+ * @return true if the counter is available for reads and updates.
+ */
+bool CounterStore::begin(int64_t seedValue) {
+    ready = false;
+    sectorCount = flash->size() / SECTOR_SIZE;
+    if (sectorCount < 2) {
+        return false;  // A ring needs at least one spare sector
+    }
+
+    bool found = false;
+    SectorHeader header;
+    SectorHeader best;
+    memset(&best, 0, sizeof(best));
+    size_t bestSector = 0;
+
+    for (size_t sector = 0; sector < sectorCount; sector++) {
+        if (!readHeader(sector, header)) continue;
+        // Serial number comparison keeps working when the generation wraps
+        if (!found || static_cast<int32_t>(header.generation - best.generation) > 0) {
+            best = header;
+            bestSector = sector;
+            found = true;
+        }
+    }
+
+    if (!found) {
+        sequence = 0;
+        if (!openSector(0, 1, seedValue)) {
+            return false;
+        }
+        value = seedValue;
+        ready = true;
+        return true;
+    }
+
+    activeSector = bestSector;
+    generation = best.generation;
+    sequence = best.sequence;
+    value = best.base;
+    replaySector();
+
+    ready = true;
+    return true;
+}
+
+/**
+ * @brief Returns the cached counter value.
+ */
+int64_t CounterStore::getValue() const {
+    return value;
+}
+
+/**
+ * @brief Appends a delta record to the active sector.
+ *
+ * The slot is consumed even when the program operation fails, since a partially
+ * programmed slot cannot be written again before the next erase.
+ *
+ * @param delta Signed change to apply.
+ * @return true if the record was written and the cached value updated.
+ */
+bool CounterStore::add(int64_t delta) {
+    if (!ready) return false;
+
+    if (nextSlot >= RECORDS_PER_SECTOR && !compact()) {
+        return false;
+    }
+
+    Record record;
+    record.delta = delta;
+    record.sequence = sequence;
+    record.crc = recordCrc(record, generation);
+
+    size_t offset = activeSector * SECTOR_SIZE + sizeof(SectorHeader) + nextSlot * sizeof(Record);
+    nextSlot++;
+
+    if (!flash->write(offset, &record, sizeof(record))) {
+        return false;
+    }
+
+    value += delta;
+    sequence++;
+    return true;
+}
+
+/**
+ * @brief Replaces the counter with an absolute value.
+ *
+ * Opens the next sector with `newValue` as its base, which also drops all
+ * previous deltas from the recovery path.
+ *
+ * @param newValue Absolute counter value.
+ * @return true on success.
+ */
+bool CounterStore::reset(int64_t newValue) {
+    if (!ready) return false;
+
+    size_t next = (activeSector + 1) % sectorCount;
+    if (!openSector(next, generation + 1, newValue)) {
+        return false;
+    }
+    value = newValue;
+    return true;
+}
+
+/**
+ * @brief Folds the deltas of the active sector into the base of the next one.
+ *
+ * Called automatically when the active sector is full. The previous sector stays
+ * intact until the ring wraps around to it, so a power loss during compaction
+ * recovers from the old sector.
+ *
+ * @return true on success.
+ */
+bool CounterStore::compact() {
+    if (!ready) return false;
+
+    size_t next = (activeSector + 1) % sectorCount;
+    return openSector(next, generation + 1, value);
+}
+
+bool CounterStore::isReady() const {
+    return ready;
+}
+
+uint32_t CounterStore::getRecordCount() const {
+    return sequence;
+}
+
+uint32_t CounterStore::getEraseCount() const {
+    return eraseCount;
+}
+
+/**
+ * @brief Erases a sector and writes a new header into it.
+ *
+ * @param sector Sector index in the ring.
+ * @param newGeneration Generation number of the new sector.
+ * @param base Counter value recorded in the header.
+ * @return true if the erase and the header program both succeeded.
+ */
+bool CounterStore::openSector(size_t sector, uint32_t newGeneration, int64_t base) {
+    if (!flash->eraseSector(sector * SECTOR_SIZE)) {
+        return false;
+    }
+    eraseCount++;
+
+    SectorHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = SECTOR_MAGIC;
+    header.generation = newGeneration;
+    header.base = base;
+    header.sequence = sequence;
+    header.crc = headerCrc(header);
+
+    if (!flash->write(sector * SECTOR_SIZE, &header, sizeof(header))) {
+        return false;
+    }
+
+    activeSector = sector;
+    generation = newGeneration;
+    nextSlot = 0;
+    return true;
+}
+
+/**
+ * @brief Reads a sector header and checks its magic and CRC.
+ *
+ * @param sector Sector index in the ring.
+ * @param header Receives the header contents.
+ * @return true if the header is valid.
+ */
+bool CounterStore::readHeader(size_t sector, SectorHeader& header) {
+    if (!flash->read(sector * SECTOR_SIZE, &header, sizeof(header))) {
+        return false;
+    }
+    return header.magic == SECTOR_MAGIC && header.crc == headerCrc(header);
+}
+
+/**
+ * @brief Applies the valid records of the active sector to the cached value.
+ *
+ * Every slot is read: a failed program can leave an erased slot behind valid
+ * records, so erased slots are skipped rather than taken as the end of the
+ * journal. Slots with a bad CRC are torn writes from a power loss: they are
+ * skipped too. New records go after the last programmed slot, never into a gap.
+ */
+void CounterStore::replaySector() {
+    const size_t batch = 16;  // Records read per flash access
+    Record records[batch];
+    nextSlot = 0;
+
+    for (size_t slot = 0; slot < RECORDS_PER_SECTOR; slot += batch) {
+        size_t count = RECORDS_PER_SECTOR - slot;
+        if (count > batch) count = batch;
+
+        size_t offset = activeSector * SECTOR_SIZE + sizeof(SectorHeader) + slot * sizeof(Record);
+        if (!flash->read(offset, records, count * sizeof(Record))) {
+            nextSlot = RECORDS_PER_SECTOR;  // Unreadable: force a roll on the next update
+            return;
+        }
+
+        for (size_t i = 0; i < count; i++) {
+            if (isErased(&records[i], sizeof(Record))) {
+                continue;  // Free slot or a write that never started
+            }
+            nextSlot = slot + i + 1;
+            if (records[i].crc != recordCrc(records[i], generation)) {
+                continue;  // Torn write
+            }
+            value += records[i].delta;
+            sequence = records[i].sequence + 1;
+        }
+    }
+}
+
+uint32_t CounterStore::headerCrc(const SectorHeader& header) const {
+    return crc32(0, &header, offsetof(SectorHeader, crc));
+}
+
+uint32_t CounterStore::recordCrc(const Record& record, uint32_t recordGeneration) const {
+    uint32_t crc = crc32(0, &record, offsetof(Record, crc));
+    return crc32(crc, &recordGeneration, sizeof(recordGeneration));
+}
+
+/**
+ * @brief Bitwise CRC-32 (IEEE 802.3), small enough for the few bytes hashed here.
+ */
+uint32_t CounterStore::crc32(uint32_t crc, const void* data, size_t len) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    crc = ~crc;
+    while (len--) {
+        crc ^= *bytes++;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+bool CounterStore::isErased(const void* data, size_t len) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < len; i++) {
+        if (bytes[i] != 0xFF) return false;
+    }
+    return true;
+}
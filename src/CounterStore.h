@@ -0,0 +1,119 @@
+#ifndef COUNTERSTORE_H
+#define COUNTERSTORE_H
+/**
+ * @file CounterStore.h
+ * @brief Wear-leveled, log-structured counter stored in a raw flash partition.
+ *
+ * The `CounterStore` class keeps a single signed 64-bit counter (the POS balance)
+ * as a journal of deltas instead of rewriting one NVS key on every update.
+ *
+ * Layout of the region:
+ * - The region is split into 4 KB flash sectors used as a ring.
+ * - Each sector starts with a `SectorHeader` carrying a generation number and the
+ *   counter value (`base`) at the moment the sector was opened.
+ * - The rest of the sector holds fixed-size `Record` slots, each one a signed delta
+ *   protected by a CRC. Slots are only ever programmed once between two erases.
+ *
+ * When the active sector is full the next sector in the ring is erased and opened
+ * with the current value as its base (compaction), so each sector is erased once
+ * per full turn of the ring and a record costs a single 16-byte program.
+ *
+ * Recovery at boot reads the sector headers, picks the valid header with the
+ * highest generation and replays its records. Torn writes are detected by the
+ * CRC and skipped, and erased gaps left by failed writes do not end the replay;
+ * a torn header makes recovery fall back to the previous sector, which is never
+ * erased before the new one is fully written.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @class CounterFlash
+ * @brief Raw flash region used by the CounterStore.
+ *
+ * Abstracts the partition access so the journal logic can run on a RAM or file
+ * backed region when built for the host.
+ */
+class CounterFlash {
+public:
+    virtual ~CounterFlash() {}
+    virtual size_t size() const = 0;                                     ///< Size of the region in bytes
+    virtual bool read(size_t offset, void* dst, size_t len) = 0;         ///< Read bytes from the region
+    virtual bool write(size_t offset, const void* src, size_t len) = 0;  ///< Program bytes (1 -> 0 bits only)
+    virtual bool eraseSector(size_t offset) = 0;                         ///< Erase one sector to 0xFF
+};
+
+/**
+ * @class PartitionFlash
+ * @brief CounterFlash backed by an ESP32 data partition.
+ */
+class PartitionFlash : public CounterFlash {
+public:
+    PartitionFlash(const char* label);
+    bool begin();                                          ///< Locate the partition by label
+    size_t size() const override;
+    bool read(size_t offset, void* dst, size_t len) override;
+    bool write(size_t offset, const void* src, size_t len) override;
+    bool eraseSector(size_t offset) override;
+
+private:
+    const char* label;       ///< Partition label from the partition table
+    const void* partition;   ///< Opaque esp_partition_t pointer once found
+};
+
+class CounterStore {
+public:
+    static const size_t SECTOR_SIZE = 4096;                ///< Flash erase unit
+    static const uint32_t SECTOR_MAGIC = 0x42414C31;       ///< "BAL1", marks a sector header
+
+    CounterStore(CounterFlash* flash);
+
+    bool begin(int64_t seedValue);   ///< Recover the counter, formats the region with seedValue if empty
+    int64_t getValue() const;        ///< Current counter value (RAM, no flash access)
+    bool add(int64_t delta);         ///< Append a delta record
+    bool reset(int64_t value);       ///< Open a new sector with an absolute value
+    bool compact();                  ///< Roll to the next sector, folding all deltas into its base
+
+    bool isReady() const;            ///< True once begin() succeeded
+    uint32_t getRecordCount() const; ///< Records appended since the region was formatted
+    uint32_t getEraseCount() const;  ///< Sector erases performed since boot
+
+private:
+    struct SectorHeader {
+        uint32_t magic;        ///< SECTOR_MAGIC
+        uint32_t generation;   ///< Increases by one on every sector roll
+        int64_t base;          ///< Counter value when the sector was opened
+        uint32_t sequence;     ///< Record sequence number at sector open
+        uint32_t reserved[2];  ///< Zero, reserved for future use
+        uint32_t crc;          ///< CRC32 of the fields above
+    };
+
+    struct Record {
+        int64_t delta;         ///< Signed change applied to the counter
+        uint32_t sequence;     ///< Global record sequence number
+        uint32_t crc;          ///< CRC32 of delta, sequence and sector generation
+    };
+
+    static const size_t RECORDS_PER_SECTOR = (SECTOR_SIZE - sizeof(SectorHeader)) / sizeof(Record);
+
+    bool openSector(size_t sector, uint32_t generation, int64_t base);  ///< Erase and write a sector header
+    bool readHeader(size_t sector, SectorHeader& header);               ///< Read and validate a sector header
+    void replaySector();                                                 ///< Apply the records of the active sector
+    uint32_t headerCrc(const SectorHeader& header) const;
+    uint32_t recordCrc(const Record& record, uint32_t generation) const;
+    static uint32_t crc32(uint32_t crc, const void* data, size_t len);
+    static bool isErased(const void* data, size_t len);
+
+    CounterFlash* flash;         ///< Backing flash region
+    size_t sectorCount;          ///< Number of sectors in the ring
+    size_t activeSector;         ///< Sector receiving new records
+    size_t nextSlot;             ///< Next free record slot in the active sector
+    uint32_t generation;         ///< Generation of the active sector
+    uint32_t sequence;           ///< Next record sequence number
+    uint32_t eraseCount;         ///< Erases since boot
+    int64_t value;               ///< Cached counter value
+    bool ready;                  ///< Region mounted and recovered
+};
+
+#endif // COUNTERSTORE_H
@@ -0,0 +1,159 @@
+#include "EventBus.h"
+
+static_assert((BUS_QUEUE_LENGTH & (BUS_QUEUE_LENGTH - 1)) == 0, "BUS_QUEUE_LENGTH must be a power of two");
+
+#define TOPIC_BIT(topic) (1U << (topic))
+
+/// Topics each subscriber receives, in BusSubscriber order
+static const uint8_t SUBSCRIPTIONS[] = {
+    TOPIC_BIT(TOPIC_TRANSACTION),                                           // log
+    TOPIC_BIT(TOPIC_TRANSACTION),                                           // buzzer
+    TOPIC_BIT(TOPIC_CARD),                                                  // metrics
+    TOPIC_BIT(TOPIC_CARD) | TOPIC_BIT(TOPIC_TRANSACTION) | TOPIC_BIT(TOPIC_LOCK),  // live
+};
+static_assert(sizeof(SUBSCRIPTIONS) / sizeof(SUBSCRIPTIONS[0]) == SUBSCRIBER_COUNT, "One entry per subscriber");
+
+static const char* const TOPIC_NAMES[] = {"card", "transaction", "lock"};
+static_assert(sizeof(TOPIC_NAMES) / sizeof(TOPIC_NAMES[0]) == TOPIC_COUNT, "One name per topic");
+
+static const char* const SUBSCRIBER_NAMES[] = {"log", "buzzer", "metrics", "live"};
+static_assert(sizeof(SUBSCRIBER_NAMES) / sizeof(SUBSCRIBER_NAMES[0]) == SUBSCRIBER_COUNT, "One name per subscriber");
+
+EventBus Bus;
+
+EventBus::EventBus() {
+    for (uint8_t subscriber = 0; subscriber < SUBSCRIBER_COUNT; subscriber++) {
+        Queue& queue = queues[subscriber];
+        for (uint32_t i = 0; i < BUS_QUEUE_LENGTH; i++) {
+            queue.cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        queue.head.store(0, std::memory_order_relaxed);
+        queue.tail.store(0, std::memory_order_relaxed);
+        queue.dropped.store(0, std::memory_order_relaxed);
+        queue.wake = nullptr;
+        queue.context = nullptr;
+    }
+    for (uint8_t topic = 0; topic < TOPIC_COUNT; topic++) {
+        published[topic].store(0, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Sets the hook called when an event is queued for a subscriber.
+ *
+ * Events published before are kept (up to the ring size) and read on the
+ * first receive().
+ *
+ * @param subscriber Subscriber to wake.
+ * @param wake Hook, e.g. a task notification; nullptr for none.
+ * @param context Passed to wake.
+ */
+void EventBus::attach(BusSubscriber subscriber, BusWake wake, void* context) {
+    queues[subscriber].context = context;
+    queues[subscriber].wake = wake;
+}
+
+/**
+ * @brief Copies an event to every subscriber of its topic and wakes them.
+ *
+ * @param event Event to deliver.
+ * @return false if at least one subscriber's ring was full and dropped it.
+ */
+bool EventBus::publish(const BusEvent& event) {
+    if (event.topic >= TOPIC_COUNT) return false;
+
+    published[event.topic].fetch_add(1, std::memory_order_relaxed);
+    bool delivered = true;
+    for (uint8_t subscriber = 0; subscriber < SUBSCRIBER_COUNT; subscriber++) {
+        if ((SUBSCRIPTIONS[subscriber] & TOPIC_BIT(event.topic)) == 0) {
+            continue;
+        }
+        Queue& queue = queues[subscriber];
+        if (!push(queue, event)) {
+            queue.dropped.fetch_add(1, std::memory_order_relaxed);
+            delivered = false;
+            continue;
+        }
+        BusWake wake = queue.wake;
+        if (wake != nullptr) {
+            wake(queue.context);
+        }
+    }
+    return delivered;
+}
+
+/**
+ * @brief Takes the oldest event queued for a subscriber.
+ *
+ * @return false if there is none.
+ */
+bool EventBus::receive(BusSubscriber subscriber, BusEvent& event) {
+    return pop(queues[subscriber], event);
+}
+
+uint32_t EventBus::getDepth(BusSubscriber subscriber) const {
+    const Queue& queue = queues[subscriber];
+    return queue.head.load(std::memory_order_relaxed) - queue.tail.load(std::memory_order_relaxed);
+}
+
+const char* EventBus::getTopicName(BusTopic topic) const {
+    return TOPIC_NAMES[topic];
+}
+
+const char* EventBus::getSubscriberName(BusSubscriber subscriber) const {
+    return SUBSCRIBER_NAMES[subscriber];
+}
+
+/**
+ * @brief Claims the next write position with a compare-and-swap, fills the
+ * cell and publishes it by advancing its sequence number.
+ *
+ * A cell is free for position p when its sequence is p, and readable at
+ * position p when it is p + 1; a reader frees it for the next lap by setting
+ * it to p + BUS_QUEUE_LENGTH.
+ *
+ * @return false if the ring is full.
+ */
+bool EventBus::push(Queue& queue, const BusEvent& event) {
+    uint32_t position = queue.head.load(std::memory_order_relaxed);
+    Cell* cell;
+    while (true) {
+        cell = &queue.cells[position & (BUS_QUEUE_LENGTH - 1)];
+        uint32_t sequence = cell->sequence.load(std::memory_order_acquire);
+        int32_t difference = (int32_t)(sequence - position);
+        if (difference == 0) {
+            if (queue.head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (difference < 0) {
+            return false;  // The reader has not freed this cell yet
+        } else {
+            position = queue.head.load(std::memory_order_relaxed);
+        }
+    }
+    cell->event = event;
+    cell->sequence.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+bool EventBus::pop(Queue& queue, BusEvent& event) {
+    uint32_t position = queue.tail.load(std::memory_order_relaxed);
+    Cell* cell;
+    while (true) {
+        cell = &queue.cells[position & (BUS_QUEUE_LENGTH - 1)];
+        uint32_t sequence = cell->sequence.load(std::memory_order_acquire);
+        int32_t difference = (int32_t)(sequence - (position + 1));
+        if (difference == 0) {
+            if (queue.tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (difference < 0) {
+            return false;  // Empty
+        } else {
+            position = queue.tail.load(std::memory_order_relaxed);
+        }
+    }
+    event = cell->event;
+    cell->sequence.store(position + BUS_QUEUE_LENGTH, std::memory_order_release);
+    return true;
+}
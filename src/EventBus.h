@@ -0,0 +1,118 @@
+#ifndef EVENTBUS_H
+#define EVENTBUS_H
+/**
+ * @file EventBus.h
+ * @brief Typed publish/subscribe bus for card, transaction and lock events.
+ *
+ * Producers describe what happened and return; they do not know who reacts:
+ * @code
+ *   BusEvent event = {TOPIC_TRANSACTION, BUS_TRANSACTION_RECHARGE, 0, true, amount, balance, millis()};
+ *   Bus.publish(event);
+ * @endcode
+ * Topics and subscribers are fixed at compile time, and so is the routing
+ * table between them:
+ *
+ * | Subscriber | Topics                   | Drained by                         |
+ * |------------|--------------------------|------------------------------------|
+ * | log        | transaction              | log task (file entry + RAM record) |
+ * | buzzer     | transaction              | buzzer esp_timer (result tone)     |
+ * | metrics    | card                     | the wake hook itself (atomic adds) |
+ * | live       | card, transaction, lock  | live task (SSE/WebSocket)          |
+ *
+ * Every subscriber owns a preallocated ring of `BUS_QUEUE_LENGTH` events.
+ * publish() copies the event into the ring of each subscriber of its topic
+ * with a lock-free bounded queue (one compare-and-swap per copy, no mutex,
+ * no allocation) and calls the subscriber's wake hook, which typically
+ * notifies its task. A full ring drops the event for that subscriber only
+ * and counts it. Publishing is safe from any task, on either core.
+ */
+
+#include <Arduino.h>
+#include <atomic>
+#include "Config.h"
+
+enum BusTopic : uint8_t {
+    TOPIC_CARD,              ///< kind: 0, code: MRC522Manager::IsMasterCard() status of an accepted tap
+    TOPIC_TRANSACTION,       ///< kind: BusTransactionKind, code: number slot 1-4 of a number save
+    TOPIC_LOCK,              ///< kind: BusLockKind, code: 1 when locked by the inactivity timer
+    TOPIC_COUNT
+};
+
+enum BusTransactionKind : uint8_t {
+    BUS_TRANSACTION_RECHARGE,
+    BUS_TRANSACTION_NUMBER_SAVED
+};
+
+enum BusLockKind : uint8_t {
+    BUS_LOCK_LOCKED,
+    BUS_LOCK_UNLOCKED
+};
+
+enum BusSubscriber : uint8_t {
+    SUBSCRIBER_LOG,
+    SUBSCRIBER_BUZZER,
+    SUBSCRIBER_METRICS,
+    SUBSCRIBER_LIVE,
+    SUBSCRIBER_COUNT
+};
+
+/**
+ * @brief One event; a fixed-size POD copied by value into every ring.
+ */
+struct BusEvent {
+    BusTopic topic;
+    uint8_t kind;            ///< Meaning depends on topic
+    uint8_t code;            ///< Meaning depends on topic
+    bool success;
+    uint32_t amount;
+    uint32_t balance;        ///< Card balance after the transaction, 0 if not applicable
+    uint32_t timeMs;         ///< millis() when published
+    char cardId[30];         ///< UID of the card involved, empty if none
+};
+
+/// Called after an event was queued for a subscriber; must not block
+typedef void (*BusWake)(void* context);
+
+class EventBus {
+public:
+    EventBus();
+
+    void attach(BusSubscriber subscriber, BusWake wake, void* context);  ///< Set the wake hook, once at startup
+    bool publish(const BusEvent& event);      ///< false if a subscriber's ring was full
+    bool receive(BusSubscriber subscriber, BusEvent& event);  ///< Take the oldest event of a subscriber
+    uint32_t getDepth(BusSubscriber subscriber) const;        ///< Events waiting for a subscriber
+
+    const char* getTopicName(BusTopic topic) const;
+    const char* getSubscriberName(BusSubscriber subscriber) const;
+    uint32_t getPublished(BusTopic topic) const { return published[topic].load(std::memory_order_relaxed); }
+    uint32_t getDropped(BusSubscriber subscriber) const {
+        return queues[subscriber].dropped.load(std::memory_order_relaxed);
+    }
+
+private:
+    /// Slot of a ring: the sequence number tells producers and consumers whose turn it is
+    struct Cell {
+        std::atomic<uint32_t> sequence;
+        BusEvent event;
+    };
+
+    /// Bounded lock-free multi-producer multi-consumer ring
+    struct Queue {
+        Cell cells[BUS_QUEUE_LENGTH];
+        std::atomic<uint32_t> head;    ///< Next position to write
+        std::atomic<uint32_t> tail;    ///< Next position to read
+        std::atomic<uint32_t> dropped;
+        BusWake wake;
+        void* context;
+    };
+
+    static bool push(Queue& queue, const BusEvent& event);
+    static bool pop(Queue& queue, BusEvent& event);
+
+    Queue queues[SUBSCRIBER_COUNT];
+    std::atomic<uint32_t> published[TOPIC_COUNT];
+};
+
+extern EventBus Bus;
+
+#endif // EVENTBUS_H
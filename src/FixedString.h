@@ -0,0 +1,167 @@
+#ifndef FIXED_STRING_H
+#define FIXED_STRING_H
+/**
+ * @file FixedString.h
+ * @brief Fixed-capacity string for the card, clock and screen hot paths.
+ *
+ * Stands in for Arduino String where text is built on every tap or redraw:
+ * the characters live inside the object, so building, copying and returning
+ * one never touches the heap and cannot fragment it over weeks of uptime.
+ * Text past the capacity is cut like snprintf() does; the string stays
+ * terminated and truncated() tells it happened.
+ */
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+
+/**
+ * @brief String of at most N characters stored in place.
+ *
+ * @tparam N Capacity in characters, terminator excluded.
+ */
+template <size_t N>
+class FixedString {
+public:
+    static const size_t CAPACITY = N;
+
+    FixedString() : size(0), cut(false) {
+        text[0] = '\0';
+    }
+
+    FixedString(const char* value) : FixedString() {
+        append(value);
+    }
+
+    FixedString& operator=(const char* value) {
+        clear();
+        return append(value);
+    }
+
+    FixedString& operator+=(const char* value) { return append(value); }
+    FixedString& operator+=(char c) { return append(c); }
+
+    /**
+     * @brief Appends a terminated text, nullptr appends nothing.
+     */
+    FixedString& append(const char* value) {
+        return value != nullptr ? append(value, strlen(value)) : *this;
+    }
+
+    /**
+     * @brief Appends at most count characters, stopping at a terminator
+     * like strncat(): card blocks are 16 bytes without one.
+     */
+    FixedString& append(const char* value, size_t count) {
+        if (value == nullptr) return *this;
+        size_t length = 0;
+        while (length < count && value[length] != '\0') length++;
+        if (length > N - size) {
+            length = N - size;
+            cut = true;
+        }
+        memcpy(text + size, value, length);
+        size += length;
+        text[size] = '\0';
+        return *this;
+    }
+
+    FixedString& append(char c) {
+        return append(&c, 1);
+    }
+
+    /**
+     * @brief Appends printf-style formatted text.
+     */
+    __attribute__((format(printf, 2, 3))) FixedString& appendf(const char* pattern, ...) {
+        va_list args;
+        va_start(args, pattern);
+        vappendf(pattern, args);
+        va_end(args);
+        return *this;
+    }
+
+    /**
+     * @brief Replaces the text with printf-style formatted text.
+     */
+    __attribute__((format(printf, 2, 3))) FixedString& format(const char* pattern, ...) {
+        clear();
+        va_list args;
+        va_start(args, pattern);
+        vappendf(pattern, args);
+        va_end(args);
+        return *this;
+    }
+
+    /**
+     * @brief Appends bytes as lowercase hex pairs, e.g. a card UID "d3:73:fd:e3".
+     *
+     * @param separator Put between two bytes, '\0' for none.
+     */
+    FixedString& appendHex(const uint8_t* bytes, size_t count, char separator = ':') {
+        for (size_t i = 0; i < count; i++) {
+            if (i > 0 && separator != '\0') append(separator);
+            appendf("%02x", bytes[i]);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Removes leading and trailing whitespace.
+     */
+    FixedString& trim() {
+        size_t start = 0;
+        while (start < size && isspace((unsigned char)text[start])) start++;
+        size_t end = size;
+        while (end > start && isspace((unsigned char)text[end - 1])) end--;
+        size = end - start;
+        memmove(text, text + start, size);
+        text[size] = '\0';
+        return *this;
+    }
+
+    void clear() {
+        size = 0;
+        cut = false;
+        text[0] = '\0';
+    }
+
+    const char* c_str() const { return text; }
+    size_t length() const { return size; }
+    bool isEmpty() const { return size == 0; }
+    bool truncated() const { return cut; }           ///< Some appended text did not fit
+    char operator[](size_t index) const { return index < size ? text[index] : '\0'; }
+
+    bool equals(const char* other) const {
+        return other != nullptr && strcmp(text, other) == 0;
+    }
+
+    bool equalsIgnoreCase(const char* other) const {
+        return other != nullptr && strcasecmp(text, other) == 0;
+    }
+
+private:
+    void vappendf(const char* pattern, va_list args) {
+        int written = vsnprintf(text + size, N + 1 - size, pattern, args);
+        if (written < 0) {
+            text[size] = '\0';
+            return;
+        }
+        if ((size_t)written > N - size) {
+            cut = true;
+            size = N;
+        } else {
+            size += written;
+        }
+    }
+
+    char text[N + 1];
+    size_t size;
+    bool cut;
+};
+
+#endif // FIXED_STRING_H
@@ -0,0 +1,100 @@
+#include "GlyphManager.h"
+
+/**
+ * @brief Constructor for the GlyphManager class.
+ *
+ * @param lcd Frame buffer whose CGRAM slots are managed.
+ */
+GlyphManager::GlyphManager(LcdFrameBuffer* lcd) : lcd(lcd) {
+    reset();
+    memset(&stats, 0, sizeof(stats));
+}
+
+/**
+ * @brief Returns the slot of a glyph, loading it first if it is not resident.
+ *
+ * @param id Glyph from LcdGlyphs.h.
+ * @return CGRAM slot (the character code to write), -1 for an unknown id.
+ */
+int8_t GlyphManager::acquire(LcdGlyphId id) {
+    if (id >= GLYPH_COUNT) return -1;
+
+    int8_t slot = getSlot(id);
+    if (slot >= 0) {
+        lastUse[slot] = ++useCounter;
+        stats.hits++;
+        return slot;
+    }
+
+    slot = pickSlot();
+    if (slotGlyph[slot] != EMPTY) {
+        stats.evictions++;
+        if (DEBUGMODE) {
+            Serial.print("GlyphManager: slot ");
+            Serial.print(slot);
+            Serial.println(" evicted");
+        }
+    }
+    uint8_t rows[LcdFrameBuffer::GLYPH_ROWS];
+    memcpy_P(rows, LCD_GLYPHS[id], sizeof(rows));
+    lcd->defineGlyph(slot, rows);
+    slotGlyph[slot] = id;
+    lastUse[slot] = ++useCounter;
+    stats.loads++;
+    return slot;
+}
+
+/**
+ * @brief Writes a glyph at the frame buffer cursor.
+ *
+ * @return Characters written, 0 for an unknown id.
+ */
+size_t GlyphManager::print(LcdGlyphId id) {
+    int8_t slot = acquire(id);
+    if (slot < 0) return 0;
+    return lcd->write((uint8_t)slot);
+}
+
+void GlyphManager::reset() {
+    memset(slotGlyph, EMPTY, sizeof(slotGlyph));
+    memset(lastUse, 0, sizeof(lastUse));
+    useCounter = 0;
+}
+
+bool GlyphManager::isResident(LcdGlyphId id) const {
+    return getSlot(id) >= 0;
+}
+
+int8_t GlyphManager::getSlot(LcdGlyphId id) const {
+    for (uint8_t slot = 0; slot < SLOTS; slot++) {
+        if (slotGlyph[slot] == id) return slot;
+    }
+    return -1;
+}
+
+const GlyphManager::Stats& GlyphManager::getStats() const {
+    return stats;
+}
+
+/**
+ * @brief Chooses the slot for a new glyph.
+ *
+ * A free slot first, then the least recently used slot not shown in the
+ * frame being drawn, then the least recently used slot at all (its cells
+ * will change to the new glyph).
+ */
+uint8_t GlyphManager::pickSlot() const {
+    int8_t hidden = -1;
+    uint8_t oldest = 0;
+    for (uint8_t slot = 0; slot < SLOTS; slot++) {
+        if (slotGlyph[slot] == EMPTY) return slot;
+
+        if (lastUse[slot] < lastUse[oldest]) {
+            oldest = slot;
+        }
+        if (!lcd->isCodeUsed(slot) && (hidden < 0 || lastUse[slot] < lastUse[hidden])) {
+            hidden = slot;
+        }
+    }
+    return hidden >= 0 ? hidden : oldest;
+}
@@ -0,0 +1,49 @@
+#ifndef GLYPHMANAGER_H
+#define GLYPHMANAGER_H
+/**
+ * @file GlyphManager.h
+ * @brief Owner of the LCD's 8 CGRAM slots, loading icons from LcdGlyphs.h on demand.
+ *
+ * The glyph table holds more icons than the controller has custom character
+ * slots. Screens ask for a glyph by id; a resident glyph is reused as is, a
+ * missing one is loaded into a free slot or, when all are taken, into the
+ * least recently used slot that no cell of the frame being drawn still shows.
+ * Loads go through the frame buffer, so a slot is only rewritten on the
+ * display when its pattern really changes.
+ */
+
+#include <Arduino.h>
+#include "LcdFrameBuffer.h"
+#include "LcdGlyphs.h"
+
+class GlyphManager {
+public:
+    struct Stats {
+        uint32_t hits;           ///< Requests served by a resident glyph
+        uint32_t loads;          ///< Glyphs loaded into a slot
+        uint32_t evictions;      ///< Loads that replaced another glyph
+    };
+
+    explicit GlyphManager(LcdFrameBuffer* lcd);
+
+    int8_t acquire(LcdGlyphId id);             ///< Slot showing the glyph, loading it if needed; -1 for a bad id
+    size_t print(LcdGlyphId id);               ///< Write the glyph at the frame buffer cursor
+    void reset();                              ///< Forget every slot, e.g. after the display was reinitialized
+    bool isResident(LcdGlyphId id) const;
+    int8_t getSlot(LcdGlyphId id) const;       ///< Slot holding the glyph, -1 if not resident
+    const Stats& getStats() const;
+
+private:
+    static const uint8_t SLOTS = LcdFrameBuffer::GLYPH_SLOTS;
+    static const uint8_t EMPTY = 0xFF;
+
+    uint8_t pickSlot() const;
+
+    LcdFrameBuffer* lcd;
+    uint8_t slotGlyph[SLOTS];    ///< LcdGlyphId loaded in each slot, EMPTY if none
+    uint32_t lastUse[SLOTS];     ///< Use counter value of the last request
+    uint32_t useCounter;
+    Stats stats;
+};
+
+#endif // GLYPHMANAGER_H
@@ -0,0 +1,327 @@
+#include "GpioManager.h"
+
+/// Pins shown by the page; the JSON keys match its element ids
+static const GpioPin GPIO_PINS[] = {
+    {"led1", GPIO_LED1_PIN, true, false},
+    {"led2", GPIO_LED2_PIN, true, false},
+    {"button1", GPIO_BUTTON1_PIN, false, true},
+    {"button2", GPIO_BUTTON2_PIN, false, true},
+};
+static const uint8_t GPIO_PIN_COUNT = sizeof(GPIO_PINS) / sizeof(GPIO_PINS[0]);
+
+/**
+ * @brief Constructor for the GpioManager class.
+ *
+ * @param assets Web UI assets, used to serve the page.
+ */
+GpioManager::GpioManager(AssetCatalog* assets)
+    : assets(assets), events("/gpio/events"), task(nullptr), levels(0), version(1), edgePending(false),
+      resync(false) {
+    portMUX_INITIALIZE(&lock);
+    memset(&stats, 0, sizeof(stats));
+}
+
+/**
+ * @brief Configures the pins, starts the GPIO task and registers the routes.
+ *
+ * Outputs start off. Inputs use the internal pull-ups and interrupt on
+ * both edges.
+ *
+ * @param server The WiFiManager's web server.
+ * @return false if the task could not be created; the routes still serve
+ *         the output state.
+ */
+bool GpioManager::begin(AsyncWebServer& server) {
+    for (uint8_t i = 0; i < GPIO_PIN_COUNT; i++) {
+        const GpioPin& pin = GPIO_PINS[i];
+        if (pin.output) {
+            pinMode(pin.pin, OUTPUT);
+            digitalWrite(pin.pin, LOW);
+        } else {
+            pinMode(pin.pin, INPUT_PULLUP);
+        }
+    }
+    levels = readInputs();
+
+    bool started = Tasks.start(TASK_GPIO, taskEntry, this, &task);
+    if (started) {
+        for (uint8_t i = 0; i < GPIO_PIN_COUNT; i++) {
+            if (!GPIO_PINS[i].output) {
+                attachInterruptArg(digitalPinToInterrupt(GPIO_PINS[i].pin), onEdge, this, CHANGE);
+            }
+        }
+    } else {
+        task = nullptr;
+        if (DEBUGMODE) {
+            Serial.println("GpioManager: task not started, inputs are not tracked");
+        }
+    }
+
+    server.on("/gpioctrl", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        assets->send(request, "/gpiomanager.html");
+    });
+    events.onConnect([this](AsyncEventSourceClient* client) { onEventsConnect(client); });
+    server.addHandler(&events);
+    server.on("/gpio/set", HTTP_POST, [this](AsyncWebServerRequest* request) { handleSet(request); });
+    server.on("/status", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        char json[GPIO_STATE_SIZE];
+        formatState(getLevels(), json, sizeof(json));
+        request->send(200, "application/json", json);
+    });
+    return started;
+}
+
+/**
+ * @brief Sets an output pin; the GPIO task pushes the new state.
+ *
+ * @param name Pin name from the table, e.g. "led1".
+ * @param on true to drive it high.
+ * @return false if no output has this name.
+ */
+bool GpioManager::setOutput(const char* name, bool on) {
+    int8_t index = findPin(name);
+    if (index < 0 || !GPIO_PINS[index].output) {
+        return false;
+    }
+    digitalWrite(GPIO_PINS[index].pin, on ? HIGH : LOW);
+    publish(1UL << index, on ? 1UL << index : 0);
+    wake();
+    return true;
+}
+
+uint32_t GpioManager::getLevels() const {
+    portENTER_CRITICAL(&lock);
+    uint32_t copy = levels;
+    portEXIT_CRITICAL(&lock);
+    return copy;
+}
+
+GpioManager::Stats GpioManager::getStats() const {
+    Stats copy;
+    portENTER_CRITICAL(&lock);
+    copy = stats;
+    portEXIT_CRITICAL(&lock);
+    copy.clients = events.count();
+    return copy;
+}
+
+/**
+ * @brief Input edge interrupt: wakes the GPIO task, nothing else.
+ */
+void IRAM_ATTR GpioManager::onEdge(void* arg) {
+    GpioManager* self = static_cast<GpioManager*>(arg);
+    portENTER_CRITICAL_ISR(&self->lock);
+    self->stats.interrupts++;
+    self->edgePending = true;
+    portEXIT_CRITICAL_ISR(&self->lock);
+
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(self->task, &woken);
+    if (woken == pdTRUE) {
+        portYIELD_FROM_ISR();
+    }
+}
+
+void GpioManager::taskEntry(void* param) {
+    static_cast<GpioManager*>(param)->run();
+}
+
+/**
+ * @brief GPIO task body: debounces the edges reported by the ISR and is
+ * the only sender of SSE events.
+ *
+ * After the first edge the task sleeps GPIO_DEBOUNCE_MS, dropping the
+ * notifications of the bounces that followed, then samples the inputs once.
+ * Every wake-up, whether from an edge, an output set or a new client, ends
+ * with pushState(). Without any for GPIO_KEEPALIVE_MS it pings the SSE
+ * clients instead.
+ */
+void GpioManager::run() {
+    uint32_t inputMask = 0;
+    for (uint8_t i = 0; i < GPIO_PIN_COUNT; i++) {
+        if (!GPIO_PINS[i].output) inputMask |= 1UL << i;
+    }
+
+    uint32_t sent = 0;   // Version last pushed to the clients
+    while (true) {
+        if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(GPIO_KEEPALIVE_MS)) == 0) {
+            if (events.count() > 0) {
+                events.send("{}", "ping");
+            }
+            continue;
+        }
+
+        portENTER_CRITICAL(&lock);
+        bool edge = edgePending;
+        portEXIT_CRITICAL(&lock);
+        if (edge) {
+            vTaskDelay(pdMS_TO_TICKS(GPIO_DEBOUNCE_MS));
+            ulTaskNotifyTake(pdTRUE, 0);
+            portENTER_CRITICAL(&lock);
+            edgePending = false;   // A later edge sets it again and wakes the task
+            portEXIT_CRITICAL(&lock);
+        }
+
+        TaskWork work(TASK_GPIO);
+        if (edge) {
+            publish(inputMask, readInputs());
+        }
+        pushState(sent);
+    }
+}
+
+/**
+ * @brief Samples the input pins.
+ *
+ * @return Bit i set when input i is active; output bits are 0.
+ */
+uint32_t GpioManager::readInputs() const {
+    uint32_t inputs = 0;
+    for (uint8_t i = 0; i < GPIO_PIN_COUNT; i++) {
+        const GpioPin& pin = GPIO_PINS[i];
+        if (!pin.output && (digitalRead(pin.pin) == (pin.activeLow ? LOW : HIGH))) {
+            inputs |= 1UL << i;
+        }
+    }
+    return inputs;
+}
+
+/**
+ * @brief Updates some pins of the state and, if it changed, bumps the
+ * version. Sends nothing: see pushState().
+ *
+ * @param mask Pins to update.
+ * @param values Their new levels, bits outside mask are ignored.
+ */
+void GpioManager::publish(uint32_t mask, uint32_t values) {
+    portENTER_CRITICAL(&lock);
+    uint32_t updated = (levels & ~mask) | (values & mask);
+    bool changed = updated != levels;
+    if (changed) {
+        levels = updated;
+        version++;
+        stats.changes++;
+    }
+    portEXIT_CRITICAL(&lock);
+}
+
+/**
+ * @brief Pushes the latest state as a `state` event if it is newer than the
+ * last one sent or a client asked for a resync. GPIO task only.
+ *
+ * Snapshot, formatting and send all happen on this one task, so two states
+ * can never overtake each other. send() only queues the event on each
+ * client, so a slow page never holds up the task.
+ *
+ * @param sent Version last pushed, updated.
+ */
+void GpioManager::pushState(uint32_t& sent) {
+    portENTER_CRITICAL(&lock);
+    uint32_t state = levels;
+    uint32_t current = version;
+    bool forced = resync;
+    resync = false;
+    portEXIT_CRITICAL(&lock);
+
+    if (current == sent && !forced) {
+        return;
+    }
+    sent = current;
+    if (events.count() > 0) {
+        char json[GPIO_STATE_SIZE];
+        formatState(state, json, sizeof(json));
+        events.send(json, "state", current);
+    }
+}
+
+/**
+ * @brief Wakes the GPIO task so it pushes the latest state.
+ */
+void GpioManager::wake() {
+    if (task != nullptr) {
+        xTaskNotifyGive(task);
+    }
+}
+
+/**
+ * @brief Formats a state as `{"led1":true,...}`.
+ *
+ * @return Length written.
+ */
+size_t GpioManager::formatState(uint32_t state, char* out, size_t size) const {
+    size_t length = 0;
+    for (uint8_t i = 0; i < GPIO_PIN_COUNT && length < size; i++) {
+        int written = snprintf(out + length, size - length, "%c\"%s\":%s", i == 0 ? '{' : ',', GPIO_PINS[i].name,
+                               (state & (1UL << i)) ? "true" : "false");
+        if (written < 0) break;
+        length += written;
+    }
+    if (length + 1 < size) {
+        out[length++] = '}';
+        out[length] = '\0';
+    }
+    return length < size ? length : size - 1;
+}
+
+int8_t GpioManager::findPin(const char* name) const {
+    for (uint8_t i = 0; i < GPIO_PIN_COUNT; i++) {
+        if (strcmp(GPIO_PINS[i].name, name) == 0) return i;
+    }
+    return -1;
+}
+
+/**
+ * @brief Accepts an SSE client and has the GPIO task send the current
+ * state. Runs on the web server task.
+ *
+ * The state goes to every client with its current version; the others
+ * just see the same state again.
+ */
+void GpioManager::onEventsConnect(AsyncEventSourceClient* client) {
+    if (events.count() > GPIO_MAX_CLIENTS) {   // The count includes this client
+        portENTER_CRITICAL(&lock);
+        stats.refused++;
+        portEXIT_CRITICAL(&lock);
+        client->close();
+        return;
+    }
+
+    portENTER_CRITICAL(&lock);
+    resync = true;
+    portEXIT_CRITICAL(&lock);
+    wake();
+}
+
+/**
+ * @brief Sets an output from the form fields `pin` and `state`.
+ */
+void GpioManager::handleSet(AsyncWebServerRequest* request) {
+    if (!request->hasParam("pin", true) || !request->hasParam("state", true)) {
+        request->send(400, "text/plain", "Missing pin or state");
+        return;
+    }
+    const char* name = request->getParam("pin", true)->value().c_str();
+    const String& value = request->getParam("state", true)->value();
+    int8_t index = findPin(name);
+    if (index < 0 || !GPIO_PINS[index].output) {
+        request->send(400, "text/plain", "Unknown output");
+        return;
+    }
+
+    bool on;
+    if (value == "on") {
+        on = true;
+    } else if (value == "off") {
+        on = false;
+    } else if (value == "toggle") {
+        on = (getLevels() & (1UL << index)) == 0;
+    } else {
+        request->send(400, "text/plain", "State must be on, off or toggle");
+        return;
+    }
+    setOutput(name, on);
+
+    char json[GPIO_STATE_SIZE];
+    formatState(getLevels(), json, sizeof(json));
+    request->send(200, "application/json", json);
+}
@@ -0,0 +1,85 @@
+#ifndef GPIOMANAGER_H
+#define GPIOMANAGER_H
+/**
+ * @file GpioManager.h
+ * @brief Backend of data/gpiomanager.html: pin states pushed over SSE, outputs set by POST.
+ *
+ * The pins of the page (two LEDs, two buttons) are listed in a table. Input
+ * pins raise a CHANGE interrupt; the ISR only wakes the GPIO task, which
+ * waits `GPIO_DEBOUNCE_MS` for the contacts to settle, samples every input
+ * and publishes the new state if it differs. Each published state bumps a
+ * version number. Only the GPIO task sends on the AsyncEventSource: the
+ * POST handler updates the outputs and a new SSE client raises a resync,
+ * and both just wake the task, which pushes the latest state. The events
+ * therefore leave in version order and the library's client list is never
+ * used from two tasks at once.
+ *
+ * Routes registered on the WiFiManager's AsyncWebServer:
+ * - `GET /gpioctrl`       : the page, through the AssetCatalog.
+ * - `GET /gpio/events`    : SSE stream, one `state` event with the JSON of
+ *                           every pin on connection and after each change.
+ * - `GET /status`         : the same JSON, for one-off reads.
+ * - `POST /gpio/set`      : `pin=led1&state=on|off|toggle`, answers the new state.
+ *
+ * The bounces of one press are coalesced by the debounce wait, so a press
+ * and its release cost two events; an idle page costs one `ping` event
+ * every `GPIO_KEEPALIVE_MS`.
+ */
+
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "Config.h"
+#include "AssetCatalog.h"
+#include "TaskTopology.h"
+
+struct GpioPin {
+    const char* name;        ///< Key in the JSON state and the `pin` parameter
+    uint8_t pin;
+    bool output;
+    bool activeLow;          ///< Input reads 0 when pressed
+};
+
+class GpioManager {
+public:
+    struct Stats {
+        uint32_t interrupts;   ///< Edges seen by the ISR
+        uint32_t changes;      ///< States published after debouncing
+        uint32_t refused;      ///< SSE connections refused because every slot was taken
+        uint8_t clients;       ///< SSE clients connected now
+    };
+
+    explicit GpioManager(AssetCatalog* assets);
+
+    bool begin(AsyncWebServer& server);   ///< Configure the pins, attach the interrupts, start the task, register the routes
+    bool setOutput(const char* name, bool on);
+    uint32_t getLevels() const;           ///< Bit i is the logical state of pin i (on / pressed)
+    Stats getStats() const;
+
+private:
+    static void IRAM_ATTR onEdge(void* arg);
+    static void taskEntry(void* param);
+    void run();
+    uint32_t readInputs() const;
+    void publish(uint32_t mask, uint32_t values);
+    void pushState(uint32_t& sent);
+    void wake();
+    size_t formatState(uint32_t levels, char* out, size_t size) const;
+    int8_t findPin(const char* name) const;
+
+    void onEventsConnect(AsyncEventSourceClient* client);
+    void handleSet(AsyncWebServerRequest* request);
+
+    AssetCatalog* assets;
+    AsyncEventSource events;
+    TaskHandle_t task;
+    uint32_t levels;           ///< Published state
+    uint32_t version;          ///< Bumped on every published change, the SSE event id
+    bool edgePending;          ///< Set by the ISR: the inputs must be debounced and sampled
+    bool resync;               ///< Set when an SSE client connects: the state is sent even if unchanged
+    Stats stats;
+    mutable portMUX_TYPE lock; ///< Protects levels, version, the flags and stats across the ISR, the GPIO task and the web server
+};
+
+#endif // GPIOMANAGER_H
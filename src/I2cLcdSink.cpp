@@ -0,0 +1,106 @@
+#include "I2cLcdSink.h"
+
+// PCF8574 pins as wired on the common backpacks: P0 = RS, P2 = E, P3 = backlight, P4-P7 = D4-D7
+static const uint8_t PIN_RS = 0x01;
+static const uint8_t PIN_EN = 0x04;
+static const uint8_t PIN_BACKLIGHT = 0x08;
+
+static const uint8_t CMD_SET_CGRAM_ADDR = 0x40;
+static const uint8_t CMD_SET_DDRAM_ADDR = 0x80;
+static const uint8_t rowOffsets[] = {0x00, 0x40, 0x14, 0x54};
+
+/**
+ * @brief Constructor for the I2cLcdSink class.
+ *
+ * @param lcd Display driver used for the controller initialization.
+ * @param address I2C address of the backpack.
+ */
+I2cLcdSink::I2cLcdSink(LiquidCrystal_I2C* lcd, uint8_t address)
+    : lcd(lcd), address(address), length(0), busBytes(0) {}
+
+/**
+ * @brief Initializes the controller and turns the backlight on. The
+ * controller's own initialization clears the display.
+ */
+void I2cLcdSink::begin() {
+    lcd->init();
+    lcd->backlight();
+    length = 0;
+    busBytes = 0;
+}
+
+/**
+ * @brief Queues a cursor command; it goes out with the next characters.
+ */
+void I2cLcdSink::moveTo(uint8_t col, uint8_t row) {
+    if (row >= sizeof(rowOffsets)) {
+        row = sizeof(rowOffsets) - 1;
+    }
+    put(CMD_SET_DDRAM_ADDR | (rowOffsets[row] + col), false);
+}
+
+/**
+ * @brief Writes a run of characters, with any pending cursor command, in
+ * one transaction per Wire buffer.
+ */
+void I2cLcdSink::writeChars(const uint8_t* data, uint8_t len) {
+    for (uint8_t i = 0; i < len; i++) {
+        put(data[i], true);
+    }
+    send();
+}
+
+/**
+ * @brief Writes a custom character pattern, address command and 8 rows in
+ * one transaction. The controller is left addressing CGRAM.
+ */
+void I2cLcdSink::loadGlyph(uint8_t slot, const uint8_t* rows) {
+    put(CMD_SET_CGRAM_ADDR | ((slot & 0x07) << 3), false);
+    for (uint8_t i = 0; i < 8; i++) {
+        put(rows[i] & 0x1F, true);
+    }
+    send();
+}
+
+uint32_t I2cLcdSink::getBusBytes() const {
+    return busBytes;
+}
+
+/**
+ * @brief Appends one character or command as two nibbles, each latched by
+ * a falling enable edge.
+ *
+ * The controller needs 37 us to execute a write; at 100 kHz the four
+ * expander bytes of the next one take about 360 us to clock out, so no
+ * delay is needed between writes.
+ *
+ * @param value Character or command byte.
+ * @param data true for a character (RS high), false for a command.
+ */
+void I2cLcdSink::put(uint8_t value, bool data) {
+    if (length + BYTES_PER_WRITE > TX_BUFFER_SIZE) {
+        send();
+    }
+    uint8_t flags = PIN_BACKLIGHT | (data ? PIN_RS : 0);
+    uint8_t high = (value & 0xF0) | flags;
+    uint8_t low = ((value << 4) & 0xF0) | flags;
+    buffer[length++] = high | PIN_EN;
+    buffer[length++] = high;
+    buffer[length++] = low | PIN_EN;
+    buffer[length++] = low;
+}
+
+/**
+ * @brief Sends the pending expander bytes as one I2C transaction.
+ */
+void I2cLcdSink::send() {
+    if (length == 0) return;
+
+    Wire.beginTransmission(address);
+    Wire.write(buffer, length);
+    if (Wire.endTransmission() != 0 && DEBUGMODE) {
+        Serial.println("I2cLcdSink: I2C write failed");
+    }
+    busBytes += 1 + length;  // Address byte plus payload
+    length = 0;
+}
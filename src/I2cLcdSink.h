@@ -0,0 +1,48 @@
+#ifndef I2CLCDSINK_H
+#define I2CLCDSINK_H
+/**
+ * @file I2cLcdSink.h
+ * @brief LcdSink for an HD44780 behind a PCF8574 I2C backpack.
+ *
+ * LiquidCrystal_I2C is only used to initialize the controller. Its write path
+ * sends every nibble as three separate one-byte I2C transfers (12 bus bytes and
+ * 6 address phases per character). The sink instead builds the expander bytes
+ * itself, two per nibble (enable high with the data, then enable low), and
+ * sends a whole run of characters, cursor command included, in as few
+ * transactions as the Wire buffer allows: about 4 bus bytes per character.
+ *
+ * The bus runs at the PCF8574's rated 100 kHz. Estimated from bus timing, not
+ * measured: a full 20x4 refresh (80 characters, 4 cursor moves) takes about
+ * 31 ms this way against about 110 ms through the library. The render
+ * statistics and the "lcd.render" trace span give the measured figure.
+ */
+
+#include <LiquidCrystal_I2C.h>
+#include <Wire.h>
+#include "LcdFrameBuffer.h"
+
+class I2cLcdSink : public LcdSink {
+public:
+    explicit I2cLcdSink(LiquidCrystal_I2C* lcd, uint8_t address = LCD_I2C_ADDRESS);
+
+    void begin() override;
+    void moveTo(uint8_t col, uint8_t row) override;
+    void writeChars(const uint8_t* data, uint8_t len) override;
+    void loadGlyph(uint8_t slot, const uint8_t* rows) override;
+    uint32_t getBusBytes() const override;
+
+private:
+    static const uint8_t BYTES_PER_WRITE = 4;   ///< Expander bytes per character or command
+    static const uint8_t TX_BUFFER_SIZE = 128;  ///< Wire transmit buffer on the ESP32
+
+    void put(uint8_t value, bool data);
+    void send();
+
+    LiquidCrystal_I2C* lcd;
+    uint8_t address;
+    uint8_t buffer[TX_BUFFER_SIZE];  ///< Expander bytes of the pending transaction
+    uint8_t length;
+    uint32_t busBytes;
+};
+
+#endif // I2CLCDSINK_H
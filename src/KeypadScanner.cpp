@@ -0,0 +1,190 @@
+#include "KeypadScanner.h"
+
+// Keypad layout (rows and columns)
+static const char keyMap[ROW_NUM][COLUMN_NUM] = {
+    {'1', '2', '3'},
+    {'4', '5', '6'},
+    {'7', '8', '9'},
+    {'*', '0', '#'}
+};
+
+static const uint8_t rowPins[ROW_NUM] = {KEYPAD_ROW_1_PIN, KEYPAD_ROW_2_PIN, KEYPAD_ROW_3_PIN, KEYPAD_ROW_4_PIN};
+static const uint8_t colPins[COLUMN_NUM] = {KEYPAD_COL_1_PIN, KEYPAD_COL_2_PIN, KEYPAD_COL_3_PIN};
+
+/// Scans a key must read the same before its debounced state changes
+static const uint8_t DEBOUNCE_SCANS = (KEYPAD_DEBOUNCE_MS + KEYPAD_SCAN_PERIOD_MS - 1) / KEYPAD_SCAN_PERIOD_MS;
+
+/**
+ * @brief Constructor for the KeypadScanner class.
+ *
+ * @param queue UI queue receiving the key events.
+ */
+KeypadScanner::KeypadScanner(QueueHandle_t queue)
+    : queue(queue), timer(nullptr), stable(0), longSent(0) {
+    memset(counters, 0, sizeof(counters));
+    memset(pressedAtMs, 0, sizeof(pressedAtMs));
+    memset(&stats, 0, sizeof(stats));
+    portMUX_INITIALIZE(&lock);
+}
+
+KeypadScanner::~KeypadScanner() {
+    end();
+}
+
+/**
+ * @brief Configures the matrix pins and starts the periodic scan.
+ *
+ * Rows are inputs with pull-ups; columns stay high-impedance except while
+ * they are being scanned.
+ *
+ * @return true if the scan timer is running.
+ */
+bool KeypadScanner::begin() {
+    for (uint8_t r = 0; r < ROW_NUM; r++) {
+        pinMode(rowPins[r], INPUT_PULLUP);
+    }
+    for (uint8_t c = 0; c < COLUMN_NUM; c++) {
+        pinMode(colPins[c], INPUT);
+    }
+
+    esp_timer_create_args_t args = {};
+    args.callback = &KeypadScanner::onTimer;
+    args.arg = this;
+    args.dispatch_method = ESP_TIMER_TASK;
+    args.name = "keypad";
+
+    if (esp_timer_create(&args, &timer) != ESP_OK) {
+        if (DEBUGMODE) {
+            Serial.println("KeypadScanner: failed to create the scan timer");
+        }
+        timer = nullptr;
+        return false;
+    }
+    return esp_timer_start_periodic(timer, KEYPAD_SCAN_PERIOD_MS * 1000ULL) == ESP_OK;
+}
+
+void KeypadScanner::end() {
+    if (timer != nullptr) {
+        esp_timer_stop(timer);
+        esp_timer_delete(timer);
+        timer = nullptr;
+    }
+}
+
+KeypadScanner::Stats KeypadScanner::getStats() const {
+    KeypadScanner::Stats copy;
+    portENTER_CRITICAL(&lock);
+    copy = stats;
+    portEXIT_CRITICAL(&lock);
+    return copy;
+}
+
+/**
+ * @brief Prints the scan statistics after the 'U' task report: the scan runs
+ * on the esp_timer task, outside the TaskTopology tasks.
+ */
+void KeypadScanner::printReport(Print& out) const {
+    Stats copy = getStats();
+    out.printf("Keypad: %lu scans, avg %lu us, max %lu us, %lu events, %lu dropped\n", (unsigned long)copy.scans,
+               (unsigned long)(copy.scans > 0 ? copy.totalScanUs / copy.scans : 0), (unsigned long)copy.maxScanUs,
+               (unsigned long)copy.events, (unsigned long)copy.dropped);
+}
+
+bool KeypadScanner::isPressed(char key) const {
+    for (uint8_t i = 0; i < KEY_COUNT; i++) {
+        if (keyMap[i / COLUMN_NUM][i % COLUMN_NUM] == key) {
+            return (stable >> i) & 1;
+        }
+    }
+    return false;
+}
+
+void KeypadScanner::onTimer(void* arg) {
+    static_cast<KeypadScanner*>(arg)->scan();
+}
+
+/**
+ * @brief Reads the raw matrix: bit set for every key closed right now.
+ */
+uint16_t KeypadScanner::readMatrix() {
+    uint16_t raw = 0;
+    for (uint8_t c = 0; c < COLUMN_NUM; c++) {
+        pinMode(colPins[c], OUTPUT);
+        digitalWrite(colPins[c], LOW);
+        delayMicroseconds(2);  // Let the row lines settle
+        for (uint8_t r = 0; r < ROW_NUM; r++) {
+            if (digitalRead(rowPins[r]) == LOW) {
+                raw |= 1 << (r * COLUMN_NUM + c);
+            }
+        }
+        pinMode(colPins[c], INPUT);
+    }
+    return raw;
+}
+
+/**
+ * @brief One scan: debounce every key and post the resulting events.
+ *
+ * Runs on the esp_timer task, never on the UI task.
+ */
+void KeypadScanner::scan() {
+    int64_t startUs = esp_timer_get_time();
+    uint32_t nowMs = (uint32_t)(startUs / 1000);
+    uint16_t raw = readMatrix();
+
+    for (uint8_t i = 0; i < KEY_COUNT; i++) {
+        uint16_t bit = 1 << i;
+        bool down = raw & bit;
+        bool wasDown = stable & bit;
+
+        if (down == wasDown) {
+            counters[i] = 0;
+            if (down && !(longSent & bit) && nowMs - pressedAtMs[i] >= KEYPAD_LONG_PRESS_MS) {
+                longSent |= bit;
+                emit(UI_EVENT_KEY_LONG, i, nowMs);
+            }
+            continue;
+        }
+
+        if (++counters[i] < DEBOUNCE_SCANS) {
+            continue;
+        }
+        counters[i] = 0;
+
+        if (down) {
+            stable |= bit;
+            pressedAtMs[i] = nowMs;
+            emit(UI_EVENT_KEY, i, nowMs);
+        } else {
+            stable &= ~bit;
+            longSent &= ~bit;
+            emit(UI_EVENT_KEY_RELEASE, i, nowMs);
+        }
+    }
+
+    uint32_t durationUs = (uint32_t)(esp_timer_get_time() - startUs);
+    portENTER_CRITICAL(&lock);
+    stats.scans++;
+    stats.lastScanUs = durationUs;
+    stats.totalScanUs += durationUs;
+    if (durationUs > stats.maxScanUs) {
+        stats.maxScanUs = durationUs;
+    }
+    portEXIT_CRITICAL(&lock);
+}
+
+/**
+ * @brief Posts a key event without blocking the scan.
+ */
+void KeypadScanner::emit(UiEventType type, uint8_t index, uint32_t nowMs) {
+    UiEvent event = {type, (uint8_t)keyMap[index / COLUMN_NUM][index % COLUMN_NUM], nowMs};
+    bool sent = xQueueSend(queue, &event, 0) == pdTRUE;
+
+    portENTER_CRITICAL(&lock);
+    if (sent) {
+        stats.events++;
+    } else {
+        stats.dropped++;
+    }
+    portEXIT_CRITICAL(&lock);
+}
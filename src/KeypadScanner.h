@@ -0,0 +1,66 @@
+#ifndef KEYPADSCANNER_H
+#define KEYPADSCANNER_H
+/**
+ * @file KeypadScanner.h
+ * @brief Timer-driven 4x3 keypad matrix scanner.
+ *
+ * An esp_timer fires every `KEYPAD_SCAN_PERIOD_MS` and scans the matrix: each
+ * column is driven low in turn and the four rows are read with their pull-ups.
+ * Debouncing happens in the driver: a key must read the same for
+ * `KEYPAD_DEBOUNCE_MS` before its state changes. Every change is posted as a
+ * timestamped UiEvent (press, release) into the UI queue, and a key held for
+ * `KEYPAD_LONG_PRESS_MS` additionally posts a long-press event.
+ *
+ * Keys are therefore caught while the UI task is busy with a card operation;
+ * the UI consumes them when it gets back to its queue. Scan cost and dropped
+ * events are reported by getStats(), exported on /metrics and printed with
+ * the 'U' console report; the UI records key-to-action latency in the trace
+ * buffer.
+ */
+
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include "Config.h"
+#include "UiEvent.h"
+
+class KeypadScanner {
+public:
+    struct Stats {
+        uint32_t scans;          ///< Matrix scans since begin()
+        uint32_t lastScanUs;     ///< Duration of the last scan
+        uint32_t maxScanUs;      ///< Longest scan
+        uint64_t totalScanUs;    ///< Sum of scan durations, for the average
+        uint32_t events;         ///< Events posted
+        uint32_t dropped;        ///< Events lost because the queue was full
+    };
+
+    explicit KeypadScanner(QueueHandle_t queue);
+    ~KeypadScanner();
+
+    bool begin();                     ///< Configure the pins and start the scan timer
+    void end();                       ///< Stop scanning
+    Stats getStats() const;
+    void printReport(Print& out) const;   ///< One line of scan cost and key events
+    bool isPressed(char key) const;   ///< Debounced state of a key
+
+private:
+    static const uint8_t KEY_COUNT = ROW_NUM * COLUMN_NUM;
+
+    static void onTimer(void* arg);
+    void scan();
+    uint16_t readMatrix();
+    void emit(UiEventType type, uint8_t index, uint32_t nowMs);
+
+    QueueHandle_t queue;
+    esp_timer_handle_t timer;
+    uint16_t stable;                      ///< Debounced key bitmap, bit = row * COLUMN_NUM + column
+    uint16_t longSent;                    ///< Keys whose long press was already reported
+    uint8_t counters[KEY_COUNT];          ///< Consecutive scans disagreeing with the stable state
+    uint32_t pressedAtMs[KEY_COUNT];      ///< When each held key was pressed
+    Stats stats;
+    mutable portMUX_TYPE lock;            ///< Protects stats for readers on the other core
+};
+
+#endif // KEYPADSCANNER_H
@@ -0,0 +1,250 @@
+#include "LcdFrameBuffer.h"
+#include <esp_timer.h>
+#include "TraceBuffer.h"
+
+/**
+ * @brief Constructor for the LcdFrameBuffer class.
+ *
+ * @param sink Display the frame is pushed to.
+ */
+LcdFrameBuffer::LcdFrameBuffer(LcdSink* sink)
+    : sink(sink), cursorCol(0), cursorRow(0), displayCol(COLS), displayRow(0), mailbox(nullptr), task(nullptr) {
+    memset(&drawn, 0, sizeof(drawn));
+    memset(drawn.cells, ' ', sizeof(drawn.cells));
+    posted = drawn;
+    memset(shown, ' ', sizeof(shown));
+    memset(shownGlyphs, 0, sizeof(shownGlyphs));
+    memset(&stats, 0, sizeof(stats));
+}
+
+/**
+ * @brief Initializes the display. Both frames start blank, matching the
+ * state the display is left in by its own initialization. CGRAM content is
+ * undefined after power-up, so every slot is marked for reloading.
+ */
+void LcdFrameBuffer::begin() {
+    sink->begin();
+    memset(drawn.cells, ' ', sizeof(drawn.cells));
+    drawn.fullRedraw = false;
+    posted = drawn;
+    memset(shown, ' ', sizeof(shown));
+    memset(shownGlyphs, 0xFF, sizeof(shownGlyphs));
+    cursorCol = 0;
+    cursorRow = 0;
+    displayCol = COLS;
+}
+
+/**
+ * @brief Blanks the RAM frame. The display is only updated by flush().
+ */
+void LcdFrameBuffer::clear() {
+    memset(drawn.cells, ' ', sizeof(drawn.cells));
+    cursorCol = 0;
+    cursorRow = 0;
+}
+
+void LcdFrameBuffer::setCursor(uint8_t col, uint8_t row) {
+    cursorCol = col;
+    cursorRow = row;
+}
+
+/**
+ * @brief Writes one character at the cursor and advances it.
+ *
+ * Characters past the end of the line are dropped instead of wrapping into
+ * another line as the controller would.
+ *
+ * @param c Character code, 0-7 select the custom glyphs.
+ * @return Always 1 so Print keeps writing.
+ */
+size_t LcdFrameBuffer::write(uint8_t c) {
+    if (cursorRow < ROWS && cursorCol < COLS) {
+        drawn.cells[cursorRow][cursorCol] = c;
+    }
+    if (cursorCol < COLS) {
+        cursorCol++;
+    }
+    return 1;
+}
+
+/**
+ * @brief Starts the LCD task; later flushes only post the frame to it.
+ *
+ * @return true if the task is running.
+ */
+bool LcdFrameBuffer::startTask() {
+    if (task != nullptr) return true;
+
+    mailbox = xQueueCreate(1, sizeof(Frame));
+    if (mailbox == nullptr) return false;
+
+    if (!Tasks.start(TASK_LCD, renderTask, this, &task)) {
+        vQueueDelete(mailbox);
+        mailbox = nullptr;
+        task = nullptr;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Pushes the frame to the display.
+ *
+ * Inline mode renders the changed cells right away. With the LCD task
+ * running, the frame is copied into the mailbox (replacing any frame not yet
+ * drawn) unless it is identical to the last one posted, and the call returns
+ * without touching the bus.
+ *
+ * @return Number of cells sent to the display, 0 when rendering is deferred.
+ */
+size_t LcdFrameBuffer::flush() {
+    if (mailbox == nullptr) {
+        size_t sent = render(drawn);
+        drawn.fullRedraw = false;
+        return sent;
+    }
+
+    if (!drawn.fullRedraw && memcmp(drawn.cells, posted.cells, sizeof(drawn.cells)) == 0 &&
+        memcmp(drawn.glyphs, posted.glyphs, sizeof(drawn.glyphs)) == 0) {
+        return 0;
+    }
+    posted = drawn;
+    drawn.fullRedraw = false;
+    xQueueOverwrite(mailbox, &posted);
+    return 0;
+}
+
+/**
+ * @brief LCD task body: renders every frame taken from the mailbox.
+ *
+ * @param param The LcdFrameBuffer.
+ */
+void LcdFrameBuffer::renderTask(void* param) {
+    LcdFrameBuffer* self = static_cast<LcdFrameBuffer*>(param);
+    Frame frame;
+    while (true) {
+        if (xQueueReceive(self->mailbox, &frame, portMAX_DELAY) == pdTRUE) {
+            TaskWork work(TASK_LCD);
+            self->render(frame);
+        }
+    }
+}
+
+/**
+ * @brief Sends the glyphs and cells of a frame that differ from the display.
+ *
+ * Changed CGRAM slots are loaded first; cells showing them change on the
+ * display by themselves. Each line is then scanned for changed cells. A run
+ * starts at the first changed cell and grows while the next cell is
+ * changed, or while the cell after a single unchanged one is. The cursor is
+ * only moved when the run does not start where the previous one left the
+ * display cursor.
+ *
+ * @param frame Frame to display; `fullRedraw` sends every glyph and cell.
+ * @return Number of cells and glyphs sent to the display.
+ */
+size_t LcdFrameBuffer::render(const Frame& frame) {
+    TRACE_SCOPE("lcd.render");
+    int64_t startUs = esp_timer_get_time();
+    const uint8_t (*cells)[COLS] = frame.cells;
+    bool full = frame.fullRedraw;
+    size_t sent = 0;
+    if (full) {
+        displayCol = COLS;  // The display may have been written behind our back
+    }
+
+    for (uint8_t slot = 0; slot < GLYPH_SLOTS; slot++) {
+        if (!full && memcmp(frame.glyphs[slot], shownGlyphs[slot], GLYPH_ROWS) == 0) {
+            continue;
+        }
+        sink->loadGlyph(slot, frame.glyphs[slot]);
+        memcpy(shownGlyphs[slot], frame.glyphs[slot], GLYPH_ROWS);
+        displayCol = COLS;  // The controller is left addressing CGRAM
+        stats.glyphLoads++;
+        sent++;
+    }
+
+    for (uint8_t row = 0; row < ROWS; row++) {
+        uint8_t col = 0;
+        while (col < COLS) {
+            if (!full && cells[row][col] == shown[row][col]) {
+                col++;
+                continue;
+            }
+
+            uint8_t start = col;
+            uint8_t end = col + 1;
+            while (end < COLS) {
+                if (full || cells[row][end] != shown[row][end]) {
+                    end++;
+                } else if (end + 1 < COLS && cells[row][end + 1] != shown[row][end + 1]) {
+                    end += 2;  // Bridge a one-cell gap
+                } else {
+                    break;
+                }
+            }
+
+            if (displayRow != row || displayCol != start) {
+                sink->moveTo(start, row);
+                stats.cursorMoves++;
+            }
+            uint8_t len = end - start;
+            sink->writeChars(&cells[row][start], len);
+            memcpy(&shown[row][start], &cells[row][start], len);
+
+            // The controller wraps into another line after the last column
+            displayRow = row;
+            displayCol = end < COLS ? end : COLS;
+            stats.cellsWritten += len;
+            sent += len;
+            col = end;
+        }
+    }
+
+    if (sent > 0) {
+        uint32_t durationUs = (uint32_t)(esp_timer_get_time() - startUs);
+        stats.flushes++;
+        stats.lastRenderUs = durationUs;
+        if (durationUs > stats.maxRenderUs) {
+            stats.maxRenderUs = durationUs;
+        }
+    }
+    return sent;
+}
+
+/**
+ * @brief Forces the next flush to resend the whole frame, e.g. after the
+ * display was reset or written to behind the frame buffer's back.
+ */
+void LcdFrameBuffer::invalidate() {
+    drawn.fullRedraw = true;
+}
+
+/**
+ * @brief Sets the pattern of a CGRAM slot. The display is only updated by
+ * flush(), and only if the pattern differs from the loaded one.
+ *
+ * @param slot Slot 0-7, shown by writing the same character code.
+ * @param rows 8 row bytes, bits 4-0 are the columns from left to right.
+ */
+void LcdFrameBuffer::defineGlyph(uint8_t slot, const uint8_t* rows) {
+    if (slot >= GLYPH_SLOTS) return;
+    memcpy(drawn.glyphs[slot], rows, GLYPH_ROWS);
+}
+
+bool LcdFrameBuffer::isCodeUsed(uint8_t code) const {
+    return memchr(drawn.cells, code, sizeof(drawn.cells)) != nullptr;
+}
+
+char LcdFrameBuffer::getChar(uint8_t col, uint8_t row) const {
+    if (row >= ROWS || col >= COLS) return ' ';
+    return (char)drawn.cells[row][col];
+}
+
+const LcdFrameBuffer::Stats& LcdFrameBuffer::getStats() const {
+    return stats;
+}
+
+uint32_t LcdFrameBuffer::getBusBytes() const {
+    return sink->getBusBytes();
+}
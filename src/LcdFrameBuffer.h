@@ -0,0 +1,110 @@
+#ifndef LCDFRAMEBUFFER_H
+#define LCDFRAMEBUFFER_H
+/**
+ * @file LcdFrameBuffer.h
+ * @brief RAM shadow of the character LCD, pushed to the display as diffs.
+ *
+ * Screens draw into the frame buffer with the usual `clear()`, `setCursor()` and
+ * `print()` calls; nothing reaches the display until `flush()`. The flush compares
+ * the frame with what the display currently shows and only sends the changed
+ * cells. Changed cells on the same line are merged into runs so each run costs a
+ * single cursor move, and a one-cell gap is bridged because rewriting an
+ * unchanged character costs the same as a cursor command.
+ *
+ * `clear()` only blanks the RAM frame: redrawing a screen over itself no longer
+ * flickers, and text that did not change is not sent again.
+ *
+ * The display is reached through the `LcdSink` interface, so the renderer can be
+ * driven on the host with a fake sink that counts bus bytes.
+ *
+ * After `startTask()`, the diff and the bus traffic run on a dedicated LCD task:
+ * `flush()` only posts a copy of the frame into a one-slot mailbox and returns,
+ * so UI code never waits on the display. Frames posted faster than the bus can
+ * render them are coalesced, only the latest one is drawn.
+ *
+ * The eight CGRAM custom characters are part of the frame too: `defineGlyph()`
+ * only changes the RAM copy and the renderer reloads the slots that differ
+ * from the display, on the same task and in the same order as the cells.
+ */
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/task.h>
+#include "Config.h"
+#include "TaskTopology.h"
+
+/**
+ * @class LcdSink
+ * @brief Minimal character display interface used by the frame buffer.
+ */
+class LcdSink {
+public:
+    virtual ~LcdSink() {}
+
+    virtual void begin() = 0;                                        ///< Initialize the display, leaves it blank
+    virtual void moveTo(uint8_t col, uint8_t row) = 0;               ///< Move the display cursor
+    virtual void writeChars(const uint8_t* data, uint8_t len) = 0;   ///< Write characters at the cursor
+    virtual void loadGlyph(uint8_t slot, const uint8_t* rows) = 0;   ///< Write an 8-row pattern to a CGRAM slot, cursor position is lost
+    virtual uint32_t getBusBytes() const = 0;                        ///< Bytes sent on the bus since begin()
+};
+
+class LcdFrameBuffer : public Print {
+public:
+    static const uint8_t COLS = LCD_COLUMNS;
+    static const uint8_t ROWS = LCD_ROWS;
+    static const uint8_t GLYPH_SLOTS = 8;   ///< CGRAM custom characters, codes 0-7
+    static const uint8_t GLYPH_ROWS = 8;
+
+    struct Stats {
+        uint32_t flushes;        ///< flush() calls that sent something
+        uint32_t cellsWritten;   ///< Characters sent to the display
+        uint32_t cursorMoves;    ///< Cursor commands sent to the display
+        uint32_t glyphLoads;     ///< CGRAM slots rewritten
+        uint32_t lastRenderUs;   ///< Duration of the last non-empty render
+        uint32_t maxRenderUs;    ///< Longest render
+    };
+
+    explicit LcdFrameBuffer(LcdSink* sink);
+
+    void begin();                                  ///< Initialize the display and blank both frames
+    bool startTask();                              ///< Render on the LCD task from now on
+    void clear();                                  ///< Blank the RAM frame, cursor to 0,0
+    void setCursor(uint8_t col, uint8_t row);      ///< Move the write position in the RAM frame
+    size_t write(uint8_t c) override;              ///< Put one character, clipped at the end of the line
+    using Print::write;
+
+    size_t flush();                                ///< Push changed cells (or hand them to the LCD task), returns cells sent
+    void invalidate();                             ///< Resend every cell on the next flush
+    void defineGlyph(uint8_t slot, const uint8_t* rows); ///< Set a CGRAM pattern, sent with the next flush
+    bool isCodeUsed(uint8_t code) const;           ///< true if a cell of the RAM frame holds this code
+
+    char getChar(uint8_t col, uint8_t row) const;  ///< Character in the RAM frame
+    const Stats& getStats() const;
+    uint32_t getBusBytes() const;                  ///< Bytes sent by the sink
+
+private:
+    struct Frame {
+        uint8_t cells[ROWS][COLS];
+        uint8_t glyphs[GLYPH_SLOTS][GLYPH_ROWS];
+        bool fullRedraw;
+    };
+
+    static void renderTask(void* param);
+    size_t render(const Frame& frame);
+
+    LcdSink* sink;
+    Frame drawn;                 ///< Frame being drawn
+    Frame posted;                ///< Last frame handed to the LCD task
+    uint8_t shown[ROWS][COLS];   ///< Frame currently on the display
+    uint8_t shownGlyphs[GLYPH_SLOTS][GLYPH_ROWS]; ///< CGRAM currently in the display
+    uint8_t cursorCol;           ///< Write position in the RAM frame
+    uint8_t cursorRow;
+    uint8_t displayCol;          ///< Display cursor after the last run, COLS when unknown
+    uint8_t displayRow;
+    Stats stats;
+    QueueHandle_t mailbox;       ///< Latest frame for the LCD task, nullptr when rendering inline
+    TaskHandle_t task;
+};
+
+#endif // LCDFRAMEBUFFER_H
@@ -0,0 +1,45 @@
+#ifndef LCDGLYPHS_H
+#define LCDGLYPHS_H
+/**
+ * @file LcdGlyphs.h
+ * @brief 5x8 custom character patterns for the LCD's CGRAM.
+ *
+ * Generated by test/imagetoglyph.py, do not edit by hand.
+ */
+
+#include <Arduino.h>
+
+enum LcdGlyphId : uint8_t {
+    GLYPH_WIFI_0,
+    GLYPH_WIFI_1,
+    GLYPH_WIFI_2,
+    GLYPH_WIFI_MAX,
+    GLYPH_BAR_1,
+    GLYPH_BAR_2,
+    GLYPH_BAR_3,
+    GLYPH_BAR_4,
+    GLYPH_BAR_5,
+    GLYPH_LOCK,
+    GLYPH_CARD,
+    GLYPH_CHECK,
+    GLYPH_CROSS,
+    GLYPH_COUNT
+};
+
+static const uint8_t LCD_GLYPHS[GLYPH_COUNT][8] PROGMEM = {
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x00},  // GLYPH_WIFI_0
+    {0x00, 0x00, 0x00, 0x00, 0x0e, 0x0a, 0x04, 0x00},  // GLYPH_WIFI_1
+    {0x00, 0x00, 0x0e, 0x1f, 0x0e, 0x0a, 0x04, 0x00},  // GLYPH_WIFI_2
+    {0x0e, 0x1f, 0x1f, 0x1f, 0x0e, 0x0a, 0x04, 0x00},  // GLYPH_WIFI_MAX
+    {0x00, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x00},  // GLYPH_BAR_1
+    {0x00, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x00},  // GLYPH_BAR_2
+    {0x00, 0x1c, 0x1c, 0x1c, 0x1c, 0x1c, 0x1c, 0x00},  // GLYPH_BAR_3
+    {0x00, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x00},  // GLYPH_BAR_4
+    {0x00, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x00},  // GLYPH_BAR_5
+    {0x0e, 0x11, 0x11, 0x1f, 0x1b, 0x1b, 0x1f, 0x00},  // GLYPH_LOCK
+    {0x00, 0x1f, 0x11, 0x15, 0x11, 0x1f, 0x00, 0x00},  // GLYPH_CARD
+    {0x00, 0x01, 0x03, 0x16, 0x1c, 0x08, 0x00, 0x00},  // GLYPH_CHECK
+    {0x00, 0x11, 0x0a, 0x04, 0x0a, 0x11, 0x00, 0x00},  // GLYPH_CROSS
+};
+
+#endif // LCDGLYPHS_H
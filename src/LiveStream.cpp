@@ -0,0 +1,374 @@
+#include "LiveStream.h"
+
+static_assert(LIVE_EVENT_SIZE <= 255, "Entry::length is 8 bits");
+
+static const char* const EVENT_NAMES[LIVE_EVENT_TYPE_COUNT] = {
+    "card",
+    "recharge",
+    "number",
+    "lock",
+    "unlock",
+};
+
+/**
+ * @brief Names the IsMasterCard() status carried by a card event.
+ */
+static const char* cardResult(uint8_t status) {
+    switch (status) {
+        case 0: return "user";
+        case 1: return "master";
+        case 6: return "auth_failed";
+        case 7: return "read_failed";
+        default: return "unknown";
+    }
+}
+
+/**
+ * @brief Masks a card UID for the unauthenticated stream, keeping its last
+ * byte: "d3:73:fd:e3" becomes "**:**:**:e3".
+ */
+static void maskCardId(const char* cardId, char* masked, size_t size) {
+    const char* lastByte = strrchr(cardId, ':');
+    size_t keep = lastByte != nullptr ? lastByte - cardId : strlen(cardId);
+    size_t length = 0;
+    for (const char* c = cardId; *c != '\0' && length + 1 < size; c++, length++) {
+        masked[length] = (size_t)(c - cardId) < keep && *c != ':' ? '*' : *c;
+    }
+    masked[length] = '\0';
+}
+
+/**
+ * @brief Constructor for the LiveStream class. The routes and the task are
+ *        set up by begin().
+ */
+LiveStream::LiveStream()
+    : events("/events"), socket("/ws"), task(nullptr), nextSequence(1) {
+    memset(ring, 0, sizeof(ring));
+    memset(clients, 0, sizeof(clients));
+    memset(&stats, 0, sizeof(stats));
+    portMUX_INITIALIZE(&lock);
+}
+
+/**
+ * @brief Registers the SSE and WebSocket endpoints on the web server and
+ * starts the task formatting their events.
+ *
+ * @param server The WiFiManager's web server.
+ */
+void LiveStream::begin(AsyncWebServer& server) {
+    events.onConnect([this](AsyncEventSourceClient* client) { onEventsConnect(client); });
+    server.addHandler(&events);
+
+    socket.onEvent([this](AsyncWebSocket* server, AsyncWebSocketClient* client, AwsEventType type, void* arg,
+                          uint8_t* data, size_t len) { onSocketEvent(client, type); });
+    server.addHandler(&socket);
+
+    if (!Tasks.start(TASK_LIVE, senderTask, this, &task)) {
+        task = nullptr;
+        if (DEBUGMODE) {
+            Serial.println("LiveStream: failed to start the sender task");
+        }
+    }
+    Bus.attach(SUBSCRIBER_LIVE, onBusEvent, this);
+}
+
+/**
+ * @brief Bus wake hook: wakes the sender task, or formats the events right
+ * away on the publisher's task when there is no sender task.
+ */
+void LiveStream::onBusEvent(void* context) {
+    LiveStream* self = static_cast<LiveStream*>(context);
+    if (self->task != nullptr) {
+        xTaskNotifyGive(self->task);
+    } else {
+        self->takeBusEvents();
+    }
+}
+
+static_assert(sizeof(LiveEvent::cardId) == sizeof(BusEvent::cardId), "Card ids are copied whole");
+
+/**
+ * @brief Publishes the events the bus queued for the stream.
+ */
+void LiveStream::takeBusEvents() {
+    BusEvent busEvent;
+    while (Bus.receive(SUBSCRIBER_LIVE, busEvent)) {
+        LiveEvent event = {LIVE_EVENT_CARD, busEvent.code, busEvent.success, busEvent.amount, busEvent.balance};
+        memcpy(event.cardId, busEvent.cardId, sizeof(event.cardId));
+        if (busEvent.topic == TOPIC_TRANSACTION) {
+            event.type = busEvent.kind == BUS_TRANSACTION_RECHARGE ? LIVE_EVENT_RECHARGE : LIVE_EVENT_NUMBER_SAVED;
+        } else if (busEvent.topic == TOPIC_LOCK) {
+            event.type = busEvent.kind == BUS_LOCK_LOCKED ? LIVE_EVENT_LOCK : LIVE_EVENT_UNLOCK;
+        }
+        publish(event);
+    }
+}
+
+/**
+ * @brief Formats an event into the ring, where the clients pick it up.
+ *
+ * Costs one snprintf and a copy; never waits on a client. Card UIDs are
+ * masked, and left out of master card taps. When the ring is
+ * full the oldest event is overwritten, clients that had not sent it yet
+ * skip it.
+ *
+ * @param event Event to broadcast.
+ * @return false if its JSON text did not fit LIVE_EVENT_SIZE.
+ */
+bool LiveStream::publish(const LiveEvent& event) {
+    if (event.type >= LIVE_EVENT_TYPE_COUNT) return false;
+
+    Entry entry;
+    int length;
+    portENTER_CRITICAL(&lock);
+    entry.sequence = nextSequence++;
+    portEXIT_CRITICAL(&lock);
+
+    const char* name = EVENT_NAMES[event.type];
+    unsigned long uptime = millis();
+    char cardId[sizeof(event.cardId)];
+    maskCardId(event.cardId, cardId, sizeof(cardId));
+    switch (event.type) {
+        case LIVE_EVENT_CARD:
+            if (event.code == 1) {
+                // Master card: its UID unlocks the device, even a masked one is not streamed
+                length = snprintf(entry.json, sizeof(entry.json),
+                                  "{\"seq\":%u,\"type\":\"%s\",\"uptimeMs\":%lu,\"result\":\"%s\"}",
+                                  (unsigned)entry.sequence, name, uptime, cardResult(event.code));
+                break;
+            }
+            length = snprintf(entry.json, sizeof(entry.json),
+                              "{\"seq\":%u,\"type\":\"%s\",\"uptimeMs\":%lu,\"cardId\":\"%s\",\"result\":\"%s\"}",
+                              (unsigned)entry.sequence, name, uptime, cardId, cardResult(event.code));
+            break;
+        case LIVE_EVENT_RECHARGE:
+            length = snprintf(entry.json, sizeof(entry.json),
+                              "{\"seq\":%u,\"type\":\"%s\",\"uptimeMs\":%lu,\"cardId\":\"%s\",\"success\":%s,"
+                              "\"amount\":%lu,\"balance\":%lu}",
+                              (unsigned)entry.sequence, name, uptime, cardId, event.success ? "true" : "false",
+                              (unsigned long)event.amount, (unsigned long)event.balance);
+            break;
+        case LIVE_EVENT_NUMBER_SAVED:
+            length = snprintf(entry.json, sizeof(entry.json),
+                              "{\"seq\":%u,\"type\":\"%s\",\"uptimeMs\":%lu,\"cardId\":\"%s\",\"success\":%s,\"slot\":%u}",
+                              (unsigned)entry.sequence, name, uptime, cardId, event.success ? "true" : "false",
+                              event.code);
+            break;
+        case LIVE_EVENT_LOCK:
+            length = snprintf(entry.json, sizeof(entry.json),
+                              "{\"seq\":%u,\"type\":\"%s\",\"uptimeMs\":%lu,\"timeout\":%s}",
+                              (unsigned)entry.sequence, name, uptime, event.code ? "true" : "false");
+            break;
+        default:
+            length = snprintf(entry.json, sizeof(entry.json), "{\"seq\":%u,\"type\":\"%s\",\"uptimeMs\":%lu}",
+                              (unsigned)entry.sequence, name, uptime);
+            break;
+    }
+
+    bool fits = length > 0 && length < (int)sizeof(entry.json);
+    if (!fits) {
+        // Keep the sequence contiguous for the clients with a valid, empty object
+        length = snprintf(entry.json, sizeof(entry.json), "{\"seq\":%u,\"type\":\"%s\"}", (unsigned)entry.sequence,
+                          name);
+    }
+    entry.type = event.type;
+    entry.length = (uint8_t)length;
+
+    portENTER_CRITICAL(&lock);
+    ring[entry.sequence % LIVE_QUEUE_LENGTH] = entry;
+    stats.published++;
+    portEXIT_CRITICAL(&lock);
+    return fits;
+}
+
+LiveStream::Stats LiveStream::getStats() const {
+    Stats copy;
+    portENTER_CRITICAL(&lock);
+    copy = stats;
+    portEXIT_CRITICAL(&lock);
+    return copy;
+}
+
+/**
+ * @brief Accepts an SSE client and sends it what it missed. Runs on the web
+ * server task, like every send to the client.
+ *
+ * A client sending `Last-Event-ID` resumes after that event if the ring
+ * still holds it, from the oldest event held otherwise; a new client starts
+ * with the next event published.
+ */
+void LiveStream::onEventsConnect(AsyncEventSourceClient* client) {
+    uint32_t last = client->lastId();
+    portENTER_CRITICAL(&lock);
+    uint32_t cursor = last != 0 && last < nextSequence ? last + 1 : nextSequence;
+    portEXIT_CRITICAL(&lock);
+
+    int8_t slot = openClient(client, nullptr, cursor);
+    if (slot < 0) {
+        client->close();
+        return;
+    }
+    client->send(nullptr, nullptr, 0, LIVE_SSE_RETRY_MS);
+    hookClient(client, slot);
+    // The library deletes the client on disconnection: free the slot first
+    client->client()->onDisconnect(
+        [this, client, slot](void* arg, AsyncClient* tcp) {
+            closeClient(slot);
+            client->_onDisconnect();
+            delete tcp;
+        },
+        nullptr);
+    pumpClient(slot);
+}
+
+/**
+ * @brief Tracks WebSocket connections. Runs on the web server task.
+ */
+void LiveStream::onSocketEvent(AsyncWebSocketClient* client, AwsEventType type) {
+    if (type == WS_EVT_CONNECT) {
+        portENTER_CRITICAL(&lock);
+        uint32_t cursor = nextSequence;
+        portEXIT_CRITICAL(&lock);
+        int8_t slot = openClient(nullptr, client, cursor);
+        if (slot < 0) {
+            client->close(1013, "Too many live clients");
+            return;
+        }
+        hookClient(client, slot);
+    } else if (type == WS_EVT_DISCONNECT) {
+        for (uint8_t slot = 0; slot < LIVE_MAX_CLIENTS; slot++) {
+            if (clients[slot].used && clients[slot].ws == client) {
+                closeClient(slot);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Chains pumpClient() after the library's TCP ack and poll handlers
+ * of a client, so its events are sent on the async_tcp task when the
+ * previous ones are acknowledged, and at least at every TCP poll.
+ */
+template <class T>
+void LiveStream::hookClient(T* client, uint8_t slot) {
+    client->client()->onAck(
+        [this, client, slot](void* arg, AsyncClient* tcp, size_t length, uint32_t time) {
+            client->_onAck(length, time);
+            pumpClient(slot);
+        },
+        nullptr);
+    client->client()->onPoll(
+        [this, client, slot](void* arg, AsyncClient* tcp) {
+            client->_onPoll();
+            pumpClient(slot);
+        },
+        nullptr);
+}
+
+/**
+ * @brief Sender task: formats the events the bus queued for the stream.
+ * The clients take them from the ring on their own.
+ */
+void LiveStream::senderTask(void* param) {
+    LiveStream* self = static_cast<LiveStream*>(param);
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        TaskWork work(TASK_LIVE);
+        self->takeBusEvents();
+    }
+}
+
+/**
+ * @brief Sends a client the events at its cursor, in order, while it has
+ * room, or a `ping` event to an SSE client silent for LIVE_KEEPALIVE_MS.
+ * Runs on the async_tcp task.
+ *
+ * Nothing waits on a slow client: the events it cannot take stay in the
+ * ring, where newer ones eventually overwrite them.
+ */
+void LiveStream::pumpClient(uint8_t slot) {
+    Client& client = clients[slot];
+    if (!client.used) return;
+
+    Entry entry;
+    uint32_t now = millis();
+    if (client.sse != nullptr) {
+        while (client.sse->packetsWaiting() < LIVE_SSE_IN_FLIGHT && peek(client.cursor, entry)) {
+            client.sse->send(entry.json, EVENT_NAMES[entry.type], entry.sequence);
+            client.cursor = entry.sequence + 1;
+            client.lastSendMs = now;
+        }
+        if (now - client.lastSendMs >= LIVE_KEEPALIVE_MS) {
+            client.sse->send("{}", "ping");
+            client.lastSendMs = now;
+        }
+    } else {
+        while (client.ws->canSend() && peek(client.cursor, entry)) {
+            client.ws->text(entry.json, entry.length);
+            client.cursor = entry.sequence + 1;
+        }
+    }
+}
+
+/**
+ * @brief Takes a client slot.
+ *
+ * @return The slot, -1 when LIVE_MAX_CLIENTS are connected.
+ */
+int8_t LiveStream::openClient(AsyncEventSourceClient* sse, AsyncWebSocketClient* ws, uint32_t cursor) {
+    int8_t found = -1;
+    for (uint8_t slot = 0; slot < LIVE_MAX_CLIENTS; slot++) {
+        if (!clients[slot].used) {
+            clients[slot].used = true;
+            clients[slot].sse = sse;
+            clients[slot].ws = ws;
+            clients[slot].cursor = cursor;
+            clients[slot].lastSendMs = millis();
+            found = slot;
+            break;
+        }
+    }
+    portENTER_CRITICAL(&lock);
+    if (found < 0) {
+        stats.refused++;
+    } else {
+        stats.clients++;
+    }
+    portEXIT_CRITICAL(&lock);
+    return found;
+}
+
+void LiveStream::closeClient(uint8_t slot) {
+    if (!clients[slot].used) return;
+    clients[slot].used = false;
+    portENTER_CRITICAL(&lock);
+    stats.clients--;
+    portEXIT_CRITICAL(&lock);
+}
+
+/**
+ * @brief Copies the event at a cursor without consuming it.
+ *
+ * A cursor older than the ring is first moved to the oldest event still
+ * held; the skipped events are counted as dropped.
+ *
+ * @param cursor A client's cursor.
+ * @return false if the cursor is up to date.
+ */
+bool LiveStream::peek(uint32_t& cursor, Entry& entry) {
+    bool found = false;
+    portENTER_CRITICAL(&lock);
+    uint32_t oldest = nextSequence > LIVE_QUEUE_LENGTH ? nextSequence - LIVE_QUEUE_LENGTH : 1;
+    if (cursor < oldest) {
+        stats.dropped += oldest - cursor;
+        cursor = oldest;
+    }
+    const Entry& stored = ring[cursor % LIVE_QUEUE_LENGTH];
+    // An event being formatted by publish() has its sequence reserved but not stored yet
+    if (cursor < nextSequence && stored.sequence == cursor) {
+        entry = stored;
+        found = true;
+    }
+    portEXIT_CRITICAL(&lock);
+    return found;
+}
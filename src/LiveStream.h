@@ -0,0 +1,113 @@
+#ifndef LIVESTREAM_H
+#define LIVESTREAM_H
+/**
+ * @file LiveStream.h
+ * @brief Live feed of device events over Server-Sent Events and WebSocket.
+ *
+ * The stream subscribes to the card, transaction and lock topics of the
+ * EventBus; the sender task takes those events and turns them into
+ * `publish()` calls, so producers never pay for the formatting. Each event
+ * is formatted to JSON once and stored in a shared ring of
+ * `LIVE_QUEUE_LENGTH` entries, numbered by a sequence. `publish()` never
+ * waits on a client, and the sender task never touches the web server.
+ *
+ * Both endpoints are unauthenticated, so card UIDs are masked down to their
+ * last byte ("**:**:**:e3") and master card taps carry no UID at all.
+ *
+ * Every client, SSE or WebSocket, owns a slot with a cursor into the ring.
+ * The library's client lists and message queues are not locked, so a client
+ * is only ever sent to from the async_tcp task: on connection, and from its
+ * TCP ack and poll callbacks, which LiveStream chains after the library's
+ * own. Each send takes the next events at the client's cursor, in order,
+ * while the client has room, so its backlog is bounded by the ring; a client
+ * that falls further behind loses its oldest events (drop-oldest, counted
+ * in the stats). An event reaches an idle client at the next TCP poll,
+ * within about half a second.
+ *
+ * - `GET /events` : SSE stream on an AsyncEventSource (`id:` is the
+ *   sequence, `event:` the type). At most `LIVE_SSE_IN_FLIGHT` messages
+ *   wait on a client. `Last-Event-ID` resumes from the ring after a
+ *   reconnection. A `ping` event keeps an idle connection open.
+ * - `/ws`         : WebSocket, one JSON text message per event, sent while
+ *   the client's send queue has room.
+ */
+
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "Config.h"
+#include "TaskTopology.h"
+#include "EventBus.h"
+
+enum LiveEventType : uint8_t {
+    LIVE_EVENT_CARD,           ///< Card tapped, code is the IsMasterCard() status
+    LIVE_EVENT_RECHARGE,       ///< Card recharged from the device balance
+    LIVE_EVENT_NUMBER_SAVED,   ///< Number written to the card, code is the slot 1-4
+    LIVE_EVENT_LOCK,           ///< Device locked, code is 1 on timeout
+    LIVE_EVENT_UNLOCK,         ///< Master card accepted
+    LIVE_EVENT_TYPE_COUNT
+};
+
+struct LiveEvent {
+    LiveEventType type;
+    uint8_t code;
+    bool success;
+    uint32_t amount;
+    uint32_t balance;
+    char cardId[30];
+};
+
+class LiveStream {
+public:
+    struct Stats {
+        uint32_t published;    ///< Events published since boot
+        uint32_t dropped;      ///< Events skipped by lagging clients or lost to an SSE resume
+        uint32_t refused;      ///< Connections refused because every client slot was taken
+        uint8_t clients;       ///< Clients connected now
+    };
+
+    LiveStream();
+
+    void begin(AsyncWebServer& server);   ///< Register /events and /ws, start the sender task and subscribe to the bus
+    bool publish(const LiveEvent& event); ///< From any task; false if the event did not fit LIVE_EVENT_SIZE
+    Stats getStats() const;
+
+private:
+    struct Entry {
+        uint32_t sequence;
+        LiveEventType type;
+        uint8_t length;
+        char json[LIVE_EVENT_SIZE];
+    };
+
+    struct Client {
+        bool used;
+        AsyncEventSourceClient* sse;   ///< Set for an SSE client
+        AsyncWebSocketClient* ws;      ///< Set for a WebSocket client
+        uint32_t cursor;               ///< Sequence of the next event to send
+        uint32_t lastSendMs;           ///< For the SSE keep-alive
+    };
+
+    void onEventsConnect(AsyncEventSourceClient* client);
+    void onSocketEvent(AsyncWebSocketClient* client, AwsEventType type);
+    static void senderTask(void* param);
+    static void onBusEvent(void* context);
+    void takeBusEvents();
+    template <class T> void hookClient(T* client, uint8_t slot);
+    void pumpClient(uint8_t slot);
+    int8_t openClient(AsyncEventSourceClient* sse, AsyncWebSocketClient* ws, uint32_t cursor);
+    void closeClient(uint8_t slot);
+    bool peek(uint32_t& cursor, Entry& entry);
+
+    AsyncEventSource events;
+    AsyncWebSocket socket;
+    TaskHandle_t task;
+    Entry ring[LIVE_QUEUE_LENGTH];
+    uint32_t nextSequence;               ///< Sequence of the next published event
+    Client clients[LIVE_MAX_CLIENTS];    ///< Used on the async_tcp task only
+    Stats stats;
+    mutable portMUX_TYPE lock;           ///< Protects the ring and the stats
+};
+
+#endif // LIVESTREAM_H
@@ -1,11 +1,55 @@
 #include "LogManager.h"
+#include <math.h>
+#include "FixedString.h"
+
+/// JSON text of one log file entry, built in place on the writer's stack
+typedef FixedString<LOG_ENTRY_SIZE - 1> EntryText;
+
+/**
+ * @brief Appends a quoted JSON string, escaping quotes, backslashes and
+ * control characters.
+ */
+static void appendJsonString(EntryText& out, const char* text) {
+  out.append('"');
+  for (const char* c = text; *c != '\0'; c++) {
+    unsigned char ch = (unsigned char)*c;
+    if (ch == '"' || ch == '\\') {
+      out.append('\\');
+      out.append(*c);
+    } else if (ch < 0x20) {
+      out.appendf("\\u%04x", ch);
+    } else {
+      out.append(*c);
+    }
+  }
+  out.append('"');
+}
+
+/**
+ * @brief Appends `,"key":"text"`.
+ */
+static void appendField(EntryText& out, const char* key, const char* text) {
+  out.appendf(",\"%s\":", key);
+  appendJsonString(out, text);
+}
+
+/**
+ * @brief Appends `,"key":value`, whole amounts without decimals.
+ */
+static void appendField(EntryText& out, const char* key, float value) {
+  if (value == floorf(value) && fabsf(value) < 1e15f) {
+    out.appendf(",\"%s\":%.0f", key, (double)value);
+  } else {
+    out.appendf(",\"%s\":%.7g", key, (double)value);
+  }
+}
 
 /**
  * @brief Constructor for the LogManager class.
  * 
  * Initializes any necessary parameters or resources for logging.
  */
-LogManager::LogManager() {
+LogManager::LogManager() : jobs(nullptr), task(nullptr) {
   // Constructor body (could initialize anything related to LogManager here)
 }
 
@@ -22,6 +66,7 @@ LogManager::~LogManager() {}
  * If the log file does not exist, it creates a new one with an empty structure.
  */
 void LogManager::begin() {
+  TRACE_SCOPE("log.begin");
   if (!SPIFFS.begin(true)) {
     Serial.println("SPIFFS initialization failed!");
     return;
@@ -62,25 +107,87 @@ void LogManager::createLogFile() {
 /**
  * @brief Helper function to create an empty log structure in the log file.
  * 
- * This function initializes the JSON structure with an empty array of log entries.
+ * This function writes the JSON structure with an empty array of log entries.
  */
 void LogManager::createLogStructure() {
-  StaticJsonDocument<512> doc;
-  JsonArray logEntries = doc.createNestedArray("logEntries");
-  
+  static const char EMPTY_LOG[] = "{\"logEntries\":[]}";
+
   File logFile = SPIFFS.open(logFilePath, FILE_WRITE);
   if (logFile) {
-    serializeJson(doc, logFile);
+    logFile.write((const uint8_t*)EMPTY_LOG, sizeof(EMPTY_LOG) - 1);
     logFile.close();
   }
 }
 
+/**
+ * @brief Starts the log writer task and subscribes it to the transactions
+ * of the bus; later entries are written off the caller's task.
+ *
+ * Until it runs (or if it cannot be created), entries are written inline.
+ *
+ * @return true if the task is running.
+ */
+bool LogManager::startTask() {
+  if (task != nullptr) return true;
+
+  jobs = xQueueCreate(LOG_QUEUE_LENGTH, sizeof(LogJob));
+  if (jobs == nullptr) return false;
+
+  if (!Tasks.start(TASK_LOG, writerTask, this, &task)) {
+    vQueueDelete(jobs);
+    jobs = nullptr;
+    task = nullptr;
+  }
+  Bus.attach(SUBSCRIBER_LOG, onBusEvent, this);
+  return task != nullptr;
+}
+
+/**
+ * @brief Bus wake hook: wakes the writer task, or logs the transactions
+ * right away when there is no writer task.
+ */
+void LogManager::onBusEvent(void* context) {
+  LogManager* self = static_cast<LogManager*>(context);
+  if (self->task != nullptr) {
+    xTaskNotifyGive(self->task);
+  } else {
+    self->takeBusEvents();
+  }
+}
+
+/**
+ * @brief Logs the transactions the bus queued: RAM record and file entry.
+ */
+void LogManager::takeBusEvents() {
+  BusEvent event;
+  while (Bus.receive(SUBSCRIBER_LOG, event)) {
+    const char* action = event.kind == BUS_TRANSACTION_RECHARGE ? "Recharge" : "Store Number";
+    const char* status = event.success ? "Success" : "Failed";
+    LogJob job;
+    prepareJob(job, action, event.cardId, status);
+    strncpy(job.deviceState, "unlocked", sizeof(job.deviceState) - 1);
+    job.amount = event.amount;
+    job.balance = event.balance;
+
+    recordTransaction(action, event.cardId, event.amount, event.balance, status);
+    writeEntry(job);
+  }
+}
+
+/**
+ * @brief Log entries waiting for the writer task, queued or on the bus.
+ */
+uint32_t LogManager::getQueueDepth() const {
+  uint32_t depth = Bus.getDepth(SUBSCRIBER_LOG);
+  return jobs != nullptr ? depth + (uint32_t)uxQueueMessagesWaiting(jobs) : depth;
+}
+
 /**
  * @brief Adds a new log entry to the JSON log file.
  * 
  * This function adds a new log entry containing details like timestamp, action, device state,
- * card ID, and other relevant information. If the log file exists, it appends the entry; otherwise,
- * it creates a new log file.
+ * card ID, and other relevant information. The entry is also kept in the RAM record, then
+ * handed to the log writer task; when the queue is full the file entry is dropped.
  * 
  * @param action The action performed (e.g., "Recharge").
  * @param deviceState The current state of the device (e.g., "unlocked").
@@ -92,46 +199,17 @@ void LogManager::createLogStructure() {
  */
 void LogManager::addLogEntry(const char* action, const char* deviceState, const char* cardId,
                              float amount, float balanceAfterRecharge, const char* storedNumber, const char* status) {
-  
-  // Get the current timestamp from inherited TimeManager methods
-  String timestamp = getDateString() + " " + getTimeString();
-
-  // Prepare the log entry
-  StaticJsonDocument<512> doc;
-  JsonObject entry = doc.createNestedObject();
-  entry["timestamp"] = timestamp;
-  entry["device state"] = deviceState;
-  entry["action"] = action;
-  entry["cardId"] = cardId;
-  entry["status"] = status;
-
-  if (amount > 0) entry["amount"] = amount;
-  if (balanceAfterRecharge > 0) entry["balanceAfterRecharge"] = balanceAfterRecharge;
-  if (strlen(storedNumber) > 0) entry["storedNumber"] = storedNumber;
-
-  // Open the log file and append the new entry
-  File logFile = SPIFFS.open(logFilePath, FILE_APPEND);
-  if (logFile) {
-    StaticJsonDocument<512> currentDoc;
-    DeserializationError error = deserializeJson(currentDoc, logFile);
-    
-    if (error) {
-      Serial.println("Failed to read log file!");
-      return;
-    }
-    
-    JsonArray logEntries = currentDoc["logEntries"];
-    logEntries.add(entry);
+  TRACE_SCOPE("log.addEntry");
 
-    logFile.close();
+  LogJob job;
+  prepareJob(job, action, cardId, status);
+  strncpy(job.deviceState, deviceState, sizeof(job.deviceState) - 1);
+  strncpy(job.storedNumber, storedNumber, sizeof(job.storedNumber) - 1);
+  job.amount = amount;
+  job.balance = balanceAfterRecharge;
 
-    // Re-open the file to overwrite the updated log data
-    logFile = SPIFFS.open(logFilePath, FILE_WRITE);
-    if (logFile) {
-      serializeJson(currentDoc, logFile);
-      logFile.close();
-    }
-  }
+  recordTransaction(action, cardId, amount, balanceAfterRecharge, status);
+  submit(job);
 }
 
 // Variation: Add a "Recharge" log entry
@@ -141,43 +219,199 @@ void LogManager::addRechargeLogEntry(const char* deviceState, const char* cardId
 
 // Variation: Add a "Store Numbers" log entry
 void LogManager::addStoreNumbersLogEntry(const char* cardId, const char* status, const char* storedNumbers[], size_t numStoredNumbers) {
-  // Prepare the log entry with specific action and cardId
-  String timestamp = getDateString() + " " + getTimeString();
-  
-  StaticJsonDocument<512> doc;
-  JsonObject entry = doc.createNestedObject();
-  entry["timestamp"] = timestamp;
-  entry["action"] = "Store Numbers";
-  entry["cardId"] = cardId;
-  entry["status"] = status;
-
-  // Add the stored numbers array
-  JsonArray storedNumbersArray = entry.createNestedArray("storedNumbers");
-  for (size_t i = 0; i < numStoredNumbers; ++i) {
-    storedNumbersArray.add(storedNumbers[i]);
-  }
-
-  // Open the log file and append the new entry
-  File logFile = SPIFFS.open(logFilePath, FILE_APPEND);
-  if (logFile) {
-    StaticJsonDocument<512> currentDoc;
-    DeserializationError error = deserializeJson(currentDoc, logFile);
-    
-    if (error) {
-      Serial.println("Failed to read log file!");
-      return;
+  TRACE_SCOPE("log.addStoreNumbers");
+
+  LogJob job;
+  prepareJob(job, "Store Numbers", cardId, status);
+  job.numberList = true;
+  for (size_t i = 0; i < numStoredNumbers && i < LogJob::NUMBERS; ++i) {
+    strncpy(job.numbers[i], storedNumbers[i], sizeof(job.numbers[i]) - 1);
+    job.numberCount++;
+  }
+
+  recordTransaction("Store Numbers", cardId, 0.0f, 0.0f, status);
+  submit(job);
+}
+
+/**
+ * @brief Clears a job and fills the fields common to every entry; the
+ * timestamp is taken now, not when the entry is written.
+ */
+void LogManager::prepareJob(LogJob& job, const char* action, const char* cardId, const char* status) {
+  memset(&job, 0, sizeof(job));
+  snprintf(job.timestamp, sizeof(job.timestamp), "%s %s", getDateString().c_str(), getTimeString().c_str());
+  strncpy(job.action, action, sizeof(job.action) - 1);
+  strncpy(job.cardId, cardId, sizeof(job.cardId) - 1);
+  strncpy(job.status, status, sizeof(job.status) - 1);
+}
+
+/**
+ * @brief Queues a job for the writer task, or writes it right away when
+ * the task is not running.
+ */
+void LogManager::submit(const LogJob& job) {
+  if (jobs == nullptr) {
+    writeEntry(job);
+    return;
+  }
+  if (xQueueSend(jobs, &job, 0) != pdTRUE) {
+    Metrics.increment(METRIC_LOG_DROPPED);
+    return;
+  }
+  xTaskNotifyGive(task);
+}
+
+/**
+ * @brief Log writer task body: woken by submit() and by the bus, writes
+ * the bus transactions and the queued entries one by one.
+ *
+ * @param param The LogManager.
+ */
+void LogManager::writerTask(void* param) {
+  LogManager* self = static_cast<LogManager*>(param);
+  LogJob job;
+  while (true) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    TaskWork work(TASK_LOG);
+    self->takeBusEvents();
+    while (xQueueReceive(self->jobs, &job, 0) == pdTRUE) {
+      self->writeEntry(job);
     }
-    
-    JsonArray logEntries = currentDoc["logEntries"];
-    logEntries.add(entry);
+  }
+}
 
-    logFile.close();
+/**
+ * @brief Formats a job as a JSON object and appends it to the log file.
+ *
+ * The text is built with snprintf() in a FixedString on the stack, so
+ * writing an entry makes no heap allocation.
+ */
+void LogManager::writeEntry(const LogJob& job) {
+  TRACE_SCOPE("log.write");
+
+  EntryText text;
+  text.append("{\"timestamp\":");
+  appendJsonString(text, job.timestamp);
+  if (strlen(job.deviceState) > 0) appendField(text, "device state", job.deviceState);
+  appendField(text, "action", job.action);
+  appendField(text, "cardId", job.cardId);
+  appendField(text, "status", job.status);
 
-    // Re-open the file to overwrite the updated log data
-    logFile = SPIFFS.open(logFilePath, FILE_WRITE);
-    if (logFile) {
-      serializeJson(currentDoc, logFile);
-      logFile.close();
+  if (job.amount > 0) appendField(text, "amount", job.amount);
+  if (job.balance > 0) appendField(text, "balanceAfterRecharge", job.balance);
+  if (strlen(job.storedNumber) > 0) appendField(text, "storedNumber", job.storedNumber);
+  if (job.numberList) {
+    text.append(",\"storedNumbers\":[");
+    for (uint8_t i = 0; i < job.numberCount; ++i) {
+      if (i > 0) text.append(',');
+      appendJsonString(text, job.numbers[i]);
     }
+    text.append(']');
+  }
+  text.append('}');
+
+  if (text.truncated()) {
+    Metrics.increment(METRIC_LOG_WRITE_ERRORS);
+    return;
+  }
+
+  if (appendEntry(text.c_str(), text.length())) {
+    Metrics.increment(METRIC_LOG_WRITES);
+  } else {
+    Metrics.increment(METRIC_LOG_WRITE_ERRORS);
+  }
+}
+
+/**
+ * @brief Appends one entry to the `logEntries` array of the log file in place.
+ *
+ * The file always ends with `]}`; the entry is written over it, followed by
+ * a new `]}`. Only the entry is written, whatever the size of the file.
+ *
+ * @param text JSON text of the entry.
+ * @param length Length of text.
+ * @return false if the file is missing, does not end like a log file or the write failed.
+ */
+bool LogManager::appendEntry(const char* text, size_t length) {
+  File logFile = SPIFFS.open(logFilePath, "r+");
+  if (!logFile) {
+    return false;
   }
-}
\ No newline at end of file
+
+  size_t size = logFile.size();
+  char tail[3];
+  if (size < sizeof(tail) || !logFile.seek(size - sizeof(tail)) ||
+      logFile.read((uint8_t*)tail, sizeof(tail)) != sizeof(tail) || tail[1] != ']' || tail[2] != '}') {
+    Serial.println("Failed to read log file!");
+    logFile.close();
+    return false;
+  }
+
+  bool first = tail[0] == '[';
+  bool written = logFile.seek(size - 2);
+  if (written && !first) written = logFile.write((const uint8_t*)",", 1) == 1;
+  if (written) written = logFile.write((const uint8_t*)text, length) == length;
+  if (written) written = logFile.write((const uint8_t*)"]}", 2) == 2;
+  logFile.close();
+  return written;
+}
+
+/**
+ * @brief Keeps a transaction in the RAM ring read by the REST API.
+ *
+ * Unlike addLogEntry() it does not touch SPIFFS, so it can be called from
+ * the UI. The oldest record is overwritten once LOG_RECENT_ENTRIES are kept.
+ *
+ * @param action The action performed (e.g., "Recharge").
+ * @param cardId The ID of the RFID card involved.
+ * @param amount The amount of the transaction, if any.
+ * @param balance The card balance after the transaction, if known.
+ * @param status The status of the action (e.g., "Success").
+ */
+void LogManager::recordTransaction(const char* action, const char* cardId, float amount,
+                                   float balance, const char* status) {
+  LogRecord record;
+  memset(&record, 0, sizeof(record));
+  record.uptimeMs = millis();
+  snprintf(record.timestamp, sizeof(record.timestamp), "%s %s", getDateString().c_str(), getTimeString().c_str());
+  strncpy(record.action, action, sizeof(record.action) - 1);
+  strncpy(record.cardId, cardId, sizeof(record.cardId) - 1);
+  strncpy(record.status, status, sizeof(record.status) - 1);
+  record.amount = amount;
+  record.balance = balance;
+
+  Metrics.increment(METRIC_LOG_RECORDS);
+  portENTER_CRITICAL(&recentLock);
+  record.sequence = nextSequence++;
+  recent[record.sequence % LOG_RECENT_ENTRIES] = record;
+  portEXIT_CRITICAL(&recentLock);
+}
+
+/**
+ * @brief Copies the kept records newer than a sequence number, oldest first.
+ *
+ * @param out Destination array.
+ * @param maxRecords Capacity of out; the newest records are kept if it is too small.
+ * @param afterSequence Only records with a greater sequence are copied (0 for all).
+ * @return Number of records copied.
+ */
+size_t LogManager::getRecentRecords(LogRecord* out, size_t maxRecords, uint32_t afterSequence) const {
+  size_t count = 0;
+  portENTER_CRITICAL(&recentLock);
+  uint32_t last = nextSequence - 1;
+  uint32_t first = last >= LOG_RECENT_ENTRIES ? last - LOG_RECENT_ENTRIES + 1 : 1;
+  if (first <= afterSequence) first = afterSequence + 1;
+  if (last >= first && last - first + 1 > maxRecords) first = last - maxRecords + 1;
+  for (uint32_t sequence = first; sequence <= last; sequence++) {
+    out[count++] = recent[sequence % LOG_RECENT_ENTRIES];
+  }
+  portEXIT_CRITICAL(&recentLock);
+  return count;
+}
+
+uint32_t LogManager::getLastSequence() const {
+  portENTER_CRITICAL(&recentLock);
+  uint32_t last = nextSequence - 1;
+  portEXIT_CRITICAL(&recentLock);
+  return last;
+}
@@ -1,10 +1,48 @@
 #ifndef LOGMANAGER_H
 #define LOGMANAGER_H
 
-#include <ArduinoJson.h>
 #include <FS.h>
 #include <SPIFFS.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
 #include "TimeManager.h"
+#include "TraceBuffer.h"
+#include "Metrics.h"
+#include "TaskTopology.h"
+#include "EventBus.h"
+
+/**
+ * @brief One transaction kept in RAM for the REST API.
+ */
+struct LogRecord {
+  uint32_t sequence;         ///< Increasing id, 1 for the first record since boot
+  uint32_t uptimeMs;         ///< millis() when recorded
+  char timestamp[24];        ///< "DD MON YYYY HH:MM", empty before the first NTP sync
+  char action[16];
+  char cardId[30];
+  char status[12];
+  float amount;
+  float balance;             ///< Card balance after the transaction, 0 if not applicable
+};
+
+/**
+ * @brief One log file entry waiting for the writer task.
+ */
+struct LogJob {
+  static const uint8_t NUMBERS = 4;  ///< Numbers a "Store Numbers" entry can list
+
+  char timestamp[24];        ///< Taken when the entry was added
+  char action[16];
+  char deviceState[12];      ///< Empty to leave the field out
+  char cardId[30];
+  char status[12];
+  char storedNumber[16];
+  float amount;
+  float balance;
+  bool numberList;           ///< Write the storedNumbers array
+  uint8_t numberCount;
+  char numbers[NUMBERS][16];
+};
 
 class LogManager : public TimeManager {  ///< Inherit from TimeManager
 private:
@@ -13,10 +51,28 @@ private:
   // Helper function to create an empty log structure
   void createLogStructure();
 
+  // Log writer task: entries are formatted and appended to the file off the caller's task
+  void prepareJob(LogJob& job, const char* action, const char* cardId, const char* status);
+  void submit(const LogJob& job);
+  void writeEntry(const LogJob& job);
+  bool appendEntry(const char* text, size_t length);
+  static void writerTask(void* param);
+  static void onBusEvent(void* context);
+  void takeBusEvents();
+
+  QueueHandle_t jobs;                    ///< Entries waiting for the writer task, nullptr before startTask()
+  TaskHandle_t task;                     ///< Writer task, nullptr when entries are written inline
+
+  LogRecord recent[LOG_RECENT_ENTRIES];  ///< Ring of the latest records
+  uint32_t nextSequence = 1;
+  mutable portMUX_TYPE recentLock = portMUX_INITIALIZER_UNLOCKED;  ///< Records are read by the web server task
+
 public:
   LogManager();
   ~LogManager();
   void begin();
+  bool startTask();                      ///< Start the log writer task and subscribe to bus transactions; entries are written inline before
+  uint32_t getQueueDepth() const;
   bool logFileExists();
   void createLogFile();
   void addLogEntry(const char* action, const char* deviceState, const char* cardId,
@@ -24,6 +80,12 @@ public:
   void addRechargeLogEntry(const char* deviceState, const char* cardId, float amount, float balanceAfterRecharge, const char* status);
   void addStoreNumbersLogEntry(const char* cardId, const char* status, const char* storedNumbers[], size_t numStoredNumbers);
 
+  // RAM record of the latest transactions, no file access
+  void recordTransaction(const char* action, const char* cardId, float amount = 0.0f,
+                         float balance = 0.0f, const char* status = "Success");
+  size_t getRecentRecords(LogRecord* out, size_t maxRecords, uint32_t afterSequence = 0) const;
+  uint32_t getLastSequence() const;
+
 };
 
 #endif // LOGMANAGER_H
@@ -10,7 +10,22 @@ byte ackKey[2] = {0x12, 0x34};  // Example values, should be set according to yo
 
 // Constructor
 MRC522Manager::MRC522Manager(ConfigManager* Config,MFRC522* RFID) : RFID(RFID),Config(Config) {
+    readerMutex = xSemaphoreCreateRecursiveMutex();
+}
 
+/**
+ * @brief Takes exclusive use of the reader.
+ *
+ * The card poller and the screens run on different tasks; each holds the
+ * reader for a whole exchange with the card so their SPI transactions are
+ * not interleaved. The mutex is recursive, nested calls are fine.
+ */
+void MRC522Manager::acquire() {
+    xSemaphoreTakeRecursive(readerMutex, portMAX_DELAY);
+}
+
+void MRC522Manager::release() {
+    xSemaphoreGiveRecursive(readerMutex);
 }
 // Initialize the MFRC522
 /**
@@ -48,12 +63,14 @@ bool MRC522Manager::authenticateWithKeys(byte sector, byte block) {
 
     // Authenticate using Key A
     if (RFID->PCD_Authenticate(MFRC522::PICC_CMD_MF_AUTH_KEY_A, block+sector, &keyAAuth, &(RFID->uid)) != MFRC522::STATUS_OK) {
+        Metrics.countAuthFailure(block + sector);
         Serial.println("Authentication failed for Key A");
         return false;
     }
 
     // Authenticate using Key B (optional)
     if (RFID->PCD_Authenticate(MFRC522::PICC_CMD_MF_AUTH_KEY_B, block+sector, &keyBAuth, &(RFID->uid)) != MFRC522::STATUS_OK) {
+        Metrics.countAuthFailure(block + sector);
         Serial.println("Authentication failed for Key B");
         return false;
     }
@@ -231,8 +248,8 @@ void MRC522Manager::printDec(byte *buffer, byte bufferSize) {
  * @return A formatted hexadecimal string representing the UID of the card, or an empty 
  * string if no card is present or if an unsupported card type is detected.
  */
-String MRC522Manager::getCardUID() {
-    String uid = "";  // Initialize UID string to empty
+UidText MRC522Manager::getCardUID() {
+    UidText uid;  // Empty until a supported card is read
     Prepare(ACTIVE_KEY);
     
     // Check for the presence of a new card
@@ -255,26 +272,35 @@ String MRC522Manager::getCardUID() {
     }
     
     // Format UID bytes as a hexadecimal string with colon separation
-    for (byte i = 0; i < RFID->uid.size; i++) {
-        if (RFID->uid.uidByte[i] < 0x10) {
-            uid += "0";  // Leading zero for single-digit hex values
-        }
-        uid += String(RFID->uid.uidByte[i], HEX);  // Append hex byte
-        if (i < RFID->uid.size - 1) {
-            uid += ":";  // Separate bytes with a colon
-        }
-    }
+    uid.appendHex(RFID->uid.uidByte, RFID->uid.size);
     
     // Halt card communication and disable encryption on the reader
     RFID->PICC_HaltA();      // Stop communication with the card
     RFID->PCD_StopCrypto1(); // Stop encryption
 
     Serial.print(F("Card UID: "));
-    Serial.println(uid);
+    Serial.println(uid.c_str());
 
     return uid;  // Return the formatted UID string
 }
 
+/**
+ * @brief Formats the UID of the last card selected by the reader.
+ *
+ * Uses the UID kept by the MFRC522 driver from the last selection, so it
+ * costs no SPI traffic. Same "xx:xx:xx:xx" format as getCardUID().
+ *
+ * @param out Destination buffer, empty string if no card was read yet.
+ * @param size Size of out.
+ */
+void MRC522Manager::getLastUID(char* out, size_t size) const {
+    size_t length = 0;
+    out[0] = '\0';
+    for (byte i = 0; i < RFID->uid.size && length + 3 < size; i++) {
+        length += snprintf(out + length, size - length, i == 0 ? "%02x" : ":%02x", RFID->uid.uidByte[i]);
+    }
+}
+
 
 
 /**
@@ -286,6 +312,7 @@ String MRC522Manager::getCardUID() {
  * @return true if the write operation was successful, false otherwise.
  */
 bool MRC522Manager::writeDataToBlockHex(byte sector, byte block, byte* data) {
+    TRACE_SCOPE("rfid.writeBlockHex");
     byte sectorBlock = sector * 4 + block; // Calculate block number based on sector and block
     byte blockAddr = sectorBlock;         // Block address
     MFRC522::StatusCode status;
@@ -313,6 +340,7 @@ bool MRC522Manager::writeDataToBlockHex(byte sector, byte block, byte* data) {
     // Authenticate with the first key (A key) of the sector
     status = RFID->PCD_Authenticate(MFRC522::PICC_CMD_MF_AUTH_KEY_A, blockAddr, &keyA, &(RFID->uid));
     if (status != MFRC522::STATUS_OK) {
+        Metrics.countAuthFailure(blockAddr);
         Serial.print(F("Authentication failed: "));
         Serial.println(RFID->GetStatusCodeName(status));
         return false; // Authentication failed
@@ -362,6 +390,7 @@ bool MRC522Manager::writeDataToBlockHex(byte sector, byte block, byte* data) {
  * @return true if the write operation was successful, false otherwise.
  */
 bool MRC522Manager::writeDataToBlock(byte sector, byte block, byte* data) {
+    TRACE_SCOPE("rfid.writeBlock");
     byte sectorBlock = sector * 4 + block; // Calculate block number based on sector and block
     byte blockAddr = sectorBlock;         // Block address
     MFRC522::StatusCode status;
@@ -439,17 +468,17 @@ bool MRC522Manager::writeDataToBlock(byte sector, byte block, byte* data) {
  * @return True if all operations were successful, otherwise false.
  */
 bool MRC522Manager::lockCard() {
-    String uid = "";  // Initialize UID string to empty
+    TRACE_SCOPE("rfid.lockCard");
     Prepare(ACTIVE_KEY);
     
     // Check for the presence of a new card
     if (!RFID->PICC_IsNewCardPresent()) {
-        return uid;  // No card detected
+        return false;  // No card detected
     }
     
     // Attempt to read the card's serial number
     if (!RFID->PICC_ReadCardSerial()) {
-        return uid;  // Failed to read card data
+        return false;  // Failed to read card data
     }
     
     // Determine the card type and ensure it's a supported MIFARE Classic card
@@ -458,24 +487,15 @@ bool MRC522Manager::lockCard() {
         && piccType != MFRC522::PICC_TYPE_MIFARE_1K
         && piccType != MFRC522::PICC_TYPE_MIFARE_4K) {
         Serial.println(F("This sample only works with MIFARE Classic cards."));
-        return uid;  // Unsupported card type
+        return false;  // Unsupported card type
     }
-    
-    // Format UID bytes as a hexadecimal string with colon separation
-    for (byte i = 0; i < RFID->uid.size; i++) {
-        if (RFID->uid.uidByte[i] < 0x10) {
-            uid += "0";  // Leading zero for single-digit hex values
-        }
-        uid += String(RFID->uid.uidByte[i], HEX);  // Append hex byte
-        if (i < RFID->uid.size - 1) {
-            uid += ":";  // Separate bytes with a colon
-        }
-    };
+
     byte status;
 
     // Authenticate with the default key
     status = RFID->PCD_Authenticate(MFRC522::PICC_CMD_MF_AUTH_KEY_A, 0, &keyA, &(RFID->uid));
     if (status != MFRC522::STATUS_OK) {
+        Metrics.countAuthFailure(0);
         Serial.println(F("Authentication with default key failed."));
         return false; // Authentication failed
     }
@@ -525,54 +545,61 @@ bool MRC522Manager::lockCard() {
 
 /**
  * @brief Recharges the balance by writing a uint value to Sector 9, Block 1.
- * This function checks if the current balance is greater than 0 before
- * writing to the card and updating the balance in preferences.
+ * This function checks if the current balance is greater than 0, debits the
+ * device balance, then writes the card. If the card write fails the amount
+ * is credited back, so the card is never credited without the debit.
  * Maximum Value of a 64-bit Unsigned Integer: 18,446,744,073,709,551,615 
  * 
  * @param amount The amount to be recharged and written to the card.
  * @return True if the operation was successful, otherwise false.
  */
 bool MRC522Manager::Recharge(uint32_t amount) {
+    TRACE_SCOPE("rfid.recharge");
+    uint32_t startMs = millis();
     // Retrieve the current balance
-    uint64_t currentBalance = Config->GetULong64(BALANCE, 0); // Default to 0 if not set
+    uint64_t currentBalance = Config->GetBalance();
 
     // Check if the current balance is valid
     if (currentBalance <= 0) {
         Serial.println(F("Current balance is zero or negative. Recharge not performed."));
+        Metrics.increment(METRIC_RECHARGE_FAILURES);
         return false; // Balance must be greater than 0 to perform recharge
     }
 
     // Check if the recharge amount is valid
     if (amount > currentBalance) {
         Serial.println(F("Recharge amount exceeds current balance."));
+        Metrics.increment(METRIC_RECHARGE_FAILURES);
         return false; // Recharge amount should not exceed the current balance
     }
 
     // Create a string with the amount to recharge, including the current card balance
-    String Data = String(amount + GetCardBalance());
+    FixedString<15> data;
+    data.format("%lu", (unsigned long)(amount + GetCardBalance()));
 
-    // Prepare data to write
+    // Prepare data to write, null terminated
     byte dataToWrite[16] = {0};  // Create a buffer for 16 bytes
+    memcpy(dataToWrite, data.c_str(), data.length());
 
-    // Convert each character of the string into a byte and store it in the buffer
-    for (int i = 0; i < Data.length() && i < 15; i++) {
-        dataToWrite[i] = Data[i]; // Write the amount into the byte array
-    }
-
-    // Add null terminator at the end of the data
-    if (Data.length() < 16) {
-        dataToWrite[Data.length()] = '\0';  // Null terminate the string
+    // Deduct the recharge amount from the balance journal before crediting the card
+    if (!Config->AdjustBalance(-static_cast<int64_t>(amount))) {
+        Serial.println(F("Failed to debit the device balance."));
+        Metrics.observeRecharge(millis() - startMs);
+        Metrics.increment(METRIC_RECHARGE_FAILURES);
+        return false; // Balance unchanged, card untouched
     }
 
     // Attempt to write the data to Sector 9, Block 1
     if (!writeDataToBlock(9, 1, dataToWrite)) {
         Serial.println(F("Failed to write amount to card."));
+        if (!Config->AdjustBalance(static_cast<int64_t>(amount))) {
+            Serial.println(F("Failed to credit the device balance back."));
+        }
+        Metrics.observeRecharge(millis() - startMs);
+        Metrics.increment(METRIC_RECHARGE_FAILURES);
         return false; // Writing failed
     }
-
-    // Update the balance in preferences
-    currentBalance -= amount;  // Deduct the recharge amount from the balance
-    Config->PutULong64(BALANCE, currentBalance);  // Update balance in preferences
+    Metrics.observeRecharge(millis() - startMs);
 
     Serial.println(F("Recharge successful. Amount written to card."));
     return true; // Success
@@ -602,6 +629,7 @@ uint32_t MRC522Manager::GetCardBalance() {
  * @return True if the operation was successful, otherwise false.
  */
 bool MRC522Manager::readDataFromBlock(byte sector, byte block, byte* buffer) {
+    TRACE_SCOPE("rfid.readBlock");
     // Check if the card is present
     if (!RFID->PICC_IsNewCardPresent()) {
         Serial.println(F("No card present."));
@@ -625,6 +653,7 @@ bool MRC522Manager::readDataFromBlock(byte sector, byte block, byte* buffer) {
     // Authenticate with the default key
     status = RFID->PCD_Authenticate(MFRC522::PICC_CMD_MF_AUTH_KEY_A, blockAddr, &keyA, &(RFID->uid));
     if (status != MFRC522::STATUS_OK) {
+        Metrics.countAuthFailure(blockAddr);
         Serial.println(F("Authentication with default key failed."));
         return false; // Authentication failed
     }
@@ -647,13 +676,13 @@ bool MRC522Manager::readDataFromBlock(byte sector, byte block, byte* buffer) {
 
 /**
  * @brief Retrieves the current balance from the device partition.
- * This function checks the stored balance value in preferences.
+ * This function returns the balance kept in the wear-leveled counter journal.
  * 
  * @return The current balance as a uint64_t value. If the balance is not set, it returns 0.
  */
 uint64_t MRC522Manager::GetBalance() {
     // Retrieve the current balance from the configuration manager
-    uint64_t currentBalance = Config->GetULong64(BALANCE, 0); // Default to 0 if not set
+    uint64_t currentBalance = Config->GetBalance();
 
     // Optionally, print the balance for debugging purposes
     Serial.print(F("Current balance retrieved: "));
@@ -712,6 +741,7 @@ String MRC522Manager::GetCPOSID() {
 }
 
 void MRC522Manager::resetRFID() {
+    TRACE_SCOPE("rfid.reset");
     // Set the reset pin as output
 //    pinMode(RFID_RST_PIN, OUTPUT);
 
@@ -731,7 +761,7 @@ void MRC522Manager::resetRFID() {
  *        If it is the master card, it will read additional information such as CPOS_ID and IMEI.
  *
  * This function scans a MIFARE Classic card, reads its UID (Unique Identifier), and compares it with a predefined
- * master card ID (`DEFAULT_MASTER_CARD_ID`). It returns a specific status code based on the outcome:
+ * master card ID (`MasterCardId` configuration entry). It returns a specific status code based on the outcome:
  * - `1` if the UID matches the master card ID (master card detected and additional information read).
  * - `0` if the UID does not match (non-master card).
  * - `3` if no card is detected.
@@ -750,7 +780,8 @@ void MRC522Manager::resetRFID() {
  *   - `7` for read failure.
  */
 uint8_t MRC522Manager::IsMasterCard() {
-    String uid = "";  // Initialize UID string to empty
+    TRACE_SCOPE("rfid.isMasterCard");
+    UidText uid;
     Prepare();  // Prepare the RFID module
 
     // Check for the presence of a new card
@@ -778,18 +809,10 @@ uint8_t MRC522Manager::IsMasterCard() {
     }
 
     // Format UID bytes as a hexadecimal string with colon separation
-    for (byte i = 0; i < RFID->uid.size; i++) {
-        if (RFID->uid.uidByte[i] < 0x10) {
-            uid += "0";  // Leading zero for single-digit hex values
-        }
-        uid += String(RFID->uid.uidByte[i], HEX);  // Append uppercase hex byte
-        if (i < RFID->uid.size - 1) {
-            uid += ":";  // Separate bytes with a colon
-        }
-    }
+    uid.appendHex(RFID->uid.uidByte, RFID->uid.size);
 
     // Check if the UID of the current card matches the predefined master card ID
-    if (uid.equalsIgnoreCase(DEFAULT_MASTR_CARD_ID)) {
+    if (uid.equalsIgnoreCase(Config->GetMasterCardId())) {
         Serial.println("IS MASTER CARD");
         // Halt card communication and disable encryption
         RFID->PICC_HaltA();      // Stop communication with the card
@@ -823,18 +846,10 @@ uint8_t MRC522Manager::IsMasterCard() {
 
     // Convert the byte array to a uint64_t value (e.g., card balance)
     cardBalance = 0;
-    String dataString = "";
 
-    // Convert byte array to string until the null terminator (or padding) is encountered
-    for (byte i = 0; i < 16; i++) {
-        if (buffer[i] == '\0') {
-            break; // Stop when the null terminator is encountered
-       }
-       dataString += (char)buffer[i]; // Convert byte to character
-    }
-
-    // Trim any extra spaces or non-numeric characters (optional)
-    dataString.trim();
+    // Take the text up to the null terminator (or padding), without extra spaces
+    BlockText dataString;
+    dataString.append((const char*)buffer, 16).trim();
 
     // Convert the string to a uint64_t value
     if (dataString.length() > 0) {
@@ -878,7 +893,8 @@ String MRC522Manager::GetMOBILE() {
  * - 5: Unsupported card type.
  */
 int MRC522Manager::SecureCheck() {
-    String uid = ""; // Initialize UID string to empty
+    TRACE_SCOPE("rfid.secureCheck");
+    UidText uid;
     Prepare();       // Prepare the RFID module
 
     // Check for the presence of a new card
@@ -906,18 +922,10 @@ int MRC522Manager::SecureCheck() {
     }
 
     // Format UID bytes as a hexadecimal string with colon separation
-    for (byte i = 0; i < RFID->uid.size; i++) {
-        if (RFID->uid.uidByte[i] < 0x10) {
-            uid += "0"; // Leading zero for single-digit hex values
-        }
-        uid += String(RFID->uid.uidByte[i], HEX); // Append uppercase hex byte
-        if (i < RFID->uid.size - 1) {
-            uid += ":"; // Separate bytes with a colon
-        }
-    }
+    uid.appendHex(RFID->uid.uidByte, RFID->uid.size);
 
     // Check if the UID of the current card matches the predefined master card ID
-    if (uid.equalsIgnoreCase(DEFAULT_MASTR_CARD_ID)) {
+    if (uid.equalsIgnoreCase(Config->GetMasterCardId())) {
         Serial.println("IS MASTER CARD");
         // Halt card communication and disable encryption
         RFID->PICC_HaltA();      // Stop communication with the card
@@ -936,24 +944,17 @@ int MRC522Manager::SecureCheck() {
  * This function returns a string representing the first number. It can be utilized 
  * in various network operations as needed.
  *
- * @return String - A string representing the first number.
+ * @return PhoneNumber - The first number, empty if it could not be read.
  */
-String MRC522Manager::GetNum01() {
+PhoneNumber MRC522Manager::GetNum01() {
     resetRFID();
     // Read data from Sector 10, Block 0
     
     byte sector = (NUM01_SECBLOC - (NUM01_SECBLOC % 4))/4;
     byte block = NUM01_SECBLOC % 4;
 
-    String num = readDataFromBlock(sector, block);
-    
-    // If the number is not available or too short, return an empty string
-    if (num.length() < 10) {
-        return "";
-    }
-
-    // Return only the first 10 digits
-    return num.substring(0, 10);
+    // Only the first 10 digits, empty if the block could not be read
+    return PhoneNumber(readDataFromBlock(sector, block).c_str());
 }
 
 
@@ -963,23 +964,16 @@ String MRC522Manager::GetNum01() {
  * This function returns a string representing the second number. It can be utilized 
  * in various network operations as needed.
  *
- * @return String - A string representing the second number.
+ * @return PhoneNumber - The second number, empty if it could not be read.
  */
-String MRC522Manager::GetNum02() {
+PhoneNumber MRC522Manager::GetNum02() {
     resetRFID();
     // Read data from Sector 10, Block 0
     byte sector = (NUM02_SECBLOC - (NUM02_SECBLOC % 4))/4;
     byte block = NUM02_SECBLOC % 4;
 
-    String num = readDataFromBlock(sector, block);
-    
-    // If the number is not available or too short, return an empty string
-    if (num.length() < 10) {
-        return "";
-    }
-
-    // Return only the first 10 digits
-    return num.substring(0, 10);
+    // Only the first 10 digits, empty if the block could not be read
+    return PhoneNumber(readDataFromBlock(sector, block).c_str());
 }
 /**
  * @brief Retrieves the third number associated with the device.
@@ -987,23 +981,16 @@ String MRC522Manager::GetNum02() {
  * This function returns a string representing the third number. It can be utilized 
  * in various network operations as needed.
  *
- * @return String - A string representing the third number.
+ * @return PhoneNumber - The third number, empty if it could not be read.
  */
-String MRC522Manager::GetNum03() {
+PhoneNumber MRC522Manager::GetNum03() {
     resetRFID();
     // Read data from Sector 10, Block 0
     byte sector = (NUM03_SECBLOC - (NUM03_SECBLOC % 4))/4;
     byte block = NUM03_SECBLOC % 4;
 
-    String num = readDataFromBlock(sector, block);
-    
-    // If the number is not available or too short, return an empty string
-    if (num.length() < 10) {
-        return "";
-    }
-
-    // Return only the first 10 digits
-    return num.substring(0, 10);
+    // Only the first 10 digits, empty if the block could not be read
+    return PhoneNumber(readDataFromBlock(sector, block).c_str());
 }
 
 /**
@@ -1012,23 +999,16 @@ String MRC522Manager::GetNum03() {
  * This function returns a string representing the fourth number. It can be utilized 
  * in various network operations as needed.
  *
- * @return String - A string representing the fourth number.
+ * @return PhoneNumber - The fourth number, empty if it could not be read.
  */
-String MRC522Manager::GetNum04() {
+PhoneNumber MRC522Manager::GetNum04() {
     resetRFID();
     // Read data from Sector 10, Block 0
     byte sector = (NUM04_SECBLOC - (NUM04_SECBLOC % 4))/4;
     byte block = NUM04_SECBLOC % 4;
 
-    String num = readDataFromBlock(sector, block);
-    
-    // If the number is not available or too short, return an empty string
-    if (num.length() < 10) {
-        return "";
-    }
-
-    // Return only the first 10 digits
-    return num.substring(0, 10);
+    // Only the first 10 digits, empty if the block could not be read
+    return PhoneNumber(readDataFromBlock(sector, block).c_str());
 }
 
 
@@ -1044,11 +1024,11 @@ String MRC522Manager::GetNum04() {
  *            The string should be 16 characters or fewer, as only the first 16 bytes 
  *            will be written to the card.
  */
-bool MRC522Manager::SaveNum01(String Num) {
+bool MRC522Manager::SaveNum01(const char* Num) {
     byte dataToWrite[16] = {0};  // Buffer to hold the data (16 bytes)
     resetRFID();
     // Convert each character of the string into a byte and store it in the buffer
-    for (int i = 0; i < Num.length(); i++) {
+    for (int i = 0; i < 16 && Num[i] != '\0'; i++) {
         dataToWrite[i] = Num[i];  // Convert each character to a byte
     }
 
@@ -1073,11 +1053,11 @@ bool MRC522Manager::SaveNum01(String Num) {
  *            The string should be 16 characters or fewer, as only the first 16 bytes 
  *            will be written to the card.
  */
-bool MRC522Manager::SaveNum02(String Num) {
+bool MRC522Manager::SaveNum02(const char* Num) {
     byte dataToWrite[16] = {0};  // Buffer to hold the data (16 bytes)
   resetRFID();
     // Convert each character of the string into a byte and store it in the buffer
-    for (int i = 0; i < Num.length(); i++) {
+    for (int i = 0; i < 16 && Num[i] != '\0'; i++) {
         dataToWrite[i] = Num[i];  // Convert each character to a byte
     }
 
@@ -1102,11 +1082,11 @@ bool MRC522Manager::SaveNum02(String Num) {
  *            The string should be 16 characters or fewer, as only the first 16 bytes 
  *            will be written to the card.
  */
-bool MRC522Manager::SaveNum03(String Num) {
+bool MRC522Manager::SaveNum03(const char* Num) {
     byte dataToWrite[16] = {0};  // Buffer to hold the data (16 bytes)
   resetRFID();
     // Convert each character of the string into a byte and store it in the buffer
-    for (int i = 0; i < Num.length(); i++) {
+    for (int i = 0; i < 16 && Num[i] != '\0'; i++) {
         dataToWrite[i] = Num[i];  // Convert each character to a byte
     }
 
@@ -1131,11 +1111,11 @@ bool MRC522Manager::SaveNum03(String Num) {
  *            The string should be 16 characters or fewer, as only the first 16 bytes 
  *            will be written to the card.
  */
-bool MRC522Manager::SaveNum04(String Num) {
+bool MRC522Manager::SaveNum04(const char* Num) {
     byte dataToWrite[16] = {0};  // Buffer to hold the data (16 bytes)
   resetRFID();
     // Convert each character of the string into a byte and store it in the buffer
-    for (int i = 0; i < Num.length(); i++) {
+    for (int i = 0; i < 16 && Num[i] != '\0'; i++) {
         dataToWrite[i] = Num[i];  // Convert each character to a byte
     }
 
@@ -1156,19 +1136,21 @@ bool MRC522Manager::SaveNum04(String Num) {
  * 
  * @param sector The sector number to read from (0-15).
  * @param block The block number within the sector (0-3).
- * @return String - The data read from the specified block as a string.
+ * @return BlockText - The data read from the specified block, up to its first null byte;
+ *         empty on failure.
  */
-String MRC522Manager::readDataFromBlock(byte sector, byte block) {
+BlockText MRC522Manager::readDataFromBlock(byte sector, byte block) {
+    TRACE_SCOPE("rfid.readBlockString");
     Prepare(ACTIVE_KEY);
 
     // Check for the presence of a new card
     if (!RFID->PICC_IsNewCardPresent()) {
-        return ""; // No card detected
+        return BlockText(); // No card detected
     }
 
     // Attempt to read the card's serial number
     if (!RFID->PICC_ReadCardSerial()) {
-        return ""; // Failed to read card data
+        return BlockText(); // Failed to read card data
     }
 
     // Determine the card type and ensure it's a supported MIFARE Classic card
@@ -1177,7 +1159,7 @@ String MRC522Manager::readDataFromBlock(byte sector, byte block) {
         piccType != MFRC522::PICC_TYPE_MIFARE_1K &&
         piccType != MFRC522::PICC_TYPE_MIFARE_4K) {
         Serial.println(F("This sample only works with MIFARE Classic cards."));
-        return ""; // Unsupported card type
+        return BlockText(); // Unsupported card type
     }
 
     byte buffer[18];          // Buffer to store read data
@@ -1188,7 +1170,7 @@ String MRC522Manager::readDataFromBlock(byte sector, byte block) {
         // Authenticate the sector with the default key
         if (!authenticateWithKeys(NUM012_AUTH, 0)) {
             Serial.println("Authentication failed");
-            return ""; // Authentication failed
+            return BlockText(); // Authentication failed
         }
     }
 
@@ -1196,22 +1178,19 @@ String MRC522Manager::readDataFromBlock(byte sector, byte block) {
         // Authenticate the sector with the default key
         if (!authenticateWithKeys(NUM034_AUTH, 0)) {
             Serial.println("Authentication failed");
-            return ""; // Authentication failed
+            return BlockText(); // Authentication failed
         }
     }
 
     // Read data from the block
     if (RFID->MIFARE_Read(sectorBlock, buffer, &bufferSize) != MFRC522::STATUS_OK) {
         Serial.println("Read failed");
-        return "";
+        return BlockText();
     }
 
     // Convert read data to a string
-    String dataString = "";
-    for (byte i = 0; i < 16; i++) {
-        dataString += (char)buffer[i]; // Convert byte to character
-    }
-
+    BlockText dataString;
+    dataString.append((const char*)buffer, 16);
     return dataString;
 }
 
@@ -1222,28 +1201,30 @@ String MRC522Manager::readDataFromBlock(byte sector, byte block) {
  *
  * This function reads the phone numbers stored on the RFID card in four separate blocks.
  * Each block contains a 10-digit phone number (or less if the data is incomplete).
- * The function returns an array of strings containing up to four phone numbers. 
+ * The function fills the four entries of numbers, in block order. 
  * The phone numbers are read from the following blocks:
  * - Sector 10, Block 0
  * - Sector 10, Block 1
  * - Sector 11, Block 0
  * - Sector 11, Block 1
  *
- * The function will return NULL if no card is present, if the card is not supported, or if any reading fails.
+ * The function will return false if no card is present, if the card is not supported, or if any reading fails.
  *
- * @return String* - Array containing up to four phone numbers, each with a maximum length of 10 digits.
+ * @param numbers Array of four phone numbers, each with a maximum length of 10 digits.
+ * @return true if the four blocks were read.
  */
-String* MRC522Manager::GetAllPhoneNumbers() {
+bool MRC522Manager::GetAllPhoneNumbers(PhoneNumber* numbers) {
+    TRACE_SCOPE("rfid.getAllPhoneNumbers");
     Prepare(ACTIVE_KEY);
     
     // Check for the presence of a new card
     if (!RFID->PICC_IsNewCardPresent()) {
-        return NULL;  // No card detected
+        return false;  // No card detected
     }
 
     // Attempt to read the card's serial number
     if (!RFID->PICC_ReadCardSerial()) {
-        return NULL;  // Failed to read card data
+        return false;  // Failed to read card data
     }
 
     // Determine the card type and ensure it's a supported MIFARE Classic card
@@ -1252,12 +1233,11 @@ String* MRC522Manager::GetAllPhoneNumbers() {
         && piccType != MFRC522::PICC_TYPE_MIFARE_1K
         && piccType != MFRC522::PICC_TYPE_MIFARE_4K) {
         Serial.println(F("This sample only works with MIFARE Classic cards."));
-        return NULL;  // Unsupported card type
+        return false;  // Unsupported card type
     }
 
     byte buffer[18]; // Buffer to store read data
     byte bufferSize = sizeof(buffer);
-    String* phoneNumbers = new String[4]; // Array to store phone numbers
 
     // Define the blocks we want to read (Sector 10 Block 0, Sector 10 Block 1, Sector 11 Block 0, Sector 11 Block 1)
     byte blocks[] = {40, 41, 44, 45};  // Blocks: 10:0 -> 0, 10:1 -> 1, 11:0 -> 4, 11:1 -> 5
@@ -1268,31 +1248,25 @@ String* MRC522Manager::GetAllPhoneNumbers() {
 
         // Authenticate the sector with the default key
         if (RFID->PCD_Authenticate(MFRC522::PICC_CMD_MF_AUTH_KEY_A, sectorBlock, &keyA, &(RFID->uid)) != MFRC522::STATUS_OK) {
+            Metrics.countAuthFailure(sectorBlock);
             Serial.println("Authentication failed while reading");
-            delete[] phoneNumbers;
-            return NULL;
+            return false;
         }
 
         // Read data from the block
         if (RFID->MIFARE_Read(sectorBlock, buffer, &bufferSize) != MFRC522::STATUS_OK) {
             Serial.println("Read failed");
-            delete[] phoneNumbers;
-            return NULL;
+            return false;
         }
 
-        // Convert the block data to string and store it in the array
-        String num = "";
-        for (byte j = 0; j < 16; j++) {
-            num += (char)buffer[j];  // Convert byte to character
-        }
-        
         // Store only the first 10 digits of the phone number in the array
-        phoneNumbers[i] = num.substring(0, 10);
+        numbers[i].clear();
+        numbers[i].append((const char*)buffer, 16);
     }
 
     // Halt card communication and disable encryption on the reader
     //RFID->PICC_HaltA();      // Stop communication with the card
     //RFID->PCD_StopCrypto1(); // Stop encryption
     
-    return phoneNumbers;  // Return the array of phone numbers
+    return true;  // The four numbers are filled
 }
@@ -3,8 +3,16 @@
 
 #include <SPI.h>
 #include <MFRC522.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
 #include "ConfigManager.h"
+#include "TraceBuffer.h"
+#include "Metrics.h"
+#include "FixedString.h"
 
+typedef FixedString<29> UidText;       ///< "xx:xx:..." UID of up to 10 bytes
+typedef FixedString<16> BlockText;     ///< Text of one card block, up to its first terminator
+typedef FixedString<10> PhoneNumber;   ///< Number slot of a user card, first 10 characters of its block
 
 /**
  * @class MRC522Manager
@@ -18,12 +26,15 @@ public:
   
     MRC522Manager(ConfigManager* Config,MFRC522* RFID);                                        ///< Constructor initializing with a ConfigManager reference
     void begin();                                         ///< Initializes the MFRC522 module for operation
+    void acquire();                                       ///< Takes the reader for a card exchange, see release()
+    void release();                                       ///< Gives the reader back to the other tasks
     bool readCard();                                      ///< Reads the RFID card and checks if it is present
-    String getCardUID();                                  ///< Retrieves the UID of the scanned card for identification
+    UidText getCardUID();                                 ///< Retrieves the UID of the scanned card for identification
+    void getLastUID(char* out, size_t size) const;        ///< Formats the UID of the last card read, without talking to the reader
     
     bool writeDataToBlock(byte sector, byte block, byte* data); ///< Writes data to a specified block in a sector of the card
     bool writeDataToBlockHex(byte sector, byte block, byte* data); ///< Writes data to a specified block in a sector of the card in Hex
-    String readDataFromBlock(byte sector, byte block);///< read data from a specified block in a sector of the card
+    BlockText readDataFromBlock(byte sector, byte block); ///< read data from a specified block in a sector of the card
     bool lockCard();                           ///< Locks the card by writing protective data to specified blocks
     bool Recharge(uint32_t amount); ///< Recharges the balance and writes it to the card, increasing its available balance
     bool IsCardDetected();                                   ///< Checks if a card is currently detected by the reader
@@ -37,21 +48,21 @@ public:
     String GetMOBILE();                                   ///< Retrieves the mobile number or ID associated with the device's network module
  
     uint8_t IsMasterCard();                                  ///< Checks if the card is classified as a master card
-    String GetNum01();                                    ///< Retrieves the first stored number from the NFC user card
-    String GetNum02();                                    ///< Retrieves the second stored number from the NFC user card
-    String GetNum03();                                    ///< Retrieves the third stored number from the NFC user card
-    String GetNum04();                                    ///< Retrieves the fourth stored number from the NFC user card
+    PhoneNumber GetNum01();                               ///< Retrieves the first stored number from the NFC user card
+    PhoneNumber GetNum02();                               ///< Retrieves the second stored number from the NFC user card
+    PhoneNumber GetNum03();                               ///< Retrieves the third stored number from the NFC user card
+    PhoneNumber GetNum04();                               ///< Retrieves the fourth stored number from the NFC user card
  
-    bool SaveNum01(String Num);                           ///< Saves a number to the first storage location on the NFC user card
-    bool SaveNum02(String Num);                           ///< Saves a number to the second storage location on the NFC user card
-    bool SaveNum03(String Num);                           ///< Saves a number to the third storage location on the NFC user card
-    bool SaveNum04(String Num);                           ///< Saves a number to the fourth storage location on the NFC user card
+    bool SaveNum01(const char* Num);                      ///< Saves a number to the first storage location on the NFC user card
+    bool SaveNum02(const char* Num);                      ///< Saves a number to the second storage location on the NFC user card
+    bool SaveNum03(const char* Num);                      ///< Saves a number to the third storage location on the NFC user card
+    bool SaveNum04(const char* Num);                      ///< Saves a number to the fourth storage location on the NFC user card
     void Prepare(const byte* customKey = nullptr) ;
     bool SecureTag(byte *userKey, byte *userACK);
     void printHex(byte *buffer, byte bufferSize);
     void printDec(byte *buffer, byte bufferSize);
     int SecureCheck();
-    String* GetAllPhoneNumbers();
+    bool GetAllPhoneNumbers(PhoneNumber* numbers);        ///< Reads the four number slots in one card session
     uint8_t cardStatusRead;
     void resetRFID();
 
@@ -59,6 +70,7 @@ public:
     MFRC522* RFID;                                       ///< Create an instance of the MFRC522 class to handle RFID operations
     MFRC522::MIFARE_Key keyA;                            ///< Default key for authentication with the RFID card
     ConfigManager* Config;                               ///< Pointer to the ConfigManager for accessing configuration settings
+    SemaphoreHandle_t readerMutex;                       ///< Recursive mutex serializing the card poller and the screens
     bool writePage(byte page, byte *data, byte len);
     // Variables for storing card-related information
     uint64_t cardBalance;    ///< The current balance stored on the RFID card
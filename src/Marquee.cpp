@@ -0,0 +1,118 @@
+#include "Marquee.h"
+
+/**
+ * @brief Constructor for the Marquee class.
+ *
+ * @param lcd Frame buffer the regions are drawn into.
+ */
+Marquee::Marquee(LcdFrameBuffer* lcd) : lcd(lcd) {
+    memset(regions, 0, sizeof(regions));
+}
+
+/**
+ * @brief Registers a region and draws its first frame.
+ *
+ * @param col First column of the region.
+ * @param row Line of the region.
+ * @param width Number of cells, clipped at the end of the line.
+ * @param text Text to show, truncated to MARQUEE_TEXT_MAX characters.
+ * @param stepMs Time between one-character shifts.
+ * @return Region id, -1 if every region is in use or the region is off screen.
+ */
+int8_t Marquee::add(uint8_t col, uint8_t row, uint8_t width, const char* text, uint32_t stepMs) {
+    if (col >= LcdFrameBuffer::COLS || row >= LcdFrameBuffer::ROWS || width == 0) {
+        return -1;
+    }
+    for (uint8_t id = 0; id < MARQUEE_MAX_REGIONS; id++) {
+        Region& region = regions[id];
+        if (region.active) continue;
+
+        region.col = col;
+        region.row = row;
+        region.width = col + width > LcdFrameBuffer::COLS ? LcdFrameBuffer::COLS - col : width;
+        region.stepMs = stepMs;
+        region.active = true;
+        setText(id, text);
+        return id;
+    }
+    if (DEBUGMODE) {
+        Serial.println("Marquee: no free region");
+    }
+    return -1;
+}
+
+/**
+ * @brief Replaces the text of a region and shows it from its first character.
+ */
+void Marquee::setText(int8_t id, const char* text) {
+    if (id < 0 || id >= MARQUEE_MAX_REGIONS || !regions[id].active) return;
+
+    Region& region = regions[id];
+    strncpy(region.text, text ? text : "", MARQUEE_TEXT_MAX);
+    region.text[MARQUEE_TEXT_MAX] = '\0';
+    region.length = strlen(region.text);
+    region.offset = 0;
+    region.nextStepMs = millis() + region.stepMs;
+    draw(region);
+}
+
+const char* Marquee::getText(int8_t id) const {
+    if (id < 0 || id >= MARQUEE_MAX_REGIONS || !regions[id].active) return "";
+    return regions[id].text;
+}
+
+void Marquee::remove(int8_t id) {
+    if (id < 0 || id >= MARQUEE_MAX_REGIONS) return;
+    regions[id].active = false;
+}
+
+void Marquee::clear() {
+    for (uint8_t id = 0; id < MARQUEE_MAX_REGIONS; id++) {
+        regions[id].active = false;
+    }
+}
+
+/**
+ * @brief Shifts every region whose step is due by one character.
+ *
+ * @param now Current millis().
+ * @return true if at least one region moved.
+ */
+bool Marquee::tick(uint32_t now) {
+    bool moved = false;
+    for (uint8_t id = 0; id < MARQUEE_MAX_REGIONS; id++) {
+        Region& region = regions[id];
+        if (!region.active || region.length <= region.width || (int32_t)(now - region.nextStepMs) < 0) {
+            continue;
+        }
+        region.offset = (region.offset + 1) % (region.length + MARQUEE_GAP);
+        region.nextStepMs = now + region.stepMs;
+        draw(region);
+        moved = true;
+    }
+    return moved;
+}
+
+uint8_t Marquee::getActiveCount() const {
+    uint8_t count = 0;
+    for (uint8_t id = 0; id < MARQUEE_MAX_REGIONS; id++) {
+        if (regions[id].active) count++;
+    }
+    return count;
+}
+
+/**
+ * @brief Writes the visible window of a region into the frame buffer.
+ */
+void Marquee::draw(const Region& region) {
+    uint16_t cycle = region.length + MARQUEE_GAP;
+    lcd->setCursor(region.col, region.row);
+    for (uint8_t i = 0; i < region.width; i++) {
+        if (region.length <= region.width) {
+            lcd->write(i < region.length ? (uint8_t)region.text[i] : ' ');
+        } else {
+            uint16_t index = (region.offset + i) % cycle;
+            lcd->write(index < region.length ? (uint8_t)region.text[index] : ' ');
+        }
+    }
+}
@@ -0,0 +1,55 @@
+#ifndef MARQUEE_H
+#define MARQUEE_H
+/**
+ * @file Marquee.h
+ * @brief Non-blocking scrolling text regions drawn into the LCD frame buffer.
+ *
+ * A screen registers a region (position, width and text) and returns; the UI
+ * event loop calls `tick()` on every iteration and each region whose step is
+ * due shifts its text by one character. Text that fits its region is drawn
+ * once and never moves. Longer text loops around with `MARQUEE_GAP` blanks
+ * between the end and the next start.
+ *
+ * Regions only rewrite their own window in the RAM frame, so the frame buffer
+ * flush sends just the cells the shift changed, and several regions can move
+ * on the same screen while keys and cards keep being handled. Regions belong
+ * to the screen on top and are dropped by ScreenManager on navigation.
+ */
+
+#include <Arduino.h>
+#include "Config.h"
+#include "LcdFrameBuffer.h"
+
+class Marquee {
+public:
+    explicit Marquee(LcdFrameBuffer* lcd);
+
+    int8_t add(uint8_t col, uint8_t row, uint8_t width, const char* text,
+               uint32_t stepMs = MARQUEE_STEP_MS);          ///< Register a region, returns its id or -1
+    void setText(int8_t id, const char* text);              ///< Replace the text and restart the scroll
+    const char* getText(int8_t id) const;                   ///< Text of a region, "" if inactive
+    void remove(int8_t id);                                 ///< Stop a region, its cells are left as they are
+    void clear();                                           ///< Stop every region
+    bool tick(uint32_t now);                                ///< Advance the due regions, true if a cell changed
+    uint8_t getActiveCount() const;
+
+private:
+    struct Region {
+        char text[MARQUEE_TEXT_MAX + 1];
+        uint8_t length;
+        uint8_t col;
+        uint8_t row;
+        uint8_t width;
+        uint8_t offset;             ///< Index of the text shown in the first cell
+        uint32_t stepMs;
+        uint32_t nextStepMs;        ///< millis() of the next shift
+        bool active;
+    };
+
+    void draw(const Region& region);
+
+    LcdFrameBuffer* lcd;
+    Region regions[MARQUEE_MAX_REGIONS];
+};
+
+#endif // MARQUEE_H
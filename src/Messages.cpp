@@ -0,0 +1,23 @@
+#include "Messages.h"
+
+/**
+ * @brief Picks a translation, or the English text when it is empty.
+ * Evaluated at compile time, the unused text is not linked in.
+ */
+static constexpr const char* translated(const char* english, const char* translation) {
+    return translation[0] != '\0' ? translation : english;
+}
+
+#if UI_LANGUAGE == UI_LANG_FR
+#define MESSAGE_TEXT(id, en, fr) translated(en, fr),
+#else
+#define MESSAGE_TEXT(id, en, fr) en,
+#endif
+
+static const char* const messages[MSG_COUNT] = {
+    MESSAGE_TABLE(MESSAGE_TEXT)
+};
+
+const char* msg(MessageId id) {
+    return id < MSG_COUNT ? messages[id] : "";
+}
@@ -0,0 +1,117 @@
+#ifndef MESSAGES_H
+#define MESSAGES_H
+/**
+ * @file Messages.h
+ * @brief Catalog of every text shown on the LCD, indexed by MessageId.
+ *
+ * Each message is declared once in `MESSAGE_TABLE` with its English text and
+ * an optional French translation. The table is expanded at build time into
+ * the `MessageId` enum and a constant pointer table; strings and table stay
+ * in flash and only the language selected by `UI_LANGUAGE` is linked in. An
+ * empty translation falls back to English.
+ *
+ * Columns: X(Id, English, French)
+ * Texts are checked at compile time to fit one LCD row. Ids starting with
+ * `MSG_FMT_` are snprintf() formats; each `%lu` takes a uint32_t and is
+ * counted at its widest (10 digits), so a balance never gets clipped.
+ */
+
+#include <stdint.h>
+#include "Config.h"
+
+#define MESSAGE_TABLE(X)                                                                            \
+    X(MSG_TITLE_SECURITY,      "SECURITY CHECK",       "CONTROLE ACCES")                            \
+    X(MSG_SCAN_MASTER,         "SCAN MASTER KEY",      "CARTE MAITRE ?")                            \
+    X(MSG_INVALID_KEY,         "INVALID KEY!",         "CLE INVALIDE!")                             \
+    X(MSG_INVALID_CARD,        ">   INVALID CARD!  <", ">  CARTE INVALIDE! <")                      \
+    X(MSG_RULE,                "____________________", "")                                          \
+    X(MSG_TITLE_HOME,          "HOME",                 "ACCUEIL")                                   \
+    X(MSG_MANAGER,             "Manager> ",            "Gerant> ")                                  \
+    X(MSG_DATE,                "Date> ",               "")                                          \
+    X(MSG_BALANCE,             "Balance> ",            "Solde> ")                                   \
+    X(MSG_UNITS,               "Units",                "Unit.")                                     \
+    X(MSG_LAST_COMM,           "LastComm> ",           "DernOp> ")                                  \
+    X(MSG_WIFI,                "Wifi >",               "")                                          \
+    X(MSG_TITLE_SELECT,        "SELECT",               "CHOIX")                                     \
+    X(MSG_MENU_RECHARGE,       "01   > RECHARGE",      "")                                          \
+    X(MSG_MENU_SET_NUMBER,     "02   > SET NUMBER",    "02   > NUMEROS")                            \
+    X(MSG_CARD_BALANCE,        "L CARD > ",            "CARTE  > ")                                 \
+    X(MSG_TITLE_RECHARGE,      "RECHARGE",             "")                                          \
+    X(MSG_POS_BALANCE,         "POS    > ",            "TPE    > ")                                 \
+    X(MSG_SELECT,              "Select>",              "Choix> ")                                   \
+    X(MSG_RECHARGE_OPTIONS,    " 1-100 2-200 3-INPUT", " 1-100 2-200 3-AUTRE")                      \
+    X(MSG_ENTER_AMOUNT,        "ENTER THE AMOUNT",     "SAISIR LE MONTANT")                         \
+    X(MSG_CONFIRM_RECHARGE,    "Confirm Recharge ?",   "Confirmer recharge?")                       \
+    X(MSG_FMT_UNITS,           "%lu Units",            "%lu Unites")                                \
+    X(MSG_LOW_BALANCE,         ">    LOW BALANCE   <", "> SOLDE INSUFFISANT<")                      \
+    X(MSG_RECHARGE_FAILED,     "> RECHARGE FAILED! <", "> RECHARGE ECHOUEE <")                      \
+    X(MSG_RECHARGE_SUCCEEDED,  "RECHARGE SUCCEEDED!",  "RECHARGE REUSSIE!")                         \
+    X(MSG_FMT_HOLD_BALANCE,    "HOLD BAL> %lu",        "ANC SOLDE %lu")                             \
+    X(MSG_FMT_NEW_BALANCE,     "NEW BAL > %lu",        "NV SOLDE> %lu")                             \
+    X(MSG_CARD_NOT_VALID,      ">  CARD NOT VALID  <", "> CARTE NON VALIDE <")                      \
+    X(MSG_WRITE_ERROR,         ">  OR WRITE ERROR  <", ">OU ERREUR ECRITURE<")                      \
+    X(MSG_OPERATION_FAILED,    "OPERATION FAILED!",    "OPERATION ECHOUEE!")                        \
+    X(MSG_NO_NUMBER,           "No Number",            "Aucun")                                     \
+    X(MSG_NUMBER_1,            "01 > ",                "")                                          \
+    X(MSG_NUMBER_2,            "02 > ",                "")                                          \
+    X(MSG_NUMBER_3,            "03 > ",                "")                                          \
+    X(MSG_NUMBER_4,            "04 > ",                "")                                          \
+    X(MSG_SEPARATOR,           "|",                    "")                                          \
+    X(MSG_NUMBERS_LABEL_1,     "| SET",                "| NUM")                                     \
+    X(MSG_NUMBERS_LABEL_2,     "| THE",                "| DE")                                      \
+    X(MSG_NUMBERS_LABEL_3,     "| NUM",                "| TEL")                                     \
+    X(MSG_ENTER_NUMBER,        "Enter New Number",     "Nouveau numero")                            \
+    X(MSG_TITLE_USER,          "USER",                 "UTILISATEUR")                               \
+    X(MSG_FMT_NEW_NUMBER,      "NEW NUMBER 0%u",       "NUMERO 0%u")                                \
+    X(MSG_SAVED,               "SAVED SUCCESSFULLY!",  "ENREGISTRE !")                              \
+    X(MSG_TITLE_LOCK_CARD,     "LOCK CARD",            "BLOQUER CARTE")                             \
+    X(MSG_PLACE_CARD,          "    Place card",       "  Poser la carte")                          \
+    X(MSG_CARD_SLOT,           ">                  <", "")                                          \
+    X(MSG_LOCK_SUCCEEDED,      "Locking Succeed!",     "Carte bloquee!")                            \
+    X(MSG_LOCK_FAILED,         "Locking Failed!",      "Blocage echoue!")                           \
+    X(MSG_TITLE_AP,            "AP MODE",              "MODE AP")                                   \
+    X(MSG_WIFI_NOT_SET,        "** WIFI NOT SET **",   "** WIFI NON CONF **")                       \
+    X(MSG_AP_ADDRESS,          "AP Address: ",         "Adresse AP: ")                              \
+    X(MSG_AP_NAME,             "Name: DeviceRF",       "Nom: DeviceRF")                             \
+    X(MSG_PROMPT_MARK,         ">",                    "")                                          \
+    X(MSG_CONFIRM_KEYS,        "No: '*'     Yes: '#'", "Non: '*'   Oui: '#'")                       \
+    X(MSG_TIMEOUT,             "Timeout",              "Delai depasse")                             \
+    X(MSG_LOCKING,             "Locking the device",   "Verrouillage")                              \
+    X(MSG_ELLIPSIS,            "...",                  "")
+
+#define UI_LANG_EN 0  ///< English, the texts of the first column
+#define UI_LANG_FR 1  ///< French, the second column
+
+// --------------------------------------------------
+// Compile-time validation of the table
+// --------------------------------------------------
+
+/**
+ * @brief Longest text a message can produce: `%lu` counts as the 10 digits
+ * of UINT32_MAX, every other character as itself.
+ */
+static constexpr uint8_t messageWidth(const char* text) {
+    return text[0] == '\0' ? 0
+         : text[0] == '%' && text[1] == 'l' && text[2] == 'u' ? 10 + messageWidth(text + 3)
+         : 1 + messageWidth(text + 1);
+}
+
+#define MESSAGE_CHECK(id, en, fr)                                                                   \
+    static_assert(messageWidth(en) <= LCD_COLUMNS, #id ": English text longer than a row");        \
+    static_assert(messageWidth(fr) <= LCD_COLUMNS, #id ": French text longer than a row");
+
+MESSAGE_TABLE(MESSAGE_CHECK)
+
+// --------------------------------------------------
+// Message ids, one per table entry
+// --------------------------------------------------
+#define MESSAGE_ID(id, en, fr) id,
+
+enum MessageId : uint8_t {
+    MESSAGE_TABLE(MESSAGE_ID)
+    MSG_COUNT
+};
+
+const char* msg(MessageId id);  ///< Text of a message in the firmware's language, "" for an unknown id
+
+#endif // MESSAGES_H
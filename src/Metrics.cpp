@@ -0,0 +1,85 @@
+#include "Metrics.h"
+
+DeviceMetrics Metrics;
+
+const uint32_t DeviceMetrics::RECHARGE_BOUNDS_MS[RECHARGE_BUCKETS] = {25, 50, 100, 250, 500, 1000, 2500};
+
+DeviceMetrics::DeviceMetrics() : rechargeCount(0), rechargeSumMs(0) {
+    for (uint8_t i = 0; i < METRIC_COUNTER_COUNT; i++) {
+        counters[i].store(0, std::memory_order_relaxed);
+    }
+    for (uint8_t i = 0; i < METRICS_AUTH_SECTORS; i++) {
+        authFailures[i].store(0, std::memory_order_relaxed);
+    }
+    for (uint8_t i = 0; i <= RECHARGE_BUCKETS; i++) {
+        rechargeBuckets[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Subscribes the counters to the card events of the bus.
+ */
+void DeviceMetrics::subscribe() {
+    Bus.attach(SUBSCRIBER_METRICS, onBusEvent, this);
+}
+
+/**
+ * @brief Bus wake hook: counting is a few atomic adds, so the events are
+ * taken right away on the publisher's task instead of waking another one.
+ */
+void DeviceMetrics::onBusEvent(void* context) {
+    DeviceMetrics* self = static_cast<DeviceMetrics*>(context);
+    BusEvent event;
+    while (Bus.receive(SUBSCRIBER_METRICS, event)) {
+        if (event.topic == TOPIC_CARD) {
+            self->increment(METRIC_CARD_TAPS);
+        }
+    }
+}
+
+/**
+ * @brief Counts an authentication failure against the sector of a block.
+ *
+ * MIFARE Classic 1K/4K: the first 32 sectors hold 4 blocks, the 8 sectors
+ * of the 4K above block 127 hold 16.
+ *
+ * @param blockAddr Absolute block number passed to PCD_Authenticate().
+ */
+void DeviceMetrics::countAuthFailure(uint8_t blockAddr) {
+    uint8_t sector = blockAddr < 128 ? blockAddr / 4 : 32 + (blockAddr - 128) / 16;
+    if (sector >= METRICS_AUTH_SECTORS) {
+        sector = METRICS_AUTH_SECTORS - 1;
+    }
+    authFailures[sector].fetch_add(1, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Records the duration of one recharge.
+ *
+ * @param durationMs Time from the start of Recharge() to its result.
+ */
+void DeviceMetrics::observeRecharge(uint32_t durationMs) {
+    uint8_t bucket = 0;
+    while (bucket < RECHARGE_BUCKETS && durationMs > RECHARGE_BOUNDS_MS[bucket]) {
+        bucket++;
+    }
+    rechargeBuckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    rechargeSumMs.fetch_add(durationMs, std::memory_order_relaxed);
+    rechargeCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint32_t DeviceMetrics::getAuthFailures(uint8_t sector) const {
+    return sector < METRICS_AUTH_SECTORS ? authFailures[sector].load(std::memory_order_relaxed) : 0;
+}
+
+uint32_t DeviceMetrics::getRechargeBucket(uint8_t bucket) const {
+    return bucket <= RECHARGE_BUCKETS ? rechargeBuckets[bucket].load(std::memory_order_relaxed) : 0;
+}
+
+uint32_t DeviceMetrics::getRechargeCount() const {
+    return rechargeCount.load(std::memory_order_relaxed);
+}
+
+uint32_t DeviceMetrics::getRechargeSumMs() const {
+    return rechargeSumMs.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,78 @@
+#ifndef METRICS_H
+#define METRICS_H
+/**
+ * @file Metrics.h
+ * @brief Lock-free runtime counters, exported in Prometheus format by MetricsServer.
+ *
+ * Hot paths bump counters of the global `Metrics` object, card taps are
+ * counted from the EventBus:
+ * @code
+ *   Metrics.increment(METRIC_CARD_TAPS);
+ *   Metrics.countAuthFailure(blockAddr);
+ *   Metrics.observeRecharge(durationMs);
+ * @endcode
+ * Every value is a `std::atomic<uint32_t>` updated with relaxed ordering, so
+ * counting costs one atomic add, never takes a lock and is safe from any task
+ * or core. Values only grow; Prometheus handles the wrap-around of a 32-bit
+ * counter like a device restart.
+ *
+ * Gauges that already exist elsewhere (heap, RSSI, queue depths, stack
+ * high-water marks) are not copied here, MetricsServer reads them at scrape
+ * time.
+ */
+
+#include <Arduino.h>
+#include <atomic>
+#include "Config.h"
+#include "EventBus.h"
+
+/**
+ * @brief Plain event counters. The order is the export order of MetricsServer.
+ */
+enum MetricCounter : uint8_t {
+    METRIC_CARD_TAPS,            ///< Cards accepted by the card poller, counted from the bus
+    METRIC_RECHARGE_FAILURES,    ///< Recharges refused or not written to the card
+    METRIC_LOG_RECORDS,          ///< Transactions recorded
+    METRIC_LOG_WRITES,           ///< Log entries appended
+    METRIC_LOG_WRITE_ERRORS,     ///< Log file writes that failed
+    METRIC_LOG_DROPPED,          ///< Log file entries lost on a full writer queue
+    METRIC_NVS_WRITES,           ///< Preferences keys written
+    METRIC_UI_EVENTS,            ///< UI events dispatched to a screen
+    METRIC_UI_EVENTS_DROPPED,    ///< UI events lost on a full queue
+    METRIC_COUNTER_COUNT
+};
+
+class DeviceMetrics {
+public:
+    static const uint8_t RECHARGE_BUCKETS = 7;                   ///< Finite histogram buckets, +Inf is implied
+    static const uint32_t RECHARGE_BOUNDS_MS[RECHARGE_BUCKETS];  ///< Upper bound of each bucket
+
+    DeviceMetrics();
+
+    void subscribe();                            ///< Count the card events of the EventBus
+
+    void increment(MetricCounter counter, uint32_t amount = 1) {
+        counters[counter].fetch_add(amount, std::memory_order_relaxed);
+    }
+    void countAuthFailure(uint8_t blockAddr);    ///< MIFARE authentication refused for this block's sector
+    void observeRecharge(uint32_t durationMs);   ///< Add one recharge to the latency histogram
+
+    uint32_t get(MetricCounter counter) const { return counters[counter].load(std::memory_order_relaxed); }
+    uint32_t getAuthFailures(uint8_t sector) const;
+    uint32_t getRechargeBucket(uint8_t bucket) const;   ///< Recharges of this bucket only, not cumulative
+    uint32_t getRechargeCount() const;
+    uint32_t getRechargeSumMs() const;
+
+private:
+    static void onBusEvent(void* context);
+
+    std::atomic<uint32_t> counters[METRIC_COUNTER_COUNT];
+    std::atomic<uint32_t> authFailures[METRICS_AUTH_SECTORS];
+    std::atomic<uint32_t> rechargeBuckets[RECHARGE_BUCKETS + 1];  ///< Last one is +Inf
+    std::atomic<uint32_t> rechargeCount;
+    std::atomic<uint32_t> rechargeSumMs;
+};
+
+extern DeviceMetrics Metrics;
+
+#endif // METRICS_H
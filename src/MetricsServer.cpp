@@ -0,0 +1,303 @@
+#include "MetricsServer.h"
+#include <stdarg.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "ScreenManager.h"
+#include "TaskTopology.h"
+
+/**
+ * @brief Exported families after the plain counters, in page order.
+ */
+enum MetricsFamily : uint8_t {
+    FAMILY_AUTH_FAILURES = METRIC_COUNTER_COUNT,
+    FAMILY_RECHARGE_DURATION,
+    FAMILY_BUS_EVENTS,
+    FAMILY_BUS_DROPPED,
+    FAMILY_UI_QUEUE_DEPTH,
+    FAMILY_LOG_QUEUE_DEPTH,
+    FAMILY_HEAP_FREE,
+    FAMILY_HEAP_MIN_FREE,
+    FAMILY_HEAP_LARGEST_BLOCK,
+    FAMILY_WIFI_RSSI,
+    FAMILY_LCD_RENDER_LAST,
+    FAMILY_LCD_RENDER_MAX,
+    FAMILY_KEYPAD_SCANS,
+    FAMILY_KEYPAD_SCAN_MAX,
+    FAMILY_KEYPAD_EVENTS,
+    FAMILY_KEYPAD_DROPPED,
+    FAMILY_TASK_STACK_FREE,
+    FAMILY_TASK_BUSY,
+    FAMILY_UPTIME,
+    FAMILY_COUNT
+};
+
+struct MetricsFamilyInfo {
+    const char* name;
+    const char* type;
+    const char* help;
+};
+
+static const MetricsFamilyInfo FAMILIES[] = {
+    {"card_taps_total", "counter", "Cards read by the UI"},
+    {"recharge_failures_total", "counter", "Recharges refused or not written to the card"},
+    {"log_records_total", "counter", "Transactions recorded"},
+    {"log_writes_total", "counter", "Log entries appended"},
+    {"log_write_errors_total", "counter", "Log file writes that failed"},
+    {"log_dropped_total", "counter", "Log file entries lost on a full writer queue"},
+    {"nvs_writes_total", "counter", "Preferences keys written"},
+    {"ui_events_total", "counter", "UI events dispatched"},
+    {"ui_events_dropped_total", "counter", "UI events lost on a full queue"},
+    {"auth_failures_total", "counter", "MIFARE authentication failures by sector"},
+    {"recharge_duration_ms", "histogram", "Time to perform a recharge"},
+    {"bus_events_total", "counter", "Events published on the event bus by topic"},
+    {"bus_dropped_total", "counter", "Bus events lost on a subscriber's full queue"},
+    {"ui_queue_depth", "gauge", "UI events waiting in the queue"},
+    {"log_queue_depth", "gauge", "Log entries waiting for the writer task"},
+    {"heap_free_bytes", "gauge", "Free heap"},
+    {"heap_min_free_bytes", "gauge", "Lowest free heap since boot"},
+    {"heap_largest_block_bytes", "gauge", "Largest allocatable heap block"},
+    {"wifi_rssi_dbm", "gauge", "Station signal strength, absent when not connected"},
+    {"lcd_render_last_us", "gauge", "Duration of the last LCD render"},
+    {"lcd_render_max_us", "gauge", "Longest LCD render"},
+    {"keypad_scans_total", "counter", "Keypad matrix scans"},
+    {"keypad_scan_max_us", "gauge", "Longest keypad matrix scan"},
+    {"keypad_events_total", "counter", "Key events posted to the UI"},
+    {"keypad_events_dropped_total", "counter", "Key events lost on a full UI queue"},
+    {"task_stack_free_bytes", "gauge", "Lowest free stack of each task since it started"},
+    {"task_busy_seconds_total", "counter", "Time each application task spent working"},
+    {"uptime_seconds", "gauge", "Time since boot"},
+};
+static_assert(sizeof(FAMILIES) / sizeof(FAMILIES[0]) == FAMILY_COUNT, "One entry per metric family");
+
+/// System tasks whose stack high-water mark is exported after the TaskTopology ones; tasks not running are skipped
+static const char* const SYSTEM_TASKS[] = {"loopTask", "async_tcp", "esp_timer", "wifi", "tiT"};
+static const uint8_t SYSTEM_TASK_COUNT = sizeof(SYSTEM_TASKS) / sizeof(SYSTEM_TASKS[0]);
+
+/**
+ * @brief Formats into a line buffer.
+ *
+ * @return Length written, clamped to the buffer when the text was cut.
+ */
+static int formatLine(char* line, size_t size, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(line, size, format, args);
+    va_end(args);
+    if (length < 0) return 0;
+    return (size_t)length < size ? length : (int)size - 1;
+}
+
+/**
+ * @brief Constructor for the MetricsServer class.
+ *
+ * @param wifiManager Source of the RSSI.
+ * @param screenManager Source of the UI event queue.
+ * @param lcd Source of the render timings.
+ * @param keypad Source of the scan statistics.
+ */
+MetricsServer::MetricsServer(WiFiManager* wifiManager, ScreenManager* screenManager, LcdFrameBuffer* lcd,
+                             KeypadScanner* keypad)
+    : wifiManager(wifiManager), screenManager(screenManager), lcd(lcd), keypad(keypad) {}
+
+/**
+ * @brief Registers the /metrics route.
+ *
+ * @param server The WiFiManager's web server.
+ */
+void MetricsServer::begin(AsyncWebServer& server) {
+    server.on("/metrics", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        Cursor cursor = {0, 0};
+        AsyncWebServerResponse* response = request->beginChunkedResponse(
+            "text/plain; version=0.0.4",
+            [this, cursor](uint8_t* buffer, size_t maxLen, size_t index) mutable {
+                return fill(cursor, buffer, maxLen);
+            });
+        response->addHeader("Cache-Control", "no-store");
+        request->send(response);
+    });
+
+    if (DEBUGMODE) {
+        Serial.println("MetricsServer: /metrics registered");
+    }
+}
+
+/**
+ * @brief Response filler: appends whole lines while they fit.
+ *
+ * @return Bytes written, 0 once every family was sent.
+ */
+size_t MetricsServer::fill(Cursor& cursor, uint8_t* buffer, size_t maxLen) {
+    char line[METRICS_LINE_SIZE];
+    size_t length = 0;
+    while (cursor.family < FAMILY_COUNT) {
+        int lineLength = renderItem(cursor.family, cursor.item, line, sizeof(line));
+        if (lineLength < 0) {
+            cursor.family++;
+            cursor.item = 0;
+            continue;
+        }
+        if (length + lineLength > maxLen) {
+            break;
+        }
+        memcpy(buffer + length, line, lineLength);
+        length += lineLength;
+        cursor.item++;
+    }
+    if (length == 0 && cursor.family < FAMILY_COUNT) {
+        return RESPONSE_TRY_AGAIN;  // Not even one line fits the send window yet
+    }
+    return length;
+}
+
+/**
+ * @brief Formats one line of a family: item 0 is the HELP/TYPE header,
+ * the following ones its samples.
+ *
+ * @return Length of the line, 0 for an item without output (e.g. a sector
+ * without failures), -1 past the last item of the family.
+ */
+int MetricsServer::renderItem(uint8_t family, uint8_t item, char* line, size_t size) {
+    const MetricsFamilyInfo& info = FAMILIES[family];
+    if (item == 0) {
+        return formatLine(line, size, "# HELP " METRICS_PREFIX "%s %s\n# TYPE " METRICS_PREFIX "%s %s\n",
+                          info.name, info.help, info.name, info.type);
+    }
+    return renderSample(family, item - 1, line, size);
+}
+
+int MetricsServer::renderSample(uint8_t family, uint8_t sample, char* line, size_t size) {
+    const char* name = FAMILIES[family].name;
+
+    if (family < METRIC_COUNTER_COUNT) {
+        if (sample > 0) return -1;
+        return formatLine(line, size, METRICS_PREFIX "%s %u\n", name, (unsigned)Metrics.get((MetricCounter)family));
+    }
+
+    switch (family) {
+    case FAMILY_AUTH_FAILURES: {
+        if (sample >= METRICS_AUTH_SECTORS) return -1;
+        uint32_t failures = Metrics.getAuthFailures(sample);
+        if (failures == 0) return 0;
+        return formatLine(line, size, METRICS_PREFIX "%s{sector=\"%u\"} %u\n", name, sample, (unsigned)failures);
+    }
+
+    case FAMILY_RECHARGE_DURATION: {
+        // Buckets are cumulative in the exposition format
+        const uint8_t buckets = DeviceMetrics::RECHARGE_BUCKETS;
+        if (sample <= buckets) {
+            uint32_t cumulative = 0;
+            for (uint8_t bucket = 0; bucket <= sample; bucket++) {
+                cumulative += Metrics.getRechargeBucket(bucket);
+            }
+            if (sample == buckets) {
+                return formatLine(line, size, METRICS_PREFIX "%s_bucket{le=\"+Inf\"} %u\n", name, (unsigned)cumulative);
+            }
+            return formatLine(line, size, METRICS_PREFIX "%s_bucket{le=\"%u\"} %u\n", name,
+                              (unsigned)DeviceMetrics::RECHARGE_BOUNDS_MS[sample], (unsigned)cumulative);
+        }
+        if (sample == buckets + 1) {
+            return formatLine(line, size, METRICS_PREFIX "%s_sum %u\n", name, (unsigned)Metrics.getRechargeSumMs());
+        }
+        if (sample == buckets + 2) {
+            return formatLine(line, size, METRICS_PREFIX "%s_count %u\n", name, (unsigned)Metrics.getRechargeCount());
+        }
+        return -1;
+    }
+
+    case FAMILY_BUS_EVENTS:
+        if (sample >= TOPIC_COUNT) return -1;
+        return formatLine(line, size, METRICS_PREFIX "%s{topic=\"%s\"} %u\n", name,
+                          Bus.getTopicName((BusTopic)sample), (unsigned)Bus.getPublished((BusTopic)sample));
+
+    case FAMILY_BUS_DROPPED:
+        if (sample >= SUBSCRIBER_COUNT) return -1;
+        return formatLine(line, size, METRICS_PREFIX "%s{subscriber=\"%s\"} %u\n", name,
+                          Bus.getSubscriberName((BusSubscriber)sample),
+                          (unsigned)Bus.getDropped((BusSubscriber)sample));
+
+    case FAMILY_KEYPAD_SCANS:
+    case FAMILY_KEYPAD_EVENTS:
+    case FAMILY_KEYPAD_DROPPED: {
+        if (sample > 0) return -1;
+        KeypadScanner::Stats stats = keypad->getStats();
+        uint32_t value = family == FAMILY_KEYPAD_SCANS ? stats.scans
+                       : family == FAMILY_KEYPAD_EVENTS ? stats.events : stats.dropped;
+        return formatLine(line, size, METRICS_PREFIX "%s %u\n", name, (unsigned)value);
+    }
+
+    case FAMILY_TASK_STACK_FREE: {
+        if (sample >= TASK_COUNT + SYSTEM_TASK_COUNT) return -1;
+        const char* taskName;
+        TaskHandle_t task;
+        if (sample < TASK_COUNT) {
+            taskName = Tasks.getSpec((TaskId)sample).name;
+            task = Tasks.getHandle((TaskId)sample);
+        } else {
+            taskName = SYSTEM_TASKS[sample - TASK_COUNT];
+            task = xTaskGetHandle(taskName);
+        }
+        if (task == nullptr) return 0;
+        // ESP-IDF counts stacks in bytes
+        return formatLine(line, size, METRICS_PREFIX "%s{task=\"%s\"} %u\n", name, taskName,
+                          (unsigned)uxTaskGetStackHighWaterMark(task));
+    }
+
+    case FAMILY_TASK_BUSY: {
+        if (sample >= TASK_COUNT) return -1;
+        const TaskSpec& spec = Tasks.getSpec((TaskId)sample);
+        uint32_t busyMs = Tasks.getBusyMs((TaskId)sample);
+        return formatLine(line, size, METRICS_PREFIX "%s{task=\"%s\",core=\"%ld\"} %lu.%03u\n", name, spec.name,
+                          (long)spec.core, (unsigned long)(busyMs / 1000), (unsigned)(busyMs % 1000));
+    }
+
+    default: {
+        int32_t value;
+        if (sample > 0 || !readGauge(family, value)) return -1;
+        return formatLine(line, size, METRICS_PREFIX "%s %ld\n", name, (long)value);
+    }
+    }
+}
+
+/**
+ * @brief Reads a single-value gauge.
+ *
+ * @return false if the gauge has no value right now.
+ */
+bool MetricsServer::readGauge(uint8_t family, int32_t& value) {
+    switch (family) {
+    case FAMILY_UI_QUEUE_DEPTH:
+        value = (int32_t)uxQueueMessagesWaiting(screenManager->getEventQueue());
+        return true;
+    case FAMILY_LOG_QUEUE_DEPTH:
+        value = (int32_t)screenManager->getLog()->getQueueDepth();
+        return true;
+    case FAMILY_HEAP_FREE:
+        value = (int32_t)ESP.getFreeHeap();
+        return true;
+    case FAMILY_HEAP_MIN_FREE:
+        value = (int32_t)ESP.getMinFreeHeap();
+        return true;
+    case FAMILY_HEAP_LARGEST_BLOCK:
+        value = (int32_t)ESP.getMaxAllocHeap();
+        return true;
+    case FAMILY_WIFI_RSSI:
+        if (!wifiManager->isStillConnected()) return false;
+        value = wifiManager->getRssi();
+        return true;
+    case FAMILY_LCD_RENDER_LAST:
+        value = (int32_t)lcd->getStats().lastRenderUs;
+        return true;
+    case FAMILY_LCD_RENDER_MAX:
+        value = (int32_t)lcd->getStats().maxRenderUs;
+        return true;
+    case FAMILY_KEYPAD_SCAN_MAX:
+        value = (int32_t)keypad->getStats().maxScanUs;
+        return true;
+    case FAMILY_UPTIME:
+        value = (int32_t)(esp_timer_get_time() / 1000000);
+        return true;
+    default:
+        return false;
+    }
+}
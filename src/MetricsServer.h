@@ -0,0 +1,57 @@
+#ifndef METRICSSERVER_H
+#define METRICSSERVER_H
+/**
+ * @file MetricsServer.h
+ * @brief `GET /metrics` in the Prometheus text exposition format.
+ *
+ * Exports the counters of `Metrics` (card taps, auth failures by sector,
+ * recharge latency histogram, log and NVS writes, UI events) and of the
+ * EventBus (events by topic, drops by subscriber) together with
+ * gauges read at scrape time: heap free/minimum/largest block, Wi-Fi RSSI,
+ * UI event and log queue depths, LCD render time, keypad scans and dropped
+ * key events, task stack high-water
+ * marks, busy time of each TaskTopology task and uptime.
+ *
+ * The text is streamed as a chunked response. Each chunk is filled line by
+ * line, every line formatted into a `METRICS_LINE_SIZE` stack buffer; the
+ * only per-request state is a two-byte cursor kept in the response callback.
+ * A scrape therefore needs no buffer the size of the page, however many
+ * metrics are exported.
+ */
+
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+#include "Config.h"
+#include "Metrics.h"
+#include "WiFiManager.h"
+#include "LcdFrameBuffer.h"
+#include "KeypadScanner.h"
+
+class ScreenManager;
+
+class MetricsServer {
+public:
+    MetricsServer(WiFiManager* wifiManager, ScreenManager* screenManager, LcdFrameBuffer* lcd,
+                  KeypadScanner* keypad);
+
+    void begin(AsyncWebServer& server);   ///< Register the /metrics route
+
+private:
+    /// Position in the page: metric family, then line within the family (0 is its HELP/TYPE header)
+    struct Cursor {
+        uint8_t family;
+        uint8_t item;
+    };
+
+    size_t fill(Cursor& cursor, uint8_t* buffer, size_t maxLen);
+    int renderItem(uint8_t family, uint8_t item, char* line, size_t size);
+    int renderSample(uint8_t family, uint8_t sample, char* line, size_t size);
+    bool readGauge(uint8_t family, int32_t& value);
+
+    WiFiManager* wifiManager;
+    ScreenManager* screenManager;
+    LcdFrameBuffer* lcd;
+    KeypadScanner* keypad;
+};
+
+#endif // METRICSSERVER_H
@@ -0,0 +1,267 @@
+#include "RecordingManager.h"
+
+/**
+ * @brief Copies a string into a JSON string body, escaping quotes,
+ * backslashes and control characters.
+ *
+ * @return Length written, the text is cut to fit size.
+ */
+static size_t jsonEscape(const char* text, char* out, size_t size) {
+    size_t length = 0;
+    for (; *text != '\0'; text++) {
+        char c = *text;
+        if (c == '"' || c == '\\') {
+            if (length + 2 >= size) break;
+            out[length++] = '\\';
+            out[length++] = c;
+        } else if ((uint8_t)c >= 0x20) {
+            if (length + 1 >= size) break;
+            out[length++] = c;
+        }
+    }
+    out[length] = '\0';
+    return length;
+}
+
+/**
+ * @brief Constructor for the RecordingManager class.
+ *
+ * @param fs Filesystem holding the files, mounted by LogManager::begin().
+ * @param assets Web UI assets, served for the page and protected from deletion.
+ */
+RecordingManager::RecordingManager(fs::FS* fs, AssetCatalog* assets) : fs(fs), assets(assets), downloads(0) {}
+
+/**
+ * @brief Registers the page and the file routes.
+ *
+ * @param server The WiFiManager's web server.
+ */
+void RecordingManager::begin(AsyncWebServer& server) {
+    server.on("/recording", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        assets->send(request, "/recordingmanager.html");
+    });
+    server.on("/list_recorded_files", HTTP_GET, [this](AsyncWebServerRequest* request) { handleList(request); });
+    server.on("/download", HTTP_GET, [this](AsyncWebServerRequest* request) { handleDownload(request); });
+    server.on("/delete", HTTP_DELETE, [this](AsyncWebServerRequest* request) { handleDelete(request); });
+
+    if (DEBUGMODE) {
+        Serial.println("RecordingManager: file routes registered");
+    }
+}
+
+/**
+ * @brief Lists one page of files.
+ *
+ * The iterator is advanced past `offset` entries here; the page itself is
+ * read from it by fillListing() as the response goes out.
+ */
+void RecordingManager::handleList(AsyncWebServerRequest* request) {
+    uint32_t offset = 0;
+    uint32_t limit = FILES_PAGE_DEFAULT;
+    if (request->hasParam("offset")) {
+        offset = strtoul(request->getParam("offset")->value().c_str(), nullptr, 10);
+    }
+    if (request->hasParam("limit")) {
+        limit = strtoul(request->getParam("limit")->value().c_str(), nullptr, 10);
+    }
+    if (limit == 0 || limit > FILES_PAGE_MAX) {
+        limit = FILES_PAGE_MAX;
+    }
+    if (offset > 0xFFFF) {
+        offset = 0xFFFF;
+    }
+
+    Listing listing;
+    listing.dir = fs->open("/");
+    if (!listing.dir || !listing.dir.isDirectory()) {
+        request->send(500, "text/plain", "Filesystem not mounted");
+        return;
+    }
+    for (uint32_t skipped = 0; skipped < offset; skipped++) {
+        File entry = listing.dir.openNextFile();
+        if (!entry) break;
+    }
+    listing.offset = (uint16_t)offset;
+    listing.limit = (uint16_t)limit;
+    listing.sent = 0;
+    listing.more = false;
+    listing.phase = LISTING_HEAD;
+
+    AsyncWebServerResponse* response = request->beginChunkedResponse(
+        "application/json",
+        [this, listing](uint8_t* buffer, size_t maxLen, size_t index) mutable {
+            return fillListing(listing, buffer, maxLen);
+        });
+    response->addHeader("Cache-Control", "no-store");
+    request->send(response);
+}
+
+/**
+ * @brief Listing filler: writes the whole items (head, entries, tail) that fit.
+ *
+ * @return Bytes written, 0 once the listing is complete.
+ */
+size_t RecordingManager::fillListing(Listing& listing, uint8_t* buffer, size_t maxLen) {
+    char item[FILES_ENTRY_SIZE];
+    size_t length = 0;
+    while (listing.phase != LISTING_DONE) {
+        int itemLength = 0;
+        if (listing.phase == LISTING_HEAD) {
+            itemLength = snprintf(item, sizeof(item), "{\"offset\":%u,\"files\":[", (unsigned)listing.offset);
+        } else if (listing.phase == LISTING_ENTRIES) {
+            if (!listing.pending) {
+                if (listing.sent < listing.limit) {
+                    listing.pending = listing.dir.openNextFile();
+                } else {
+                    // Page full: only check whether another one follows
+                    File next = listing.dir.openNextFile();
+                    listing.more = (bool)next;
+                }
+                if (!listing.pending) {
+                    listing.dir.close();
+                    listing.phase = LISTING_TAIL;
+                    continue;
+                }
+            }
+            char name[ASSET_PATH_MAX * 2 + 1];
+            jsonEscape(listing.pending.path(), name, sizeof(name));
+            itemLength = snprintf(item, sizeof(item), "%s{\"name\":\"%s\",\"size\":%u,\"mtime\":%lu}",
+                                  listing.sent > 0 ? "," : "", name, (unsigned)listing.pending.size(),
+                                  (unsigned long)listing.pending.getLastWrite());
+        } else {
+            if (listing.more) {
+                itemLength = snprintf(item, sizeof(item), "],\"next\":%u}", (unsigned)(listing.offset + listing.sent));
+            } else {
+                itemLength = snprintf(item, sizeof(item), "],\"next\":null}");
+            }
+        }
+        if (itemLength < 0 || (size_t)itemLength >= sizeof(item)) {
+            itemLength = 0;  // Cannot happen with paths of ASSET_PATH_MAX characters
+        }
+        if (length + itemLength > maxLen) {
+            break;
+        }
+        memcpy(buffer + length, item, itemLength);
+        length += itemLength;
+
+        if (listing.phase == LISTING_HEAD) {
+            listing.phase = LISTING_ENTRIES;
+        } else if (listing.phase == LISTING_ENTRIES) {
+            listing.pending.close();
+            listing.pending = File();
+            listing.sent++;
+        } else {
+            listing.phase = LISTING_DONE;
+        }
+    }
+    if (length == 0 && listing.phase != LISTING_DONE) {
+        return RESPONSE_TRY_AGAIN;  // Not even one entry fits the send window yet
+    }
+    return length;
+}
+
+/**
+ * @brief Sends a file as an attachment.
+ *
+ * The file stays open in the response filler, which reads it directly into
+ * the server's send buffer; it is closed when the response is destroyed.
+ */
+void RecordingManager::handleDownload(AsyncWebServerRequest* request) {
+    char path[ASSET_PATH_MAX + 1];
+    if (!getPathParam(request, path, sizeof(path))) {
+        request->send(400, "text/plain", "Invalid file parameter");
+        return;
+    }
+    if (downloads >= FILES_MAX_DOWNLOADS) {
+        AsyncWebServerResponse* response = request->beginResponse(503, "text/plain", "Too many downloads");
+        response->addHeader("Retry-After", "5");
+        request->send(response);
+        return;
+    }
+
+    File file = fs->open(path, FILE_READ);
+    if (!file || file.isDirectory()) {
+        request->send(404, "text/plain", "File not found");
+        return;
+    }
+
+    AsyncWebServerResponse* response = request->beginResponse(
+        "application/octet-stream", file.size(),
+        [file](uint8_t* buffer, size_t maxLen, size_t index) mutable { return file.read(buffer, maxLen); });
+    const char* name = strrchr(path, '/') + 1;
+    char disposition[ASSET_PATH_MAX + 32];
+    snprintf(disposition, sizeof(disposition), "attachment; filename=\"%s\"", name);
+    response->addHeader("Content-Disposition", disposition);
+    response->addHeader("Cache-Control", "no-store");
+    downloads++;
+    request->onDisconnect([this]() { downloads--; });
+    request->send(response);
+}
+
+void RecordingManager::handleDelete(AsyncWebServerRequest* request) {
+    char path[ASSET_PATH_MAX + 1];
+    if (!getPathParam(request, path, sizeof(path))) {
+        request->send(400, "text/plain", "Invalid file parameter");
+        return;
+    }
+    if (isProtected(path)) {
+        request->send(403, "text/plain", "File is in use by the device");
+        return;
+    }
+    if (!fs->exists(path)) {
+        request->send(404, "text/plain", "File not found");
+        return;
+    }
+    if (!fs->remove(path)) {
+        request->send(500, "text/plain", "Delete failed");
+        return;
+    }
+
+    if (DEBUGMODE) {
+        Serial.print("RecordingManager: deleted ");
+        Serial.println(path);
+    }
+    request->send(200, "text/plain", "Deleted");
+}
+
+/**
+ * @brief Reads the `file` parameter as an absolute SPIFFS path.
+ *
+ * A leading '/' is added when missing; paths longer than the SPIFFS limit
+ * or containing ".." are refused.
+ *
+ * @return false if the parameter is missing or invalid.
+ */
+bool RecordingManager::getPathParam(AsyncWebServerRequest* request, char* path, size_t size) {
+    if (!request->hasParam("file")) {
+        return false;
+    }
+    const String& value = request->getParam("file")->value();
+    if (value.length() == 0 || strstr(value.c_str(), "..") != nullptr) {
+        return false;
+    }
+    int length = snprintf(path, size, "%s%s", value[0] == '/' ? "" : "/", value.c_str());
+    return length > 1 && (size_t)length < size;
+}
+
+/**
+ * @brief true for files the device needs: web UI assets (and their .gz),
+ * the asset index and the active log file.
+ */
+bool RecordingManager::isProtected(const char* path) const {
+    if (strcmp(path, ASSET_INDEX_PATH) == 0 || strcmp(path, LOGFILE_PATH) == 0) {
+        return true;
+    }
+    if (assets->find(path) != nullptr) {
+        return true;
+    }
+    size_t length = strlen(path);
+    if (length > 3 && strcmp(path + length - 3, ".gz") == 0) {
+        char plain[ASSET_PATH_MAX + 1];
+        memcpy(plain, path, length - 3);
+        plain[length - 3] = '\0';
+        const AssetEntry* entry = assets->find(plain);
+        return entry != nullptr && entry->gzipped;
+    }
+    return false;
+}
@@ -0,0 +1,67 @@
+#ifndef RECORDINGMANAGER_H
+#define RECORDINGMANAGER_H
+/**
+ * @file RecordingManager.h
+ * @brief File routes behind data/recordingmanager.html: list, download and delete SPIFFS files.
+ *
+ * Routes registered on the WiFiManager's AsyncWebServer:
+ * - `GET /recording`            : the page itself, through the AssetCatalog.
+ * - `GET /list_recorded_files`  : `{"offset":0,"files":[{"name","size","mtime"}],"next":20}`,
+ *                                 `?offset=&limit=` select the page, `next` is null on the last one.
+ * - `GET /download?file=<path>` : the file as an attachment.
+ * - `DELETE /delete?file=<path>`: removes the file.
+ *
+ * Nothing is buffered whole. The listing walks the directory iterator while
+ * the response is being sent, formatting one entry at a time into the send
+ * buffer; a download reads the file straight into the buffer the server is
+ * about to hand to TCP, so a log segment of several hundred kB costs no more
+ * RAM than a small one. At most `FILES_MAX_DOWNLOADS` downloads run at once,
+ * each holding a SPIFFS file descriptor.
+ *
+ * The web UI assets, their index and the active log file cannot be deleted.
+ */
+
+#include <Arduino.h>
+#include <FS.h>
+#include <ESPAsyncWebServer.h>
+#include "Config.h"
+#include "AssetCatalog.h"
+
+class RecordingManager {
+public:
+    RecordingManager(fs::FS* fs, AssetCatalog* assets);
+
+    void begin(AsyncWebServer& server);   ///< Register the file routes
+
+private:
+    enum ListingPhase : uint8_t {
+        LISTING_HEAD,
+        LISTING_ENTRIES,
+        LISTING_TAIL,
+        LISTING_DONE
+    };
+
+    /// State of one listing response, kept in its filler between calls
+    struct Listing {
+        File dir;
+        File pending;           ///< Entry taken from the iterator but not sent yet
+        uint16_t offset;
+        uint16_t limit;
+        uint16_t sent;
+        bool more;              ///< Another entry follows the page
+        ListingPhase phase;
+    };
+
+    void handleList(AsyncWebServerRequest* request);
+    void handleDownload(AsyncWebServerRequest* request);
+    void handleDelete(AsyncWebServerRequest* request);
+    size_t fillListing(Listing& listing, uint8_t* buffer, size_t maxLen);
+    bool getPathParam(AsyncWebServerRequest* request, char* path, size_t size);
+    bool isProtected(const char* path) const;
+
+    fs::FS* fs;
+    AssetCatalog* assets;
+    uint8_t downloads;          ///< Downloads in progress, only touched on the web server task
+};
+
+#endif // RECORDINGMANAGER_H
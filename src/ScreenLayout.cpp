@@ -0,0 +1,130 @@
+#include "ScreenLayout.h"
+#include "TraceBuffer.h"
+
+/**
+ * @brief Constructor for the LayoutRenderer class.
+ *
+ * @param lcd Frame buffer the layouts are drawn into.
+ * @param marquee Scroller used by the scroll fields.
+ */
+LayoutRenderer::LayoutRenderer(LcdFrameBuffer* lcd, Marquee* marquee)
+    : lcd(lcd), marquee(marquee), layout{nullptr, 0} {
+    memset(scrollRegions, -1, sizeof(scrollRegions));
+}
+
+/**
+ * @brief Makes a layout current: blanks the frame, stops the scroll regions
+ * and draws the static texts. Fields stay blank until they are set.
+ */
+void LayoutRenderer::show(const ScreenLayout& newLayout) {
+    TRACE_SCOPE("lcd.layout");
+    layout = newLayout;
+    memset(scrollRegions, -1, sizeof(scrollRegions));
+    marquee->clear();
+    lcd->clear();
+
+    for (uint8_t i = 0; i < layout.count; i++) {
+        const LayoutItem& item = layout.items[i];
+        if (item.kind == LAYOUT_TEXT) {
+            lcd->setCursor(item.col, item.row);
+            lcd->print(msg(item.text));
+        }
+    }
+}
+
+/**
+ * @brief Draws a field of the current layout, unless it already shows this text.
+ *
+ * The text is aligned in the field and clipped to its width; a scroll field
+ * hands it to the marquee instead.
+ *
+ * @param field Field id.
+ * @param value Text to show.
+ * @return true if the field changed, false if unchanged or not in the layout.
+ */
+bool LayoutRenderer::setField(LayoutField field, const char* value) {
+    const LayoutItem* item = find(field);
+    if (item == nullptr) return false;
+    if (value == nullptr) value = "";
+
+    if (item->kind == LAYOUT_SCROLL) {
+        int8_t& region = scrollRegions[field];
+        if (region >= 0 && strcmp(marquee->getText(region), value) == 0) {
+            return false;
+        }
+        if (region >= 0) {
+            marquee->setText(region, value);
+        } else {
+            region = marquee->add(item->col, item->row, item->width, value);
+        }
+        return true;
+    }
+
+    char cells[LCD_COLUMNS];
+    memset(cells, ' ', item->width);
+    size_t length = strlen(value);
+    if (length > item->width) {
+        length = item->width;
+    }
+    uint8_t start = 0;
+    if (item->align == ALIGN_RIGHT) {
+        start = item->width - length;
+    } else if (item->align == ALIGN_CENTER) {
+        start = (item->width - length) / 2;
+    }
+    memcpy(cells + start, value, length);
+
+    bool changed = false;
+    for (uint8_t i = 0; i < item->width && !changed; i++) {
+        changed = lcd->getChar(item->col + i, item->row) != cells[i];
+    }
+    if (!changed) return false;
+
+    lcd->setCursor(item->col, item->row);
+    lcd->write((const uint8_t*)cells, item->width);
+    return true;
+}
+
+/**
+ * @brief Draws a number field through the format of its layout item
+ * (a MSG_FMT_* message), or as a plain number.
+ */
+bool LayoutRenderer::setField(LayoutField field, uint32_t value) {
+    const LayoutItem* item = find(field);
+    if (item == nullptr) return false;
+
+    char text[LCD_COLUMNS + 1];
+    snprintf(text, sizeof(text), item->text < MSG_COUNT ? msg(item->text) : "%lu", (unsigned long)value);
+    return setField(field, text);
+}
+
+/**
+ * @brief Blanks a field and moves the frame cursor to its first cell, for
+ * content drawn by the caller (glyphs).
+ *
+ * @return false if the field is not in the current layout.
+ */
+bool LayoutRenderer::moveTo(LayoutField field) {
+    const LayoutItem* item = find(field);
+    if (item == nullptr) return false;
+
+    lcd->setCursor(item->col, item->row);
+    for (uint8_t i = 0; i < item->width; i++) {
+        lcd->write(' ');
+    }
+    lcd->setCursor(item->col, item->row);
+    return true;
+}
+
+bool LayoutRenderer::hasField(LayoutField field) const {
+    return find(field) != nullptr;
+}
+
+const LayoutItem* LayoutRenderer::find(LayoutField field) const {
+    for (uint8_t i = 0; i < layout.count; i++) {
+        if (layout.items[i].kind != LAYOUT_TEXT && layout.items[i].field == field) {
+            return &layout.items[i];
+        }
+    }
+    return nullptr;
+}
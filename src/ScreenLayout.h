@@ -0,0 +1,131 @@
+#ifndef SCREENLAYOUT_H
+#define SCREENLAYOUT_H
+/**
+ * @file ScreenLayout.h
+ * @brief Declarative screen layouts and the engine drawing them into the frame buffer.
+ *
+ * A layout is a constexpr table of items placed on the 20x4 grid:
+ * - `layoutText()`   : static catalog text, drawn when the layout is shown;
+ * - `layoutField()`  : a slot of fixed width filled at runtime by field id,
+ *                      left/right/center aligned, optionally through a
+ *                      `MSG_FMT_*` format for numbers;
+ * - `layoutScroll()` : a field that scrolls through the Marquee when its
+ *                      text is wider than the slot.
+ *
+ * `LayoutRenderer::show()` blanks the frame and draws the static items once.
+ * Screens then only call `setField()`; a field whose text did not change is
+ * not touched, so a refresh redraws nothing but the values that moved.
+ * `checkLayout()` validates a table at compile time (items on screen, fields
+ * set).
+ */
+
+#include <Arduino.h>
+#include "Config.h"
+#include "LcdFrameBuffer.h"
+#include "Marquee.h"
+#include "Messages.h"
+
+enum LayoutItemKind : uint8_t {
+    LAYOUT_TEXT,     ///< Static message
+    LAYOUT_FIELD,    ///< Value set at runtime, clipped to its width
+    LAYOUT_SCROLL    ///< Value set at runtime, scrolled when wider than the slot
+};
+
+enum LayoutAlign : uint8_t {
+    ALIGN_LEFT,
+    ALIGN_RIGHT,
+    ALIGN_CENTER
+};
+
+/**
+ * @brief Ids of the dynamic fields. A screen only uses the ones its layout places.
+ */
+enum LayoutField : uint8_t {
+    FIELD_NONE,
+    FIELD_TIME,              ///< Current time, filled by ScreenManager::showLayout()
+    FIELD_WIFI,              ///< Wi-Fi signal glyphs, filled by ScreenManager::showLayout()
+    FIELD_ICONS,             ///< Custom glyphs drawn by the screen
+    FIELD_TITLE,
+    FIELD_LINE_1,
+    FIELD_LINE_2,
+    FIELD_LINE_3,
+    FIELD_MANAGER,
+    FIELD_DATE,
+    FIELD_DEVICE_BALANCE,
+    FIELD_CARD_BALANCE,
+    FIELD_LAST_COMM,
+    FIELD_OPTIONS,
+    FIELD_NUMBER_1,
+    FIELD_NUMBER_2,
+    FIELD_NUMBER_3,
+    FIELD_NUMBER_4,
+    FIELD_AP_ADDRESS,
+    FIELD_INPUT,
+    FIELD_HINT,              ///< Reference value under a prompt
+    FIELD_COUNT
+};
+
+struct LayoutItem {
+    LayoutItemKind kind;
+    uint8_t col;
+    uint8_t row;
+    uint8_t width;           ///< Cells owned by the item, 0 for a text item (its own length)
+    MessageId text;          ///< Text item: the message. Field: format, MSG_COUNT for none
+    LayoutField field;
+    LayoutAlign align;
+};
+
+struct ScreenLayout {
+    const LayoutItem* items;
+    uint8_t count;
+};
+
+constexpr LayoutItem layoutText(uint8_t col, uint8_t row, MessageId text) {
+    return LayoutItem{LAYOUT_TEXT, col, row, 0, text, FIELD_NONE, ALIGN_LEFT};
+}
+
+constexpr LayoutItem layoutField(LayoutField field, uint8_t col, uint8_t row, uint8_t width,
+                                 LayoutAlign align = ALIGN_LEFT, MessageId format = MSG_COUNT) {
+    return LayoutItem{LAYOUT_FIELD, col, row, width, format, field, align};
+}
+
+constexpr LayoutItem layoutScroll(LayoutField field, uint8_t col, uint8_t row, uint8_t width) {
+    return LayoutItem{LAYOUT_SCROLL, col, row, width, MSG_COUNT, field, ALIGN_LEFT};
+}
+
+/// Page title with the time in the top-right corner
+#define LAYOUT_HEADER(title) layoutText(0, 0, title), layoutField(FIELD_TIME, 15, 0, 5)
+
+#define LAYOUT_ITEM_COUNT(items) (sizeof(items) / sizeof((items)[0]))
+#define LAYOUT_OF(items) ScreenLayout{items, (uint8_t)LAYOUT_ITEM_COUNT(items)}
+
+/**
+ * @brief true if every item is on screen and every field has a width and an id.
+ */
+constexpr bool checkLayout(const LayoutItem* items, size_t count) {
+    return count == 0 ||
+           (items[0].row < LCD_ROWS && items[0].col + items[0].width <= LCD_COLUMNS &&
+            (items[0].kind == LAYOUT_TEXT || (items[0].width > 0 && items[0].field != FIELD_NONE)) &&
+            checkLayout(items + 1, count - 1));
+}
+
+class LayoutRenderer {
+public:
+    LayoutRenderer(LcdFrameBuffer* lcd, Marquee* marquee);
+
+    void show(const ScreenLayout& layout);                 ///< Blank the frame and draw the static items
+    bool setField(LayoutField field, const char* value);  ///< Draw a field if its text changed
+    bool setField(LayoutField field, uint32_t value);     ///< Same, through the item's number format
+    bool moveTo(LayoutField field);                        ///< Blank a field and put the cursor on it, for custom drawing
+    bool hasField(LayoutField field) const;
+
+private:
+    const LayoutItem* find(LayoutField field) const;
+
+    LcdFrameBuffer* lcd;
+    Marquee* marquee;
+    ScreenLayout layout;
+    int8_t scrollRegions[FIELD_COUNT];   ///< Marquee region of each scroll field, -1 before the first value
+};
+
+#endif // SCREENLAYOUT_H
@@ -1,56 +1,144 @@
 #ifndef SCREENMANAGER_H
 #define SCREENMANAGER_H
+/**
+ * @file ScreenManager.h
+ * @brief Event loop, screen stack and drawing helpers of the LCD + keypad UI.
+ *
+ * Keypad, card, network and timer inputs are turned into UiEvent values and
+ * queued; key events come from the KeypadScanner timer and card events from
+ * the CardPoller's RFID task. `poll()` runs one iteration of the loop on the
+ * UI task: it samples the Wi-Fi state, waits up to `UI_POLL_INTERVAL_MS` for
+ * events, dispatches them to the screen on top of the stack, fires due
+ * timers, advances the marquee regions and flushes the frame buffer. Other
+ * tasks can feed the same queue with `post()`.
+ *
+ * Screens are statically allocated members; navigation only moves pointers on
+ * a fixed-depth stack. The device locks after `LockTimeout` without a key press
+ * or card tap, and shows the access point page instead of the security check
+ * while the setup access point is up.
+ */
 
-
-#include <KeyPad.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
 #include "WiFiManager.h"
 #include "LogManager.h"
 #include "MRC522Manager.h"
 #include "SPI.h"
-#include <LiquidCrystal_I2C.h>
+#include "LcdFrameBuffer.h"
+#include "Marquee.h"
+#include "GlyphManager.h"
+#include "ScreenLayout.h"
 #include "BuzzerManager.h"
+#include "EventBus.h"
+#include "CardPoller.h"
+#include "TaskTopology.h"
+#include "UiEvent.h"
+#include "UiScreens.h"
 
 
 class ScreenManager {
 public:
     // Constructor
-    ScreenManager(WiFiManager* wiFiManager,LogManager* Log,MRC522Manager* mRC522Manager , LiquidCrystal_I2C* LCD,BuzzerManager* Buzz);
+    ScreenManager(ConfigManager* Config, WiFiManager* wiFiManager, LogManager* Log, MRC522Manager* mRC522Manager,
+                  LcdFrameBuffer* LCD, BuzzerManager* Buzz);
 
     // Initialization function
     void begin();
 
+    // Event loop
+    void poll(uint32_t waitMs = UI_POLL_INTERVAL_MS); // Sample inputs, dispatch queued events and timers, flush the LCD
+    bool post(const UiEvent& event);                  // Queue an event from any task
+    bool postFromISR(const UiEvent& event, BaseType_t* higherPriorityTaskWoken); // Queue an event from an ISR
+    void dispatch(const UiEvent& event);              // Deliver one event to the top screen
+    QueueHandle_t getEventQueue() const;              // Queue fed by the input drivers
+
+    // Navigation
+    void push(UiScreen* screen);                      // Show a screen on top of the current one
+    void pop();                                       // Return to the screen below
+    void replace(UiScreen* screen);                   // Swap the top screen
+    void resetTo(UiScreen* screen);                   // Drop the whole stack and show a screen
+    void finish(bool accepted, const char* value = ""); // Pop and hand a result to the screen below
+    void lock(bool timedOut);                         // Return to the security check
+    void unlock();                                    // Master card accepted, go to the home page
+    void showApPage();                                // Access point setup page
+    UiScreen* getTopScreen() const;
+    uint8_t getDepth() const;
+    bool isLocked() const;
+
+    // Timers
+    void startScreenTimer(uint32_t ms, bool repeat = false); // Timer of the top screen, stopped on navigation
+    void stopScreenTimer();
+
     // Screen control functions
     void clearScreen(); // Clear the screen with a specified color
+    void show(); // Push the drawn frame to the LCD
     void displayText(const char* text, int x, int y); // Display text at specified coordinates
     void displayCenteredText(const char* text,int y); // Display centered text horizontally
-    
-    // New functions for success and failure messages
-    void displaySuccessMessage(const char* message, int blinkCount, int row);
-    void displayFailureMessage(const char* message, int blinkCount, int row);
+    void showLayout(const ScreenLayout& layout); // Draw a layout, filling its time and Wi-Fi fields
+    void updateCommonFields();                   // Refresh the time and Wi-Fi fields of the current layout
     void eraseCharacter(int x, int y);
-
-    String ShowPrompt(const char* Text,const char* Num);// return the String of what have been type in the porompt
-    bool confirmInput(const char* Text);// confirm the user input
-    bool confirmRecharge(uint16_t amount);// confrm user input recharg
     void displayWiFiSignal();
-    void LockCardPage() ;
-    void HomePage(const char* nameTop);
-    void RechargePage();
-    void MasterMode();
-    void UserMode();
-    void SecurityCheck();
-    void GotoApPage();
-    char SelectAction();
-    String GetLastRechergAmount();
-    char Kharacter = NO_KEY;
-    void scrollTextOnLine(String text, int startX, int stopX, int line);
+    void setLastRechargeAmount(uint32_t amount);
+    uint32_t getLastRechargeAmount() const;
+
+    // Services used by the screens
+    LcdFrameBuffer* getLcd() const { return LCD; }
+    Marquee& getMarquee() { return marquee; }
+    GlyphManager& getGlyphs() { return glyphs; }
+    LayoutRenderer& getLayout() { return layout; }
+    MRC522Manager* getRfid() const { return mRC522Manager; }
+    LogManager* getLog() const { return Log; }
+    BuzzerManager* getBuzzer() const { return Buzz; }
+    ConfigManager* getConfig() const { return Config; }
+    WiFiManager* getWiFi() const { return wiFiManager; }
+    CardPoller& getCardPoller() { return cardPoller; }
+
+    // Screens
+    LockScreen lockScreen;
+    HomeScreen homeScreen;
+    SelectActionScreen selectActionScreen;
+    RechargeScreen rechargeScreen;
+    UserModeScreen userModeScreen;
+    LockCardScreen lockCardScreen;
+    ApScreen apScreen;
+    PromptScreen promptScreen;
+    ConfirmScreen confirmScreen;
+    MessageScreen messageScreen;
+
 private:
-    LiquidCrystal_I2C* LCD; // LCD instance
+    struct UiTimer {
+        uint32_t deadline;       ///< millis() at which the timer fires
+        uint32_t period;         ///< Reload period, 0 for one-shot
+        bool active;
+    };
+
+    void enterTop();
+    void navigated();
+    void pollInputs(uint32_t now);
+    void pollTimers(uint32_t now);
+    UiCardMode getTopCardMode() const;
+    void startTimer(UiTimerId id, uint32_t ms, bool repeat);
+
+    ConfigManager* Config;
+    LcdFrameBuffer* LCD; // Frame buffer drawn into, flushed to the LCD by show()
+    Marquee marquee;     // Scrolling regions of the top screen
+    GlyphManager glyphs; // Custom characters in the LCD's CGRAM
+    LayoutRenderer layout; // Draws the screens' layout tables
     WiFiManager* wiFiManager;
     LogManager* Log;
     MRC522Manager* mRC522Manager;
     BuzzerManager* Buzz;
-    uint16_t LastAmount;
+    CardPoller cardPoller; // Polls the reader for the top screen, on the RFID task once started
+    uint32_t LastAmount;
+
+    QueueHandle_t events;                           ///< Pending input events
+    UiScreen* stack[UI_SCREEN_STACK_DEPTH];
+    uint8_t depth;
+    uint32_t navigationCount;                       ///< Bumped on every stack change
+    UiTimer timers[UI_TIMER_COUNT];
+    bool locked;
+    bool wifiConnected;
+    bool apActive;                                  ///< Last sampled WiFiManager::isApActive()
 };
 
 #endif // SCREENMANAGER_H
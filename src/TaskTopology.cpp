@@ -0,0 +1,143 @@
+#include "TaskTopology.h"
+
+/// One entry per TaskId, in the same order
+static const TaskSpec TASK_SPECS[] = {
+    {"ui", UI_TASK_STACK_SIZE, UI_TASK_PRIORITY, UI_TASK_CORE},
+    {"rfid", RFID_TASK_STACK_SIZE, RFID_TASK_PRIORITY, RFID_TASK_CORE},
+    {"log", LOG_TASK_STACK_SIZE, LOG_TASK_PRIORITY, LOG_TASK_CORE},
+    {"lcd", LCD_TASK_STACK_SIZE, LCD_TASK_PRIORITY, LCD_TASK_CORE},
+    {"live", LIVE_TASK_STACK_SIZE, LIVE_TASK_PRIORITY, LIVE_TASK_CORE},
+    {"gpio", GPIO_TASK_STACK_SIZE, GPIO_TASK_PRIORITY, GPIO_TASK_CORE},
+    {"net", NET_TASK_STACK_SIZE, NET_TASK_PRIORITY, NET_TASK_CORE},
+};
+static_assert(sizeof(TASK_SPECS) / sizeof(TASK_SPECS[0]) == TASK_COUNT, "One TaskSpec per TaskId");
+
+TaskTopology Tasks;
+
+TaskTopology::TaskTopology() : reportMs(0) {
+    for (uint8_t id = 0; id < TASK_COUNT; id++) {
+        handles[id] = nullptr;
+        busyMs[id].store(0, std::memory_order_relaxed);
+        pendingUs[id] = 0;
+        reportBusyMs[id] = 0;
+    }
+}
+
+/**
+ * @brief Creates a task with the name, stack, priority and core of its spec.
+ *
+ * @param id Task to create; a task is only started once.
+ * @param entry Task body.
+ * @param param Passed to entry.
+ * @param handle Optional copy of the handle, set before the call returns.
+ * @return false if the task could not be created.
+ */
+bool TaskTopology::start(TaskId id, TaskFunction_t entry, void* param, TaskHandle_t* handle) {
+    const TaskSpec& spec = TASK_SPECS[id];
+    if (handles[id] != nullptr) {
+        if (handle != nullptr) *handle = handles[id];
+        return true;
+    }
+
+    TaskHandle_t created = nullptr;
+    if (xTaskCreatePinnedToCore(entry, spec.name, spec.stackSize, param, spec.priority, &created, spec.core) !=
+        pdPASS) {
+        if (DEBUGMODE) {
+            Serial.printf("TaskTopology: failed to start %s\n", spec.name);
+        }
+        return false;
+    }
+    handles[id] = created;
+    if (handle != nullptr) *handle = created;
+    return true;
+}
+
+const TaskSpec& TaskTopology::getSpec(TaskId id) const {
+    return TASK_SPECS[id];
+}
+
+TaskHandle_t TaskTopology::getHandle(TaskId id) const {
+    return handles[id];
+}
+
+/**
+ * @brief Adds busy time to a task.
+ *
+ * Whole milliseconds go to the shared atomic counter, the remainder is kept
+ * until it adds up to one. Only the task itself calls this, so the remainder
+ * needs no lock.
+ */
+void TaskTopology::addBusyTime(TaskId id, uint32_t us) {
+    uint32_t pending = pendingUs[id] + us;
+    if (pending >= 1000) {
+        busyMs[id].fetch_add(pending / 1000, std::memory_order_relaxed);
+        pending %= 1000;
+    }
+    pendingUs[id] = pending;
+}
+
+/**
+ * @brief Prints, for every task, its share of its core since the previous
+ * report (or since boot) and its lowest free stack.
+ *
+ * With FreeRTOS run-time stats enabled, the scheduler's own figures for
+ * every task in the system follow.
+ */
+void TaskTopology::printReport(Print& out) {
+    uint32_t now = millis();
+    uint32_t elapsedMs = now - reportMs;
+    reportMs = now;
+
+    out.printf("Tasks: CPU over the last %lu ms\n", (unsigned long)elapsedMs);
+    out.println("  task  core prio   cpu%  stack free");
+    uint32_t coreMs[2] = {0, 0};
+    for (uint8_t id = 0; id < TASK_COUNT; id++) {
+        const TaskSpec& spec = TASK_SPECS[id];
+        uint32_t busy = getBusyMs((TaskId)id);
+        uint32_t deltaMs = busy - reportBusyMs[id];
+        reportBusyMs[id] = busy;
+        if (spec.core >= 0 && spec.core < 2) {
+            coreMs[spec.core] += deltaMs;
+        }
+
+        if (handles[id] == nullptr) {
+            out.printf("  %-5s %4ld %4u      -  not running\n", spec.name, (long)spec.core, (unsigned)spec.priority);
+            continue;
+        }
+        // ESP-IDF counts stacks in bytes
+        out.printf("  %-5s %4ld %4u %5.1f%%  %10u\n", spec.name, (long)spec.core, (unsigned)spec.priority,
+                   elapsedMs > 0 ? deltaMs * 100.0 / elapsedMs : 0.0,
+                   (unsigned)uxTaskGetStackHighWaterMark(handles[id]));
+    }
+    for (uint8_t core = 0; core < 2; core++) {
+        out.printf("  core %u: %.1f%% in the tasks above\n", core,
+                   elapsedMs > 0 ? coreMs[core] * 100.0 / elapsedMs : 0.0);
+    }
+
+#if configGENERATE_RUN_TIME_STATS
+    static TaskStatus_t status[24];
+    uint32_t totalRunTime = 0;
+    UBaseType_t count = uxTaskGetSystemState(status, sizeof(status) / sizeof(status[0]), &totalRunTime);
+    if (count > 0 && totalRunTime > 0) {
+        out.println("  scheduler run time since boot:");
+        for (UBaseType_t i = 0; i < count; i++) {
+            out.printf("  %-16s %5.1f%%\n", status[i].pcTaskName,
+                       status[i].ulRunTimeCounter * 100.0 / totalRunTime);
+        }
+    }
+#endif
+}
+
+/**
+ * @brief Serial console command handler.
+ *
+ * @param command Character read from the console.
+ * @return true if the command was handled here.
+ */
+bool TaskTopology::handleCommand(int command) {
+    if (command != 'U') {
+        return false;
+    }
+    printReport(Serial);
+    return true;
+}
@@ -0,0 +1,100 @@
+#ifndef TASKTOPOLOGY_H
+#define TASKTOPOLOGY_H
+/**
+ * @file TaskTopology.h
+ * @brief The application's FreeRTOS tasks: names, cores, priorities, stacks and CPU usage.
+ *
+ * | Task | Core | Role                                                  | Fed by                         |
+ * |------|------|-------------------------------------------------------|--------------------------------|
+ * | ui   | 1    | ScreenManager event loop                              | UI event queue                 |
+ * | rfid | 1    | Card tap / presence polling (CardPoller)              | task notification on navigation|
+ * | log  | 0    | Appends log entries to SPIFFS (LogManager)            | log job queue                  |
+ * | lcd  | 0    | Sends changed cells to the I2C LCD (LcdFrameBuffer)   | frame mailbox                  |
+ * | live | 0    | Formats SSE/WebSocket events into a ring (LiveStream) | task notification              |
+ * | gpio | 0    | Debounces the GPIO inputs, sends SSE (GpioManager)    | notification: ISR, POST, client|
+ * | net  | 0    | Wi-Fi attempts, timeouts and AP fallback (WiFiManager)| notification from its timer    |
+ *
+ * The stack, priority and core of each task are the `*_TASK_*` constants of
+ * the Task Topology section of Config.h; tasks are created with start(),
+ * never with xTaskCreate directly.
+ *
+ * CPU usage is measured per task by wrapping each unit of work, after the
+ * task returns from its blocking wait, in a TaskWork scope:
+ * @code
+ *   xQueueReceive(queue, &job, portMAX_DELAY);
+ *   TaskWork work(TASK_LOG);
+ *   write(job);
+ * @endcode
+ * The busy time is a relaxed atomic per task, so it costs two
+ * esp_timer_get_time() calls and one atomic add per unit of work. `U` on the
+ * serial console prints each task's share of a core since the previous
+ * report with its stack high-water mark; /metrics exports the busy time as a
+ * counter.
+ */
+
+#include <Arduino.h>
+#include <atomic>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "Config.h"
+
+enum TaskId : uint8_t {
+    TASK_UI,
+    TASK_RFID,
+    TASK_LOG,
+    TASK_LCD,
+    TASK_LIVE,
+    TASK_GPIO,
+    TASK_NET,
+    TASK_COUNT
+};
+
+struct TaskSpec {
+    const char* name;          ///< FreeRTOS task name
+    uint32_t stackSize;        ///< Bytes
+    UBaseType_t priority;
+    BaseType_t core;
+};
+
+class TaskTopology {
+public:
+    TaskTopology();
+
+    bool start(TaskId id, TaskFunction_t entry, void* param, TaskHandle_t* handle = nullptr);
+    const TaskSpec& getSpec(TaskId id) const;
+    TaskHandle_t getHandle(TaskId id) const;   ///< nullptr until started
+
+    void addBusyTime(TaskId id, uint32_t us);  ///< Only called by the task itself, see TaskWork
+    uint32_t getBusyMs(TaskId id) const { return busyMs[id].load(std::memory_order_relaxed); }
+
+    void printReport(Print& out);              ///< CPU share since the last report and free stack of every task
+    bool handleCommand(int command);           ///< 'U' prints the report; false for other commands
+
+private:
+    TaskHandle_t handles[TASK_COUNT];
+    std::atomic<uint32_t> busyMs[TASK_COUNT];
+    uint32_t pendingUs[TASK_COUNT];            ///< Busy time below 1 ms not yet added, owned by each task
+    uint32_t reportBusyMs[TASK_COUNT];         ///< busyMs at the last report
+    uint32_t reportMs;                         ///< millis() at the last report
+};
+
+extern TaskTopology Tasks;
+
+/**
+ * @brief Adds the lifetime of the scope to a task's busy time.
+ */
+class TaskWork {
+public:
+    explicit TaskWork(TaskId id) : id(id), startUs(esp_timer_get_time()) {}
+    ~TaskWork() { Tasks.addBusyTime(id, (uint32_t)(esp_timer_get_time() - startUs)); }
+
+private:
+    TaskWork(const TaskWork&);
+    TaskWork& operator=(const TaskWork&);
+
+    TaskId id;
+    int64_t startUs;
+};
+
+#endif // TASKTOPOLOGY_H
@@ -1,8 +1,8 @@
 #include "TimeManager.h"
 
 // Helper function to convert month number to text
-String TimeManager ::getMonthText(int month) {
-    const char* months[] = {"JAN", "FEB", "MAR", "APR", "MAY", "JUN", 
+const char* TimeManager::getMonthText(int month) {
+    static const char* const months[] = {"JAN", "FEB", "MAR", "APR", "MAY", "JUN", 
                             "JUL", "AUG", "SEP", "OCT", "NOV", "DEC"};
     return months[month - 1]; // month is 1-based
 }
@@ -17,16 +17,19 @@ TimeManager::TimeManager(const char* ntpServer, long timeOffset, unsigned long u
 
 /**
  * @brief Initializes the NTP client.
+ *
+ * Only opens the UDP socket; the first synchronization happens through
+ * updateTime() once Wi-Fi is connected, so boot never waits on NTP.
  */
 void TimeManager::initialize() {
     timeClient.begin();
-    timeClient.update();
 }
 
 /**
  * @brief Updates the NTP time by syncing with the server.
  */
 void TimeManager::updateTime() {
+    TRACE_SCOPE("ntp.update");
     if (WiFi.status() == WL_CONNECTED) {
         timeClient.update();
     }
@@ -35,9 +38,10 @@ void TimeManager::updateTime() {
 
 /**
  * @brief Gets the current time in "HH:MM" format.
- * @return String representing the current time.
+ * @return Text representing the current time.
  */
-String TimeManager::getTimeString() {
+ClockText TimeManager::getTimeString() {
+    TRACE_SCOPE("ntp.getTime");
     if (WiFi.status() == WL_CONNECTED) {
         timeClient.update(); // Sync time
 
@@ -53,16 +57,18 @@ String TimeManager::getTimeString() {
         int minutes = timeinfo->tm_min; // Minutes
 
         // Format time string
-        String timeStr = (hours < 10 ? "0" : "") + String(hours) + ":" + (minutes < 10 ? "0" : "") + String(minutes);
+        ClockText timeStr;
+        timeStr.format("%02d:%02d", hours, minutes);
         return timeStr;
     }
-    return "No WiFi";
+    return ClockText("No WiFi");
 }
 /**
  * @brief Gets the previous time (current time minus 1 minute) in "HH:MM" format.
- * @return String representing the time one minute before the current time.
+ * @return Text representing the time one minute before the current time.
  */
-String TimeManager::getPreviousMinuteTimeString() {
+ClockText TimeManager::getPreviousMinuteTimeString() {
+    TRACE_SCOPE("ntp.getPreviousTime");
     if (WiFi.status() == WL_CONNECTED) {
         timeClient.update(); // Sync time
 
@@ -84,16 +90,18 @@ String TimeManager::getPreviousMinuteTimeString() {
         int minutes = timeinfo->tm_min; // Minutes
 
         // Format the previous time string
-        String previousTimeStr = (hours < 10 ? "0" : "") + String(hours) + ":" + (minutes < 10 ? "0" : "") + String(minutes);
+        ClockText previousTimeStr;
+        previousTimeStr.format("%02d:%02d", hours, minutes);
         return previousTimeStr;
     }
-    return "No WiFi";
+    return ClockText("No WiFi");
 }
 /**
  * @brief Gets the current date in "DD MON YYYY" format.
- * @return String representing the current date.
+ * @return Text representing the current date.
  */
-String TimeManager::getDateString() {
+ClockText TimeManager::getDateString() {
+    TRACE_SCOPE("ntp.getDate");
     if (WiFi.status() == WL_CONNECTED) {
         timeClient.update(); // Sync time
 
@@ -110,16 +118,18 @@ String TimeManager::getDateString() {
         int year = timeinfo->tm_year + YEAROFFSET; // Year (years since 1900)
 
         // Format date string
-        String dateStr = String(day) + " " + getMonthText(month) + " " + String(year);
+        ClockText dateStr;
+        dateStr.format("%d %s %d", day, getMonthText(month), year);
         return dateStr;
     }
-    return "No WiFi";
+    return ClockText("No WiFi");
 }
 /**
  * @brief Gets the previous date (current date minus 1 day) in "DD MON YYYY" format.
- * @return String representing the date one day before the current date.
+ * @return Text representing the date one day before the current date.
  */
-String TimeManager::getPreviousDateString() {
+ClockText TimeManager::getPreviousDateString() {
+    TRACE_SCOPE("ntp.getPreviousDate");
     if (WiFi.status() == WL_CONNECTED) {
         timeClient.update(); // Sync time
 
@@ -142,8 +152,9 @@ String TimeManager::getPreviousDateString() {
         int year = timeinfo->tm_year + YEAROFFSET; // Year (years since 1900)
 
         // Format the previous date string
-        String previousDateStr = String(day) + " " + getMonthText(month) + " " + String(year);
+        ClockText previousDateStr;
+        previousDateStr.format("%d %s %d", day, getMonthText(month), year);
         return previousDateStr;
     }
-    return "No WiFi";
+    return ClockText("No WiFi");
 }
\ No newline at end of file
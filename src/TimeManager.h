@@ -5,18 +5,22 @@
 #include <WiFiUdp.h>
 #include <WiFi.h>
 #include "Config.h"
+#include "TraceBuffer.h"
+#include "FixedString.h"
+
+typedef FixedString<11> ClockText;   ///< "HH:MM", "DD MON YYYY" or "No WiFi"
 
 class TimeManager {
 public:
     TimeManager(const char* ntpServer = "pool.ntp.org", long timeOffset = TIMEOFFSET, unsigned long updateInterval = 60000);
     
     void initialize();          // Initialize NTP client
-    String getTimeString();     // Returns current time as "HH:MM"
-    String getPreviousMinuteTimeString();
-    String getDateString();     // Returns current date as "DD MON YYYY"
-    String getPreviousDateString();
+    ClockText getTimeString();  // Returns current time as "HH:MM"
+    ClockText getPreviousMinuteTimeString();
+    ClockText getDateString();  // Returns current date as "DD MON YYYY"
+    ClockText getPreviousDateString();
     void updateTime();          // Update NTP time
-    String getMonthText(int month);
+    const char* getMonthText(int month);
     
 
 private:
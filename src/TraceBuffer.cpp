@@ -0,0 +1,135 @@
+#include "TraceBuffer.h"
+
+TraceBuffer Trace;  ///< Global trace buffer used by TRACE_SCOPE / TRACE_INSTANT
+
+/**
+ * @brief Constructor for the TraceBuffer class.
+ */
+TraceBuffer::TraceBuffer() : head(0), count(0), dropped(0), paused(false) {
+    portMUX_INITIALIZE(&lock);
+}
+
+/**
+ * @brief Stores a complete event in the ring buffer.
+ *
+ * Overwrites the oldest event when the buffer is full. Safe to call from any
+ * task on either core; the critical section only covers the slot update.
+ *
+ * @param name Static event name.
+ * @param startUs esp_timer timestamp of the event start.
+ * @param durationUs Event duration in microseconds.
+ */
+void TraceBuffer::record(const char* name, int64_t startUs, uint32_t durationUs) {
+    if (paused) return;
+
+    uint32_t taskId = (uint32_t)(uintptr_t)xTaskGetCurrentTaskHandle();
+
+    portENTER_CRITICAL(&lock);
+    Event& event = events[head];
+    event.name = name;
+    event.startUs = startUs;
+    event.durationUs = durationUs;
+    event.taskId = taskId;
+    head = (head + 1) % TRACE_BUFFER_SIZE;
+    if (count < TRACE_BUFFER_SIZE) {
+        count++;
+    } else {
+        dropped++;
+    }
+    portEXIT_CRITICAL(&lock);
+}
+
+/**
+ * @brief Stores an instant (zero duration) event.
+ *
+ * @param name Static event name.
+ */
+void TraceBuffer::instant(const char* name) {
+    record(name, esp_timer_get_time(), INSTANT_EVENT);
+}
+
+/**
+ * @brief Drops every stored event.
+ */
+void TraceBuffer::clear() {
+    portENTER_CRITICAL(&lock);
+    head = 0;
+    count = 0;
+    dropped = 0;
+    portEXIT_CRITICAL(&lock);
+}
+
+size_t TraceBuffer::getCount() const {
+    return count;
+}
+
+uint32_t TraceBuffer::getDropped() const {
+    return dropped;
+}
+
+/**
+ * @brief Writes the stored events as Chrome trace-event JSON.
+ *
+ * Events are written oldest first, one per line, as complete ("X") or instant
+ * ("i") events. Recording is paused for the duration of the dump so slots are
+ * not overwritten while they are being printed.
+ *
+ * @param out Destination, e.g. Serial or an AsyncResponseStream.
+ * @return Number of events written.
+ */
+size_t TraceBuffer::dump(Print& out) {
+    paused = true;
+
+    portENTER_CRITICAL(&lock);
+    uint16_t total = count;
+    uint16_t first = (head + TRACE_BUFFER_SIZE - count) % TRACE_BUFFER_SIZE;
+    portEXIT_CRITICAL(&lock);
+
+    out.print("{\"displayTimeUnit\":\"ms\",\"otherData\":{\"dropped\":");
+    out.print(dropped);
+    out.print("},\"traceEvents\":[\n");
+
+    for (uint16_t i = 0; i < total; i++) {
+        const Event& event = events[(first + i) % TRACE_BUFFER_SIZE];
+        if (event.durationUs == INSTANT_EVENT) {
+            out.printf("{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%lld,\"pid\":1,\"tid\":%u}",
+                       event.name, (long long)event.startUs, event.taskId);
+        } else {
+            out.printf("{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%lld,\"dur\":%u,\"pid\":1,\"tid\":%u}",
+                       event.name, (long long)event.startUs, event.durationUs, event.taskId);
+        }
+        out.print(i + 1 < total ? ",\n" : "\n");
+    }
+    out.print("]}\n");
+
+    paused = false;
+    return total;
+}
+
+/**
+ * @brief Dumps the buffer on Serial when a 'T' command is received.
+ *
+ * Meant to be polled from the main loop; a 'C' command clears the buffer.
+ */
+void TraceBuffer::handleSerial() {
+    while (Serial.available() > 0) {
+        handleCommand(Serial.read());
+    }
+}
+
+/**
+ * @brief Handles one console command, for consoles shared with other modules.
+ *
+ * @param command Character read from the console.
+ * @return true if the command was handled here.
+ */
+bool TraceBuffer::handleCommand(int command) {
+    if (command == 'T') {
+        dump(Serial);
+    } else if (command == 'C') {
+        clear();
+    } else {
+        return false;
+    }
+    return true;
+}
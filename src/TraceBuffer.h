@@ -0,0 +1,88 @@
+#ifndef TRACEBUFFER_H
+#define TRACEBUFFER_H
+/**
+ * @file TraceBuffer.h
+ * @brief Lightweight timing instrumentation with a fixed RAM ring buffer.
+ *
+ * Code is instrumented with scoped markers:
+ * @code
+ *   void MRC522Manager::Recharge(...) {
+ *       TRACE_SCOPE("rfid.recharge");
+ *       ...
+ *   }
+ * @endcode
+ * The marker takes an `esp_timer_get_time()` timestamp when the scope opens and
+ * records one complete event (name, start, duration, task) when it closes. The
+ * buffer keeps the last `TRACE_BUFFER_SIZE` events and can be dumped as Chrome
+ * trace-event JSON (chrome://tracing, Perfetto) to any `Print` sink: Serial or
+ * an HTTP response stream.
+ *
+ * Event names must be string literals, only the pointer is stored.
+ * Set `TRACE_ENABLED` to 0 in Config.h to compile all markers out.
+ */
+
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include "Config.h"
+
+class TraceBuffer {
+public:
+    struct Event {
+        const char* name;        ///< Static event name
+        int64_t startUs;         ///< esp_timer timestamp at scope entry
+        uint32_t durationUs;     ///< Scope duration, INSTANT_EVENT for instant markers
+        uint32_t taskId;         ///< Recording task, used as the trace thread id
+    };
+
+    static const uint32_t INSTANT_EVENT = 0xFFFFFFFF;  ///< durationUs value of instant events
+
+    TraceBuffer();
+
+    void record(const char* name, int64_t startUs, uint32_t durationUs);  ///< Store a complete event
+    void instant(const char* name);                                        ///< Store a point-in-time event
+    void clear();                                                          ///< Drop every stored event
+    size_t getCount() const;                                               ///< Events currently stored
+    uint32_t getDropped() const;                                           ///< Events overwritten since clear()
+
+    size_t dump(Print& out);       ///< Write the buffer as Chrome trace-event JSON, returns events written
+    void handleSerial();           ///< Dump on Serial when a 'T' command is received
+    bool handleCommand(int command); ///< 'T' dumps, 'C' clears; false for other commands
+
+private:
+    Event events[TRACE_BUFFER_SIZE];
+    uint16_t head;                 ///< Next slot to write
+    uint16_t count;                ///< Number of valid slots
+    uint32_t dropped;              ///< Events overwritten by newer ones
+    volatile bool paused;          ///< Recording suspended while dumping
+    portMUX_TYPE lock;             ///< Protects head/count across tasks and cores
+};
+
+extern TraceBuffer Trace;
+
+/**
+ * @class TraceScope
+ * @brief RAII helper recording the lifetime of a scope into the trace buffer.
+ */
+class TraceScope {
+public:
+    explicit TraceScope(const char* name) : name(name), startUs(esp_timer_get_time()) {}
+    ~TraceScope() { Trace.record(name, startUs, (uint32_t)(esp_timer_get_time() - startUs)); }
+
+private:
+    const char* name;
+    int64_t startUs;
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+#if TRACE_ENABLED
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(traceScope_, __LINE__)(name)  ///< Time the enclosing scope
+#define TRACE_INSTANT(name) Trace.instant(name)                                   ///< Mark a point in time
+#else
+#define TRACE_SCOPE(name) do {} while (0)
+#define TRACE_INSTANT(name) do {} while (0)
+#endif
+
+#endif // TRACEBUFFER_H
@@ -0,0 +1,44 @@
+#ifndef UIEVENT_H
+#define UIEVENT_H
+/**
+ * @file UiEvent.h
+ * @brief Events consumed by the UI event loop.
+ *
+ * Every input reaches the screens as a small POD event posted into the
+ * ScreenManager queue, whichever task or source produced it.
+ */
+
+#include <stdint.h>
+
+enum UiEventType : uint8_t {
+    UI_EVENT_KEY,            ///< code: key character, key pressed
+    UI_EVENT_KEY_RELEASE,    ///< code: key character, key released
+    UI_EVENT_KEY_LONG,       ///< code: key character, key held for KEYPAD_LONG_PRESS_MS
+    UI_EVENT_CARD,           ///< code: MRC522Manager::IsMasterCard() status of a tapped card
+    UI_EVENT_CARD_REMOVED,   ///< The card of the current session left the reader
+    UI_EVENT_TIMER,          ///< code: UiTimerId
+    UI_EVENT_NETWORK         ///< code: 1 when Wi-Fi connected, 0 when it dropped
+};
+
+enum UiTimerId : uint8_t {
+    UI_TIMER_SCREEN,         ///< Timer owned by the top screen, stopped on navigation
+    UI_TIMER_LOCK,           ///< Inactivity timer locking the device
+    UI_TIMER_COUNT
+};
+
+/**
+ * @brief How the card reader is polled while a screen is on top.
+ */
+enum UiCardMode : uint8_t {
+    UI_CARD_NONE,       ///< Reader is left alone
+    UI_CARD_TAP,        ///< Poll for new cards, post UI_EVENT_CARD
+    UI_CARD_PRESENCE    ///< Check that the session card is still there, post UI_EVENT_CARD_REMOVED
+};
+
+struct UiEvent {
+    UiEventType type;
+    uint8_t code;            ///< Meaning depends on type
+    uint32_t timeMs;         ///< millis() when the event was produced
+};
+
+#endif // UIEVENT_H
@@ -0,0 +1,131 @@
+#ifndef UILAYOUTS_H
+#define UILAYOUTS_H
+/**
+ * @file UiLayouts.h
+ * @brief Layout tables of the UI screens (see ScreenLayout.h).
+ *
+ * Included by UiScreens.cpp only. Every table is checked at compile time.
+ */
+
+#include "ScreenLayout.h"
+
+static constexpr LayoutItem LOCK_LAYOUT[] = {
+    LAYOUT_HEADER(MSG_TITLE_SECURITY),
+    layoutText(0, 1, MSG_SCAN_MASTER),
+    layoutField(FIELD_ICONS, 17, 1, 3),
+};
+
+static constexpr LayoutItem HOME_MANAGER_LAYOUT[] = {
+    LAYOUT_HEADER(MSG_TITLE_HOME),
+    layoutText(0, 1, MSG_MANAGER),
+    layoutField(FIELD_MANAGER, 9, 1, 11),
+    layoutText(0, 2, MSG_DATE),
+    layoutField(FIELD_DATE, 6, 2, 14),
+    layoutField(FIELD_WIFI, 0, 3, 20),
+};
+
+static constexpr LayoutItem HOME_BALANCE_LAYOUT[] = {
+    LAYOUT_HEADER(MSG_TITLE_HOME),
+    layoutText(0, 1, MSG_BALANCE),
+    layoutField(FIELD_DEVICE_BALANCE, 9, 1, 6),
+    layoutText(15, 1, MSG_UNITS),
+    layoutText(0, 2, MSG_LAST_COMM),
+    layoutScroll(FIELD_LAST_COMM, 10, 2, 10),
+    layoutField(FIELD_WIFI, 0, 3, 20),
+};
+
+static constexpr LayoutItem SELECT_ACTION_LAYOUT[] = {
+    LAYOUT_HEADER(MSG_TITLE_SELECT),
+    layoutText(0, 1, MSG_MENU_RECHARGE),
+    layoutText(0, 2, MSG_MENU_SET_NUMBER),
+    layoutText(0, 3, MSG_CARD_BALANCE),
+    layoutField(FIELD_CARD_BALANCE, 9, 3, 6),
+    layoutText(15, 3, MSG_UNITS),
+};
+
+static constexpr LayoutItem RECHARGE_LAYOUT[] = {
+    LAYOUT_HEADER(MSG_TITLE_RECHARGE),
+    layoutText(0, 1, MSG_POS_BALANCE),
+    layoutField(FIELD_DEVICE_BALANCE, 9, 1, 6),
+    layoutText(15, 1, MSG_UNITS),
+    layoutText(0, 2, MSG_CARD_BALANCE),
+    layoutField(FIELD_CARD_BALANCE, 9, 2, 6),
+    layoutText(15, 2, MSG_UNITS),
+    layoutText(0, 3, MSG_SELECT),
+    layoutScroll(FIELD_OPTIONS, 7, 3, 13),
+};
+
+static constexpr LayoutItem USER_MODE_LAYOUT[] = {
+    layoutText(0, 0, MSG_NUMBER_1),
+    layoutField(FIELD_NUMBER_1, 5, 0, 10),
+    layoutText(15, 0, MSG_NUMBERS_LABEL_1),
+    layoutText(0, 1, MSG_NUMBER_2),
+    layoutField(FIELD_NUMBER_2, 5, 1, 10),
+    layoutText(15, 1, MSG_NUMBERS_LABEL_2),
+    layoutText(0, 2, MSG_NUMBER_3),
+    layoutField(FIELD_NUMBER_3, 5, 2, 10),
+    layoutText(15, 2, MSG_NUMBERS_LABEL_3),
+    layoutText(0, 3, MSG_NUMBER_4),
+    layoutField(FIELD_NUMBER_4, 5, 3, 10),
+    layoutText(15, 3, MSG_SEPARATOR),
+    layoutScroll(FIELD_TIME, 16, 3, 4),
+};
+
+static constexpr LayoutItem LOCK_CARD_LAYOUT[] = {
+    LAYOUT_HEADER(MSG_TITLE_LOCK_CARD),
+    layoutField(FIELD_WIFI, 0, 1, 20),
+    layoutText(0, 2, MSG_PLACE_CARD),
+    layoutText(0, 3, MSG_CARD_SLOT),
+};
+
+static constexpr LayoutItem AP_LAYOUT[] = {
+    LAYOUT_HEADER(MSG_TITLE_AP),
+    layoutText(0, 1, MSG_WIFI_NOT_SET),
+    layoutText(0, 2, MSG_AP_ADDRESS),
+    layoutField(FIELD_AP_ADDRESS, 12, 2, 8),
+    layoutText(0, 3, MSG_AP_NAME),
+};
+
+static constexpr LayoutItem PROMPT_LAYOUT[] = {
+    layoutField(FIELD_TITLE, 0, 0, 20),
+    layoutText(0, 2, MSG_PROMPT_MARK),
+    layoutField(FIELD_INPUT, 3, 2, UI_PROMPT_MAX_LENGTH),
+    layoutField(FIELD_HINT, 5, 3, 15),
+};
+
+static constexpr LayoutItem CONFIRM_LAYOUT[] = {
+    layoutField(FIELD_LINE_1, 0, 0, 20, ALIGN_CENTER),
+    layoutField(FIELD_LINE_2, 0, 2, 20, ALIGN_CENTER),
+    layoutText(0, 3, MSG_CONFIRM_KEYS),
+};
+
+static constexpr LayoutItem MESSAGE_LAYOUT[] = {
+    layoutField(FIELD_TITLE, 0, 0, 14),
+    layoutField(FIELD_TIME, 15, 0, 5),
+    layoutField(FIELD_LINE_1, 0, 1, 20, ALIGN_CENTER),
+    layoutField(FIELD_LINE_2, 0, 2, 20, ALIGN_CENTER),
+    layoutField(FIELD_LINE_3, 0, 3, 20, ALIGN_CENTER),
+};
+
+static constexpr LayoutItem MESSAGE_UNTITLED_LAYOUT[] = {
+    layoutField(FIELD_LINE_1, 0, 1, 20, ALIGN_CENTER),
+    layoutField(FIELD_LINE_2, 0, 2, 20, ALIGN_CENTER),
+    layoutField(FIELD_LINE_3, 0, 3, 20, ALIGN_CENTER),
+};
+
+#define LAYOUT_CHECK(items) static_assert(checkLayout(items, LAYOUT_ITEM_COUNT(items)), #items ": item off screen or field without id")
+
+LAYOUT_CHECK(LOCK_LAYOUT);
+LAYOUT_CHECK(HOME_MANAGER_LAYOUT);
+LAYOUT_CHECK(HOME_BALANCE_LAYOUT);
+LAYOUT_CHECK(SELECT_ACTION_LAYOUT);
+LAYOUT_CHECK(RECHARGE_LAYOUT);
+LAYOUT_CHECK(USER_MODE_LAYOUT);
+LAYOUT_CHECK(LOCK_CARD_LAYOUT);
+LAYOUT_CHECK(AP_LAYOUT);
+LAYOUT_CHECK(PROMPT_LAYOUT);
+LAYOUT_CHECK(CONFIRM_LAYOUT);
+LAYOUT_CHECK(MESSAGE_LAYOUT);
+LAYOUT_CHECK(MESSAGE_UNTITLED_LAYOUT);
+
+#endif // UILAYOUTS_H
@@ -0,0 +1,552 @@
+#include "UiScreens.h"
+#include "ScreenManager.h"
+#include "UiLayouts.h"
+
+/**
+ * @brief Copies a string into a fixed buffer, truncating it.
+ */
+static void copyText(char* dest, const char* src, size_t size) {
+    strncpy(dest, src ? src : "", size - 1);
+    dest[size - 1] = '\0';
+}
+
+/**
+ * @brief Publishes a transaction on the card just used. The log, the buzzer
+ * (result tone) and the live clients take it from the bus.
+ *
+ * @param kind BUS_TRANSACTION_RECHARGE or BUS_TRANSACTION_NUMBER_SAVED.
+ * @param code Number slot 1-4 of a number save.
+ */
+static void publishTransaction(ScreenManager& ui, BusTransactionKind kind, uint8_t code, bool success,
+                               uint32_t amount, uint32_t balance) {
+    BusEvent event = {TOPIC_TRANSACTION, kind, code, success, amount, balance, millis()};
+    ui.getRfid()->getLastUID(event.cardId, sizeof(event.cardId));
+    Bus.publish(event);
+}
+
+// --------------------------------------------------
+// LockScreen
+// --------------------------------------------------
+
+/**
+ * @brief Draws the security check prompt.
+ */
+void LockScreen::onEnter(ScreenManager& ui) {
+    ui.showLayout(LAYOUT_OF(LOCK_LAYOUT));
+    ui.getLayout().moveTo(FIELD_ICONS);
+    ui.getGlyphs().print(GLYPH_LOCK);
+    ui.getLcd()->print(' ');
+    ui.getGlyphs().print(GLYPH_CARD);
+}
+
+/**
+ * @brief Unlocks on the master card, rejects any other card.
+ */
+void LockScreen::onEvent(ScreenManager& ui, const UiEvent& event) {
+    if (event.type == UI_EVENT_CARD) {
+        if (event.code == 1) {
+            ui.getBuzzer()->playSuccessTone();
+            ui.unlock();
+        } else {
+            ui.getBuzzer()->playFailureTone();
+            ui.push(&ui.messageScreen.setup(msg(MSG_TITLE_SECURITY), "", msg(MSG_INVALID_KEY), "", 1500));
+        }
+    }
+}
+
+// --------------------------------------------------
+// HomeScreen
+// --------------------------------------------------
+
+/**
+ * @brief Shows the first view and starts the view rotation.
+ */
+void HomeScreen::onEnter(ScreenManager& ui) {
+    view = 0;
+    draw(ui);
+    ui.startScreenTimer(UI_HOME_ROTATE_MS, true);
+}
+
+/**
+ * @brief Draws the current view.
+ *
+ * View 0: manager name, date and Wi-Fi signal.
+ * View 1: device balance, scrolling last communication and Wi-Fi signal.
+ */
+void HomeScreen::draw(ScreenManager& ui) {
+    TRACE_SCOPE("lcd.homePage");
+    LayoutRenderer& layout = ui.getLayout();
+
+    if (view == 0) {
+        ui.showLayout(LAYOUT_OF(HOME_MANAGER_LAYOUT));
+        layout.setField(FIELD_MANAGER, ui.getConfig()->GetManagerName());
+        layout.setField(FIELD_DATE, ui.getLog()->getDateString().c_str());
+    } else {
+        ui.showLayout(LAYOUT_OF(HOME_BALANCE_LAYOUT));
+        layout.setField(FIELD_DEVICE_BALANCE, (uint32_t)ui.getRfid()->GetBalance());
+        FixedString<40> lastComm;
+        lastComm.format("%s %s %lu", ui.getLog()->getDateString().c_str(), ui.getLog()->getTimeString().c_str(),
+                        (unsigned long)ui.getLastRechargeAmount());
+        layout.setField(FIELD_LAST_COMM, lastComm.c_str());
+    }
+}
+
+/**
+ * @brief Rotates the views, opens a user card session on a card tap and the
+ * lock card page when '#' is held.
+ */
+void HomeScreen::onEvent(ScreenManager& ui, const UiEvent& event) {
+    switch (event.type) {
+        case UI_EVENT_TIMER:
+            view ^= 1;
+            draw(ui);
+            break;
+
+        case UI_EVENT_NETWORK:
+            ui.updateCommonFields();
+            break;
+
+        case UI_EVENT_KEY_LONG:
+            if (event.code == '#') {
+                ui.getBuzzer()->playSuccessTone();
+                ui.push(&ui.lockCardScreen);
+            }
+            break;
+
+        case UI_EVENT_CARD:
+            if (event.code == 0) {
+                ui.push(&ui.selectActionScreen);  // Readable user card
+            } else if (event.code == 6 || event.code == 7) {
+                ui.getBuzzer()->playFailureTone();
+                ui.push(&ui.messageScreen.setup(msg(MSG_TITLE_SECURITY), "", msg(MSG_INVALID_CARD), msg(MSG_RULE)));
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+// --------------------------------------------------
+// SelectActionScreen
+// --------------------------------------------------
+
+/**
+ * @brief Draws the action menu with the card balance.
+ */
+void SelectActionScreen::onEnter(ScreenManager& ui) {
+    ui.getBuzzer()->playSuccessTone();
+    ui.showLayout(LAYOUT_OF(SELECT_ACTION_LAYOUT));
+    ui.getLayout().setField(FIELD_CARD_BALANCE, ui.getRfid()->GetCardBalance());
+}
+
+/**
+ * @brief '1' recharges, '2' edits the card numbers, '*' or removing the card ends the session.
+ */
+void SelectActionScreen::onEvent(ScreenManager& ui, const UiEvent& event) {
+    if (event.type == UI_EVENT_CARD_REMOVED) {
+        ui.getBuzzer()->playFailureTone();
+        ui.pop();
+        return;
+    }
+    if (event.type != UI_EVENT_KEY) return;
+
+    switch (event.code) {
+        case '1':
+            ui.getBuzzer()->playSuccessTone();
+            ui.replace(&ui.rechargeScreen);
+            break;
+        case '2':
+            ui.getBuzzer()->playSuccessTone();
+            ui.replace(&ui.userModeScreen);
+            break;
+        case '*':
+            ui.getBuzzer()->playFailureTone();
+            ui.pop();
+            break;
+        default:
+            break;
+    }
+}
+
+// --------------------------------------------------
+// RechargeScreen
+// --------------------------------------------------
+
+/**
+ * @brief Draws device and card balances with the scrolling recharge options.
+ */
+void RechargeScreen::onEnter(ScreenManager& ui) {
+    LayoutRenderer& layout = ui.getLayout();
+    confirming = false;
+
+    ui.showLayout(LAYOUT_OF(RECHARGE_LAYOUT));
+    layout.setField(FIELD_DEVICE_BALANCE, (uint32_t)ui.getRfid()->GetBalance());
+    layout.setField(FIELD_CARD_BALANCE, ui.getRfid()->GetCardBalance());
+    layout.setField(FIELD_OPTIONS, msg(MSG_RECHARGE_OPTIONS));
+}
+
+/**
+ * @brief '1' and '2' pick a fixed amount, '3' asks for one, '*' leaves.
+ */
+void RechargeScreen::onEvent(ScreenManager& ui, const UiEvent& event) {
+    if (event.type != UI_EVENT_KEY) return;
+
+    switch (event.code) {
+        case '1':
+            request(ui, 100);
+            break;
+        case '2':
+            request(ui, 200);
+            break;
+        case '3':
+            confirming = false;
+            ui.push(&ui.promptScreen.setup(msg(MSG_ENTER_AMOUNT), msg(MSG_UNITS)));
+            break;
+        case '*':
+            ui.pop();
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Checks the device balance and asks for confirmation of an amount.
+ *
+ * @param amount Units to transfer to the card.
+ */
+void RechargeScreen::request(ScreenManager& ui, uint32_t amount) {
+    if (ui.getRfid()->GetBalance() < amount) {
+        ui.getBuzzer()->playFailureTone();
+        ui.replace(&ui.messageScreen.setup(msg(MSG_TITLE_HOME), "", msg(MSG_LOW_BALANCE), msg(MSG_RECHARGE_FAILED)));
+        return;
+    }
+
+    char detail[LCD_COLUMNS + 1];
+    snprintf(detail, sizeof(detail), msg(MSG_FMT_UNITS), (unsigned long)amount);
+    this->amount = amount;
+    confirming = true;
+    ui.push(&ui.confirmScreen.setup(msg(MSG_CONFIRM_RECHARGE), detail));
+}
+
+/**
+ * @brief Receives the typed amount or the confirmation answer.
+ */
+void RechargeScreen::onResult(ScreenManager& ui, bool accepted, const char* value) {
+    if (!confirming) {
+        uint32_t typed = (uint32_t)strtoul(value, nullptr, 10);
+        if (accepted && typed > 0) {
+            request(ui, typed);
+        }
+        return;
+    }
+
+    if (!accepted) {
+        ui.pop();  // Cancelled recharge returns to the home page
+        return;
+    }
+    apply(ui);
+}
+
+/**
+ * @brief Writes the recharge to the card and shows the outcome.
+ */
+void RechargeScreen::apply(ScreenManager& ui) {
+    MRC522Manager* rfid = ui.getRfid();
+    uint32_t holdBalance = rfid->GetCardBalance();
+    rfid->resetRFID();
+
+    if (rfid->Recharge(amount)) {
+        char hold[LCD_COLUMNS + 1];
+        char updated[LCD_COLUMNS + 1];
+        snprintf(hold, sizeof(hold), msg(MSG_FMT_HOLD_BALANCE), (unsigned long)holdBalance);
+        snprintf(updated, sizeof(updated), msg(MSG_FMT_NEW_BALANCE), (unsigned long)(holdBalance + amount));
+        ui.setLastRechargeAmount(amount);
+        publishTransaction(ui, BUS_TRANSACTION_RECHARGE, 0, true, amount, holdBalance + amount);
+        ui.replace(&ui.messageScreen.setup(msg(MSG_TITLE_HOME), msg(MSG_RECHARGE_SUCCEEDED), hold, updated));
+    } else {
+        publishTransaction(ui, BUS_TRANSACTION_RECHARGE, 0, false, amount, holdBalance);
+        ui.replace(&ui.messageScreen.setup(msg(MSG_TITLE_HOME), msg(MSG_CARD_NOT_VALID), msg(MSG_WRITE_ERROR), msg(MSG_RECHARGE_FAILED)));
+    }
+}
+
+// --------------------------------------------------
+// UserModeScreen
+// --------------------------------------------------
+
+/**
+ * @brief Reads and lists the four numbers stored on the card, with the time
+ * scrolling in the bottom-right corner.
+ */
+void UserModeScreen::onEnter(ScreenManager& ui) {
+    static const LayoutField fields[4] = {FIELD_NUMBER_1, FIELD_NUMBER_2, FIELD_NUMBER_3, FIELD_NUMBER_4};
+    MRC522Manager* rfid = ui.getRfid();
+
+    ui.getBuzzer()->playSuccessTone();
+    ui.showLayout(LAYOUT_OF(USER_MODE_LAYOUT));
+
+    for (uint8_t row = 0; row < 4; row++) {
+        PhoneNumber number;
+        switch (row) {
+            case 0: number = rfid->GetNum01(); break;
+            case 1: number = rfid->GetNum02(); break;
+            case 2: number = rfid->GetNum03(); break;
+            default: number = rfid->GetNum04(); break;
+        }
+        ui.getLayout().setField(fields[row], number.isEmpty() ? msg(MSG_NO_NUMBER) : number.c_str());
+    }
+}
+
+/**
+ * @brief '1'-'4' edit a number, '*' or removing the card leaves.
+ */
+void UserModeScreen::onEvent(ScreenManager& ui, const UiEvent& event) {
+    if (event.type == UI_EVENT_CARD_REMOVED) {
+        ui.pop();
+        return;
+    }
+    if (event.type != UI_EVENT_KEY) return;
+
+    if (event.code == '*') {
+        ui.pop();
+        return;
+    }
+    if (event.code < '1' || event.code > '4') return;
+
+    MRC522Manager* rfid = ui.getRfid();
+    slot = event.code - '1';
+    PhoneNumber current;
+    switch (slot) {
+        case 0: current = rfid->GetNum01(); break;
+        case 1: current = rfid->GetNum02(); break;
+        case 2: current = rfid->GetNum03(); break;
+        default: current = rfid->GetNum04(); break;
+    }
+    ui.push(&ui.promptScreen.setup(msg(MSG_ENTER_NUMBER), current.c_str()));
+}
+
+/**
+ * @brief Saves the typed number and shows the outcome, then the list again.
+ */
+void UserModeScreen::onResult(ScreenManager& ui, bool accepted, const char* value) {
+    if (!accepted) return;
+
+    MRC522Manager* rfid = ui.getRfid();
+    bool saved;
+    switch (slot) {
+        case 0: saved = rfid->SaveNum01(value); break;
+        case 1: saved = rfid->SaveNum02(value); break;
+        case 2: saved = rfid->SaveNum03(value); break;
+        default: saved = rfid->SaveNum04(value); break;
+    }
+
+    publishTransaction(ui, BUS_TRANSACTION_NUMBER_SAVED, slot + 1, saved, 0, 0);
+    if (saved) {
+        char line[LCD_COLUMNS + 1];
+        snprintf(line, sizeof(line), msg(MSG_FMT_NEW_NUMBER), (unsigned)(slot + 1));
+        ui.push(&ui.messageScreen.setup(msg(MSG_TITLE_USER), "", line, msg(MSG_SAVED)));
+    } else {
+        ui.push(&ui.messageScreen.setup(msg(MSG_TITLE_HOME), msg(MSG_CARD_NOT_VALID), msg(MSG_WRITE_ERROR), msg(MSG_OPERATION_FAILED)));
+    }
+}
+
+// --------------------------------------------------
+// LockCardScreen
+// --------------------------------------------------
+
+/**
+ * @brief Draws the lock card instructions.
+ */
+void LockCardScreen::onEnter(ScreenManager& ui) {
+    ui.showLayout(LAYOUT_OF(LOCK_CARD_LAYOUT));
+}
+
+/**
+ * @brief Locks any readable non-master card, '*' leaves.
+ */
+void LockCardScreen::onEvent(ScreenManager& ui, const UiEvent& event) {
+    if (event.type == UI_EVENT_KEY && event.code == '*') {
+        ui.pop();
+        return;
+    }
+    if (event.type == UI_EVENT_NETWORK) {
+        ui.updateCommonFields();
+        return;
+    }
+    if (event.type != UI_EVENT_CARD || event.code != 0) return;
+
+    if (ui.getRfid()->lockCard()) {
+        ui.push(&ui.messageScreen.setup(msg(MSG_TITLE_LOCK_CARD), "", msg(MSG_LOCK_SUCCEEDED), "", 2000));
+    } else {
+        ui.push(&ui.messageScreen.setup(msg(MSG_TITLE_LOCK_CARD), "", msg(MSG_LOCK_FAILED), "", 2000));
+    }
+}
+
+// --------------------------------------------------
+// ApScreen
+// --------------------------------------------------
+
+/**
+ * @brief Draws the access point address and device name.
+ */
+void ApScreen::onEnter(ScreenManager& ui) {
+    ui.showLayout(LAYOUT_OF(AP_LAYOUT));
+    ui.getLayout().setField(FIELD_AP_ADDRESS, ui.getWiFi()->Message);
+}
+
+/**
+ * @brief Redraws on network changes, unlocks on the master card, '*' goes
+ * back to the security check.
+ */
+void ApScreen::onEvent(ScreenManager& ui, const UiEvent& event) {
+    if (event.type == UI_EVENT_NETWORK) {
+        onEnter(ui);
+    } else if (event.type == UI_EVENT_CARD && event.code == 1) {
+        ui.getBuzzer()->playSuccessTone();
+        ui.unlock();
+    } else if (event.type == UI_EVENT_KEY && event.code == '*') {
+        ui.lock(false);
+    }
+}
+
+// --------------------------------------------------
+// PromptScreen
+// --------------------------------------------------
+
+/**
+ * @brief Prepares the prompt before it is pushed.
+ *
+ * @param promptText Question shown on the first row.
+ * @param currentNum Current value shown as a reference.
+ * @return The screen, to pass to ScreenManager::push().
+ */
+PromptScreen& PromptScreen::setup(const char* promptText, const char* currentNum) {
+    copyText(prompt, promptText, sizeof(prompt));
+    copyText(current, currentNum, sizeof(current));
+    input[0] = '\0';
+    length = 0;
+    return *this;
+}
+
+void PromptScreen::onEnter(ScreenManager& ui) {
+    LayoutRenderer& layout = ui.getLayout();
+    ui.showLayout(LAYOUT_OF(PROMPT_LAYOUT));
+    layout.setField(FIELD_TITLE, prompt);
+    layout.setField(FIELD_HINT, current);
+    drawInput(ui);
+}
+
+void PromptScreen::drawInput(ScreenManager& ui) {
+    ui.getLayout().setField(FIELD_INPUT, input);
+}
+
+/**
+ * @brief Digits append up to UI_PROMPT_MAX_LENGTH, '*' erases the last digit
+ * or cancels the prompt when nothing is typed, '#' confirms.
+ */
+void PromptScreen::onEvent(ScreenManager& ui, const UiEvent& event) {
+    if (event.type != UI_EVENT_KEY) return;
+
+    char key = (char)event.code;
+    if (key >= '0' && key <= '9') {
+        if (length < UI_PROMPT_MAX_LENGTH) {
+            input[length++] = key;
+            input[length] = '\0';
+            drawInput(ui);
+        }
+    } else if (key == '*') {
+        if (length > 0) {
+            input[--length] = '\0';
+            drawInput(ui);
+        } else {
+            ui.finish(false);
+        }
+    } else if (key == '#') {
+        ui.finish(true, input);
+    }
+}
+
+// --------------------------------------------------
+// ConfirmScreen
+// --------------------------------------------------
+
+/**
+ * @brief Prepares the question before it is pushed.
+ *
+ * @param questionText Question shown on the first row.
+ * @param detailText Value being confirmed, centered on the third row.
+ * @return The screen, to pass to ScreenManager::push().
+ */
+ConfirmScreen& ConfirmScreen::setup(const char* questionText, const char* detailText) {
+    copyText(question, questionText, sizeof(question));
+    copyText(detail, detailText, sizeof(detail));
+    return *this;
+}
+
+void ConfirmScreen::onEnter(ScreenManager& ui) {
+    ui.showLayout(LAYOUT_OF(CONFIRM_LAYOUT));
+    ui.getLayout().setField(FIELD_LINE_1, question);
+    ui.getLayout().setField(FIELD_LINE_2, detail);
+}
+
+void ConfirmScreen::onEvent(ScreenManager& ui, const UiEvent& event) {
+    if (event.type != UI_EVENT_KEY) return;
+
+    if (event.code == '#') {
+        ui.getBuzzer()->playSuccessTone();
+        ui.finish(true);
+    } else if (event.code == '*') {
+        ui.getBuzzer()->playFailureTone();
+        ui.finish(false);
+    }
+}
+
+// --------------------------------------------------
+// MessageScreen
+// --------------------------------------------------
+
+/**
+ * @brief Prepares the message before it is pushed.
+ *
+ * @param titleText Page title drawn with the time, empty for none.
+ * @param line1 Centered text of the second row.
+ * @param line2 Centered text of the third row.
+ * @param line3 Centered text of the fourth row.
+ * @param hold Time before the message closes itself.
+ * @return The screen, to pass to ScreenManager::push() or replace().
+ */
+MessageScreen& MessageScreen::setup(const char* titleText, const char* line1, const char* line2,
+                                    const char* line3, uint32_t hold) {
+    copyText(title, titleText, sizeof(title));
+    copyText(lines[0], line1, sizeof(lines[0]));
+    copyText(lines[1], line2, sizeof(lines[1]));
+    copyText(lines[2], line3, sizeof(lines[2]));
+    holdMs = hold;
+    return *this;
+}
+
+void MessageScreen::onEnter(ScreenManager& ui) {
+    static const LayoutField lineFields[3] = {FIELD_LINE_1, FIELD_LINE_2, FIELD_LINE_3};
+    LayoutRenderer& layout = ui.getLayout();
+
+    if (title[0] != '\0') {
+        ui.showLayout(LAYOUT_OF(MESSAGE_LAYOUT));
+        layout.setField(FIELD_TITLE, title);
+    } else {
+        ui.showLayout(LAYOUT_OF(MESSAGE_UNTITLED_LAYOUT));
+    }
+    for (uint8_t i = 0; i < 3; i++) {
+        layout.setField(lineFields[i], lines[i]);
+    }
+    ui.startScreenTimer(holdMs);
+}
+
+/**
+ * @brief Closes on timeout or on any key.
+ */
+void MessageScreen::onEvent(ScreenManager& ui, const UiEvent& event) {
+    if (event.type == UI_EVENT_TIMER || event.type == UI_EVENT_KEY) {
+        ui.pop();
+    }
+}
@@ -0,0 +1,180 @@
+#ifndef UISCREENS_H
+#define UISCREENS_H
+/**
+ * @file UiScreens.h
+ * @brief Screens of the device UI, driven by ScreenManager's event loop.
+ *
+ * A screen never waits: it draws itself in `onEnter()` by showing its layout
+ * table (UiLayouts.h) and setting the fields, reacts to one event at
+ * a time in `onEvent()` and navigates by asking the ScreenManager to push, pop
+ * or replace screens. A screen pushed to collect an answer (prompt,
+ * confirmation) hands it back to the screen below through `onResult()`.
+ *
+ * Navigation graph:
+ * @code
+ *   Lock --master--> Home --user card--> SelectAction --1--> Recharge --> Prompt / Confirm
+ *    ^ |                  |                             --2--> UserMode --> Prompt
+ *    | AP up              +--hold #--> LockCard
+ *    | v
+ *   Ap --master--> Home
+ * @endcode
+ * Message screens are pushed on top for results and pop themselves after a
+ * timeout or on any key.
+ */
+
+#include <Arduino.h>
+#include "Config.h"
+#include "UiEvent.h"
+#include "Messages.h"
+
+class ScreenManager;
+
+/**
+ * @class UiScreen
+ * @brief Base class of every screen.
+ */
+class UiScreen {
+public:
+    virtual ~UiScreen() {}
+
+    virtual void onEnter(ScreenManager& ui) = 0;                          ///< Became the top screen: draw it
+    virtual void onEvent(ScreenManager& ui, const UiEvent& event) = 0;    ///< Handle one input or timer event
+    virtual void onResult(ScreenManager& ui, bool accepted, const char* value) {}  ///< A screen pushed by this one finished
+    virtual UiCardMode getCardMode() const { return UI_CARD_NONE; }
+};
+
+/**
+ * @brief Locked device, waits for the master card.
+ */
+class LockScreen : public UiScreen {
+public:
+    void onEnter(ScreenManager& ui) override;
+    void onEvent(ScreenManager& ui, const UiEvent& event) override;
+    UiCardMode getCardMode() const override { return UI_CARD_TAP; }
+};
+
+/**
+ * @brief Home page alternating between manager/date and balance/last recharge views.
+ */
+class HomeScreen : public UiScreen {
+public:
+    void onEnter(ScreenManager& ui) override;
+    void onEvent(ScreenManager& ui, const UiEvent& event) override;
+    UiCardMode getCardMode() const override { return UI_CARD_TAP; }
+
+private:
+    void draw(ScreenManager& ui);
+    uint8_t view = 0;
+};
+
+/**
+ * @brief Action menu shown while a user card is on the reader.
+ */
+class SelectActionScreen : public UiScreen {
+public:
+    void onEnter(ScreenManager& ui) override;
+    void onEvent(ScreenManager& ui, const UiEvent& event) override;
+    UiCardMode getCardMode() const override { return UI_CARD_PRESENCE; }
+};
+
+/**
+ * @brief Transfers units from the device balance to the user card.
+ */
+class RechargeScreen : public UiScreen {
+public:
+    void onEnter(ScreenManager& ui) override;
+    void onEvent(ScreenManager& ui, const UiEvent& event) override;
+    void onResult(ScreenManager& ui, bool accepted, const char* value) override;
+
+private:
+    void request(ScreenManager& ui, uint32_t amount);
+    void apply(ScreenManager& ui);
+
+    bool confirming = false;     ///< false: waiting for an amount, true: for the confirmation
+    uint32_t amount = 0;
+};
+
+/**
+ * @brief Lists and edits the four numbers stored on the user card.
+ */
+class UserModeScreen : public UiScreen {
+public:
+    void onEnter(ScreenManager& ui) override;
+    void onEvent(ScreenManager& ui, const UiEvent& event) override;
+    void onResult(ScreenManager& ui, bool accepted, const char* value) override;
+    UiCardMode getCardMode() const override { return UI_CARD_PRESENCE; }
+
+private:
+    uint8_t slot = 0;            ///< Number being edited, 0-3
+};
+
+/**
+ * @brief Locks the next non-master card placed on the reader.
+ */
+class LockCardScreen : public UiScreen {
+public:
+    void onEnter(ScreenManager& ui) override;
+    void onEvent(ScreenManager& ui, const UiEvent& event) override;
+    UiCardMode getCardMode() const override { return UI_CARD_TAP; }
+};
+
+/**
+ * @brief Access point setup instructions, shown instead of the security check
+ * while the setup access point is up. The master card still unlocks.
+ */
+class ApScreen : public UiScreen {
+public:
+    void onEnter(ScreenManager& ui) override;
+    void onEvent(ScreenManager& ui, const UiEvent& event) override;
+    UiCardMode getCardMode() const override { return UI_CARD_TAP; }
+};
+
+/**
+ * @brief Numeric entry: digits append, '*' erases or cancels when empty, '#' confirms.
+ */
+class PromptScreen : public UiScreen {
+public:
+    PromptScreen& setup(const char* promptText, const char* currentNum);
+    void onEnter(ScreenManager& ui) override;
+    void onEvent(ScreenManager& ui, const UiEvent& event) override;
+
+private:
+    void drawInput(ScreenManager& ui);
+
+    char prompt[LCD_COLUMNS + 1];
+    char current[LCD_COLUMNS + 1];
+    char input[UI_PROMPT_MAX_LENGTH + 1];
+    uint8_t length = 0;
+};
+
+/**
+ * @brief Yes/no question: '#' accepts, '*' declines.
+ */
+class ConfirmScreen : public UiScreen {
+public:
+    ConfirmScreen& setup(const char* question, const char* detail);
+    void onEnter(ScreenManager& ui) override;
+    void onEvent(ScreenManager& ui, const UiEvent& event) override;
+
+private:
+    char question[LCD_COLUMNS + 1];
+    char detail[LCD_COLUMNS + 1];
+};
+
+/**
+ * @brief Result message with an optional title row, dismissed by timeout or any key.
+ */
+class MessageScreen : public UiScreen {
+public:
+    MessageScreen& setup(const char* title, const char* line1, const char* line2, const char* line3,
+                         uint32_t holdMs = UI_MESSAGE_MS);
+    void onEnter(ScreenManager& ui) override;
+    void onEvent(ScreenManager& ui, const UiEvent& event) override;
+
+private:
+    char title[LCD_COLUMNS + 1];
+    char lines[3][LCD_COLUMNS + 1];
+    uint32_t holdMs = UI_MESSAGE_MS;
+};
+
+#endif // UISCREENS_H
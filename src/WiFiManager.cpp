@@ -10,6 +10,8 @@
  */
 #include "WiFiManager.h"
 
+static const EventBits_t CONNECTED_BIT = 1 << 0;
+
 
 /**
  * @brief Constructor for the WiFiManager class.
@@ -17,25 +19,25 @@
  * Initializes the WiFiManager object, setting default values for the access point 
  * credentials and other configurations.
  */
-WiFiManager::WiFiManager(ConfigManager* configManager):configManager(configManager),server(80),isAPMode(false), apSSID(DEFAULT_AP_SSID),apPassword(DEFAULT_AP_PASSWORD){}
+WiFiManager::WiFiManager(ConfigManager* configManager):configManager(configManager),server(80),assets(&SPIFFS),isAPMode(false), apSSID(DEFAULT_AP_SSID),apPassword(DEFAULT_AP_PASSWORD),
+    state(WIFI_STATE_IDLE), connected(false), apFallback(false), failures(0), attempts(0), retryAtUs(0), timer(nullptr),
+    task(nullptr), serverStarted(false), signalPercent(0xFF), signalRssi(0), signalReadMs(0) {
+    events = xEventGroupCreate();
+    portMUX_INITIALIZE(&lock);
+}
 /**
  * @brief Begins the WiFiManager initialization process.
  *
- * This method mounts the SPIFFS filesystem, checks the configuration for 
- * the connection mode (AP or Wi-Fi), and starts the appropriate connection process.
+ * This method checks the configuration for the connection mode (AP or Wi-Fi)
+ * and starts the appropriate connection process. SPIFFS is mounted by the
+ * LogManager boot stage. The call returns as soon as the first attempt is
+ * started; waitForConnection() waits for its outcome.
  */
 void WiFiManager::begin() {
     if (DEBUGMODE) {
-        Serial.begin(115200);
         Serial.println("###########################################################");
         Serial.println("#                 Starting WIFI Manager                   #");
         Serial.println("###########################################################");
-        
-        if (!SPIFFS.begin(true)) {
-            Serial.println("An error has occurred while mounting SPIFFS");
-            return;
-        }
-        Serial.println("SPIFFS mounted successfully");
         Serial.println("WiFiManager: Begin initialization");
     }
 
@@ -48,6 +50,23 @@ void WiFiManager::begin() {
         Serial.printf("WiFiManager: Start mode - %s\n", startAP ? "AP" : "WiFi");
     }
 
+    assets.begin();
+
+    esp_timer_create_args_t args = {};
+    args.callback = &WiFiManager::timerCallback;
+    args.arg = this;
+    args.dispatch_method = ESP_TIMER_TASK;
+    args.name = "wifi";
+    if (esp_timer_create(&args, &timer) != ESP_OK) {
+        if (DEBUGMODE) {
+            Serial.println("WiFiManager: Failed to create the reconnection timer");
+        }
+        timer = nullptr;
+    } else if (!Tasks.start(TASK_NET, taskEntry, this, &task)) {
+        task = nullptr;  // The timer callback makes the Wi-Fi calls itself
+    }
+    WiFi.onEvent([this](WiFiEvent_t event, WiFiEventInfo_t info) { onWiFiEvent(event); });
+
     // Start in access point mode or connect to WiFi based on the flag
     startAP ? connectToWiFi() : startAccessPoint();
 }
@@ -71,17 +90,15 @@ void WiFiManager::setAPCredentials(const char* ssid, const char* password) {
 }
 
 /**
- * @brief Connects to the specified Wi-Fi network.
+ * @brief Starts connecting to the specified Wi-Fi network.
  *
- * Attempts to connect to the Wi-Fi using stored credentials. If the connection fails, 
- * it defaults to starting the access point.
+ * Uses the stored credentials; without credentials the access point is
+ * started instead. The outcome is reported by the Wi-Fi events, failed
+ * attempts are retried by the reconnection timer.
  */
 void WiFiManager::connectToWiFi() {
-    String ssid = configManager->GetString(WIFISSID, "unity22");
-    String password = configManager->GetString(WIFIPASS, "987456321");
-    // Formatted message
-    char text[50]; // Ensure this is large enough to hold your formatted string
-    sprintf(text, "WiFiManager:Attempting to connect to WiFi - %s...", ssid);
+    const char* ssid = configManager->GetWifiSsid();
+    const char* password = configManager->GetWifiPass();
     
     if (DEBUGMODE) {
         Serial.print("WiFiManager: Attempting to connect to WiFi\n - SSID: ");
@@ -90,45 +107,226 @@ void WiFiManager::connectToWiFi() {
         Serial.println(password);
     }
 
-    if (ssid == "" || password == "") {
+    if (ssid[0] == '\0' || password[0] == '\0' || timer == nullptr) {
         startAccessPoint();
+        return;
+    }
+
+    WiFi.mode(WIFI_STA);
+    WiFi.setAutoReconnect(false);  // Reconnections are paced by the backoff timer
+    setServerCallback();           // The REST API is served on the station too
+    attempt();
+}
+
+/**
+ * @brief Starts one connection attempt and arms its timeout.
+ */
+void WiFiManager::attempt() {
+    portENTER_CRITICAL(&lock);
+    state = WIFI_STATE_CONNECTING;
+    attempts++;
+    portEXIT_CRITICAL(&lock);
+
+    if (DEBUGMODE) {
+        Serial.printf("WiFiManager: Connection attempt %u\n", (unsigned)attempts);
+    }
+    armTimer(WIFI_CONNECT_TIMEOUT_MS * 1000LL);
+    WiFi.begin(configManager->GetWifiSsid(), configManager->GetWifiPass());
+}
+
+/**
+ * @brief Counts a failed attempt and arms the timer for the next one.
+ *
+ * The delay doubles with each failure from WIFI_BACKOFF_MIN_MS up to
+ * WIFI_BACKOFF_MAX_MS; the attempt then starts at a random point of the
+ * second half of that delay. When the failures reach
+ * WIFI_AP_FALLBACK_FAILURES the timer fires at once to open the access point.
+ */
+void WiFiManager::scheduleRetry() {
+    portENTER_CRITICAL(&lock);
+    if (failures < 0xFF) {
+        failures++;
+    }
+    uint8_t failed = failures;
+    portEXIT_CRITICAL(&lock);
+
+    uint32_t delayMs = WIFI_BACKOFF_MAX_MS;
+    if (failed <= 16 && ((uint32_t)WIFI_BACKOFF_MIN_MS << (failed - 1)) < WIFI_BACKOFF_MAX_MS) {
+        delayMs = (uint32_t)WIFI_BACKOFF_MIN_MS << (failed - 1);
+    }
+    delayMs = delayMs / 2 + esp_random() % (delayMs / 2 + 1);
+    retryAtUs = esp_timer_get_time() + delayMs * 1000LL;
+
+    if (DEBUGMODE) {
+        Serial.printf("WiFiManager: Attempt failed (%u in a row), retrying in %u ms\n", failed, (unsigned)delayMs);
+    }
+
+    bool openAp = failed >= WIFI_AP_FALLBACK_FAILURES && !apFallback;
+    armTimer(openAp ? 0 : delayMs * 1000LL);
+}
+
+void WiFiManager::armTimer(int64_t delayUs) {
+    esp_timer_stop(timer);
+    esp_timer_start_once(timer, delayUs > 0 ? delayUs : 0);
+}
+
+/**
+ * @brief Reconnection timer callback, on the esp_timer task: wakes the net
+ * task, which makes the Wi-Fi calls.
+ */
+void WiFiManager::timerCallback(void* arg) {
+    WiFiManager* self = static_cast<WiFiManager*>(arg);
+    if (self->task != nullptr) {
+        xTaskNotifyGive(self->task);
     } else {
-        WiFi.begin(ssid.c_str(), password.c_str());
-        unsigned long startAttemptTime = millis();
+        self->onTimer();
+    }
+}
 
-        if (DEBUGMODE) {
-            Serial.println("WiFiManager: Connecting to WiFi...");
-        }
+/**
+ * @brief Net task body: runs onTimer() once per timer expiry.
+ */
+void WiFiManager::taskEntry(void* param) {
+    WiFiManager* self = static_cast<WiFiManager*>(param);
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        TaskWork work(TASK_NET);
+        self->onTimer();
+    }
+}
 
-        while (WiFi.status() != WL_CONNECTED && millis() - startAttemptTime < 10000) {
-            delay(500);
-            if (DEBUGMODE) {
-                Serial.print(".");
+/**
+ * @brief Reconnection timer work, run on the net task: times out the attempt
+ * in progress, opens or closes the fallback access point and starts the next
+ * attempt when due.
+ */
+void WiFiManager::onTimer() {
+    portENTER_CRITICAL(&lock);
+    WiFiState current = state;
+    if (current == WIFI_STATE_CONNECTING) {
+        state = WIFI_STATE_BACKOFF;  // The disconnect event below is then ignored
+    }
+    portEXIT_CRITICAL(&lock);
+
+    switch (current) {
+        case WIFI_STATE_CONNECTING:
+            WiFi.disconnect();
+            scheduleRetry();
+            break;
+
+        case WIFI_STATE_CONNECTED:
+            if (apFallback) {
+                stopFallbackAccessPoint();
+            }
+            break;
+
+        case WIFI_STATE_BACKOFF: {
+            if (failures >= WIFI_AP_FALLBACK_FAILURES && !apFallback) {
+                startFallbackAccessPoint();
+            }
+            int64_t now = esp_timer_get_time();
+            if (now < retryAtUs) {
+                armTimer(retryAtUs - now);
+            } else {
+                attempt();
             }
+            break;
         }
 
-        if (WiFi.status() == WL_CONNECTED) {
-           
-            IPAddress localIP = WiFi.localIP();
-                // Formatted message
-            char text[100]; // Ensure this is large enough to hold your formatted string
-            sprintf(text, "WiFiManager: Connected to WiFi IP Address: %d.%d.%d.%d", localIP[0], localIP[1], localIP[2], localIP[3]);
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Wi-Fi event handler, runs on the Wi-Fi event task.
+ *
+ * Only updates the cached state and (re)arms the timer; the Wi-Fi calls
+ * themselves are made on the net task when the timer fires.
+ *
+ * @param event Arduino Wi-Fi event id.
+ */
+void WiFiManager::onWiFiEvent(WiFiEvent_t event) {
+    switch (event) {
+        case ARDUINO_EVENT_WIFI_STA_GOT_IP:
+            portENTER_CRITICAL(&lock);
+            state = WIFI_STATE_CONNECTED;
+            connected = true;
+            failures = 0;
+            signalPercent = 0xFF;
+            portEXIT_CRITICAL(&lock);
+
+            xEventGroupSetBits(events, CONNECTED_BIT);
+            if (timer != nullptr) {
+                esp_timer_stop(timer);
+                if (apFallback) {
+                    armTimer(0);  // Close the fallback access point
+                }
+            }
             if (DEBUGMODE) {
-                Serial.print("\nWiFiManager: Connected to WiFi,\nIP Address: ");
+                Serial.print("WiFiManager: Connected to WiFi, IP Address: ");
                 Serial.println(WiFi.localIP());
-                //setServerCallback();
             }
-            //server.begin(); // Start web server
-        } else {
-            
-             if (DEBUGMODE) {
-                Serial.println("WiFiManager: Failed to connect to WiFi.\nSwitching to AP mode.");
-                configManager->SetAPFLag(); // Set flag to start in AP mode next time
-                configManager->RestartSysDelay(3000);
+            break;
+
+        case ARDUINO_EVENT_WIFI_STA_DISCONNECTED:
+        case ARDUINO_EVENT_WIFI_STA_LOST_IP: {
+            portENTER_CRITICAL(&lock);
+            bool wasActive = state == WIFI_STATE_CONNECTED || state == WIFI_STATE_CONNECTING;
+            if (wasActive) {
+                state = WIFI_STATE_BACKOFF;
+                connected = false;
+            }
+            portEXIT_CRITICAL(&lock);
+
+            // Otherwise it is the disconnect of a timed-out attempt, already rescheduled
+            if (!wasActive || timer == nullptr) break;
+
+            xEventGroupClearBits(events, CONNECTED_BIT);
+            if (DEBUGMODE) {
+                Serial.println("WiFiManager: WiFi connection lost");
             }
+            scheduleRetry();
+            break;
         }
+
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Opens the setup access point next to the station after repeated
+ * failures, so the credentials can be fixed without a reboot.
+ */
+void WiFiManager::startFallbackAccessPoint() {
+    if (DEBUGMODE) {
+        Serial.println("WiFiManager: Failed to connect to WiFi.\nOpening the AP alongside the station.");
     }
+    WiFi.mode(WIFI_AP_STA);
+    WiFi.softAP(apSSID.c_str(), apPassword.c_str());
+    IPAddress localIP = WiFi.softAPIP();
+    sprintf(Message, "Connect-IP Address:%d.%d.%d.%d", localIP[0], localIP[1], localIP[2], localIP[3]);
+    apFallback = true;
+    setServerCallback();
 }
+
+/**
+ * @brief Closes the fallback access point once the station is connected.
+ * Waits while a client is still connected to it.
+ */
+void WiFiManager::stopFallbackAccessPoint() {
+    if (WiFi.softAPgetStationNum() > 0) {
+        armTimer(WIFI_CONNECT_TIMEOUT_MS * 1000LL);
+        return;
+    }
+    if (DEBUGMODE) {
+        Serial.println("WiFiManager: Closing the fallback AP");
+    }
+    WiFi.softAPdisconnect(true);
+    apFallback = false;
+}
+
 /**
  * @brief Starts the access point mode.
  *
@@ -141,8 +339,6 @@ void WiFiManager::startAccessPoint() {
     }
 
     WiFi.disconnect();
-    delay(100);
-
     WiFi.softAP(apSSID.c_str(), apPassword.c_str());
     IPAddress localIP = WiFi.softAPIP();
             // Formatted message
@@ -164,10 +360,20 @@ void WiFiManager::startAccessPoint() {
  * serving static files, and controlling GPIO.
  */
 void WiFiManager:: setServerCallback(){
+    if (serverStarted) return;  // Routes are registered once, the fallback AP may open several times
+    serverStarted = true;
     server.on("/", HTTP_GET, [this](AsyncWebServerRequest* request) { handleSetWiFi(request);});
     server.on("/saveWiFi", HTTP_POST, [this](AsyncWebServerRequest* request) { handleSaveWiFi(request); });
-    // Serve static files like icons, CSS, JS, etc.
-    server.serveStatic("/icons/", SPIFFS, "/icons/").setCacheControl("max-age=86400");
+    // Icons are revalidated by ETag once a day
+    server.on("/icons", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        assets.send(request, request->url().c_str(), "max-age=86400");
+    });
+    // Chrome trace-event JSON of the last recorded TRACE_SCOPE events
+    server.on("/trace", HTTP_GET, [](AsyncWebServerRequest* request) {
+        AsyncResponseStream* response = request->beginResponseStream("application/json");
+        Trace.dump(*response);
+        request->send(response);
+    });
     server.begin();
 }
 /**
@@ -180,7 +386,7 @@ void WiFiManager::handleRoot(AsyncWebServerRequest* request) {
         Serial.println("WiFiManager: Handling welcome root request");
     }
 
-    request->send(SPIFFS, "/welcome.html", "text/html");
+    assets.send(request, "/welcome.html");
 }
 
 /**
@@ -193,7 +399,7 @@ void WiFiManager::handleSetWiFi(AsyncWebServerRequest* request) {
         Serial.println("WiFiManager: Handling set wifi request");
     }
 
-    request->send(SPIFFS, "/wifiCredentialsPage.html", "text/html");
+    assets.send(request, "/wifiCredentialsPage.html");
 }
 /**
  * @brief Handles saving the Wi-Fi credentials.
@@ -220,10 +426,12 @@ void WiFiManager::handleSaveWiFi(AsyncWebServerRequest* request) {
             // Formatted message
             char text[50]; // Ensure this is large enough to hold your formatted string
             sprintf(text, "WiFiManager: Saving Wifi Credentials...");
-            configManager->PutString(WIFISSID, ssid);
-            configManager->PutString(WIFIPASS, password);
+            if (!configManager->SetWifiSsid(ssid.c_str()) || !configManager->SetWifiPass(password.c_str())) {
+                request->send(400, "text/plain", "Invalid SSID or Password.");
+                return;
+            }
             configManager->ResetAPFLag();
-            request->send(SPIFFS, "/thankyou_page.html", "text/html");
+            assets.send(request, "/thankyou_page.html");
             sprintf(text, "WiFiManager: Device Restarting in 3 Sec");
             configManager->RestartSysDelay(3000);
         } else {
@@ -236,25 +444,99 @@ void WiFiManager::handleSaveWiFi(AsyncWebServerRequest* request) {
 /**
  * @brief Gets the Wi-Fi signal strength as a percentage.
  *
- * @return The signal strength percentage.
+ * RSSI is read from the Wi-Fi stack at most every WIFI_RSSI_REFRESH_MS, the
+ * cached value is returned in between.
+ *
+ * @return The signal strength percentage, 0 when not connected.
  */
 uint8_t WiFiManager::getSignalStrengthPercent() {
+    if (!connected) {
+        return 0;
+    }
+    refreshSignal();
+    return signalPercent;
+}
+
+/**
+ * @brief Gets the received signal strength of the station.
+ *
+ * Shares the cache of getSignalStrengthPercent().
+ *
+ * @return RSSI in dBm, 0 when not connected.
+ */
+int8_t WiFiManager::getRssi() {
+    if (!connected) {
+        return 0;
+    }
+    refreshSignal();
+    return signalRssi;
+}
+
+/**
+ * @brief Reads the RSSI again once the cached value is older than
+ * WIFI_RSSI_REFRESH_MS.
+ */
+void WiFiManager::refreshSignal() {
+    uint32_t now = millis();
+    if (signalPercent != 0xFF && now - signalReadMs < WIFI_RSSI_REFRESH_MS) {
+        return;
+    }
+
     int rssi = WiFi.RSSI();  // Get RSSI value
     // Convert RSSI to a percentage
     if (rssi <= -100) {
-        return 0;  // Very weak signal
+        signalPercent = 0;  // Very weak signal
     } else if (rssi >= -50) {
-        return 100;  // Excellent signal
+        signalPercent = 100;  // Excellent signal
     } else {
-        return 2 * (rssi + 100);  // Convert to percentage
+        signalPercent = 2 * (rssi + 100);  // Convert to percentage
     }
+    signalRssi = (int8_t)rssi;
+    signalReadMs = now;
 }
 
 /**
  * @brief Checks if the ESP32 is still connected to the Wi-Fi network.
+ *
+ * Returns the state cached from the Wi-Fi events, so it is cheap enough to
+ * call on every UI loop iteration.
  * 
  * @return true if connected to Wi-Fi, false otherwise.
  */
 bool WiFiManager::isStillConnected() {
-    return WiFi.status() == WL_CONNECTED;
-}
\ No newline at end of file
+    return connected;
+}
+
+WiFiState WiFiManager::getState() const {
+    return state;
+}
+
+bool WiFiManager::isApActive() const {
+    return isAPMode || apFallback;
+}
+
+uint32_t WiFiManager::getAttemptCount() const {
+    return attempts;
+}
+
+/**
+ * @brief Blocks the calling task until the station has an IP.
+ *
+ * Meant for background tasks that need the network (e.g. the first NTP sync);
+ * the UI polls isStillConnected() instead.
+ *
+ * @param timeoutMs Longest wait.
+ * @return true if connected.
+ */
+bool WiFiManager::waitForConnection(uint32_t timeoutMs) {
+    EventBits_t bits = xEventGroupWaitBits(events, CONNECTED_BIT, pdFALSE, pdTRUE, pdMS_TO_TICKS(timeoutMs));
+    return (bits & CONNECTED_BIT) != 0;
+}
+
+AsyncWebServer& WiFiManager::getServer() {
+    return server;
+}
+
+AssetCatalog& WiFiManager::getAssets() {
+    return assets;
+}
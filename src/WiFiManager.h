@@ -12,29 +12,49 @@
  * @note This class relies on a ConfigManager instance to store and retrieve Wi-Fi credentials
  * and settings. It also manages LED states and provides endpoints for client interactions.
  * 
+ * Connection:
+ * - The station is driven by Wi-Fi events (`WiFi.onEvent`), nothing waits on it.
+ *   An attempt that does not get an IP within `WIFI_CONNECT_TIMEOUT_MS`, or a lost
+ *   connection, schedules a new attempt on a one-shot timer with exponential
+ *   backoff (`WIFI_BACKOFF_MIN_MS` doubling up to `WIFI_BACKOFF_MAX_MS`) and random
+ *   jitter, so devices that lost the same router do not retry in lockstep.
+ * - After `WIFI_AP_FALLBACK_FAILURES` failed attempts in a row the setup access
+ *   point is opened next to the station (AP+STA) instead of rebooting; the station
+ *   keeps retrying and the access point closes once it connects.
+ * - The timer callback only notifies the `net` task (TaskTopology.h), which makes
+ *   the Wi-Fi calls: the esp_timer task it shares with the keypad scan and the
+ *   buzzer never waits on the Wi-Fi stack.
+ * - The connection state and signal strength are cached, so the UI loop can poll
+ *   them without calling into the Wi-Fi stack.
+ *
  * Usage:
  * - Initialize an instance of WiFiManager.
- * - Call the begin() method to start the Wi-Fi manager, which will either connect to Wi-Fi 
- *   or start an access point based on the stored configuration.
+ * - Call the begin() method to start the Wi-Fi manager, which will either start
+ *   connecting to Wi-Fi or start an access point based on the stored configuration.
+ *   It returns immediately; waitForConnection() blocks a background task until connected.
  * - Set access point credentials using setAPCredentials() if needed.
  * - Utilize the web server to handle user interactions for configuring Wi-Fi or controlling GPIOs.
- * 
+ *
  * Public Methods:
  * - `WiFiManager()`: Constructor that initializes the WiFiManager instance.
  * - `void begin()`: Starts the Wi-Fi manager, determining the mode (Wi-Fi or AP).
  * - `void setAPCredentials(const char* ssid, const char* password)`: Sets the SSID and password 
  *   for the access point.
  * - `void setServerCallback()`: Configures the server routes and callbacks for handling web requests.
+ * - `bool isStillConnected()`: Cached station state, updated by the Wi-Fi events.
+ * - `WiFiState getState()`: Cached connection state machine state.
+ * - `bool waitForConnection(uint32_t timeoutMs)`: Blocks the calling task until an IP is obtained.
  * 
  * Private Methods:
- * - `void connectToWiFi()`: Attempts to connect to the specified Wi-Fi network using stored credentials.
+ * - `void connectToWiFi()`: Starts connecting to the specified Wi-Fi network using stored credentials.
+ * - `void onWiFiEvent(WiFiEvent_t event)`: Updates the cached state and schedules reconnections.
+ * - `void onTimer()`: Runs the connection attempts, timeouts and the AP fallback, on the net task.
  * - `void startAccessPoint()`: Initializes the ESP32 in access point mode with the configured SSID and password.
  * - `void handleRoot(AsyncWebServerRequest* request)`: Handles requests to the root URL by serving the 
  *   welcome page.
  * - `void handleSetWiFi(AsyncWebServerRequest* request)`: Serves the Wi-Fi credentials input page.
  * - `void handleSaveWiFi(AsyncWebServerRequest* request)`: Processes incoming requests to save Wi-Fi 
  *   credentials.
- * - `void handleGPIO(AsyncWebServerRequest* request)`: Serves the GPIO control page.
  * 
  * Member Variables:
  * - `ConfigManager* configManager`: Pointer to the ConfigManager for accessing configuration settings.
@@ -42,8 +62,6 @@
  * - `bool isAPMode`: Indicates whether the Wi-Fi manager is currently operating in AP mode.
  * - `String apSSID`: SSID for the access point.
  * - `String apPassword`: Password for the access point.
- * - `bool led1State`: State of LED 1 (on/off).
- * - `bool led2State`: State of LED 2 (on/off).
  */
 
 #include <WiFi.h>
@@ -52,8 +70,21 @@
 #include <NTPClient.h>
 #include <WiFiUdp.h>
 #include <ESPAsyncWebServer.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/event_groups.h>
 #include "ConfigManager.h"
+#include "AssetCatalog.h"
+#include "TraceBuffer.h"
+#include "TaskTopology.h"
+
 
+enum WiFiState : uint8_t {
+    WIFI_STATE_IDLE,          ///< Not started, or running as a plain access point
+    WIFI_STATE_CONNECTING,    ///< Attempt in progress, waiting for an IP
+    WIFI_STATE_CONNECTED,     ///< Station has an IP
+    WIFI_STATE_BACKOFF        ///< Waiting before the next attempt
+};
 
 class WiFiManager {
 public:
@@ -66,14 +97,29 @@ public:
     void setAPCredentials(const char* ssid, const char* password);    
     void setServerCallback();
     uint8_t getSignalStrengthPercent();
+    int8_t getRssi();                             ///< Cached station RSSI in dBm, 0 when not connected
     char Message[100];
     bool isStillConnected();
+    WiFiState getState() const;
+    bool isApActive() const;                      ///< true in AP mode and during the AP+STA fallback
+    uint32_t getAttemptCount() const;             ///< Connection attempts since boot
+    bool waitForConnection(uint32_t timeoutMs);   ///< Block the calling task until connected
+    AsyncWebServer& getServer();                  ///< Server other modules add their routes to
+    AssetCatalog& getAssets();                    ///< Web UI files, for modules serving their own page
 
 private:
-    bool led1State = false;
-    bool led2State = false;
     void connectToWiFi();
     void startAccessPoint();
+    void startFallbackAccessPoint();
+    void stopFallbackAccessPoint();
+    void attempt();
+    void scheduleRetry();
+    void refreshSignal();
+    void armTimer(int64_t delayUs);
+    static void timerCallback(void* arg);
+    static void taskEntry(void* param);
+    void onTimer();
+    void onWiFiEvent(WiFiEvent_t event);
     void handleRoot(AsyncWebServerRequest* request);
     void handleSetWiFi(AsyncWebServerRequest* request);
     void handleSaveWiFi(AsyncWebServerRequest* request);
@@ -82,10 +128,27 @@ private:
 
     ConfigManager* configManager;
     AsyncWebServer server;
+    AssetCatalog assets;              ///< Prebuilt gzip/ETag web UI files
     bool isAPMode;
     String apSSID;
     String apPassword;
     WiFiUDP ntpUDP;
+
+    // Connection state, written by the Wi-Fi event task and the timer
+    volatile WiFiState state;
+    volatile bool connected;          ///< Cached for isStillConnected()
+    volatile bool apFallback;         ///< Setup AP opened alongside the station
+    uint8_t failures;                 ///< Failed attempts since the last connection
+    uint32_t attempts;
+    int64_t retryAtUs;                ///< Start of the next attempt in WIFI_STATE_BACKOFF
+    esp_timer_handle_t timer;
+    TaskHandle_t task;                ///< Runs onTimer(), nullptr when the timer runs it inline
+    EventGroupHandle_t events;        ///< CONNECTED_BIT while the station has an IP
+    bool serverStarted;
+    uint8_t signalPercent;            ///< Cached getSignalStrengthPercent() value
+    int8_t signalRssi;                ///< Cached getRssi() value
+    uint32_t signalReadMs;            ///< millis() of the last RSSI read
+    portMUX_TYPE lock;                ///< Protects the state transitions
 };
 
 
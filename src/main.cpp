@@ -2,11 +2,23 @@
 #include "MRC522Manager.h"
 #include "ScreenManager.h"
 #include "WiFiManager.h"
+#include "BootSequencer.h"
+#include "TraceBuffer.h"
+#include "I2cLcdSink.h"
+#include "KeypadScanner.h"
+#include "ApiServer.h"
+#include "LiveStream.h"
+#include "MetricsServer.h"
+#include "RecordingManager.h"
+#include "GpioManager.h"
+#include "TaskTopology.h"
 #include <Wire.h>
 
 // Preferences object to store non-volatile data
 Preferences prefs;
-LiquidCrystal_I2C LCD(0x27, 20, 4);
+LiquidCrystal_I2C LCD(LCD_I2C_ADDRESS, LCD_COLUMNS, LCD_ROWS);
+I2cLcdSink lcdSink(&LCD);              // Counts the I2C traffic of the display
+LcdFrameBuffer lcdFrame(&lcdSink);     // Screens draw here, only changed cells reach the LCD
 
 // Manager instances for handling various functionalities
 ConfigManager* configManager = nullptr;
@@ -17,156 +29,134 @@ TimeManager* timeManager = nullptr;
 LogManager* Log = nullptr;
 MFRC522 rfid(RFID_SDA_PIN, RFID_RST_PIN);
 BuzzerManager* Buzz = nullptr;
+KeypadScanner* keypad = nullptr;
+ApiServer* api = nullptr;
+LiveStream* live = nullptr;
+MetricsServer* metrics = nullptr;
+RecordingManager* files = nullptr;
+GpioManager* gpio = nullptr;
 
-bool startAP = false;  // Flag to determine if Access Point (AP) page should be shown
+bool uiTaskRunning = false;  // The UI loop runs on its own task; loop() only serves the console
 
-// Define constants
-const unsigned long HOME_PAGE_INTERVAL = 60000;  // 60 seconds
-unsigned long previousMillis = 0;  // Store last time homepage was displayed
+BootSequencer boot;  // Runs the init stages and records their timings
+
+/**
+ * @brief UI task body: runs the screen event loop forever.
+ */
+static void uiTask(void* param) {
+    while (true) {
+        screenManager->poll();
+    }
+}
 
 /**
  * @brief Initializes the Arduino environment and application managers.
  * 
- * This setup function initializes various managers responsible for different
- * functionalities such as RFID, keypad, Wi-Fi, screen display, and time-related
- * operations. The function configures serial communication, instantiates manager
- * objects, and initializes them. The setup function also determines whether the
- * Access Point (AP) page or the homepage should be displayed.
+ * This setup function instantiates the managers responsible for RFID, keypad,
+ * Wi-Fi, screen display, logging and time, then hands their initialization to
+ * the BootSequencer. Independent peripherals (LCD on I2C, RFID on SPI, SPIFFS,
+ * buzzer) are brought up in parallel, and the Wi-Fi connection and first NTP
+ * sync run in the background so the UI is available before the network is.
+ * The UI, card reader and log writer then run on their own tasks, see
+ * TaskTopology.h.
  */
 void setup() {
+    TRACE_SCOPE("setup");
+
     // Initialize serial communication for debugging and logging
     Serial.begin(115200);
 
     // Initialize I2C with custom SDA and SCL pins
     Wire.begin(SDA_PIN, SCL_PIN);
+    Wire.setClock(LCD_I2C_CLOCK_HZ);  // The LCD is the only device on this bus
 
     // Open Preferences in read-write mode
     prefs.begin(CONFIG_PARTITION, false);  
 
-    // Instantiate and initialize configuration manager
-    configManager = new ConfigManager(&prefs);  // Manage device configurations
-    configManager->begin();
-
-    // Retrieve AP flag setting
-    startAP = configManager->GetAPFLag();      
+    Metrics.subscribe();  // Card taps are counted from the event bus
 
-    // Initialize Wi-Fi manager and start Wi-Fi connection process
+    // Instantiate the managers; constructors do not touch the hardware
+    configManager = new ConfigManager(&prefs);  // Manage device configurations
     wifiManager = new WiFiManager(configManager);  
-    wifiManager->begin();  // Start Wi-Fi manager
-
-    // Initialize time manager for handling time-related functions
     timeManager = new TimeManager(); 
-    timeManager->initialize();
-    Serial.println(timeManager->getTimeString());
-    Serial.println(timeManager->getDateString());
-
-    // Initialize Log manager for handling log-related functions
     Log = new LogManager();
-    Log->begin();
-
-    // Initialize buzzer manager for handling beep sounds
     Buzz = new BuzzerManager(BUZZ_PIN);
-    Buzz->begin();
-
-    // Initialize RFID manager for handling RFID card operations
-    SPI.begin(RFID_SCK_PIN, RFID_MISO_PIN, RFID_MOSI_PIN);  // Initialize SPI
-    rfid.PCD_Init();  // Initialize MFRC522
     rfidManager = new MRC522Manager(configManager, &rfid); 
-    rfidManager->begin();  // Start RFID manager
-
-    // Initialize screen manager to manage display screens and UI navigation
-    screenManager = new ScreenManager(wifiManager, Log, rfidManager, &LCD, Buzz); 
-    screenManager->begin();
-    
-    // Display AP page if the startAP flag is set
-    if (startAP) {
-       // screenManager->GotoApPage();
-    }
+    live = new LiveStream();  // SSE/WebSocket feed of card, transaction and lock events
+    screenManager = new ScreenManager(configManager, wifiManager, Log, rfidManager, &lcdFrame, Buzz); 
+    keypad = new KeypadScanner(screenManager->getEventQueue());  // Posts key events to the UI
+    api = new ApiServer(configManager, wifiManager, screenManager, Log);  // Serves /api/* from RAM
+    metrics = new MetricsServer(wifiManager, screenManager, &lcdFrame, keypad);  // Prometheus /metrics
+    files = new RecordingManager(&SPIFFS, &wifiManager->getAssets());    // List, download and delete SPIFFS files
+    gpio = new GpioManager(&wifiManager->getAssets());                   // Pin states pushed to gpiomanager.html
+
+    // Configuration first: every other stage depends on it
+    boot.addStage("config", []() { configManager->begin(); });
+
+    // Peripherals on separate buses come up together
+    boot.addStage("lcd", []() {
+        screenManager->begin();
+        lcdFrame.startTask();  // From now on the LCD is drawn off the UI task
+    }, BOOT_PARALLEL);
+    boot.addStage("rfid", []() {
+        SPI.begin(RFID_SCK_PIN, RFID_MISO_PIN, RFID_MOSI_PIN);  // Initialize SPI
+        rfid.PCD_Init();  // Initialize MFRC522
+        rfidManager->begin();  // Start RFID manager
+        screenManager->getCardPoller().start();  // Cards are polled on the RFID task from now on
+    }, BOOT_PARALLEL);
+    boot.addStage("spiffs", []() {
+        Log->begin();
+        Log->startTask();  // Log file entries are written on the log task from now on
+    }, BOOT_PARALLEL);
+    boot.addStage("buzzer", []() { Buzz->begin(); }, BOOT_PARALLEL);
+    boot.addStage("keypad", []() { keypad->begin(); }, BOOT_PARALLEL);
+
+    // Wi-Fi connection and the first NTP sync do not hold up the UI
+    boot.addStage("wifi", []() {
+        api->begin(wifiManager->getServer());
+        live->begin(wifiManager->getServer());
+        metrics->begin(wifiManager->getServer());
+        files->begin(wifiManager->getServer());
+        gpio->begin(wifiManager->getServer());
+        wifiManager->begin();  // Start Wi-Fi manager, connects in the background
+        wifiManager->waitForConnection(WIFI_CONNECT_TIMEOUT_MS);
+        timeManager->initialize();
+        timeManager->updateTime();
+        Serial.println(timeManager->getTimeString().c_str());
+        Serial.println(timeManager->getDateString().c_str());
+    }, BOOT_BACKGROUND);
+
+    boot.run();
+    boot.printReport();
+
+    // The device starts locked, on the security check; the UI switches to
+    // the access point page by itself while the setup AP is up
+    screenManager->lock(false);
+    uiTaskRunning = Tasks.start(TASK_UI, uiTask, nullptr);
 }
 
 /**
- * @brief Main loop that processes user input and navigates based on conditions.
+ * @brief Main loop: serves the serial console.
  * 
- * This loop constantly checks the status of the Wi-Fi connection and displays
- * the homepage or handles security check processes. If an RFID card is detected,
- * the system checks if it's a master or regular card, and navigates to the appropriate
- * page (e.g., master mode or recharge page). If the Wi-Fi is disconnected, the loop
- * will return to the Access Point (AP) page.
+ * Every page is a non-blocking screen driven by ScreenManager on the UI task;
+ * loop() only runs the UI event loop itself if that task could not be
+ * created. The UI runs whether or not Wi-Fi is connected.
  */
 void loop() {
-    lock:
-    // Perform initial security check on the screen if Wi-Fi is still connected
-    if (wifiManager->isStillConnected()) {
-        screenManager->SecurityCheck();
+    if (!uiTaskRunning) {
+        screenManager->poll();
     }
 
-    // Start of the loop
-    Start:
-    screenManager->clearScreen();  // Clear screen before the new process
-    unsigned long startTime = millis(); // Record the start time for timeout management
-
-    while (wifiManager->isStillConnected()) {
-        delay(10);  // Small delay to avoid overwhelming the system
-
-        // Check if the loop has been running for more than 1 minute (timeout)
-        if (millis() - startTime > LOCK_TIMEOUT) {
-            screenManager->clearScreen();
-            screenManager->displayCenteredText("Timeout", 1);
-            screenManager->displayCenteredText("Locking the device", 2);
-            screenManager->displayCenteredText("...", 3);
-            delay(2000);
-            screenManager->clearScreen();
-            goto lock; // Exit the loop after timeout
-        }
-
-        // Check if the RFID card is master card
-        rfidManager->IsMasterCard();
-
-        if (rfidManager->cardStatusRead == 6) {
-            // Authentication failed, invalid card
-            Buzz->playFailureTone();
-            screenManager->clearScreen();
-            screenManager->displayCenteredText("SECURITY CHECK", 0);
-            screenManager->displayCenteredText(">   INVALID CARD!  <", 2);
-            screenManager->displayCenteredText("____________________", 3);
-            delay(3000);
-            goto Start;  // Restart the process
-        }
-
-        if (rfidManager->cardStatusRead == 0) goto in;
-
-        // Display the homepage with device manager name
-        screenManager->HomePage(DEFAULT_DEV_MANAGER_NAME);
-
-        in:
-        if (rfidManager->cardStatusRead == 0) {
-            screenManager->clearScreen();
-            char choice = screenManager->SelectAction();
-            Serial.println("The User choice is :");
-            Serial.print(choice);
-            Serial.println();
-
-            if (choice == '1') {
-                // Recharge page if choice is '1'
-                screenManager->clearScreen();
-                screenManager->RechargePage();
-                rfidManager->resetRFID();
-                goto Start;  // Restart the process
-            } else if (choice == '2') {
-                // User mode if choice is '2'
-                screenManager->clearScreen();
-                screenManager->UserMode();
-                rfidManager->resetRFID();
-                goto Start;  // Restart the process
-            } else if (choice == '*') {
-                // Reset RFID and return to the start if '*' is pressed
-                rfidManager->resetRFID();
-                goto Start;  // Restart the process
-            }
+    while (Serial.available() > 0) {
+        int command = Serial.read();
+        // 'T' dumps the trace buffer, 'C' clears it, 'U' prints the CPU usage of the
+        // tasks and of the keypad scan timer
+        if (!Trace.handleCommand(command) && Tasks.handleCommand(command)) {
+            keypad->printReport(Serial);
         }
     }
 
-    // If Wi-Fi is disconnected, navigate back to the AP page
-    //screenManager->GotoApPage();
-    goto Start;  // Go back to the start label or handle AP mode in your logic
+    if (uiTaskRunning) {
+        vTaskDelay(pdMS_TO_TICKS(CONSOLE_POLL_MS));
+    }
 }
@@ -0,0 +1,113 @@
+"""
+Builds the SPIFFS image content of the web UI from data/.
+
+Text assets (HTML, CSS, JS, JSON, SVG) are minified conservatively (comments
+and indentation removed, line breaks kept so inline scripts are unaffected)
+and gzip-compressed; only the .gz file is written, the web server adds
+`Content-Encoding: gzip` when it serves it. Other files (PNG icons) are
+copied as is. Every asset gets a content hash used as its strong ETag.
+
+The list is written to /assets.idx, read by AssetCatalog at boot:
+    <path> <etag> <g|->
+one line per asset, 'g' when the stored file is the .gz.
+
+Used as a PlatformIO pre-script (platformio.ini: extra_scripts), it rebuilds
+the output before every build, so `pio run -t uploadfs` always uploads the
+current assets. It can also be run by hand (from the project root):
+    python test/build_assets.py [-i data] [-o .pio/www]
+"""
+import argparse
+import gzip
+import hashlib
+import os
+import re
+import shutil
+
+COMPRESSIBLE = ('.html', '.htm', '.css', '.js', '.json', '.svg', '.txt')
+SPIFFS_NAME_MAX = 31    # Longest SPIFFS path, without the terminating zero
+INDEX_NAME = 'assets.idx'
+ETAG_LENGTH = 16        # Hex digits of the SHA-256 kept in the ETag
+
+
+def minify(name, text):
+    """Strips comments and indentation; keeps one statement per line."""
+    if name.endswith(('.html', '.htm', '.svg')):
+        text = re.sub(r'<!--.*?-->', '', text, flags=re.S)
+    if name.endswith('.css'):
+        text = re.sub(r'/\*.*?\*/', '', text, flags=re.S)
+    if name.endswith('.json'):
+        return re.sub(r'\s*\n\s*', '', text)
+    lines = (line.strip() for line in text.splitlines())
+    return '\n'.join(line for line in lines if line)
+
+
+def build_asset(source, relative, output):
+    """Writes one asset to output, returns (spiffs path, etag, gzipped)."""
+    with open(source, 'rb') as f:
+        content = f.read()
+
+    gzipped = False
+    if relative.lower().endswith(COMPRESSIBLE):
+        text = minify(relative.lower(), content.decode('utf-8'))
+        # mtime=0 keeps the archive, hence the ETag, identical across builds
+        packed = gzip.compress(text.encode('utf-8'), compresslevel=9, mtime=0)
+        if len(packed) < len(content):
+            content, gzipped = packed, True
+
+    path = '/' + relative.replace(os.sep, '/')
+    stored = path + '.gz' if gzipped else path
+    if len(stored) > SPIFFS_NAME_MAX:
+        raise SystemExit("%s: name longer than %d characters once stored" % (stored, SPIFFS_NAME_MAX))
+
+    target = os.path.join(output, stored.lstrip('/'))
+    os.makedirs(os.path.dirname(target), exist_ok=True)
+    with open(target, 'wb') as f:
+        f.write(content)
+
+    etag = hashlib.sha256(content).hexdigest()[:ETAG_LENGTH]
+    return path, etag, gzipped, len(content)
+
+
+def build(source_dir, output_dir, verbose=True):
+    if os.path.isdir(output_dir):
+        shutil.rmtree(output_dir)
+    os.makedirs(output_dir)
+
+    entries = []
+    total_in = total_out = 0
+    for root, _, files in os.walk(source_dir):
+        for name in sorted(files):
+            source = os.path.join(root, name)
+            relative = os.path.relpath(source, source_dir)
+            path, etag, gzipped, size = build_asset(source, relative, output_dir)
+            entries.append((path, etag, gzipped))
+            total_in += os.path.getsize(source)
+            total_out += size
+
+    entries.sort()
+    with open(os.path.join(output_dir, INDEX_NAME), 'w') as f:
+        for path, etag, gzipped in entries:
+            f.write("%s %s %s\n" % (path, etag, 'g' if gzipped else '-'))
+
+    if verbose:
+        print("Assets: %d files, %d -> %d bytes in %s" % (len(entries), total_in, total_out, output_dir))
+    return entries
+
+
+def main():
+    root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+    parser = argparse.ArgumentParser(description="Minify, gzip and hash the web UI assets")
+    parser.add_argument('-i', '--input', default=os.path.join(root, 'data'))
+    parser.add_argument('-o', '--output', default=os.path.join(root, '.pio', 'www'))
+    args = parser.parse_args()
+    build(args.input, args.output)
+
+
+try:
+    Import("env")  # noqa: F821 - defined when run by PlatformIO
+except NameError:
+    if __name__ == '__main__':
+        main()
+else:
+    project = env.subst("$PROJECT_DIR")  # noqa: F821
+    build(os.path.join(project, 'data'), env.subst("$PROJECT_DATA_DIR"))  # noqa: F821
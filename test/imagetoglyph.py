@@ -0,0 +1,176 @@
+"""
+Generates src/LcdGlyphs.h, the 5x8 custom character table loaded into the
+LCD's CGRAM by GlyphManager.
+
+Like imagetoarray.py, icons are drawn from PNG files: the alpha channel is
+sampled and opaque pixels become lit dots. Unlike it, each glyph row is its
+own byte (bits 4-0 = columns 0-4), the layout the HD44780 expects. Icons that
+belong together (the Wi-Fi levels) are cropped to a shared frame so they keep
+their relative size. Glyphs too small to draw as a PNG are written as 5x8
+ASCII art below ('#' lit, '.' off).
+
+Usage (from the project root):
+    python test/imagetoglyph.py [-o src/LcdGlyphs.h] [--preview]
+"""
+import argparse
+import os
+
+from PIL import Image
+
+GLYPH_WIDTH = 5
+GLYPH_HEIGHT = 8
+ICON_HEIGHT = 7        # The bottom row is left blank, it is the cursor line
+ALPHA_THRESHOLD = 60   # Average alpha of a dot's area above which it is lit
+
+# Wi-Fi level icons, weakest first, sharing the frame of the largest one
+WIFI_ICONS = [
+    ("GLYPH_WIFI_0", "wifiICO/wifi0.png"),
+    ("GLYPH_WIFI_1", "wifiICO/wifi1png.png"),
+    ("GLYPH_WIFI_2", "wifiICO/wifi2png.png"),
+    ("GLYPH_WIFI_MAX", "wifiICO/wifiMax.png"),
+]
+
+# Cells of a horizontal bar graph, 1 to 5 columns lit
+BAR_GLYPHS = [("GLYPH_BAR_%d" % n, n) for n in range(1, GLYPH_WIDTH + 1)]
+
+ART_GLYPHS = [
+    ("GLYPH_LOCK", [
+        ".###.",
+        "#...#",
+        "#...#",
+        "#####",
+        "##.##",
+        "##.##",
+        "#####",
+        ".....",
+    ]),
+    ("GLYPH_CARD", [
+        ".....",
+        "#####",
+        "#...#",
+        "#.#.#",
+        "#...#",
+        "#####",
+        ".....",
+        ".....",
+    ]),
+    ("GLYPH_CHECK", [
+        ".....",
+        "....#",
+        "...##",
+        "#.##.",
+        "###..",
+        ".#...",
+        ".....",
+        ".....",
+    ]),
+    ("GLYPH_CROSS", [
+        ".....",
+        "#...#",
+        ".#.#.",
+        "..#..",
+        ".#.#.",
+        "#...#",
+        ".....",
+        ".....",
+    ]),
+]
+
+
+def shared_frame(paths):
+    """Union of the opaque bounding boxes of several images."""
+    boxes = [Image.open(path).convert('RGBA').split()[3].getbbox() for path in paths]
+    return (min(b[0] for b in boxes), min(b[1] for b in boxes),
+            max(b[2] for b in boxes), max(b[3] for b in boxes))
+
+
+def image_to_glyph_rows(image_path, frame):
+    """Samples the alpha channel of an image into GLYPH_HEIGHT row bytes."""
+    alpha = Image.open(image_path).convert('RGBA').split()[3].crop(frame)
+    alpha = alpha.resize((GLYPH_WIDTH, ICON_HEIGHT), Image.BOX)
+
+    rows = []
+    for y in range(ICON_HEIGHT):
+        row = 0
+        for x in range(GLYPH_WIDTH):
+            row = (row << 1) | (1 if alpha.getpixel((x, y)) >= ALPHA_THRESHOLD else 0)
+        rows.append(row)
+    return rows + [0] * (GLYPH_HEIGHT - ICON_HEIGHT)
+
+
+def bar_rows(columns):
+    """Cell with its first `columns` columns lit, rows 1-6."""
+    row = ((1 << columns) - 1) << (GLYPH_WIDTH - columns)
+    return [0] + [row] * (GLYPH_HEIGHT - 2) + [0]
+
+
+def art_rows(art):
+    assert len(art) == GLYPH_HEIGHT and all(len(line) == GLYPH_WIDTH for line in art)
+    return [int(line.replace('#', '1').replace('.', '0'), 2) for line in art]
+
+
+def build_glyphs(root):
+    glyphs = []
+    paths = [os.path.join(root, path) for _, path in WIFI_ICONS]
+    frame = shared_frame(paths)
+    for (name, _), path in zip(WIFI_ICONS, paths):
+        glyphs.append((name, image_to_glyph_rows(path, frame)))
+    for name, columns in BAR_GLYPHS:
+        glyphs.append((name, bar_rows(columns)))
+    for name, art in ART_GLYPHS:
+        glyphs.append((name, art_rows(art)))
+    return glyphs
+
+
+def render_header(glyphs):
+    out = []
+    out.append("#ifndef LCDGLYPHS_H")
+    out.append("#define LCDGLYPHS_H")
+    out.append("/**")
+    out.append(" * @file LcdGlyphs.h")
+    out.append(" * @brief 5x8 custom character patterns for the LCD's CGRAM.")
+    out.append(" *")
+    out.append(" * Generated by test/imagetoglyph.py, do not edit by hand.")
+    out.append(" */")
+    out.append("")
+    out.append("#include <Arduino.h>")
+    out.append("")
+    out.append("enum LcdGlyphId : uint8_t {")
+    for name, _ in glyphs:
+        out.append("    %s," % name)
+    out.append("    GLYPH_COUNT")
+    out.append("};")
+    out.append("")
+    out.append("static const uint8_t LCD_GLYPHS[GLYPH_COUNT][8] PROGMEM = {")
+    for name, rows in glyphs:
+        out.append("    {%s},  // %s" % (', '.join('0x%02x' % row for row in rows), name))
+    out.append("};")
+    out.append("")
+    out.append("#endif // LCDGLYPHS_H")
+    return '\n'.join(out) + '\n'
+
+
+def preview(glyphs):
+    for name, rows in glyphs:
+        print(name)
+        for row in rows:
+            print('  ' + ''.join('#' if row & (1 << (GLYPH_WIDTH - 1 - x)) else '.' for x in range(GLYPH_WIDTH)))
+
+
+def main():
+    root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+    parser = argparse.ArgumentParser(description="Generate the LCD custom glyph table")
+    parser.add_argument('-o', '--output', default=os.path.join(root, 'src', 'LcdGlyphs.h'))
+    parser.add_argument('--preview', action='store_true', help="print the glyphs as ASCII art")
+    args = parser.parse_args()
+
+    glyphs = build_glyphs(root)
+    if args.preview:
+        preview(glyphs)
+    with open(args.output, 'w') as f:
+        f.write(render_header(glyphs))
+    print("Wrote %d glyphs to %s" % (len(glyphs), args.output))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,83 @@
+/**
+ * @file test_main.cpp
+ * @brief GET /api/config on the booted firmware: the configuration is
+ * listed without the credentials.
+ *
+ * Run with `pio test -e native -f test_api_config`.
+ */
+
+#include <unity.h>
+#include <ESPAsyncWebServer.h>
+#include "ApiServer.h"
+#include "Simulator.h"
+
+static const char WIFI_PASSWORD[] = "k7#TopSecret";
+static const char MASTER_CARD[] = "a1:b2:c3:d4";
+
+static Simulator simulator;
+static AsyncWebServer server(80);
+static ApiServer* api;
+static String body;
+
+/**
+ * @brief Requests a route and keeps the response body.
+ *
+ * @return The HTTP status.
+ */
+static int get(const char* url) {
+    AsyncWebServerRequest request(HTTP_GET, url);
+    server.handle(&request);
+    const AsyncWebServerResponse* response = request.getResponse();
+    TEST_ASSERT_NOT_NULL(response);
+    body = response->body();
+    return response->code();
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_config_lists_the_visible_settings() {
+    TEST_ASSERT_EQUAL_INT(200, get("/api/config"));
+    TEST_ASSERT_NOT_NULL(strstr(body.c_str(), "\"DeviceName\":\"" DEFAULT_DEVICE_NAME "\""));
+    TEST_ASSERT_NOT_NULL(strstr(body.c_str(), "\"WifiSsid\""));
+    TEST_ASSERT_NOT_NULL(strstr(body.c_str(), "\"LockTimeout\""));
+}
+
+void test_config_leaves_out_the_wifi_password() {
+    TEST_ASSERT_EQUAL_INT(200, get("/api/config"));
+    TEST_ASSERT_NULL(strstr(body.c_str(), "WifiPass"));
+    TEST_ASSERT_NULL(strstr(body.c_str(), WIFI_PASSWORD));
+}
+
+void test_config_leaves_out_the_master_card() {
+    TEST_ASSERT_EQUAL_INT(200, get("/api/config"));
+    TEST_ASSERT_NULL(strstr(body.c_str(), "MasterCardId"));
+    TEST_ASSERT_NULL(strstr(body.c_str(), MASTER_CARD));
+}
+
+void test_response_slot_is_released_on_disconnect() {
+    for (uint8_t i = 0; i < API_RESPONSE_SLOTS + 2; i++) {
+        TEST_ASSERT_EQUAL_INT(200, get("/api/config"));
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, api->getStats().busy);
+}
+
+int main(int argc, char** argv) {
+    HostHal::setSerialOutput(nullptr);
+    setenv("TZ", "UTC", 1);
+    simulator.begin();
+    ConfigManager* config = simulator.getConfig();
+    config->SetWifiPass(WIFI_PASSWORD);
+    config->SetMasterCardId(MASTER_CARD);
+
+    ScreenManager* screens = simulator.getScreens();
+    api = new ApiServer(config, screens->getWiFi(), screens, screens->getLog());
+    api->begin(server);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_config_lists_the_visible_settings);
+    RUN_TEST(test_config_leaves_out_the_wifi_password);
+    RUN_TEST(test_config_leaves_out_the_master_card);
+    RUN_TEST(test_response_slot_is_released_on_disconnect);
+    return UNITY_END();
+}
@@ -0,0 +1,172 @@
+/**
+ * @file test_main.cpp
+ * @brief CounterStore journal recovery on a RAM flash region: reboots, failed
+ * and torn record writes, torn sector headers.
+ *
+ * Run with `pio test -e native -f test_counter_store`.
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "CounterStore.h"
+
+/**
+ * @brief RAM flash region that can fail or tear the next program operation.
+ *
+ * Programming only clears bits like NOR flash. A failed write programs
+ * nothing, a torn write programs the first half of the bytes; both report
+ * failure as esp_partition_write() would on a brown-out.
+ */
+class RamFlash : public CounterFlash {
+public:
+    enum Fault { NONE, FAIL, TEAR };
+
+    explicit RamFlash(size_t sectors) : length(sectors * CounterStore::SECTOR_SIZE), fault(NONE) {
+        memset(bytes, 0xFF, sizeof(bytes));
+    }
+
+    size_t size() const override { return length; }
+
+    bool read(size_t offset, void* dst, size_t len) override {
+        if (offset + len > length) return false;
+        memcpy(dst, bytes + offset, len);
+        return true;
+    }
+
+    bool write(size_t offset, const void* src, size_t len) override {
+        if (offset + len > length) return false;
+        Fault current = fault;
+        fault = NONE;
+        if (current == FAIL) return false;
+        size_t programmed = current == TEAR ? len / 2 : len;
+        const uint8_t* data = static_cast<const uint8_t*>(src);
+        for (size_t i = 0; i < programmed; i++) bytes[offset + i] &= data[i];
+        return current == NONE;
+    }
+
+    bool eraseSector(size_t offset) override {
+        if (offset + CounterStore::SECTOR_SIZE > length) return false;
+        memset(bytes + offset, 0xFF, CounterStore::SECTOR_SIZE);
+        return true;
+    }
+
+    void failNextWrite() { fault = FAIL; }
+    void tearNextWrite() { fault = TEAR; }
+
+private:
+    uint8_t bytes[4 * CounterStore::SECTOR_SIZE];
+    size_t length;
+    Fault fault;
+};
+
+static const size_t SECTORS = 4;
+static const size_t RECORDS_PER_SECTOR = (CounterStore::SECTOR_SIZE - 32) / 16;
+
+/**
+ * @brief Recovers the counter as a reboot would, on a fresh CounterStore.
+ */
+static int64_t reboot(RamFlash& flash) {
+    CounterStore store(&flash);
+    TEST_ASSERT_TRUE(store.begin(0));
+    return store.getValue();
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_empty_region_starts_at_seed() {
+    RamFlash flash(SECTORS);
+    CounterStore store(&flash);
+    TEST_ASSERT_TRUE(store.begin(250));
+    TEST_ASSERT_EQUAL_INT64(250, store.getValue());
+    TEST_ASSERT_EQUAL_INT64(250, reboot(flash));
+}
+
+void test_records_survive_reboot() {
+    RamFlash flash(SECTORS);
+    CounterStore store(&flash);
+    TEST_ASSERT_TRUE(store.begin(100));
+    TEST_ASSERT_TRUE(store.add(50));
+    TEST_ASSERT_TRUE(store.add(-30));
+    TEST_ASSERT_EQUAL_INT64(120, store.getValue());
+    TEST_ASSERT_EQUAL_INT64(120, reboot(flash));
+}
+
+void test_failed_write_does_not_hide_later_records() {
+    RamFlash flash(SECTORS);
+    CounterStore store(&flash);
+    TEST_ASSERT_TRUE(store.begin(0));
+    TEST_ASSERT_TRUE(store.add(10));
+
+    flash.failNextWrite();
+    TEST_ASSERT_FALSE(store.add(1000));  // Leaves an erased slot behind
+    TEST_ASSERT_EQUAL_INT64(10, store.getValue());
+
+    TEST_ASSERT_TRUE(store.add(20));
+    TEST_ASSERT_TRUE(store.add(30));
+    TEST_ASSERT_EQUAL_INT64(60, reboot(flash));
+}
+
+void test_torn_write_is_skipped() {
+    RamFlash flash(SECTORS);
+    CounterStore store(&flash);
+    TEST_ASSERT_TRUE(store.begin(0));
+    TEST_ASSERT_TRUE(store.add(10));
+
+    flash.tearNextWrite();
+    TEST_ASSERT_FALSE(store.add(1000));  // Half-programmed slot, bad CRC
+    TEST_ASSERT_TRUE(store.add(5));
+    TEST_ASSERT_EQUAL_INT64(15, reboot(flash));
+}
+
+void test_power_loss_after_torn_write_keeps_appending() {
+    RamFlash flash(SECTORS);
+    {
+        CounterStore store(&flash);
+        TEST_ASSERT_TRUE(store.begin(0));
+        TEST_ASSERT_TRUE(store.add(7));
+        flash.tearNextWrite();
+        TEST_ASSERT_FALSE(store.add(1000));  // Power lost here
+    }
+
+    CounterStore store(&flash);
+    TEST_ASSERT_TRUE(store.begin(0));
+    TEST_ASSERT_EQUAL_INT64(7, store.getValue());
+    TEST_ASSERT_TRUE(store.add(3));          // Must not reuse the torn slot
+    TEST_ASSERT_EQUAL_INT64(10, reboot(flash));
+}
+
+void test_sector_roll_keeps_value() {
+    RamFlash flash(SECTORS);
+    CounterStore store(&flash);
+    TEST_ASSERT_TRUE(store.begin(0));
+    const size_t count = RECORDS_PER_SECTOR * 2 + 3;
+    for (size_t i = 0; i < count; i++) {
+        TEST_ASSERT_TRUE(store.add(1));
+    }
+    TEST_ASSERT_EQUAL_INT64((int64_t)count, store.getValue());
+    TEST_ASSERT_EQUAL_INT64((int64_t)count, reboot(flash));
+}
+
+void test_torn_header_falls_back_to_previous_sector() {
+    RamFlash flash(SECTORS);
+    CounterStore store(&flash);
+    TEST_ASSERT_TRUE(store.begin(0));
+    TEST_ASSERT_TRUE(store.add(40));
+
+    flash.tearNextWrite();
+    TEST_ASSERT_FALSE(store.reset(999));     // Power lost while opening the next sector
+    TEST_ASSERT_EQUAL_INT64(40, reboot(flash));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_empty_region_starts_at_seed);
+    RUN_TEST(test_records_survive_reboot);
+    RUN_TEST(test_failed_write_does_not_hide_later_records);
+    RUN_TEST(test_torn_write_is_skipped);
+    RUN_TEST(test_power_loss_after_torn_write_keeps_appending);
+    RUN_TEST(test_sector_roll_keeps_value);
+    RUN_TEST(test_torn_header_falls_back_to_previous_sector);
+    return UNITY_END();
+}
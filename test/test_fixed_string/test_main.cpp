@@ -0,0 +1,113 @@
+/**
+ * @file test_main.cpp
+ * @brief FixedString at and past its capacity: appends, formatting, hex
+ * UIDs and trimming keep the text terminated and flag truncation.
+ *
+ * Run with `pio test -e native -f test_fixed_string`.
+ */
+
+#include <unity.h>
+#include "FixedString.h"
+
+void setUp() {}
+void tearDown() {}
+
+void test_append_fills_to_capacity_exactly() {
+    FixedString<8> text("abcd");
+    text.append("efgh");
+    TEST_ASSERT_EQUAL_STRING("abcdefgh", text.c_str());
+    TEST_ASSERT_EQUAL_UINT(8, text.length());
+    TEST_ASSERT_FALSE(text.truncated());
+}
+
+void test_append_past_capacity_is_cut_and_flagged() {
+    FixedString<8> text("abcdef");
+    text.append("ghij");
+    TEST_ASSERT_EQUAL_STRING("abcdefgh", text.c_str());
+    TEST_ASSERT_EQUAL_UINT(8, text.length());
+    TEST_ASSERT_TRUE(text.truncated());
+
+    text += 'z';   // Full: nothing more fits
+    TEST_ASSERT_EQUAL_STRING("abcdefgh", text.c_str());
+
+    text.clear();
+    TEST_ASSERT_FALSE(text.truncated());
+    TEST_ASSERT_TRUE(text.isEmpty());
+}
+
+void test_append_count_stops_at_terminator() {
+    const char block[16] = {'N', 'A', 'M', 'E', '\0', 'x', 'x', 'x'};
+    FixedString<16> text;
+    text.append(block, sizeof(block));
+    TEST_ASSERT_EQUAL_STRING("NAME", text.c_str());
+
+    const char unterminated[4] = {'1', '2', '3', '4'};
+    text.append(unterminated, sizeof(unterminated));
+    TEST_ASSERT_EQUAL_STRING("NAME1234", text.c_str());
+    TEST_ASSERT_FALSE(text.truncated());
+}
+
+void test_append_hex_formats_a_uid() {
+    const uint8_t uid[] = {0xd3, 0x73, 0xfd, 0xe3};
+    FixedString<16> text;
+    text.appendHex(uid, sizeof(uid));
+    TEST_ASSERT_EQUAL_STRING("d3:73:fd:e3", text.c_str());
+
+    text.clear();
+    text.appendHex(uid, sizeof(uid), '\0');
+    TEST_ASSERT_EQUAL_STRING("d373fde3", text.c_str());
+}
+
+void test_append_hex_past_capacity_is_cut() {
+    const uint8_t uid[] = {0x04, 0xa1, 0xb2, 0xc3, 0xd4, 0xe5, 0xf6};
+    FixedString<11> text;
+    text.appendHex(uid, sizeof(uid));
+    TEST_ASSERT_EQUAL_STRING("04:a1:b2:c3", text.c_str());
+    TEST_ASSERT_TRUE(text.truncated());
+}
+
+void test_appendf_overflow_keeps_the_fitting_prefix() {
+    FixedString<10> text("id=");
+    text.appendf("%lu/%s", 4294967295UL, "units");
+    TEST_ASSERT_EQUAL_STRING("id=4294967", text.c_str());
+    TEST_ASSERT_EQUAL_UINT(10, text.length());
+    TEST_ASSERT_TRUE(text.truncated());
+
+    text.format("%u", 42u);   // Replaces the text and the flag
+    TEST_ASSERT_EQUAL_STRING("42", text.c_str());
+    TEST_ASSERT_FALSE(text.truncated());
+}
+
+void test_trim_removes_outer_whitespace_only() {
+    FixedString<16> text("  12 34\t\n");
+    text.trim();
+    TEST_ASSERT_EQUAL_STRING("12 34", text.c_str());
+    TEST_ASSERT_EQUAL_UINT(5, text.length());
+
+    text = " \t ";
+    text.trim();
+    TEST_ASSERT_TRUE(text.isEmpty());
+    TEST_ASSERT_EQUAL_STRING("", text.c_str());
+}
+
+void test_index_past_the_end_reads_terminator() {
+    FixedString<4> text("ab");
+    TEST_ASSERT_EQUAL_INT('b', text[1]);
+    TEST_ASSERT_EQUAL_INT('\0', text[2]);
+    TEST_ASSERT_EQUAL_INT('\0', text[10]);
+    TEST_ASSERT_TRUE(text.equals("ab"));
+    TEST_ASSERT_TRUE(text.equalsIgnoreCase("AB"));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_append_fills_to_capacity_exactly);
+    RUN_TEST(test_append_past_capacity_is_cut_and_flagged);
+    RUN_TEST(test_append_count_stops_at_terminator);
+    RUN_TEST(test_append_hex_formats_a_uid);
+    RUN_TEST(test_append_hex_past_capacity_is_cut);
+    RUN_TEST(test_appendf_overflow_keeps_the_fitting_prefix);
+    RUN_TEST(test_trim_removes_outer_whitespace_only);
+    RUN_TEST(test_index_past_the_end_reads_terminator);
+    return UNITY_END();
+}
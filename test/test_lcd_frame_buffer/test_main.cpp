@@ -0,0 +1,114 @@
+/**
+ * @file test_main.cpp
+ * @brief LcdFrameBuffer diff rendering, measured in bus bytes on HostLcdSink.
+ *
+ * HostLcdSink counts 4 expander bytes per character or command like
+ * I2cLcdSink, so a cursor move plus one character costs 8 bytes.
+ *
+ * Run with `pio test -e native -f test_lcd_frame_buffer`.
+ */
+
+#include <unity.h>
+#include "LcdFrameBuffer.h"
+#include "HostLcdSink.h"
+
+static const uint32_t BYTES_PER_WRITE = 4;
+
+static HostLcdSink* sink;
+static LcdFrameBuffer* lcd;
+
+/**
+ * @brief Bus bytes sent by one flush.
+ */
+static uint32_t flushBytes() {
+    uint32_t before = sink->getBusBytes();
+    lcd->flush();
+    return sink->getBusBytes() - before;
+}
+
+static void drawHome() {
+    lcd->clear();
+    lcd->setCursor(0, 0);
+    lcd->print("HOME           05:30");
+    lcd->setCursor(0, 1);
+    lcd->print("Tap your card");
+}
+
+void setUp() {
+    sink = new HostLcdSink();
+    lcd = new LcdFrameBuffer(sink);
+    lcd->begin();
+    flushBytes();   // Loads the eight CGRAM slots once
+}
+
+void tearDown() {
+    delete lcd;
+    delete sink;
+}
+
+void test_first_draw_sends_only_text() {
+    drawHome();
+    // Blank cells already match the display: runs "HOME", "05:30" and
+    // "Tap your card" (single spaces bridged), one cursor move each
+    TEST_ASSERT_EQUAL_UINT32((4 + 5 + 13 + 3) * BYTES_PER_WRITE, flushBytes());
+    char row[LCD_COLUMNS + 1];
+    TEST_ASSERT_EQUAL_STRING("Tap your card       ", sink->getRow(1, row, sizeof(row)));
+}
+
+void test_unchanged_redraw_sends_nothing() {
+    drawHome();
+    flushBytes();
+    drawHome();
+    TEST_ASSERT_EQUAL_UINT32(0, flushBytes());
+    TEST_ASSERT_EQUAL_UINT32(0, flushBytes());
+}
+
+void test_single_cell_change_sends_one_move_and_one_char() {
+    drawHome();
+    flushBytes();
+    drawHome();
+    lcd->setCursor(19, 0);
+    lcd->print('1');   // 05:30 -> 05:31
+    TEST_ASSERT_EQUAL_UINT32(2 * BYTES_PER_WRITE, flushBytes());
+    char row[LCD_COLUMNS + 1];
+    TEST_ASSERT_EQUAL_STRING("HOME           05:31", sink->getRow(0, row, sizeof(row)));
+}
+
+void test_one_cell_gap_is_bridged() {
+    drawHome();
+    flushBytes();
+    drawHome();
+    lcd->setCursor(15, 0);
+    lcd->print("1");
+    lcd->setCursor(17, 0);
+    lcd->print("4");   // 05:30 -> 15:40, the ':' between is resent
+    TEST_ASSERT_EQUAL_UINT32((1 + 3) * BYTES_PER_WRITE, flushBytes());
+}
+
+void test_invalidate_resends_every_cell() {
+    drawHome();
+    flushBytes();
+    lcd->invalidate();
+    uint32_t bytes = flushBytes();
+    TEST_ASSERT_GREATER_THAN(LCD_COLUMNS * LCD_ROWS * BYTES_PER_WRITE - 1, bytes);
+}
+
+void test_unchanged_glyph_is_not_reloaded() {
+    const uint8_t bars[LcdFrameBuffer::GLYPH_ROWS] = {0, 0, 0, 0, 0, 0, 0, 0x1F};
+    lcd->defineGlyph(2, bars);
+    uint32_t first = flushBytes();
+    TEST_ASSERT_EQUAL_UINT32((1 + LcdFrameBuffer::GLYPH_ROWS) * BYTES_PER_WRITE, first);
+    lcd->defineGlyph(2, bars);
+    TEST_ASSERT_EQUAL_UINT32(0, flushBytes());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_first_draw_sends_only_text);
+    RUN_TEST(test_unchanged_redraw_sends_nothing);
+    RUN_TEST(test_single_cell_change_sends_one_move_and_one_char);
+    RUN_TEST(test_one_cell_gap_is_bridged);
+    RUN_TEST(test_invalidate_resends_every_cell);
+    RUN_TEST(test_unchanged_glyph_is_not_reloaded);
+    return UNITY_END();
+}
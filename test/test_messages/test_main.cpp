@@ -0,0 +1,78 @@
+/**
+ * @file test_main.cpp
+ * @brief Formatted catalog messages at their widest values, and the recharge
+ * result screen of a card reaching the largest balance.
+ *
+ * Run with `pio test -e native -f test_messages`.
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include "Messages.h"
+#include "Simulator.h"
+
+static Simulator simulator;
+
+static const unsigned long MAX_BALANCE = 4294967295UL;   ///< UINT32_MAX, the card balance type
+
+void setUp() {}
+void tearDown() {}
+
+/**
+ * @brief Formats a balance without clipping and checks it fits one row.
+ */
+static void assertFitsRow(MessageId id, unsigned long value) {
+    char text[64];
+    char digits[16];
+    int length = snprintf(text, sizeof(text), msg(id), value);
+    snprintf(digits, sizeof(digits), "%lu", value);
+    TEST_ASSERT_LESS_OR_EQUAL(LCD_COLUMNS, length);
+    TEST_ASSERT_NOT_NULL(strstr(text, digits));
+}
+
+void test_balance_formats_fit_a_row_at_the_largest_balance() {
+    assertFitsRow(MSG_FMT_HOLD_BALANCE, MAX_BALANCE);
+    assertFitsRow(MSG_FMT_NEW_BALANCE, MAX_BALANCE);
+    assertFitsRow(MSG_FMT_UNITS, MAX_BALANCE);
+}
+
+void test_message_width_counts_lu_at_ten_digits() {
+    TEST_ASSERT_EQUAL_UINT(10, messageWidth("%lu"));
+    TEST_ASSERT_EQUAL_UINT(16, messageWidth("%lu Units"));
+    TEST_ASSERT_EQUAL_UINT(14, messageWidth("NEW NUMBER 0%u"));
+}
+
+void test_recharge_to_the_largest_balance_shows_every_digit() {
+    simulator.execute("card big 04:0b:16:21 balance 4294967195");
+    TEST_ASSERT_TRUE(simulator.execute("tap master"));
+    simulator.wait(300);
+    simulator.execute("remove");
+    simulator.wait(300);
+
+    simulator.execute("tap big");
+    simulator.wait(500);
+    simulator.pressKey('1');    // Recharge
+    simulator.wait(300);
+    simulator.pressKey('1');    // 100 units
+    simulator.wait(300);
+    simulator.pressKey('#');
+    simulator.wait(1000);
+
+    TEST_ASSERT_TRUE(simulator.rowContains(1, msg(MSG_RECHARGE_SUCCEEDED)));
+    TEST_ASSERT_TRUE(simulator.rowContains(2, "4294967195"));
+    TEST_ASSERT_TRUE(simulator.rowContains(3, "4294967295"));
+    simulator.execute("remove");
+}
+
+int main(int argc, char** argv) {
+    HostHal::setSerialOutput(nullptr);
+    setenv("TZ", "UTC", 1);
+    simulator.begin();
+    simulator.execute("card master d3:73:fd:e3");
+
+    UNITY_BEGIN();
+    RUN_TEST(test_balance_formats_fit_a_row_at_the_largest_balance);
+    RUN_TEST(test_message_width_counts_lu_at_ten_digits);
+    RUN_TEST(test_recharge_to_the_largest_balance_shows_every_digit);
+    return UNITY_END();
+}
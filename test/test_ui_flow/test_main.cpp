@@ -0,0 +1,206 @@
+/**
+ * @file test_main.cpp
+ * @brief Screen stack navigation, driven through the simulator like the
+ * host scripts: cards on the reader, keys on the pad, the setup access point.
+ *
+ * Run with `pio test -e native -f test_ui_flow`.
+ */
+
+#include <unity.h>
+#include "Simulator.h"
+
+static Simulator simulator;
+static ScreenManager* ui;
+
+static void run(const char* line) {
+    TEST_ASSERT_TRUE_MESSAGE(simulator.execute(line), line);
+}
+
+static void key(char pressed) {
+    simulator.pressKey(pressed);
+    simulator.wait(100);
+}
+
+static void unlock() {
+    run("tap master");
+    simulator.wait(300);
+    run("remove");
+    simulator.wait(300);
+    TEST_ASSERT_TRUE(ui->getTopScreen() == &ui->homeScreen);
+}
+
+static void startSession() {
+    unlock();
+    run("tap alice");
+    simulator.wait(500);
+    TEST_ASSERT_TRUE(ui->getTopScreen() == &ui->selectActionScreen);
+}
+
+void setUp() {
+    run("remove");
+    run("wifi ap off");
+    ui->lock(false);
+    simulator.wait(100);
+}
+
+void tearDown() {}
+
+void test_master_card_unlocks_to_home() {
+    TEST_ASSERT_TRUE(ui->getTopScreen() == &ui->lockScreen);
+    TEST_ASSERT_TRUE(ui->isLocked());
+    unlock();
+    TEST_ASSERT_FALSE(ui->isLocked());
+    TEST_ASSERT_EQUAL_UINT(1, ui->getDepth());
+}
+
+void test_other_card_keeps_device_locked() {
+    run("tap alice");
+    simulator.wait(300);
+    TEST_ASSERT_TRUE(ui->getTopScreen() == &ui->messageScreen);
+    run("remove");
+    simulator.wait(2000);
+    TEST_ASSERT_TRUE(ui->getTopScreen() == &ui->lockScreen);
+    TEST_ASSERT_EQUAL_UINT(1, ui->getDepth());
+}
+
+void test_session_ends_when_card_leaves() {
+    startSession();
+    TEST_ASSERT_EQUAL_UINT(2, ui->getDepth());
+    run("remove");
+    simulator.wait(500);
+    TEST_ASSERT_TRUE(ui->getTopScreen() == &ui->homeScreen);
+    TEST_ASSERT_EQUAL_UINT(1, ui->getDepth());
+}
+
+void test_prompt_star_erases_then_cancels() {
+    startSession();
+    key('1');
+    TEST_ASSERT_TRUE(ui->getTopScreen() == &ui->rechargeScreen);
+    key('3');
+    TEST_ASSERT_TRUE(ui->getTopScreen() == &ui->promptScreen);
+    uint8_t depth = ui->getDepth();
+
+    key('5');
+    key('*');   // Erases the 5
+    TEST_ASSERT_TRUE(ui->getTopScreen() == &ui->promptScreen);
+    key('*');   // Nothing typed: cancels
+    TEST_ASSERT_TRUE(ui->getTopScreen() == &ui->rechargeScreen);
+    TEST_ASSERT_EQUAL_UINT(depth - 1, ui->getDepth());
+    TEST_ASSERT_TRUE(simulator.rowContains(0, "RECHARGE"));
+}
+
+void test_cancelled_number_prompt_returns_to_list() {
+    startSession();
+    key('2');
+    TEST_ASSERT_TRUE(ui->getTopScreen() == &ui->userModeScreen);
+    key('1');
+    TEST_ASSERT_TRUE(ui->getTopScreen() == &ui->promptScreen);
+    key('*');
+    TEST_ASSERT_TRUE(ui->getTopScreen() == &ui->userModeScreen);
+}
+
+void test_declined_recharge_returns_home() {
+    startSession();
+    key('1');
+    key('1');
+    TEST_ASSERT_TRUE(ui->getTopScreen() == &ui->confirmScreen);
+    key('*');
+    TEST_ASSERT_TRUE(ui->getTopScreen() != &ui->confirmScreen && ui->getTopScreen() != &ui->rechargeScreen);
+    run("remove");   // Home would open a new session for the card still on the reader
+    simulator.wait(500);
+    TEST_ASSERT_TRUE(ui->getTopScreen() == &ui->homeScreen);
+    TEST_ASSERT_EQUAL_UINT(1, ui->getDepth());
+}
+
+void test_recharge_fails_when_the_balance_cannot_be_debited() {
+    ConfigManager* config = simulator.getConfig();
+    uint64_t balance = config->GetBalance();
+    byte block[16];
+    memcpy(block, simulator.findCard("alice")->blocks[37], sizeof(block));
+
+    startSession();
+    key('1');
+    key('1');
+    TEST_ASSERT_TRUE(ui->getTopScreen() == &ui->confirmScreen);
+    HostHal::failPartitionWrites(100);   // The balance journal cannot be written
+    key('#');
+    simulator.wait(1500);
+    HostHal::failPartitionWrites(0);
+
+    TEST_ASSERT_TRUE(simulator.rowContains(3, "RECHARGE FAILED"));
+    TEST_ASSERT_EQUAL_INT64((int64_t)balance, (int64_t)config->GetBalance());
+    TEST_ASSERT_TRUE(memcmp(block, simulator.findCard("alice")->blocks[37], sizeof(block)) == 0);   // Card not credited
+    run("remove");
+    simulator.wait(500);
+}
+
+void test_hold_hash_opens_lock_card_page() {
+    unlock();
+    simulator.pressKey('#', KEYPAD_LONG_PRESS_MS + 100);
+    simulator.wait(100);
+    TEST_ASSERT_TRUE(ui->getTopScreen() == &ui->lockCardScreen);
+    TEST_ASSERT_TRUE(simulator.rowContains(0, "LOCK CARD"));
+
+    key('*');
+    TEST_ASSERT_TRUE(ui->getTopScreen() == &ui->homeScreen);
+}
+
+void test_short_hash_stays_home() {
+    unlock();
+    key('#');
+    TEST_ASSERT_TRUE(ui->getTopScreen() == &ui->homeScreen);
+}
+
+void test_access_point_page_follows_the_ap() {
+    run("wifi ap on");
+    simulator.wait(100);
+    TEST_ASSERT_TRUE(ui->getTopScreen() == &ui->apScreen);
+    TEST_ASSERT_TRUE(simulator.rowContains(1, "WIFI NOT SET"));
+
+    run("wifi ap off");
+    simulator.wait(100);
+    TEST_ASSERT_TRUE(ui->getTopScreen() == &ui->lockScreen);
+}
+
+void test_master_card_unlocks_from_access_point_page() {
+    run("wifi ap on");
+    simulator.wait(100);
+    TEST_ASSERT_TRUE(ui->getTopScreen() == &ui->apScreen);
+    unlock();
+
+    run("wifi ap off");   // Leaving AP mode does not lock an unlocked device
+    simulator.wait(100);
+    TEST_ASSERT_TRUE(ui->getTopScreen() == &ui->homeScreen);
+}
+
+void test_star_leaves_access_point_page() {
+    run("wifi ap on");
+    simulator.wait(100);
+    key('*');
+    TEST_ASSERT_TRUE(ui->getTopScreen() == &ui->lockScreen);
+    run("wifi ap off");
+}
+
+int main(int argc, char** argv) {
+    HostHal::setSerialOutput(nullptr);
+    setenv("TZ", "UTC", 1);
+    simulator.begin();
+    ui = simulator.getScreens();
+    simulator.execute("card master d3:73:fd:e3");
+    simulator.execute("card alice 04:a1:b2:c3 balance 500");
+
+    UNITY_BEGIN();
+    RUN_TEST(test_master_card_unlocks_to_home);
+    RUN_TEST(test_other_card_keeps_device_locked);
+    RUN_TEST(test_session_ends_when_card_leaves);
+    RUN_TEST(test_prompt_star_erases_then_cancels);
+    RUN_TEST(test_cancelled_number_prompt_returns_to_list);
+    RUN_TEST(test_declined_recharge_returns_home);
+    RUN_TEST(test_recharge_fails_when_the_balance_cannot_be_debited);
+    RUN_TEST(test_hold_hash_opens_lock_card_page);
+    RUN_TEST(test_short_hash_stays_home);
+    RUN_TEST(test_access_point_page_follows_the_ap);
+    RUN_TEST(test_master_card_unlocks_from_access_point_page);
+    RUN_TEST(test_star_leaves_access_point_page);
+    return UNITY_END();
+}